@@ -0,0 +1,197 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_data_out_async_writer_h
+#define dealii_data_out_async_writer_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/thread_management.h>
+
+#include <deque>
+#include <future>
+#include <limits>
+#include <string>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A class that writes the output of DataOutInterface objects (for example
+ * DataOut after a call to DataOut::build_patches()) to files in the
+ * background, so that the expensive parts of the output, i.e., the
+ * formatting, the compression of VTU data, and the file I/O, overlap with
+ * the computations of the program.
+ *
+ * A call to write() takes a snapshot of the patches, the names of the data
+ * sets, and the output flags of the DataOutInterface object and returns
+ * immediately. The snapshot is then written on a task, see
+ * Threads::new_task(). Since the snapshot is a copy, the DataOut object and
+ * the vectors attached to it can be modified, rebuilt, or destroyed right
+ * after write() returns:
+ * @code
+ *   DataOutAsyncWriter<dim> writer;
+ *   for (unsigned int step = 0; step < n_steps; ++step)
+ *     {
+ *       ... // compute solution
+ *
+ *       DataOut<dim> data_out;
+ *       data_out.attach_dof_handler(dof_handler);
+ *       data_out.add_data_vector(solution, "solution");
+ *       data_out.build_patches();
+ *       writer.write(data_out,
+ *                    "solution-" + Utilities::int_to_string(step, 4) + ".vtu",
+ *                    DataOutBase::vtu);
+ *     }
+ *   writer.wait();
+ * @endcode
+ *
+ * To bound the memory consumed by the snapshots, the number of writes and
+ * the size of the snapshots in flight are limited by the arguments of the
+ * constructor. If a new write would exceed the limits, write() first waits
+ * for the oldest writes to finish.
+ *
+ * Each call to write() returns a std::shared_future that becomes ready when
+ * the file has been written, and that rethrows the exception raised while
+ * writing, if any. An exception of a write is also rethrown by the next
+ * call to write() or wait() that waits for this write. The destructor waits
+ * for all pending writes but ignores their exceptions.
+ *
+ * @note Only output formats that are written by a single process to a
+ * stream can be written in the background. Collective MPI output, such as
+ * DataOutInterface::write_vtu_in_parallel() or
+ * DataOutInterface::write_hdf5_parallel(), must be done on the thread that
+ * participates in the communication.
+ *
+ * @note Objects of this class are not thread-safe, i.e., write() and wait()
+ * must be called from the same thread.
+ *
+ * @ingroup output
+ */
+template <int dim, int spacedim = dim>
+class DataOutAsyncWriter
+{
+public:
+  /**
+   * Constructor. At most @p max_pending_writes writes whose snapshots
+   * consume at most @p max_pending_memory bytes together are in flight at
+   * any time. A single write is always allowed, even if its snapshot is
+   * larger than @p max_pending_memory.
+   */
+  DataOutAsyncWriter(
+    const unsigned int max_pending_writes = 2,
+    const std::size_t  max_pending_memory =
+      std::numeric_limits<std::size_t>::max());
+
+  /**
+   * Destructor. Waits for all pending writes to finish.
+   */
+  ~DataOutAsyncWriter();
+
+  /**
+   * Take a snapshot of the output of @p data_out and write it to the file
+   * @p filename in the format @p output_format in the background. If no
+   * output format is requested, the default format of @p data_out is used,
+   * see DataOutInterface::write().
+   */
+  std::shared_future<void>
+  write(const DataOutInterface<dim, spacedim> &data_out,
+        const std::string &                    filename,
+        const DataOutBase::OutputFormat        output_format =
+          DataOutBase::default_format);
+
+  /**
+   * Wait for all pending writes to finish and rethrow the first exception
+   * raised while writing, if any.
+   */
+  void
+  wait();
+
+  /**
+   * Return the number of writes that have not finished yet.
+   */
+  unsigned int
+  n_pending_writes() const;
+
+  /**
+   * Return the memory, in bytes, consumed by the snapshots of the writes
+   * that have not been waited for.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * Exception
+   */
+  DeclException1(ExcInvalidNumberOfWrites,
+                 unsigned int,
+                 << "The maximal number of pending writes must be at least "
+                 << "one, but you gave " << arg1 << ".");
+
+private:
+  /**
+   * A write that has been started.
+   */
+  struct PendingWrite
+  {
+    /**
+     * The task writing the snapshot.
+     */
+    Threads::Task<void> task;
+
+    /**
+     * The future returned to the caller of write().
+     */
+    std::shared_future<void> future;
+
+    /**
+     * The memory consumed by the snapshot.
+     */
+    std::size_t memory;
+  };
+
+  /**
+   * Wait for the oldest pending write to finish, remove it from the list of
+   * pending writes, and rethrow its exception, if any.
+   */
+  void
+  wait_for_oldest();
+
+  /**
+   * The maximal number of pending writes.
+   */
+  const unsigned int max_pending_writes;
+
+  /**
+   * The maximal memory consumed by the snapshots of the pending writes.
+   */
+  const std::size_t max_pending_memory;
+
+  /**
+   * The pending writes, in the order they were started.
+   */
+  std::deque<PendingWrite> pending_writes;
+
+  /**
+   * The memory consumed by the snapshots of the pending writes.
+   */
+  std::size_t pending_memory;
+};
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -47,6 +47,8 @@ DEAL_II_NAMESPACE_OPEN
 
 class ParameterHandler;
 class XDMFEntry;
+template <int dim, int spacedim>
+class DataOutAsyncWriter;
 
 /**
  * This is a base class for output of data on meshes of very general form.
@@ -1170,9 +1172,48 @@ namespace DataOutBase
      * when trying to read files generated with this flag set to @p true.
      * Experience with these programs shows that these error messages are likely
      * going to be rather less descriptive and more obscure.
+     *
+     * @note To output a finite element field of polynomial degree $p$ with
+     * cells of the same degree, call DataOut::build_patches() with $p$
+     * subdivisions. The field is then evaluated only at the $(p+1)^d$
+     * equispaced nodes of each Lagrange cell. Together with
+     * #filter_duplicate_vertices, the size of the output then scales with
+     * the number of degrees of freedom of a continuous field.
      */
     bool write_higher_order_cells;
 
+    /**
+     * Flag determining whether vertices shared by several patches are
+     * written only once to VTU files. The data values of such a vertex are
+     * taken from the first patch it belongs to. Since patches do not know
+     * about the vertices or degrees of freedom of the mesh, shared vertices
+     * are identified through the neighbor information of the patches as
+     * set up by DataOut::build_patches(): the nodes on the common face of
+     * two neighboring patches with the same number of subdivisions are
+     * merged. Vertices at hanging nodes, and vertices of patches without
+     * neighbor information, are written once per patch. This reduces the
+     * size of the output considerably for fields that are continuous across
+     * cells, in particular for high-order output with
+     * #write_higher_order_cells, but does not represent discontinuous fields
+     * correctly.
+     *
+     * Default is <tt>false</tt>.
+     */
+    bool filter_duplicate_vertices;
+
+    /**
+     * The size, in bytes, of the blocks into which each data array of a VTU
+     * file is split before compression. The blocks are compressed
+     * independently of each other and in parallel, and are stored in the
+     * multi-block format of VTK's compressed data arrays. Smaller blocks
+     * expose more parallelism for small data arrays, larger blocks give
+     * slightly better compression ratios. Data arrays smaller than the block
+     * size are written as a single block. The value must be positive.
+     *
+     * Default is 2<sup>20</sup>, i.e., one megabyte.
+     */
+    unsigned int compression_block_size;
+
     /**
      * Constructor.
      */
@@ -1181,7 +1222,9 @@ namespace DataOutBase
       const unsigned int cycle = std::numeric_limits<unsigned int>::min(),
       const bool         print_date_and_time              = true,
       const ZlibCompressionLevel compression_level        = best_compression,
-      const bool                 write_higher_order_cells = false);
+      const bool                 write_higher_order_cells  = false,
+      const unsigned int         compression_block_size    = 1U << 20,
+      const bool                 filter_duplicate_vertices = false);
   };
 
 
@@ -3354,6 +3397,13 @@ private:
    * dimension. Can be changed by using the <tt>set_flags</tt> function.
    */
   DataOutBase::Deal_II_IntermediateFlags deal_II_intermediate_flags;
+
+  /**
+   * The asynchronous writer takes snapshots of the patches and names of
+   * objects of this class.
+   */
+  template <int, int>
+  friend class DataOutAsyncWriter;
 };
 
 
@@ -0,0 +1,193 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_data_out_hdf5_time_series_h
+#define dealii_data_out_hdf5_time_series_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <ios>
+#include <string>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A class that writes the output of a time dependent simulation into a
+ * single HDF5 file and an XDMF file that describes the time series, for
+ * example for visualization with ParaView or VisIt.
+ *
+ * In contrast to calling DataOutInterface::write_hdf5_parallel() and
+ * DataOutInterface::write_xdmf_file() in every time step, the mesh is only
+ * written when it changes, and the fields of all time steps on the same
+ * mesh are appended to one extendable, chunked dataset per field. The HDF5
+ * file is organized as follows:
+ * @code
+ *   /mesh_0/nodes      node coordinates of the first mesh
+ *   /mesh_0/cells      connectivity of the first mesh
+ *   /mesh_0/<name>     values of the field <name> on the first mesh, with
+ *                      dimensions (time steps) x (nodes) x (components)
+ *   /mesh_1/...        the same for the mesh after the first change
+ * @endcode
+ * The XDMF file is updated after each time step by overwriting only its
+ * closing tags, so that the cost of a time step does not grow with the
+ * number of steps written before, and so that the files written so far can
+ * be visualized while the simulation is still running. Each time step
+ * selects its row of the field datasets with an XDMF hyperslab, and
+ * describes the mesh and the datasets with the dimensions they have after
+ * this time step, so that the entries of earlier time steps remain valid
+ * when the datasets grow by further rows.
+ *
+ * A typical use looks like this:
+ * @code
+ *   DataOutHDF5TimeSeries<dim> time_series("solution", MPI_COMM_WORLD);
+ *   for (unsigned int step = 0; step < n_steps; ++step)
+ *     {
+ *       ... // compute solution, maybe refine the mesh
+ *
+ *       DataOut<dim> data_out;
+ *       data_out.attach_dof_handler(dof_handler);
+ *       data_out.add_data_vector(solution, "solution");
+ *       data_out.build_patches();
+ *       time_series.write(data_out, time, mesh_was_refined);
+ *     }
+ * @endcode
+ * This writes the files <tt>solution.h5</tt> and <tt>solution.xdmf</tt>.
+ *
+ * A new mesh is written if the caller says so, or if the global number of
+ * nodes or cells differs from the previous time step. Meshes whose vertices
+ * move without a change of the number of nodes, e.g., in ALE computations,
+ * must be flagged by the caller.
+ *
+ * All functions of this class are collective operations on the communicator
+ * given to the constructor. If HDF5 was built with MPI support, the data of
+ * all processes is written collectively to the same file. The HDF5 file is
+ * opened and closed in each call to write(), so that it is in a consistent
+ * state between the time steps.
+ *
+ * @ingroup output
+ */
+template <int dim, int spacedim = dim>
+class DataOutHDF5TimeSeries
+{
+public:
+  /**
+   * Constructor. The output is written to the files
+   * <tt>filename_base.h5</tt> and <tt>filename_base.xdmf</tt>, which are
+   * overwritten by the first call to write(). The @p flags determine how
+   * the patches are converted to nodes and cells. The default removes
+   * duplicate vertices and pads vector fields to three components, as
+   * required by XDMF.
+   */
+  DataOutHDF5TimeSeries(const std::string &                     filename_base,
+                        const MPI_Comm &                        comm,
+                        const DataOutBase::DataOutFilterFlags &flags =
+                          DataOutBase::DataOutFilterFlags(true, true));
+
+  /**
+   * Append the output of @p data_out for the given @p time to the time
+   * series. If @p mesh_changed is true on any process, or if the mesh has a
+   * different number of nodes or cells than in the previous call, the mesh
+   * is written again.
+   */
+  void
+  write(const DataOutInterface<dim, spacedim> &data_out,
+        const double                           time,
+        const bool                             mesh_changed = false);
+
+  /**
+   * Return the number of time steps written so far.
+   */
+  unsigned int
+  n_time_steps() const;
+
+  /**
+   * Return the number of meshes written so far.
+   */
+  unsigned int
+  n_meshes() const;
+
+  /**
+   * Return the name of the HDF5 file.
+   */
+  std::string
+  get_hdf5_filename() const;
+
+  /**
+   * Return the name of the XDMF file.
+   */
+  std::string
+  get_xdmf_filename() const;
+
+private:
+  /**
+   * Append the description of the current time step to the XDMF file. Only
+   * called on the root process.
+   */
+  void
+  write_xdmf_entry(const DataOutBase::DataOutFilter &data_filter,
+                   const double                      time);
+
+  /**
+   * The base of the file names passed to the constructor.
+   */
+  const std::string filename_base;
+
+  /**
+   * The communicator of the processes that write.
+   */
+  const MPI_Comm communicator;
+
+  /**
+   * The flags of the conversion of patches to nodes and cells.
+   */
+  const DataOutBase::DataOutFilterFlags flags;
+
+  /**
+   * The number of time steps written so far.
+   */
+  unsigned int n_steps;
+
+  /**
+   * The number of meshes written so far. The current mesh is stored in the
+   * group <tt>mesh_(n_mesh_versions-1)</tt>.
+   */
+  unsigned int n_mesh_versions;
+
+  /**
+   * The number of time steps written on the current mesh, i.e., the extent
+   * of the first dimension of the field datasets of the current mesh.
+   */
+  unsigned int n_steps_on_mesh;
+
+  /**
+   * The global number of nodes and cells of the current mesh.
+   */
+  unsigned int global_node_cell_count[2];
+
+  /**
+   * The position of the closing tags in the XDMF file, where the next time
+   * step is written.
+   */
+  std::streampos xdmf_footer_position;
+};
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -19,6 +19,7 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/array_view.h>
+#include <deal.II/base/mpi_tags.h>
 
 #include <map>
 #include <vector>
@@ -753,7 +754,7 @@ namespace Utilities
                                        buffers_to_send[i].size(),
                                        MPI_CHAR,
                                        rank,
-                                       21,
+                                       internal::Tags::mpi_some_to_some,
                                        comm,
                                        &buffer_send_requests[i]);
             AssertThrowMPI(ierr);
@@ -770,7 +771,10 @@ namespace Utilities
           {
             // Probe what's going on. Take data from the first available sender
             MPI_Status status;
-            int        ierr = MPI_Probe(MPI_ANY_SOURCE, 21, comm, &status);
+            int        ierr = MPI_Probe(MPI_ANY_SOURCE,
+                                 internal::Tags::mpi_some_to_some,
+                                 comm,
+                                 &status);
             AssertThrowMPI(ierr);
 
             // Length of the message
@@ -783,8 +787,13 @@ namespace Utilities
             const unsigned int rank = status.MPI_SOURCE;
 
             // Actually receive the message
-            ierr = MPI_Recv(
-              buffer.data(), len, MPI_CHAR, rank, 21, comm, MPI_STATUS_IGNORE);
+            ierr = MPI_Recv(buffer.data(),
+                            len,
+                            MPI_CHAR,
+                            rank,
+                            internal::Tags::mpi_some_to_some,
+                            comm,
+                            MPI_STATUS_IGNORE);
             AssertThrowMPI(ierr);
             Assert(received_objects.find(rank) == received_objects.end(),
                    ExcInternalError(
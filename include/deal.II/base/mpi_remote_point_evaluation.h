@@ -0,0 +1,383 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mpi_remote_point_evaluation_h
+#define dealii_mpi_remote_point_evaluation_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/fe/fe_update_flags.h>
+#include <deal.II/fe/mapping.h>
+
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+// forward declarations
+template <int dim, int spacedim>
+class DoFHandler;
+template <int dim, int spacedim>
+class FEValues;
+template <int dim, int spacedim>
+class FiniteElement;
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    /**
+     * A class that evaluates quantities at arbitrary points of a (possibly
+     * distributed) triangulation, where each process asks for a set of points
+     * that may lie in cells owned by any other process.
+     *
+     * The expensive work is done once in reinit(): the candidate owners of
+     * each point are determined from lists of bounding boxes that describe
+     * the locally owned domain of each process, with one box for each of its
+     * cells on the first level of refinement, the points are sent to the
+     * candidates, which
+     * locate them in their locally owned cells with
+     * GridTools::compute_point_locations_batched(), and the pattern of the
+     * replies is recorded. Afterwards, each call to evaluate_and_process()
+     * only evaluates the quantities at the points located on the current
+     * process, grouped by cell, and sends the values back to the requesting
+     * processes in a single point-to-point exchange. This makes the class
+     * suitable for coupling problems and probes that evaluate fields at the
+     * same points in every time step:
+     * @code
+     *   Utilities::MPI::RemotePointEvaluation<dim> evaluation;
+     *   evaluation.reinit(points, triangulation, mapping);
+     *   for (unsigned int step = 0; step < n_steps; ++step)
+     *     {
+     *       ...
+     *       const std::vector<Tensor<1, 1>> values =
+     *         VectorTools::point_values<1>(evaluation, dof_handler, solution);
+     *     }
+     * @endcode
+     *
+     * Points on the interface between the domains of two processes are
+     * evaluated by the process with the lower rank. Points that are not found
+     * in any locally owned cell of any process get a default-constructed
+     * value and are listed by get_missing_points().
+     *
+     * The object must be set up again if the triangulation or the points
+     * change.
+     */
+    template <int dim, int spacedim = dim>
+    class RemotePointEvaluation : public Subscriptor
+    {
+    public:
+      /**
+       * Constructor. @p tolerance is the tolerance in reference coordinates
+       * for a point to be considered inside a cell.
+       */
+      RemotePointEvaluation(const double tolerance = 1e-10);
+
+      /**
+       * Set up the communication pattern for the evaluation at the
+       * @p points given by the current process. The mapping @p mapping
+       * describes the geometry of the cells of @p triangulation. If the
+       * triangulation is a parallel::Triangulation, this function is a
+       * collective operation on its communicator.
+       */
+      void
+      reinit(const std::vector<Point<spacedim>> &points,
+             const Triangulation<dim, spacedim> &triangulation,
+             const Mapping<dim, spacedim> &      mapping);
+
+      /**
+       * Evaluate a quantity at the points requested by all processes that
+       * lie in locally owned cells of the current process, and return the
+       * values at the points requested by the current process in @p output.
+       *
+       * The function @p evaluation_function is called once with the cells
+       * and reference points returned by get_cell_data(), and must fill the
+       * entries of its first argument, which has as many entries as there are
+       * reference points, in the same order. Then the values are sent to the
+       * processes that requested them. The type @p T must be trivially
+       * copyable, e.g. a number or a Tensor, since it is sent as a contiguous
+       * MPI datatype of <code>sizeof(T)</code> bytes.
+       */
+      template <typename T>
+      void
+      evaluate_and_process(
+        std::vector<T> &output,
+        const std::function<void(const ArrayView<T> &,
+                                 const GridTools::PointLocations<dim, spacedim>
+                                   &)> &evaluation_function) const;
+
+      /**
+       * Return the locally owned cells and the reference coordinates of the
+       * points, requested by any process, that are evaluated on the current
+       * process.
+       */
+      const GridTools::PointLocations<dim, spacedim> &
+      get_cell_data() const;
+
+      /**
+       * Call @p evaluate_cell for each cell of get_cell_data() with an
+       * FEValues object that uses the reference points of the cell as
+       * quadrature formula and is reinit'ed on the corresponding cell of
+       * @p dof_handler, together with the position of the first point of the
+       * cell among the reference points of get_cell_data().
+       *
+       * Since the reference points differ from cell to cell, a new FEValues
+       * object is set up for each cell and destroyed before the next one is
+       * set up. The memory used therefore does not grow with the number of
+       * cells, but @p evaluate_cell must not keep a reference to the object.
+       */
+      void
+      loop_over_cells(
+        const DoFHandler<dim, spacedim> &dof_handler,
+        const UpdateFlags                update_flags,
+        const std::function<void(const FEValues<dim, spacedim> &,
+                                 const unsigned int)> &evaluate_cell) const;
+
+      /**
+       * Return the indices of the points passed to reinit() on the current
+       * process that were not found in any locally owned cell of any
+       * process.
+       */
+      const std::vector<unsigned int> &
+      get_missing_points() const;
+
+      /**
+       * Return whether all points passed to reinit() on the current process
+       * were found.
+       */
+      bool
+      all_points_found() const;
+
+      /**
+       * Return the triangulation passed to reinit().
+       */
+      const Triangulation<dim, spacedim> &
+      get_triangulation() const;
+
+      /**
+       * Return the mapping passed to reinit().
+       */
+      const Mapping<dim, spacedim> &
+      get_mapping() const;
+
+      /**
+       * Return the communicator of the triangulation passed to reinit().
+       */
+      const MPI_Comm &
+      get_communicator() const;
+
+    private:
+      /**
+       * The tolerance passed to the constructor.
+       */
+      const double tolerance;
+
+      /**
+       * The triangulation passed to reinit().
+       */
+      SmartPointer<const Triangulation<dim, spacedim>> triangulation;
+
+      /**
+       * The mapping passed to reinit().
+       */
+      SmartPointer<const Mapping<dim, spacedim>> mapping;
+
+      /**
+       * The communicator of the triangulation.
+       */
+      MPI_Comm communicator;
+
+      /**
+       * The number of points passed to reinit().
+       */
+      unsigned int n_requested_points;
+
+      /**
+       * The points evaluated on the current process, grouped by cell.
+       */
+      GridTools::PointLocations<dim, spacedim> cell_data;
+
+      /**
+       * The ranks the values computed on the current process are sent to,
+       * in ascending order.
+       */
+      std::vector<unsigned int> send_ranks;
+
+      /**
+       * The start of the values for each rank in @p send_ranks within
+       * @p send_indices, with one more entry than @p send_ranks.
+       */
+      std::vector<unsigned int> send_ptrs;
+
+      /**
+       * The positions of the values sent to the other processes among the
+       * reference points of @p cell_data.
+       */
+      std::vector<unsigned int> send_indices;
+
+      /**
+       * The ranks the current process receives values from, in ascending
+       * order.
+       */
+      std::vector<unsigned int> recv_ranks;
+
+      /**
+       * The start of the values from each rank in @p recv_ranks within the
+       * received data, with one more entry than @p recv_ranks.
+       */
+      std::vector<unsigned int> recv_ptrs;
+
+      /**
+       * The index of the requested point each received value belongs to,
+       * or numbers::invalid_unsigned_int if the point is also found by a
+       * process with lower rank and the value is discarded.
+       */
+      std::vector<unsigned int> recv_point_indices;
+
+      /**
+       * The points requested by the current process that were not found.
+       */
+      std::vector<unsigned int> missing_points;
+    };
+
+
+
+    /* ---------------------- inline and template functions ------------- */
+
+
+    template <int dim, int spacedim>
+    template <typename T>
+    void
+    RemotePointEvaluation<dim, spacedim>::evaluate_and_process(
+      std::vector<T> &output,
+      const std::function<
+        void(const ArrayView<T> &,
+             const GridTools::PointLocations<dim, spacedim> &)>
+        &evaluation_function) const
+    {
+      Assert(triangulation != nullptr,
+             ExcMessage("You need to call reinit() first."));
+
+      // evaluate at the points located on the current process
+      std::vector<T> buffer(cell_data.reference_points.size());
+      evaluation_function(make_array_view(buffer), cell_data);
+
+      std::vector<T> send_buffer(send_indices.size());
+      for (unsigned int i = 0; i < send_indices.size(); ++i)
+        send_buffer[i] = buffer[send_indices[i]];
+      std::vector<T> recv_buffer(recv_ptrs.back());
+
+      const unsigned int my_rank = this_mpi_process(communicator);
+#ifdef DEAL_II_WITH_MPI
+      // send the values as elements of a datatype of sizeof(T) bytes, so
+      // that the counts passed to MPI are numbers of values rather than
+      // numbers of bytes
+      MPI_Datatype value_type;
+      int          ierr = MPI_Type_contiguous(sizeof(T), MPI_BYTE, &value_type);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Type_commit(&value_type);
+      AssertThrowMPI(ierr);
+
+      const int mpi_tag = internal::Tags::remote_point_evaluation;
+
+      std::vector<MPI_Request> requests;
+      requests.reserve(send_ranks.size() + recv_ranks.size());
+      for (unsigned int r = 0; r < recv_ranks.size(); ++r)
+        if (recv_ranks[r] != my_rank)
+          {
+            AssertThrow(recv_ptrs[r + 1] - recv_ptrs[r] <=
+                          static_cast<unsigned int>(
+                            std::numeric_limits<int>::max()),
+                        ExcMessage("Too many values to receive."));
+            requests.emplace_back();
+            ierr = MPI_Irecv(recv_buffer.data() + recv_ptrs[r],
+                             recv_ptrs[r + 1] - recv_ptrs[r],
+                             value_type,
+                             recv_ranks[r],
+                             mpi_tag,
+                             communicator,
+                             &requests.back());
+            AssertThrowMPI(ierr);
+          }
+      for (unsigned int r = 0; r < send_ranks.size(); ++r)
+        if (send_ranks[r] != my_rank)
+          {
+            AssertThrow(send_ptrs[r + 1] - send_ptrs[r] <=
+                          static_cast<unsigned int>(
+                            std::numeric_limits<int>::max()),
+                        ExcMessage("Too many values to send."));
+            requests.emplace_back();
+            ierr = MPI_Isend(send_buffer.data() + send_ptrs[r],
+                             send_ptrs[r + 1] - send_ptrs[r],
+                             value_type,
+                             send_ranks[r],
+                             mpi_tag,
+                             communicator,
+                             &requests.back());
+            AssertThrowMPI(ierr);
+          }
+#endif
+
+      // the values for the current process are copied directly
+      for (unsigned int r = 0; r < recv_ranks.size(); ++r)
+        if (recv_ranks[r] == my_rank)
+          {
+            const unsigned int s =
+              std::lower_bound(send_ranks.begin(), send_ranks.end(), my_rank) -
+              send_ranks.begin();
+            AssertIndexRange(s, send_ranks.size());
+            AssertDimension(send_ptrs[s + 1] - send_ptrs[s],
+                            recv_ptrs[r + 1] - recv_ptrs[r]);
+            std::copy(send_buffer.begin() + send_ptrs[s],
+                      send_buffer.begin() + send_ptrs[s + 1],
+                      recv_buffer.begin() + recv_ptrs[r]);
+          }
+
+#ifdef DEAL_II_WITH_MPI
+      if (requests.size() > 0)
+        {
+          ierr = MPI_Waitall(requests.size(),
+                             requests.data(),
+                             MPI_STATUSES_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+      ierr = MPI_Type_free(&value_type);
+      AssertThrowMPI(ierr);
+#endif
+
+      output.clear();
+      output.resize(n_requested_points);
+      for (unsigned int i = 0; i < recv_buffer.size(); ++i)
+        if (recv_point_indices[i] != numbers::invalid_unsigned_int)
+          output[recv_point_indices[i]] = recv_buffer[i];
+    }
+
+  } // namespace MPI
+} // namespace Utilities
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
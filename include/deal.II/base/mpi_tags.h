@@ -0,0 +1,59 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mpi_tags_h
+#define dealii_mpi_tags_h
+
+#include <deal.II/base/config.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    namespace internal
+    {
+      /**
+       * The tags of the point-to-point messages that functions of the
+       * library exchange on communicators given by the user. Keeping them in
+       * one place ensures that the messages of different functions cannot
+       * be mixed up if their communication overlaps.
+       */
+      namespace Tags
+      {
+        /**
+         * The tags, one for each function that sends messages.
+         */
+        enum enumeration : int
+        {
+          /**
+           * Utilities::MPI::some_to_some().
+           */
+          mpi_some_to_some = 21,
+
+          /**
+           * Utilities::MPI::RemotePointEvaluation::evaluate_and_process().
+           */
+          remote_point_evaluation = 22
+        };
+      } // namespace Tags
+    }   // namespace internal
+  }     // namespace MPI
+} // namespace Utilities
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
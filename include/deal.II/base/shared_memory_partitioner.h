@@ -0,0 +1,431 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_shared_memory_partitioner_h
+#define dealii_shared_memory_partitioner_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/partitioner.h>
+
+#include <deal.II/lac/vector_operation.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+#ifdef DEAL_II_WITH_MPI
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    /**
+     * An array of numbers that is allocated in an MPI-3 shared memory window
+     * (<code>MPI_Win_allocate_shared</code>). All processes of the
+     * shared-memory communicator given to the constructor allocate their
+     * part of the window together, and each process can access the parts of
+     * all other processes of the communicator through direct loads and
+     * stores rather than through messages.
+     *
+     * The object opens a passive-target access epoch on the window for its
+     * whole lifetime. Accesses to memory of other processes must be
+     * separated from the accesses of the owning process by a call to
+     * synchronize() on all processes of the communicator.
+     *
+     * Both the constructor and the destructor are collective operations on
+     * the shared-memory communicator.
+     */
+    template <typename Number>
+    class SharedMemoryArray
+    {
+    public:
+      /**
+       * Allocate @p size elements on the current process as part of a
+       * window shared among all processes of @p communicator_sm. The
+       * processes in @p communicator_sm must be able to share memory, e.g.,
+       * because the communicator was created by
+       * <code>MPI_Comm_split_type(..., MPI_COMM_TYPE_SHARED, ...)</code>.
+       */
+      SharedMemoryArray(const MPI_Comm &  communicator_sm,
+                        const std::size_t size);
+
+      /**
+       * Destructor. Frees the window.
+       */
+      ~SharedMemoryArray();
+
+      /**
+       * Return a pointer to the part of the window owned by the current
+       * process.
+       */
+      Number *
+      data() const;
+
+      /**
+       * Return the pointers to the parts of the window owned by all
+       * processes of the shared-memory communicator, indexed by their rank
+       * in that communicator.
+       */
+      const std::vector<Number *> &
+      get_arrays() const;
+
+      /**
+       * Make sure that all writes issued on any process of the shared-memory
+       * communicator before this call are visible to all processes after the
+       * call. This function is a collective operation.
+       */
+      void
+      synchronize() const;
+
+      /**
+       * Return an estimate for the memory consumption, in bytes, of this
+       * object, including the part of the window owned by the current
+       * process.
+       */
+      std::size_t
+      memory_consumption() const;
+
+    private:
+      /**
+       * The shared-memory communicator.
+       */
+      MPI_Comm communicator_sm;
+
+      /**
+       * The number of elements owned by the current process.
+       */
+      std::size_t local_size;
+
+      /**
+       * The window holding the data.
+       */
+      MPI_Win window;
+
+      /**
+       * The base pointers of all processes in the window.
+       */
+      std::vector<Number *> arrays;
+    };
+
+
+
+    /**
+     * This class augments a Partitioner by the information needed to
+     * exchange ghost values between the processes of a compute node through
+     * shared memory. Given the communicator @p communicator_sm of processes
+     * that can share memory (typically obtained by
+     * <code>MPI_Comm_split_type(..., MPI_COMM_TYPE_SHARED, ...)</code>), the
+     * ghost indices of the partitioner are split into two groups:
+     *
+     * - Ghost indices owned by a process in @p communicator_sm. For vectors
+     *   whose memory is allocated in a SharedMemoryArray, these entries are
+     *   read directly from the memory of the owning process in
+     *   export_to_ghosted_array(), and the owning process reads the
+     *   contributions of other processes directly from their ghost arrays in
+     *   import_from_ghosted_array(). In both cases, each process only writes
+     *   to its own memory, so no atomic operations are necessary.
+     *
+     * - All other ghost indices. They are described by the partitioner
+     *   returned by get_off_node_partitioner(), which is set up with the
+     *   ghost index set of the original partitioner as the larger ghost index
+     *   set, i.e., it exchanges the off-node ghost values by MPI messages
+     *   directly into their positions in the full ghost array.
+     *
+     * The class is used by LinearAlgebra::distributed::Vector when it is
+     * initialized with a shared-memory communicator.
+     */
+    class SharedMemoryPartitioner
+    {
+    public:
+      /**
+       * Set up the exchange pattern. This is a collective operation on the
+       * communicator of @p partitioner and on @p communicator_sm. The
+       * processes of @p communicator_sm must be a subset of the processes of
+       * the communicator of @p partitioner.
+       */
+      SharedMemoryPartitioner(
+        const std::shared_ptr<const Partitioner> &partitioner,
+        const MPI_Comm &                          communicator_sm);
+
+      /**
+       * Return the partitioner the object was set up with.
+       */
+      const std::shared_ptr<const Partitioner> &
+      get_partitioner() const;
+
+      /**
+       * Return the partitioner describing the exchange of ghost values with
+       * processes outside of the shared-memory communicator.
+       */
+      const std::shared_ptr<const Partitioner> &
+      get_off_node_partitioner() const;
+
+      /**
+       * Return the shared-memory communicator.
+       */
+      const MPI_Comm &
+      get_shared_memory_communicator() const;
+
+      /**
+       * Return the number of ghost indices that are owned by processes in the
+       * shared-memory communicator.
+       */
+      unsigned int
+      n_shared_ghost_indices() const;
+
+      /**
+       * Fill the entries of @p ghost_array that are owned by processes in the
+       * shared-memory communicator by reading from the arrays of the owning
+       * processes. The argument @p shared_arrays contains the pointers to
+       * the start of the locally owned part of the vector on all processes
+       * of the shared-memory communicator, as given by
+       * SharedMemoryArray::get_arrays(). The caller is responsible for
+       * synchronizing the processes before and after this call.
+       */
+      template <typename Number>
+      void
+      export_to_ghosted_array(const std::vector<Number *> &shared_arrays,
+                              const ArrayView<Number> &    ghost_array) const;
+
+      /**
+       * Combine the ghost entries on other processes of the shared-memory
+       * communicator that refer to locally owned indices of the current
+       * process into @p locally_owned_array, according to @p
+       * vector_operation. The ghost arrays of the other processes are read
+       * directly from @p shared_arrays, which are laid out as described for
+       * export_to_ghosted_array(). For VectorOperation::insert, nothing is
+       * done. The caller is responsible for synchronizing the processes
+       * before and after this call.
+       */
+      template <typename Number>
+      void
+      import_from_ghosted_array(
+        const VectorOperation::values vector_operation,
+        const std::vector<Number *> & shared_arrays,
+        const ArrayView<Number> &     locally_owned_array) const;
+
+      /**
+       * Return an estimate of the memory consumption of this object in
+       * bytes.
+       */
+      std::size_t
+      memory_consumption() const;
+
+    private:
+      /**
+       * A contiguous range of entries that is copied between the memory of
+       * the current process and the memory of another process of the
+       * shared-memory communicator.
+       */
+      struct Chunk
+      {
+        /**
+         * Position of the first entry in the memory of the current process,
+         * relative to the start of the ghost array for exports and to the
+         * start of the locally owned array for imports.
+         */
+        unsigned int local_offset;
+
+        /**
+         * Rank of the other process in the shared-memory communicator.
+         */
+        unsigned int rank;
+
+        /**
+         * Position of the first entry in the memory of the other process,
+         * relative to the start of its locally owned array.
+         */
+        unsigned int remote_offset;
+
+        /**
+         * Number of entries.
+         */
+        unsigned int length;
+      };
+
+      /**
+       * The partitioner the object was set up with.
+       */
+      std::shared_ptr<const Partitioner> partitioner;
+
+      /**
+       * The partitioner for the exchange with other nodes.
+       */
+      std::shared_ptr<const Partitioner> off_node_partitioner;
+
+      /**
+       * The shared-memory communicator.
+       */
+      MPI_Comm communicator_sm;
+
+      /**
+       * The ranges of ghost entries read from other processes in
+       * export_to_ghosted_array().
+       */
+      std::vector<Chunk> ghost_chunks;
+
+      /**
+       * The ranges of ghost entries of other processes combined into the
+       * locally owned entries in import_from_ghosted_array().
+       */
+      std::vector<Chunk> import_chunks;
+    };
+
+
+
+    /* ------------------------- inline functions ----------------------- */
+
+#  ifndef DOXYGEN
+
+    template <typename Number>
+    inline SharedMemoryArray<Number>::SharedMemoryArray(
+      const MPI_Comm &  communicator_sm,
+      const std::size_t size)
+      : communicator_sm(communicator_sm)
+      , local_size(size)
+      , window(MPI_WIN_NULL)
+    {
+      // let each process allocate its part of the window in its own memory
+      // pages, which keeps the data close to the process on NUMA systems
+      MPI_Info info;
+      int      ierr = MPI_Info_create(&info);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Info_set(info, "alloc_shared_noncontig", "true");
+      AssertThrowMPI(ierr);
+
+      Number *local_array = nullptr;
+      ierr                = MPI_Win_allocate_shared(size * sizeof(Number),
+                                     sizeof(Number),
+                                     info,
+                                     communicator_sm,
+                                     &local_array,
+                                     &window);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Info_free(&info);
+      AssertThrowMPI(ierr);
+
+      ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+      AssertThrowMPI(ierr);
+
+      arrays.resize(n_mpi_processes(communicator_sm));
+      for (unsigned int rank = 0; rank < arrays.size(); ++rank)
+        {
+          MPI_Aint remote_size;
+          int      displacement_unit;
+          ierr = MPI_Win_shared_query(
+            window, rank, &remote_size, &displacement_unit, &arrays[rank]);
+          AssertThrowMPI(ierr);
+        }
+      Assert(arrays[this_mpi_process(communicator_sm)] == local_array ||
+               size == 0,
+             ExcInternalError());
+    }
+
+
+
+    template <typename Number>
+    inline SharedMemoryArray<Number>::~SharedMemoryArray()
+    {
+      if (window != MPI_WIN_NULL)
+        {
+          int ierr = MPI_Win_unlock_all(window);
+          AssertNothrow(ierr == MPI_SUCCESS, ExcMPI(ierr));
+          ierr = MPI_Win_free(&window);
+          AssertNothrow(ierr == MPI_SUCCESS, ExcMPI(ierr));
+          (void)ierr;
+        }
+    }
+
+
+
+    template <typename Number>
+    inline Number *
+    SharedMemoryArray<Number>::data() const
+    {
+      return arrays[this_mpi_process(communicator_sm)];
+    }
+
+
+
+    template <typename Number>
+    inline const std::vector<Number *> &
+    SharedMemoryArray<Number>::get_arrays() const
+    {
+      return arrays;
+    }
+
+
+
+    template <typename Number>
+    inline void
+    SharedMemoryArray<Number>::synchronize() const
+    {
+      int ierr = MPI_Win_sync(window);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Barrier(communicator_sm);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Win_sync(window);
+      AssertThrowMPI(ierr);
+    }
+
+
+
+    template <typename Number>
+    inline std::size_t
+    SharedMemoryArray<Number>::memory_consumption() const
+    {
+      return sizeof(*this) + arrays.capacity() * sizeof(Number *) +
+             local_size * sizeof(Number);
+    }
+
+
+
+    inline const std::shared_ptr<const Partitioner> &
+    SharedMemoryPartitioner::get_partitioner() const
+    {
+      return partitioner;
+    }
+
+
+
+    inline const std::shared_ptr<const Partitioner> &
+    SharedMemoryPartitioner::get_off_node_partitioner() const
+    {
+      return off_node_partitioner;
+    }
+
+
+
+    inline const MPI_Comm &
+    SharedMemoryPartitioner::get_shared_memory_communicator() const
+    {
+      return communicator_sm;
+    }
+
+#  endif // ifndef DOXYGEN
+
+  } // namespace MPI
+} // namespace Utilities
+
+#endif // DEAL_II_WITH_MPI
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
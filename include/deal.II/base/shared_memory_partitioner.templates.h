@@ -0,0 +1,95 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_shared_memory_partitioner_templates_h
+#define dealii_shared_memory_partitioner_templates_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/partitioner.templates.h>
+#include <deal.II/base/shared_memory_partitioner.h>
+
+#include <algorithm>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Utilities
+{
+  namespace MPI
+  {
+#ifndef DOXYGEN
+
+#  ifdef DEAL_II_WITH_MPI
+
+    template <typename Number>
+    void
+    SharedMemoryPartitioner::export_to_ghosted_array(
+      const std::vector<Number *> &shared_arrays,
+      const ArrayView<Number> &    ghost_array) const
+    {
+      AssertDimension(shared_arrays.size(),
+                      n_mpi_processes(communicator_sm));
+      AssertDimension(ghost_array.size(), partitioner->n_ghost_indices());
+
+      for (const Chunk &chunk : ghost_chunks)
+        std::copy(shared_arrays[chunk.rank] + chunk.remote_offset,
+                  shared_arrays[chunk.rank] + chunk.remote_offset +
+                    chunk.length,
+                  ghost_array.data() + chunk.local_offset);
+    }
+
+
+
+    template <typename Number>
+    void
+    SharedMemoryPartitioner::import_from_ghosted_array(
+      const VectorOperation::values vector_operation,
+      const std::vector<Number *> & shared_arrays,
+      const ArrayView<Number> &     locally_owned_array) const
+    {
+      AssertDimension(shared_arrays.size(),
+                      n_mpi_processes(communicator_sm));
+      AssertDimension(locally_owned_array.size(), partitioner->local_size());
+
+      for (const Chunk &chunk : import_chunks)
+        {
+          const Number *read_position =
+            shared_arrays[chunk.rank] + chunk.remote_offset;
+          Number *write_position =
+            locally_owned_array.data() + chunk.local_offset;
+          if (vector_operation == VectorOperation::add)
+            for (unsigned int j = 0; j < chunk.length; ++j)
+              write_position[j] += read_position[j];
+          else if (vector_operation == VectorOperation::min)
+            for (unsigned int j = 0; j < chunk.length; ++j)
+              write_position[j] =
+                internal::get_min(read_position[j], write_position[j]);
+          else if (vector_operation == VectorOperation::max)
+            for (unsigned int j = 0; j < chunk.length; ++j)
+              write_position[j] =
+                internal::get_max(read_position[j], write_position[j]);
+        }
+    }
+
+#  endif // ifdef DEAL_II_WITH_MPI
+#endif   // ifndef DOXYGEN
+
+  } // namespace MPI
+} // namespace Utilities
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -42,6 +42,7 @@ template <int dim, int spacedim>
 class FESubfaceValues;
 template <int dim, int spacedim>
 class FESystem;
+class FEMatrixCache;
 
 /**
  * This is the base class for finite elements in arbitrary dimensions. It
@@ -3078,6 +3079,7 @@ protected:
   friend class FEFaceValues<dim, spacedim>;
   friend class FESubfaceValues<dim, spacedim>;
   friend class FESystem<dim, spacedim>;
+  friend class FEMatrixCache;
 
   // explicitly check for sensible template arguments, but not on windows
   // because MSVC creates bogus warnings during normal compilation
@@ -0,0 +1,184 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_fe_matrix_cache_h
+#define dealii_fe_matrix_cache_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <string>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <int dim, int spacedim>
+class FiniteElement;
+
+
+/**
+ * A process-wide cache for the interface constraint matrices and the
+ * prolongation and restriction matrices of finite elements, keyed by the
+ * string returned by FiniteElement::get_name().
+ *
+ * For elements of high degree, computing these matrices is expensive:
+ * FE_Nedelec, for example, computes the interface constraints in its
+ * constructor and the transfer matrices upon first request by projections,
+ * which takes minutes for high degrees in 3d. In a parallel program, every
+ * process repeats this work. With this class, the matrices can be computed
+ * once, written to a file, and read by all processes of later runs:
+ * @code
+ *   // preparation run
+ *   FE_Nedelec<3> fe(8);
+ *   FEMatrixCache::add(fe);
+ *   FEMatrixCache::write("fe_matrices.bin", MPI_COMM_WORLD);
+ *
+ *   // production runs: read the file on rank 0, broadcast it to all other
+ *   // ranks, and use the cached matrices in all elements created afterwards
+ *   FEMatrixCache::read("fe_matrices.bin", MPI_COMM_WORLD);
+ *   FE_Nedelec<3> fe(8);
+ * @endcode
+ *
+ * The cache is opt-in: it is only consulted by the elements after enable()
+ * or read() has been called. It is currently used by FE_Q (and the other
+ * elements derived from FE_Q_Base) and FE_Nedelec; FESystem objects benefit
+ * through their base elements. Elements whose name does not identify them
+ * uniquely, such as FE_Q with support points that are reported as
+ * <code>QUnknownNodes</code>, are never cached.
+ *
+ * The file format is a binary format with a version number. The numbers are
+ * stored in the byte order of the machine that wrote the file, so files can
+ * only be shared between machines of the same architecture.
+ *
+ * All functions of this class are thread-safe.
+ *
+ * @ingroup febase
+ */
+class FEMatrixCache
+{
+public:
+  /**
+   * Constructor. This constructor is deleted because no instance of this
+   * class needs to be constructed (all members are static).
+   */
+  FEMatrixCache() = delete;
+
+  /**
+   * Let the finite element classes look up their matrices in the cache.
+   */
+  static void
+  enable();
+
+  /**
+   * Stop using the cache and remove all entries.
+   */
+  static void
+  disable();
+
+  /**
+   * Return whether the cache is used by the finite element classes.
+   */
+  static bool
+  is_enabled();
+
+  /**
+   * Return the number of finite elements stored in the cache.
+   */
+  static unsigned int
+  n_entries();
+
+  /**
+   * Return the number of calls to fill_interface_constraints() and
+   * fill_transfer_matrices() since the start of the program that copied
+   * matrices from the cache to a finite element.
+   */
+  static unsigned int
+  n_hits();
+
+  /**
+   * Store the interface constraints as well as the prolongation and
+   * restriction matrices of @p fe in the cache, replacing a previous entry
+   * with the same name. The lazily initialized matrices for isotropic
+   * refinement are computed through
+   * FiniteElement::isotropic_prolongation_is_implemented() and
+   * FiniteElement::isotropic_restriction_is_implemented() before they are
+   * stored. This function does not enable the cache.
+   */
+  template <int dim, int spacedim>
+  static void
+  add(const FiniteElement<dim, spacedim> &fe);
+
+  /**
+   * Write all entries of the cache to the file @p filename. Only the process
+   * with rank zero in @p mpi_communicator writes the file.
+   */
+  static void
+  write(const std::string &filename,
+        const MPI_Comm &   mpi_communicator = MPI_COMM_SELF);
+
+  /**
+   * Read the entries stored in the file @p filename into the cache and enable
+   * the cache. Only the process with rank zero in @p mpi_communicator reads
+   * the file, and the content is sent to all other processes of the
+   * communicator. This function is a collective operation.
+   */
+  static void
+  read(const std::string &filename,
+       const MPI_Comm &   mpi_communicator = MPI_COMM_SELF);
+
+  /**
+   * If the cache is enabled and contains an entry for @p fe with non-empty
+   * interface constraints, copy them to @p fe and return @p true. This
+   * function is called by the constructors of finite element classes before
+   * they compute the interface constraints.
+   */
+  template <int dim, int spacedim>
+  static bool
+  fill_interface_constraints(FiniteElement<dim, spacedim> &fe);
+
+  /**
+   * If the cache is enabled and contains an entry for @p fe, copy all
+   * prolongation and restriction matrices of the entry that are not yet
+   * initialized in @p fe to @p fe and return whether any matrix was copied.
+   * This function is called by the finite element classes that initialize
+   * their transfer matrices upon first request, while they hold the lock that
+   * protects the matrices.
+   */
+  template <int dim, int spacedim>
+  static bool
+  fill_transfer_matrices(FiniteElement<dim, spacedim> &fe);
+
+  /**
+   * Return an estimate of the memory consumption of the cache in bytes.
+   */
+  static std::size_t
+  memory_consumption();
+
+  /**
+   * Exception
+   */
+  DeclException1(ExcInvalidCacheFile,
+                 std::string,
+                 << "The file <" << arg1
+                 << "> is not a finite element matrix cache written by this "
+                 << "version of FEMatrixCache.");
+};
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -313,6 +313,14 @@ private:
   void
   initialize_restriction();
 
+  /**
+   * Compute the interface constraints from the face embedding matrices.
+   * Called from the constructor unless the constraints can be taken from the
+   * FEMatrixCache.
+   */
+  void
+  compute_interface_constraints(const unsigned int order);
+
   /**
    * These are the factors multiplied to a function in the
    * #generalized_face_support_points when computing the integration.
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/derivative_form.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/point.h>
@@ -59,6 +60,54 @@ class FEValuesBase;
 
 namespace internal
 {
+  namespace MatrixFreeFunctions
+  {
+    template <typename Number>
+    struct ShapeInfo;
+  }
+
+  namespace FEValuesImplementation
+  {
+    /**
+     * The arrays used by FEValuesBase when evaluating a finite element field
+     * with sum factorization, see FEValuesBase::tensor_product_shape_info.
+     * They are sized once when the FEValues object is initialized and kept
+     * across calls to avoid memory allocations on every cell.
+     */
+    template <int dim, int spacedim>
+    struct TensorProductScratchData
+    {
+      /**
+       * The values of the degrees of freedom of the present cell in the
+       * lexicographic numbering of the tensor product kernels.
+       */
+      AlignedVector<double> dof_values;
+
+      /**
+       * The values of the field in the quadrature points.
+       */
+      AlignedVector<double> values_quad;
+
+      /**
+       * The gradients of the field on the reference cell in the quadrature
+       * points, stored component by component.
+       */
+      AlignedVector<double> gradients_quad;
+
+      /**
+       * Temporary storage of the tensor product kernels.
+       */
+      AlignedVector<double> scratch;
+
+      /**
+       * The gradients on the reference cell handed to the mapping, and the
+       * gradients on the real cell the mapping transforms them into.
+       */
+      std::vector<Tensor<1, dim>>      reference_gradients;
+      std::vector<Tensor<1, spacedim>> real_gradients;
+    };
+  } // namespace FEValuesImplementation
+
   /**
    * A class whose specialization is used to define what type the curl of a
    * vector valued function corresponds to.
@@ -1985,7 +2034,10 @@ namespace internal
  * zero) components of the shape function using this set of functions.
  *
  * <li> get_function_values(), get_function_gradients(), etc.: Compute a
- * finite element function or its derivative in quadrature points.
+ * finite element function or its derivative in quadrature points. When the
+ * scalar versions evaluate the function with sum factorization, they work in
+ * arrays stored in the object, so an object must not be used by several
+ * threads at once, even if all threads only call these const functions.
  *
  * <li> reinit: initialize the FEValues object for a certain cell. This
  * function is not in the present class but only in the derived classes and
@@ -2295,6 +2347,13 @@ public:
    * IndexSet, then the function is represented as one that is either zero or
    * one, depending on whether a DoF index is in the set or not.
    *
+   * @note For scalar tensor-product elements such as FE_Q or FE_DGQ of
+   * degree three or higher on tensor-product quadrature formulas, this
+   * function evaluates the field with sum factorization and does not need
+   * the flag below, see tensor_product_shape_info. The evaluation uses
+   * scratch arrays of this object, so the function must not be called on the
+   * same object from several threads at once.
+   *
    * @dealiiRequiresUpdateFlags{update_values}
    */
   template <class InputVector>
@@ -2454,6 +2513,10 @@ public:
    * IndexSet, then the function is represented as one that is either zero or
    * one, depending on whether a DoF index is in the set or not.
    *
+   * @note As for get_function_values(), this function does not need the
+   * flag below when it evaluates the field with sum factorization, see
+   * tensor_product_shape_info.
+   *
    * @dealiiRequiresUpdateFlags{update_gradients}
    */
   template <class InputVector>
@@ -3363,6 +3426,38 @@ protected:
                                                                      spacedim>
     finite_element_output;
 
+  /**
+   * If the finite element is a scalar tensor-product element with support
+   * points, such as FE_Q or FE_DGQ, of degree three or higher and the
+   * quadrature formula of an FEValues object is the tensor product of the
+   * same one-dimensional formula in all coordinate directions, this object
+   * holds the values and derivatives of the one-dimensional shape functions
+   * in the one-dimensional quadrature points. It is then used by the scalar
+   * variants of get_function_values() and get_function_gradients() to
+   * evaluate a finite element field with sum factorization at a cost of
+   * $\mathcal O(p^{d+1})$ per cell rather than the $\mathcal O(p^{2d})$ of
+   * the summation over the shape function tables. Otherwise, the pointer is
+   * empty.
+   *
+   * Since these functions then do not read the shape function tables, they
+   * can be called without @p update_values and @p update_gradients among the
+   * update flags. Leaving out these flags skips the filling of the tables in
+   * each call to reinit(), whose size alone is $\mathcal O(p^{2d})$.
+   */
+  std::shared_ptr<
+    const dealii::internal::MatrixFreeFunctions::ShapeInfo<double>>
+    tensor_product_shape_info;
+
+  /**
+   * Scratch arrays for the evaluation with sum factorization. Like the
+   * other data computed on the present cell, they make it unsafe to call the
+   * functions evaluating finite element fields on the same object from
+   * several threads at once.
+   */
+  mutable dealii::internal::FEValuesImplementation::
+    TensorProductScratchData<dim, spacedim>
+      tensor_product_scratch_data;
+
 
   /**
    * Original update flags handed to the constructor of FEValues.
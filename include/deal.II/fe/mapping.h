@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/derivative_form.h>
 
 #include <deal.II/fe/fe_update_flags.h>
@@ -404,6 +405,38 @@ public:
     const typename Triangulation<dim, spacedim>::cell_iterator &cell,
     const Point<spacedim> &                                     p) const = 0;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the corresponding
+   * points on the unit cell, and store their coordinates in @p unit_points.
+   * This function computes the same points as calling
+   * transform_real_to_unit_cell() for each point, but derived classes can
+   * share the work that is the same for all points, such as the computation
+   * of the support points of the mapping on the cell, and evaluate several
+   * points at once. This makes it the preferred function when many points
+   * need to be located in the same cell, as is the case for particles or for
+   * the evaluation of a solution at arbitrary points.
+   *
+   * Rather than throwing an exception of type Mapping::ExcTransformationFailed
+   * when the inverse mapping can not be computed for one of the points, this
+   * function sets the first coordinate of the respective entry in
+   * @p unit_points to <code>std::numeric_limits<double>::infinity()</code>
+   * and continues with the other points. This can be checked for with
+   * <code>unit_points[i][0] == std::numeric_limits<double>::infinity()</code>.
+   *
+   * The default implementation calls transform_real_to_unit_cell() for each
+   * point.
+   *
+   * @param cell Iterator to the cell that will be used to define the mapping.
+   * @param real_points Locations of points on the given cell.
+   * @param unit_points The reference cell locations of the points. The size
+   * of this array must be the same as the size of @p real_points.
+   */
+  virtual void
+  transform_points_real_to_unit_cell(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+    const ArrayView<const Point<spacedim>> &                    real_points,
+    const ArrayView<Point<dim>> &unit_points) const;
+
   /**
    * Transform the point @p p on the real @p cell to the corresponding point
    * on the unit cell, and then projects it to a dim-1  point on the face with
@@ -89,6 +89,17 @@ public:
     const typename Triangulation<dim, spacedim>::cell_iterator &cell,
     const Point<spacedim> &p) const override;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the unit cell, see
+   * Mapping::transform_points_real_to_unit_cell(). The extent of the cell is
+   * computed only once, and the transformation never fails.
+   */
+  virtual void
+  transform_points_real_to_unit_cell(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+    const ArrayView<const Point<spacedim>> &                    real_points,
+    const ArrayView<Point<dim>> &unit_points) const override;
+
   /**
    * @}
    */
@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mapping_q_cache_h
+#define dealii_mapping_q_cache_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/tria.h>
+
+#include <boost/signals2/connection.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup mapping */
+/*@{*/
+
+
+/**
+ * This class implements a caching strategy for objects of the MappingQGeneric
+ * family in terms of the MappingQGeneric::compute_mapping_support_points()
+ * function, which is used in all operations of MappingQGeneric. The
+ * information of the mapping is pre-computed by the
+ * MappingQCache::initialize() function for all cells of a triangulation,
+ * using several threads, and stored in a flat array per level of the
+ * triangulation.
+ *
+ * The use of this class is most obvious when the evaluation of the mapping
+ * is expensive, e.g., when a high polynomial degree is combined with a
+ * Manifold such as the TransfiniteInterpolationManifold or the
+ * SphericalManifold whose get_new_points() functions involve Newton
+ * iterations. In that case, MappingQGeneric spends most of the time of
+ * FEValues::reinit() in the queries to the manifold, whereas this class
+ * merely copies the stored points. The cached points can also describe a
+ * deformed configuration similar to MappingQEulerian, see the initialize()
+ * function taking a displacement vector.
+ *
+ * Apart from the origin of the support points, this class behaves exactly
+ * like MappingQGeneric and can be used with FEValues, FEFaceValues,
+ * FESubfaceValues, and MatrixFree.
+ *
+ * The cache is cleared when the triangulation passed to initialize() changes,
+ * and initialize() must be called again before the mapping can be used on
+ * the new mesh. For parallel::distributed::Triangulation objects, the support
+ * points are not computed on artificial active cells.
+ */
+template <int dim, int spacedim = dim>
+class MappingQCache : public MappingQGeneric<dim, spacedim>
+{
+public:
+  /**
+   * Constructor. @p polynomial_degree denotes the polynomial degree of the
+   * polynomials that are used to map cells from the reference to the real
+   * cell.
+   */
+  explicit MappingQCache(const unsigned int polynomial_degree);
+
+  /**
+   * Copy constructor. The new object shares the cached support points with
+   * @p mapping, as well as the connection to the triangulation that clears
+   * them when the triangulation changes. The connection is kept alive as
+   * long as any of the objects sharing the cache exists.
+   */
+  MappingQCache(const MappingQCache<dim, spacedim> &mapping);
+
+  /**
+   * Destructor.
+   */
+  ~MappingQCache() override;
+
+  /**
+   * clone() functionality. For documentation, see Mapping::clone().
+   */
+  virtual std::unique_ptr<Mapping<dim, spacedim>>
+  clone() const override;
+
+  /**
+   * Return @p false because the preservation of vertex locations depends on
+   * the mapping handed to the initialize() function.
+   */
+  virtual bool
+  preserves_vertex_locations() const override;
+
+  /**
+   * Return the vertices of the cell as stored in the cache, which differ
+   * from the vertices of the triangulation when the cache describes a
+   * deformed configuration.
+   */
+  virtual std::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+  get_vertices(const typename Triangulation<dim, spacedim>::cell_iterator
+                 &cell) const override;
+
+  /**
+   * Initialize the data cache by computing the mapping support points for all
+   * cells (on all levels) of the given triangulation with the given @p
+   * mapping, which must be of the same polynomial degree as the present
+   * object.
+   */
+  void
+  initialize(const Triangulation<dim, spacedim> &  triangulation,
+             const MappingQGeneric<dim, spacedim> &mapping);
+
+  /**
+   * Initialize the data cache by letting the function given as an argument
+   * provide the mapping support points for all cells (on all levels) of the
+   * given triangulation. The function must return a vector of
+   * <code>Utilities::fixed_power<dim>(this->get_degree()+1)</code> points,
+   * ordered in the same way as the points returned by
+   * MappingQGeneric::compute_mapping_support_points(). The function is called
+   * on several threads concurrently.
+   */
+  void
+  initialize(const Triangulation<dim, spacedim> &triangulation,
+             const std::function<std::vector<Point<spacedim>>(
+               const typename Triangulation<dim, spacedim>::cell_iterator &)>
+               &compute_points_on_cell);
+
+  /**
+   * Initialize the data cache for a deformed configuration, similar to
+   * MappingQEulerian: The support points of @p mapping on each active cell
+   * are shifted by the first @p spacedim components of the finite element
+   * field described by @p dof_handler and @p vector. The vector must contain
+   * the values of all locally relevant degrees of freedom, i.e., parallel
+   * vectors need to have their ghost values updated. Cells that are not
+   * active are given the support points of @p mapping without displacement.
+   */
+  template <typename VectorType>
+  void
+  initialize(const MappingQGeneric<dim, spacedim> &mapping,
+             const DoFHandler<dim, spacedim> &     dof_handler,
+             const VectorType &                    vector);
+
+  /**
+   * Return the memory consumption (in bytes) of the cache.
+   */
+  virtual std::size_t
+  memory_consumption() const;
+
+protected:
+  /**
+   * This is the main function overridden from the base class
+   * MappingQGeneric: It returns the support points stored in the cache.
+   */
+  virtual std::vector<Point<spacedim>>
+  compute_mapping_support_points(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell)
+    const override;
+
+private:
+  /**
+   * The number of support points per cell.
+   */
+  const unsigned int n_points_per_cell;
+
+  /**
+   * The cached support points. The points of the cell with index @p i on
+   * level @p l are stored in <code>(*support_point_cache)[l]</code> starting
+   * at position <code>i*n_points_per_cell</code>. The cache is shared
+   * between copies of this object.
+   */
+  std::shared_ptr<std::vector<std::vector<Point<spacedim>>>>
+    support_point_cache;
+
+  /**
+   * The connection to Triangulation::Signals::any_change that clears the
+   * cache when the triangulation changes. Like the cache, the connection is
+   * shared between copies of this object, and it is disconnected when the
+   * last of them is destroyed.
+   */
+  std::shared_ptr<boost::signals2::scoped_connection> clear_signal;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -39,6 +39,9 @@ DEAL_II_NAMESPACE_OPEN
 template <int, int>
 class MappingQ;
 
+template <int, int>
+class MappingQCache;
+
 
 /*!@addtogroup mapping */
 /*@{*/
@@ -180,6 +183,21 @@ public:
     const typename Triangulation<dim, spacedim>::cell_iterator &cell,
     const Point<spacedim> &p) const override;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the unit cell, see
+   * Mapping::transform_points_real_to_unit_cell(). For dim==spacedim, this
+   * function computes the support points of the mapping on @p cell only once
+   * and runs the Newton iteration of transform_real_to_unit_cell() for as
+   * many points at once as there are lanes in VectorizedArray<double>,
+   * evaluating the mapping by sum factorization. For dim<spacedim, the points
+   * are mapped one at a time.
+   */
+  virtual void
+  transform_points_real_to_unit_cell(
+    const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+    const ArrayView<const Point<spacedim>> &                    real_points,
+    const ArrayView<Point<dim>> &unit_points) const override;
+
   /**
    * @}
    */
@@ -649,6 +667,13 @@ protected:
    */
   Table<2, double> support_point_weights_cell;
 
+  /**
+   * The numbering of the mapping support points of a cell, as returned by
+   * compute_mapping_support_points(), in the lexicographic order used by
+   * transform_points_real_to_unit_cell().
+   */
+  const std::vector<unsigned int> renumber_lexicographic_to_hierarchic;
+
   /**
    * Return the locations of support points for the mapping. For example, for
    * $Q_1$ mappings these are the vertices, and for higher order polynomial
@@ -735,6 +760,13 @@ protected:
    */
   template <int, int>
   friend class MappingQ;
+
+  /**
+   * Make MappingQCache a friend since it needs to call the
+   * compute_mapping_support_points() function.
+   */
+  template <int, int>
+  friend class MappingQCache;
 };
 
 
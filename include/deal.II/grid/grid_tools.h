@@ -750,6 +750,99 @@ namespace GridTools
       &cell_hint =
         typename Triangulation<dim, spacedim>::active_cell_iterator());
 
+  /**
+   * The location of a set of points in the active cells of a triangulation,
+   * as computed by GridTools::compute_point_locations_batched(). The points
+   * are grouped by the cell they lie in, in a compressed row format: the
+   * points located in <code>cells[c]</code> are the entries
+   * <code>cell_ptrs[c]</code> to <code>cell_ptrs[c+1]-1</code> of
+   * @p reference_points and @p point_indices. This is the layout needed to
+   * evaluate a finite element solution at the points cell by cell, e.g.
+   * with an FEValues object set up with the reference points of one cell as
+   * quadrature formula.
+   */
+  template <int dim, int spacedim>
+  struct PointLocations
+  {
+    /**
+     * The active cells that contain at least one point, sorted by their
+     * active cell index.
+     */
+    std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>
+      cells;
+
+    /**
+     * The start of the points of each cell in @p reference_points and
+     * @p point_indices. This vector has one more entry than @p cells.
+     */
+    std::vector<unsigned int> cell_ptrs;
+
+    /**
+     * The coordinates of the points on the reference cell of the cell they
+     * lie in.
+     */
+    std::vector<Point<dim>> reference_points;
+
+    /**
+     * The position of each point in the vector of points passed to
+     * GridTools::compute_point_locations_batched(). Within each cell, the
+     * indices are sorted.
+     */
+    std::vector<unsigned int> point_indices;
+
+    /**
+     * The sorted indices of the points that were not found in any active
+     * cell, e.g. because they lie outside the domain.
+     */
+    std::vector<unsigned int> missing_points;
+  };
+
+  /**
+   * Find the active cells around all points in @p points at once and
+   * return their locations grouped by cell. This function computes the same
+   * information as compute_point_locations(), but is designed for large
+   * numbers of points, for which it is considerably faster:
+   * - Rather than walking from cell to cell through the vertex-to-cell map
+   *   for each point, the candidate cells are taken from the R-tree of the
+   *   cell bounding boxes returned by Cache::get_cell_bounding_boxes_rtree().
+   * - The points are sorted along a Morton (Z-order) space-filling curve and
+   *   processed in chunks of nearby points, which share a single R-tree
+   *   query and the set of candidate cells.
+   * - For each candidate cell, all points of a chunk that lie inside the
+   *   bounding box of the cell are mapped to the reference cell with a single
+   *   call to Mapping::transform_points_real_to_unit_cell().
+   * - The chunks are processed in parallel on multiple threads.
+   *
+   * A point is assigned to the candidate cell with the smallest active cell
+   * index whose reference coordinates are inside the reference cell up to
+   * @p tolerance, so that points on the faces between cells are located
+   * uniquely and independently of the order of the points. Points that are
+   * not found are listed in PointLocations::missing_points rather than
+   * causing an exception.
+   *
+   * @note The candidate cells are identified by the bounding boxes of their
+   * vertices. Points that lie in the curved part of a cell outside this box,
+   * for high order mappings, are not found in that cell.
+   *
+   * @param[in] cache The triangulation's GridTools::Cache, which also
+   * provides the mapping.
+   * @param[in] points The points to locate.
+   * @param[in] tolerance The tolerance in reference coordinates for a point
+   * to be considered inside a cell.
+   * @param[in] predicate If given, only the cells for which this function
+   * returns @p true are considered, e.g. the locally owned cells of a
+   * parallel triangulation.
+   */
+  template <int dim, int spacedim>
+  PointLocations<dim, spacedim>
+  compute_point_locations_batched(
+    const Cache<dim, spacedim> &        cache,
+    const std::vector<Point<spacedim>> &points,
+    const double                        tolerance = 1e-10,
+    const std::function<bool(
+      const typename Triangulation<dim, spacedim>::active_cell_iterator &)>
+      &predicate = {});
+
   /**
    * Given a @p cache and a list of
    * @p local_points for each process, find the points lying on the locally
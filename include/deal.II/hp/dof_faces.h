@@ -21,6 +21,8 @@
 
 #include <deal.II/hp/fe_collection.h>
 
+#include <boost/serialization/version.hpp>
+
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
@@ -40,23 +42,6 @@ namespace internal
      * more information, in particular on the layout of the class hierarchy, and
      * the use of file names).
      *
-     * <h4>Offset computations</h4>
-     *
-     * For hp methods, not all cells may use the same finite element, and it
-     * is consequently more complicated to determine where the DoF indices for
-     * a given line, quad, or hex are stored. As described in the
-     * documentation of the internal::DoFHandlerImplementation::DoFLevel class,
-     * we can compute the location of the first line DoF, for example, by
-     * calculating the offset as <code>line_index *
-     * dof_handler.get_fe().dofs_per_line</code>. This of course doesn't work
-     * any more if different lines may have different numbers of degrees of
-     * freedom associated with them. Consequently, rather than using this
-     * simple multiplication, the dofs array has an associated array
-     * dof_offsets. The data corresponding to a line then starts at index
-     * <code>line_dof_offsets[line_index]</code> within the
-     * <code>line_dofs</code> array.
-     *
-     *
      * <h4>Multiple data sets per object</h4>
      *
      * If two adjacent cells use different finite elements, then the face that
@@ -65,27 +50,38 @@ namespace internal
      * indices, it is easy to see that edges and vertices can have as many
      * sets of DoF indices associated with them as there are adjacent cells.
      *
-     * Consequently, for objects that have a lower dimensionality than cells,
-     * we have to store a map from the finite element index to the set of DoF
-     * indices associated. Since real sets are typically very inefficient to
-     * store, and since most of the time we expect the number of individual
-     * keys to be small (frequently, adjacent cells will have the same finite
-     * element, and only a single entry will exist in the map), what we do is
-     * instead to store a linked list. In this format, the first entry
-     * starting at position
-     * <code>lines.dofs[lines.dof_offsets[line_index]]</code> will denote the
-     * finite element index of the set of DoF indices following; after this
-     * set, we will store the finite element index of the second set followed
-     * by the corresponding DoF indices; and so on. Finally, when all finite
-     * element indices adjacent to this object have been covered, we write a
-     * -1 to indicate the end of the list.
+     * <h4>Storage format</h4>
+     *
+     * For hp methods, not all cells may use the same finite element, and it
+     * is consequently more complicated to determine where the DoF indices for
+     * a given line, quad, or hex are stored. We therefore use a two-level
+     * layout that is analogous to how we store data in compressed row storage
+     * for sparse matrices:
+     *
+     * - The finite element indices that are active on the object with index
+     *   <code>obj_index</code> are stored in
+     *   <code>active_fe_indices[fe_offsets[obj_index]]</code> up to (but not
+     *   including) <code>active_fe_indices[fe_offsets[obj_index+1]]</code>,
+     *   sorted by their value. An object that is not adjacent to any active
+     *   cell has an empty range.
+     * - For each entry <code>s</code> of the @p active_fe_indices array, the
+     *   DoF indices for the corresponding finite element start at
+     *   <code>dofs[dof_offsets[s]]</code>.
+     *
+     * Consequently, the number of finite elements active on an object, and
+     * the n-th of them, are available in constant time. Finding the DoF
+     * indices for a given finite element index only requires a search among
+     * the (few) finite element indices active on this object, without
+     * having to query the finite elements for their number of degrees of
+     * freedom, and the finite element indices are stored in a type much
+     * smaller than the one used for the DoF indices.
      *
      * Access to this kind of data, as well as the distinction between cells
      * and objects of lower dimensionality are encoded in the accessor
      * functions, DoFObjects::set_dof_index() and DoFLevel::get_dof_index().
-     * They are able to traverse this list and pick out or set a DoF index
-     * given the finite element index and its location within the set of DoFs
-     * corresponding to this finite element.
+     * They are able to pick out or set a DoF index given the finite element
+     * index and its location within the set of DoFs corresponding to this
+     * finite element.
      *
      *
      * @ingroup hp
@@ -96,11 +92,28 @@ namespace internal
     {
     public:
       /**
-       * Store the start index for the degrees of freedom of each object in
-       * the @p dofs array.
-       *
-       * The type we store is then obviously the type the @p dofs array uses
-       * for indexing.
+       * The type in which we store the active FE index.
+       */
+      using active_fe_index_type = unsigned short int;
+
+      /**
+       * For each object, the position of the first of its active finite
+       * element indices in the @p active_fe_indices array. This array has
+       * one more entry than there are objects, the last entry being the
+       * size of the @p active_fe_indices array.
+       */
+      std::vector<unsigned int> fe_offsets;
+
+      /**
+       * The finite element indices that are active on the objects, stored
+       * consecutively for all objects. See the general documentation of this
+       * class for more information.
+       */
+      std::vector<active_fe_index_type> active_fe_indices;
+
+      /**
+       * For each entry in the @p active_fe_indices array, the start index
+       * of the corresponding degrees of freedom in the @p dofs array.
        */
       std::vector<unsigned int> dof_offsets;
 
@@ -110,6 +123,15 @@ namespace internal
        */
       std::vector<types::global_dof_index> dofs;
 
+      /**
+       * Set up the @p dof_offsets array from the @p fe_offsets and
+       * @p active_fe_indices arrays, and allocate the @p dofs array with
+       * all DoF indices set to numbers::invalid_dof_index.
+       */
+      template <int dim, int spacedim>
+      void
+      allocate_dofs(const dealii::hp::DoFHandler<dim, spacedim> &dof_handler);
+
       /**
        * Set the global index of the @p local_index-th degree of freedom
        * located on the object with number @p obj_index to the value given by
@@ -199,11 +221,27 @@ namespace internal
 
       /**
        * Read or write the data of this object to or from a stream for the
-       * purpose of serialization
+       * purpose of serialization.
+       *
+       * The current format has version 1. Archives of version 0 stored the
+       * active finite element indices of each object inline with its degrees
+       * of freedom; they can not be interpreted without the finite elements,
+       * and reading them throws an exception.
        */
       template <class Archive>
       void
       serialize(Archive &ar, const unsigned int version);
+
+    private:
+      /**
+       * Return the position of the given @p fe_index in the
+       * @p active_fe_indices array among the entries that belong to the
+       * object @p obj_index, or numbers::invalid_unsigned_int if this finite
+       * element is not active on the object.
+       */
+      unsigned int
+      fe_set_index(const unsigned int obj_index,
+                   const unsigned int fe_index) const;
     };
 
 
@@ -358,6 +396,48 @@ namespace internal
       ar &lines &quads;
     }
 
+
+
+    template <int structdim>
+    inline unsigned int
+    DoFIndicesOnFacesOrEdges<structdim>::fe_set_index(
+      const unsigned int obj_index,
+      const unsigned int fe_index) const
+    {
+      for (unsigned int s = fe_offsets[obj_index];
+           s < fe_offsets[obj_index + 1];
+           ++s)
+        if (active_fe_indices[s] == fe_index)
+          return s;
+      return numbers::invalid_unsigned_int;
+    }
+
+
+
+    template <int structdim>
+    template <int dim, int spacedim>
+    inline void
+    DoFIndicesOnFacesOrEdges<structdim>::allocate_dofs(
+      const dealii::hp::DoFHandler<dim, spacedim> &dof_handler)
+    {
+      Assert(fe_offsets.size() > 0, ExcInternalError());
+      AssertDimension(fe_offsets.back(), active_fe_indices.size());
+
+      dof_offsets.resize(active_fe_indices.size());
+      unsigned int n_dofs = 0;
+      for (unsigned int s = 0; s < active_fe_indices.size(); ++s)
+        {
+          dof_offsets[s] = n_dofs;
+          n_dofs += dof_handler.get_fe(active_fe_indices[s])
+                      .template n_dofs_per_object<structdim>();
+        }
+
+      dofs.clear();
+      dofs.resize(n_dofs, numbers::invalid_dof_index);
+    }
+
+
+
     template <int structdim>
     template <int dim, int spacedim>
     inline types::global_dof_index
@@ -368,6 +448,7 @@ namespace internal
       const unsigned int                           local_index,
       const unsigned int /*obj_level*/) const
     {
+      (void)dof_handler;
       Assert((fe_index !=
               dealii::hp::DoFHandler<dim, spacedim>::default_fe_index),
              ExcMessage("You need to specify a FE index when working "
@@ -382,13 +463,13 @@ namespace internal
                            0,
                            dof_handler.get_fe(fe_index)
                              .template n_dofs_per_object<structdim>()));
-      Assert(obj_index < dof_offsets.size(),
-             ExcIndexRange(obj_index, 0, dof_offsets.size()));
+      Assert(obj_index + 1 < fe_offsets.size(),
+             ExcIndexRange(obj_index, 0, fe_offsets.size() - 1));
 
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert(dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert(fe_offsets[obj_index] != fe_offsets[obj_index + 1],
              ExcMessage("You are trying to access degree of freedom "
                         "information for an object on which no such "
                         "information is available"));
@@ -396,24 +477,16 @@ namespace internal
       Assert(structdim < dim,
              ExcMessage("This object can not be used for cells."));
 
-      // there may be multiple finite elements associated with
-      // this object. hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const types::global_dof_index  starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer         = &dofs[starting_offset];
-      while (true)
-        {
-          Assert(*pointer != numbers::invalid_dof_index, ExcInternalError());
-          if (*pointer == fe_index)
-            return *(pointer + 1 + local_index);
-          else
-            pointer += static_cast<types::global_dof_index>(
-              dof_handler.get_fe(*pointer)
-                .template n_dofs_per_object<structdim>() +
-              1);
-        }
+      // there may be multiple finite elements associated with this object.
+      // find the one with the correct fe_index, and then poke into that
+      // part. trigger an exception if we can't find a set for this
+      // particular fe_index
+      const unsigned int fe_set = fe_set_index(obj_index, fe_index);
+      Assert(fe_set != numbers::invalid_unsigned_int,
+             ExcMessage("The given finite element index is not active on "
+                        "this object."));
+
+      return dofs[dof_offsets[fe_set] + local_index];
     }
 
 
@@ -429,6 +502,7 @@ namespace internal
       const types::global_dof_index                global_index,
       const unsigned int /*obj_level*/)
     {
+      (void)dof_handler;
       Assert((fe_index !=
               dealii::hp::DoFHandler<dim, spacedim>::default_fe_index),
              ExcMessage("You need to specify a FE index when working "
@@ -443,13 +517,13 @@ namespace internal
                            0,
                            dof_handler.get_fe(fe_index)
                              .template n_dofs_per_object<structdim>()));
-      Assert(obj_index < dof_offsets.size(),
-             ExcIndexRange(obj_index, 0, dof_offsets.size()));
+      Assert(obj_index + 1 < fe_offsets.size(),
+             ExcIndexRange(obj_index, 0, fe_offsets.size() - 1));
 
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert(dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert(fe_offsets[obj_index] != fe_offsets[obj_index + 1],
              ExcMessage("You are trying to access degree of freedom "
                         "information for an object on which no such "
                         "information is available"));
@@ -457,26 +531,16 @@ namespace internal
       Assert(structdim < dim,
              ExcMessage("This object can not be used for cells."));
 
-      // there may be multiple finite elements associated with
-      // this object.  hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const types::global_dof_index starting_offset = dof_offsets[obj_index];
-      types::global_dof_index *     pointer         = &dofs[starting_offset];
-      while (true)
-        {
-          Assert(*pointer != numbers::invalid_dof_index, ExcInternalError());
-          if (*pointer == fe_index)
-            {
-              *(pointer + 1 + local_index) = global_index;
-              return;
-            }
-          else
-            pointer += dof_handler.get_fe(*pointer)
-                         .template n_dofs_per_object<structdim>() +
-                       1;
-        }
+      // there may be multiple finite elements associated with this object.
+      // find the one with the correct fe_index, and then poke into that
+      // part. trigger an exception if we can't find a set for this
+      // particular fe_index
+      const unsigned int fe_set = fe_set_index(obj_index, fe_index);
+      Assert(fe_set != numbers::invalid_unsigned_int,
+             ExcMessage("The given finite element index is not active on "
+                        "this object."));
+
+      dofs[dof_offsets[fe_set] + local_index] = global_index;
     }
 
 
@@ -485,42 +549,17 @@ namespace internal
     template <int dim, int spacedim>
     inline unsigned int
     DoFIndicesOnFacesOrEdges<structdim>::n_active_fe_indices(
-      const dealii::hp::DoFHandler<dim, spacedim> &dof_handler,
-      const unsigned int                           obj_index) const
+      const dealii::hp::DoFHandler<dim, spacedim> &,
+      const unsigned int obj_index) const
     {
-      Assert(obj_index < dof_offsets.size(),
-             ExcIndexRange(obj_index, 0, dof_offsets.size()));
-
-      // make sure we are on an
-      // object for which DoFs have
-      // been allocated at all
-      if (dof_offsets[obj_index] == numbers::invalid_unsigned_int)
-        return 0;
+      Assert(obj_index + 1 < fe_offsets.size(),
+             ExcIndexRange(obj_index, 0, fe_offsets.size() - 1));
 
       Assert(structdim < dim,
              ExcMessage("This object can not be used for cells."));
 
-      // there may be multiple finite elements associated with this
-      // object. hop along the list of index sets until we find the
-      // one with the correct fe_index, and then poke into that
-      // part. trigger an exception if we can't find a set for this
-      // particular fe_index
-      const unsigned int             starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer         = &dofs[starting_offset];
-      unsigned int                   counter         = 0;
-      while (true)
-        {
-          if (*pointer == numbers::invalid_dof_index)
-            // end of list reached
-            return counter;
-          else
-            {
-              ++counter;
-              pointer += dof_handler.get_fe(*pointer)
-                           .template n_dofs_per_object<structdim>() +
-                         1;
-            }
-        }
+      // objects on which no DoFs have been allocated have an empty range
+      return fe_offsets[obj_index + 1] - fe_offsets[obj_index];
     }
 
 
@@ -534,13 +573,14 @@ namespace internal
       const unsigned int obj_index,
       const unsigned int n) const
     {
-      Assert(obj_index < dof_offsets.size(),
-             ExcIndexRange(obj_index, 0, dof_offsets.size()));
+      (void)dof_handler;
+      Assert(obj_index + 1 < fe_offsets.size(),
+             ExcIndexRange(obj_index, 0, fe_offsets.size() - 1));
 
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert(dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert(fe_offsets[obj_index] != fe_offsets[obj_index + 1],
              ExcMessage("You are trying to access degree of freedom "
                         "information for an object on which no such "
                         "information is available"));
@@ -551,31 +591,12 @@ namespace internal
       Assert(n < n_active_fe_indices(dof_handler, obj_index),
              ExcIndexRange(n, 0, n_active_fe_indices(dof_handler, obj_index)));
 
-      // there may be multiple finite elements associated with
-      // this object. hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const unsigned int             starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer         = &dofs[starting_offset];
-      unsigned int                   counter         = 0;
-      while (true)
-        {
-          Assert(*pointer != numbers::invalid_dof_index, ExcInternalError());
-
-          const unsigned int fe_index = *pointer;
-
-          Assert(fe_index < dof_handler.get_fe_collection().size(),
-                 ExcInternalError());
-
-          if (counter == n)
-            return fe_index;
+      const unsigned int fe_index =
+        active_fe_indices[fe_offsets[obj_index] + n];
+      Assert(fe_index < dof_handler.get_fe_collection().size(),
+             ExcInternalError());
 
-          ++counter;
-          pointer += dof_handler.get_fe(fe_index)
-                       .template n_dofs_per_object<structdim>() +
-                     1;
-        }
+      return fe_index;
     }
 
 
@@ -589,10 +610,11 @@ namespace internal
       const unsigned int                           fe_index,
       const unsigned int /*obj_level*/) const
     {
-      Assert(obj_index < dof_offsets.size(),
+      (void)dof_handler;
+      Assert(obj_index + 1 < fe_offsets.size(),
              ExcIndexRange(obj_index,
                            0,
-                           static_cast<unsigned int>(dof_offsets.size())));
+                           static_cast<unsigned int>(fe_offsets.size() - 1)));
       Assert((fe_index !=
               dealii::hp::DoFHandler<dim, spacedim>::default_fe_index),
              ExcMessage("You need to specify a FE index when working "
@@ -605,7 +627,7 @@ namespace internal
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert(dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert(fe_offsets[obj_index] != fe_offsets[obj_index + 1],
              ExcMessage("You are trying to access degree of freedom "
                         "information for an object on which no such "
                         "information is available"));
@@ -613,36 +635,28 @@ namespace internal
       Assert(structdim < dim,
              ExcMessage("This object can not be used for cells."));
 
-      // there may be multiple finite elements associated with
-      // this object. hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const types::global_dof_index  starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer         = &dofs[starting_offset];
-      while (true)
-        {
-          if (*pointer == numbers::invalid_dof_index)
-            // end of list reached
-            return false;
-          else if (*pointer == fe_index)
-            return true;
-          else
-            pointer += static_cast<types::global_dof_index>(
-              dof_handler.get_fe(*pointer)
-                .template n_dofs_per_object<structdim>() +
-              1);
-        }
+      return (fe_set_index(obj_index, fe_index) !=
+              numbers::invalid_unsigned_int);
     }
 
+
     template <int structdim>
     template <class Archive>
     void
     DoFIndicesOnFacesOrEdges<structdim>::serialize(Archive &ar,
-                                                   const unsigned int)
+                                                   const unsigned int version)
     {
-      ar &dofs;
+      AssertThrow(version >= 1,
+                  ExcMessage(
+                    "The archive stores the degrees of freedom of an "
+                    "hp::DoFHandler on faces or edges in the format of "
+                    "earlier versions of deal.II, which can not be read "
+                    "anymore."));
+
+      ar &fe_offsets;
+      ar &active_fe_indices;
       ar &dof_offsets;
+      ar &dofs;
     }
 
 
@@ -652,4 +666,21 @@ namespace internal
 
 DEAL_II_NAMESPACE_CLOSE
 
+namespace boost
+{
+  namespace serialization
+  {
+    // the class version of DoFIndicesOnFacesOrEdges, stored in archives and
+    // passed to its serialize() function. version 1 is the format in which
+    // the active fe indices are stored separately from the dof indices
+    template <int structdim>
+    struct version<dealii::internal::hp::DoFIndicesOnFacesOrEdges<structdim>>
+    {
+      using type = boost::mpl::int_<1>;
+      using tag  = boost::mpl::integral_c_tag;
+      BOOST_STATIC_CONSTANT(int, value = type::value);
+    };
+  } // namespace serialization
+} // namespace boost
+
 #endif
@@ -0,0 +1,615 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_eigen_lobpcg_h
+#define dealii_eigen_lobpcg_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Locally optimal block preconditioned conjugate gradient method (LOBPCG)
+ * for the smallest eigenvalues of the symmetric generalized eigenvalue
+ * problem $Ax = \lambda Bx$ with a symmetric matrix $A$ and a symmetric
+ * positive definite matrix $B$, see A. V. Knyazev, Toward the optimal
+ * preconditioned eigensolver: Locally optimal block preconditioned conjugate
+ * gradient method, SIAM J. Sci. Comput. 23 (2001), pp. 517-541.
+ *
+ * The method improves a block of $m$ approximate eigenvectors $X$ in each
+ * iteration by a Rayleigh-Ritz step in the space spanned by $X$, the
+ * preconditioned residuals $W = P^{-1}(AX - BX\Theta)$, and the directions
+ * $P$ of the previous update. The Rayleigh-Ritz step solves a dense
+ * generalized eigenvalue problem of size at most $3m$ with
+ * LAPACKFullMatrix::compute_generalized_eigenvalues_symmetric(), and all
+ * operations between the blocks of vectors are done with the blocked
+ * operations of MultiVector, so the vector entries are read only once for
+ * all vectors of a block and distributed vectors need one reduction for all
+ * inner products of two blocks. To keep the Rayleigh-Ritz step stable, the
+ * blocks $W$ and $P$ are $B$-orthonormalized against $X$ and themselves, and
+ * directions that become linearly dependent are dropped.
+ *
+ * The matrices $A$ and $B$ and the preconditioner only need to provide a
+ * function <tt>vmult(VectorType &, const VectorType &)</tt>, so the method
+ * works with matrix-free operators, LinearOperator objects, and any of the
+ * preconditioners of the library, e.g., PreconditionChebyshev or multigrid.
+ * Since the method needs neither factorizations nor inner solves, it is
+ * particularly suited for large problems on distributed vectors, like
+ * LinearAlgebra::distributed::Vector. The approximate eigenvectors are
+ * applied to the matrices with
+ * internal::MultiVectorImplementation::vmult(), i.e., in one pass over the
+ * matrix for SparseMatrix.
+ *
+ * The number of eigenpairs to compute is given by the number of vectors of
+ * the MultiVector passed to solve(), which must contain linearly independent
+ * initial guesses. A few more vectors than eigenpairs wanted usually speed
+ * up the convergence of the last ones considerably.
+ *
+ * <h3>Convergence and soft locking</h3>
+ *
+ * The convergence of the eigenpair $(\theta_j, x_j)$ is measured by the
+ * $l_2$ norm of its residual $Ax_j - \theta_j Bx_j$, and the largest of these
+ * norms is passed to the SolverControl object in each iteration. With
+ * AdditionalData::soft_locking enabled (the default), pairs whose residual
+ * norm has dropped below the tolerance of the SolverControl object are
+ * locked softly: they do not contribute preconditioned residuals and
+ * directions to the basis any more, which saves the application of $A$, $B$,
+ * and the preconditioner to them, but they stay in the Rayleigh-Ritz step
+ * and thus keep improving as the other pairs converge.
+ *
+ * This class requires deal.II to be configured with LAPACK. The entries of
+ * the vectors must be real.
+ */
+template <typename VectorType = Vector<double>>
+class EigenLOBPCG : private Solver<VectorType>
+{
+public:
+  /**
+   * Declare type of container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Declare type of the vector entries.
+   */
+  using value_type = typename VectorType::value_type;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    explicit AdditionalData(const bool soft_locking = true)
+      : soft_locking(soft_locking)
+    {}
+
+    /**
+     * Exclude converged eigenpairs from the computation of new search
+     * directions, see the general documentation of this class.
+     */
+    bool soft_locking;
+  };
+
+  /**
+   * Constructor.
+   */
+  EigenLOBPCG(SolverControl &       cn,
+              const AdditionalData &data = AdditionalData());
+
+  /**
+   * Compute the smallest eigenvalues of the generalized eigenvalue problem
+   * $Ax = \lambda Bx$. On entry, @p eigenvectors contains the initial guesses
+   * and determines the number of eigenpairs computed. On exit, it contains
+   * the $B$-orthonormal approximate eigenvectors and @p eigenvalues the
+   * corresponding eigenvalues in ascending order.
+   */
+  template <typename MatrixType,
+            typename MassMatrixType,
+            typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        const MassMatrixType &    B,
+        const PreconditionerType &preconditioner,
+        std::vector<double> &     eigenvalues,
+        MultiVector<VectorType> & eigenvectors);
+
+  /**
+   * Compute the smallest eigenvalues of the standard eigenvalue problem
+   * $Ax = \lambda x$, i.e., the previous function with $B$ equal to the
+   * identity. The eigenvectors are orthonormal on exit. The blocks
+   * multiplied by $B$ are the blocks themselves in this case, which saves
+   * their storage and updates.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        const PreconditionerType &preconditioner,
+        std::vector<double> &     eigenvalues,
+        MultiVector<VectorType> & eigenvectors);
+
+  /**
+   * Return the number of applications of the matrix $A$ to a vector in the
+   * last call to solve(). This number is smaller than the number of
+   * iterations times the number of eigenpairs if pairs were locked.
+   */
+  unsigned int
+  n_matrix_vector_products() const;
+
+protected:
+  /**
+   * $B$-orthonormalize the vectors of @p Z, given $BZ$ in @p BZ and, if not
+   * null, $AZ$ in @p AZ, which are transformed in the same way. Vectors that
+   * are linearly dependent on the previous ones are dropped. Return the
+   * number of remaining vectors. For $B$ equal to the identity, @p BZ may be
+   * the same object as @p Z.
+   */
+  unsigned int
+  orthonormalize(MultiVector<VectorType> &Z,
+                 MultiVector<VectorType> &BZ,
+                 MultiVector<VectorType> *AZ);
+
+  /**
+   * Subtract from @p Z its $B$-orthogonal projection onto the
+   * $B$-orthonormal vectors @p V, given $BV$ in @p BV, and update @p AZ and
+   * @p BZ accordingly, if not null, using $AV$ in @p AV. For $B$ equal to
+   * the identity, @p BZ may point to @p Z.
+   */
+  void
+  orthogonalize_against(const MultiVector<VectorType> &V,
+                        const MultiVector<VectorType> &AV,
+                        const MultiVector<VectorType> &BV,
+                        MultiVector<VectorType> &      Z,
+                        MultiVector<VectorType> *      AZ,
+                        MultiVector<VectorType> *      BZ);
+
+  /**
+   * Solve the projected eigenvalue problem of the Rayleigh-Ritz step in the
+   * basis given by the blocks @p basis, with the matrices applied to the
+   * blocks given in @p A_basis and @p B_basis. Return the smallest
+   * @p n_eigenpairs eigenvalues in @p eigenvalues and the coefficients of
+   * the corresponding eigenvectors in the basis as columns of @p Y.
+   */
+  void
+  rayleigh_ritz(const std::vector<const MultiVector<VectorType> *> &basis,
+                const std::vector<const MultiVector<VectorType> *> &A_basis,
+                const std::vector<const MultiVector<VectorType> *> &B_basis,
+                const unsigned int      n_eigenpairs,
+                std::vector<double> &   eigenvalues,
+                FullMatrix<value_type> &Y) const;
+
+  /**
+   * Reference to the control object, whose tolerance is used for soft
+   * locking.
+   */
+  SolverControl &solver_control;
+
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The number of matrix-vector products with $A$ of the last solve.
+   */
+  unsigned int n_products;
+};
+
+/*@}*/
+/*---------------------------------------------------------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename VectorType>
+EigenLOBPCG<VectorType>::EigenLOBPCG(SolverControl &       cn,
+                                     const AdditionalData &data)
+  : Solver<VectorType>(cn)
+  , solver_control(cn)
+  , additional_data(data)
+  , n_products(0)
+{}
+
+
+
+template <typename VectorType>
+unsigned int
+EigenLOBPCG<VectorType>::n_matrix_vector_products() const
+{
+  return n_products;
+}
+
+
+
+template <typename VectorType>
+unsigned int
+EigenLOBPCG<VectorType>::orthonormalize(MultiVector<VectorType> &Z,
+                                        MultiVector<VectorType> &BZ,
+                                        MultiVector<VectorType> *AZ)
+{
+  const unsigned int n = Z.n_vectors();
+  if (n == 0)
+    return 0;
+
+  FullMatrix<value_type> gram;
+  Z.Tmmult(gram, BZ);
+
+  // Cholesky factorization gram = R^T R computed column by column, skipping
+  // the columns whose remaining part is lost in roundoff. The columns of
+  // the coefficient matrix C = R^{-1} are built up at the same time, such
+  // that Z C is B-orthonormal.
+  const double              drop_tolerance = 1e-10;
+  std::vector<unsigned int> kept;
+  FullMatrix<double>        R(n, n);
+  FullMatrix<value_type>    C(n, n);
+  for (unsigned int j = 0; j < n; ++j)
+    {
+      const double gram_jj = gram(j, j);
+      double       d       = gram_jj;
+      for (unsigned int k = 0; k < kept.size(); ++k)
+        {
+          double r = 0.5 * (gram(kept[k], j) + gram(j, kept[k]));
+          for (unsigned int l = 0; l < k; ++l)
+            r -= R(kept[l], kept[k]) * R(kept[l], j);
+          R(kept[k], j) = r / R(kept[k], kept[k]);
+          d -= R(kept[k], j) * R(kept[k], j);
+        }
+      if (!(d > drop_tolerance * gram_jj) || gram_jj <= 0.)
+        continue;
+
+      R(j, j)           = std::sqrt(d);
+      C(j, kept.size()) = 1. / R(j, j);
+      for (unsigned int k = 0; k < kept.size(); ++k)
+        for (unsigned int i = 0; i < n; ++i)
+          C(i, kept.size()) -= R(kept[k], j) / R(j, j) * C(i, k);
+      kept.push_back(j);
+    }
+
+  if (kept.empty())
+    {
+      Z.select_vectors(kept);
+      BZ.select_vectors(kept);
+      if (AZ != nullptr)
+        AZ->select_vectors(kept);
+      return 0;
+    }
+
+  FullMatrix<value_type> C_kept(n, kept.size());
+  C_kept.fill(C, 0, 0, 0, 0);
+
+  MultiVector<VectorType> tmp(kept.size(), Z[0]);
+  Z.mmult(tmp, C_kept);
+  Z.swap(tmp);
+  if (&BZ != &Z)
+    {
+      tmp.reinit(kept.size(), Z[0], true);
+      BZ.mmult(tmp, C_kept);
+      BZ.swap(tmp);
+    }
+  if (AZ != nullptr)
+    {
+      tmp.reinit(kept.size(), Z[0], true);
+      AZ->mmult(tmp, C_kept);
+      AZ->swap(tmp);
+    }
+
+  return kept.size();
+}
+
+
+
+template <typename VectorType>
+void
+EigenLOBPCG<VectorType>::orthogonalize_against(
+  const MultiVector<VectorType> &V,
+  const MultiVector<VectorType> &AV,
+  const MultiVector<VectorType> &BV,
+  MultiVector<VectorType> &      Z,
+  MultiVector<VectorType> *      AZ,
+  MultiVector<VectorType> *      BZ)
+{
+  if (V.n_vectors() == 0 || Z.n_vectors() == 0)
+    return;
+
+  FullMatrix<value_type> coefficients;
+  BV.Tmmult(coefficients, Z);
+  coefficients *= value_type(-1.);
+
+  V.mmult(Z, coefficients, true);
+  if (AZ != nullptr)
+    AV.mmult(*AZ, coefficients, true);
+  if (BZ != nullptr && BZ != &Z)
+    BV.mmult(*BZ, coefficients, true);
+}
+
+
+
+template <typename VectorType>
+void
+EigenLOBPCG<VectorType>::rayleigh_ritz(
+  const std::vector<const MultiVector<VectorType> *> &basis,
+  const std::vector<const MultiVector<VectorType> *> &A_basis,
+  const std::vector<const MultiVector<VectorType> *> &B_basis,
+  const unsigned int                                  n_eigenpairs,
+  std::vector<double> &                               eigenvalues,
+  FullMatrix<value_type> &                            Y) const
+{
+  std::vector<unsigned int> offsets(1, 0);
+  for (const MultiVector<VectorType> *block : basis)
+    offsets.push_back(offsets.back() + block->n_vectors());
+  const unsigned int n = offsets.back();
+  Assert(n >= n_eigenpairs, ExcInternalError());
+
+  // assemble the symmetric projected matrices from the upper blocks
+  LAPACKFullMatrix<double> projected_A(n, n), projected_B(n, n);
+  FullMatrix<value_type>   block_A, block_B;
+  for (unsigned int b = 0; b < basis.size(); ++b)
+    for (unsigned int c = b; c < basis.size(); ++c)
+      {
+        basis[b]->Tmmult(block_A, *A_basis[c]);
+        basis[b]->Tmmult(block_B, *B_basis[c]);
+        for (unsigned int i = 0; i < block_A.m(); ++i)
+          for (unsigned int j = 0; j < block_A.n(); ++j)
+            {
+              const unsigned int row = offsets[b] + i, col = offsets[c] + j;
+              projected_A(row, col) = block_A(i, j);
+              projected_B(row, col) = block_B(i, j);
+              projected_A(col, row) = block_A(i, j);
+              projected_B(col, row) = block_B(i, j);
+            }
+        if (b == c)
+          for (unsigned int i = 0; i < block_A.m(); ++i)
+            for (unsigned int j = 0; j < i; ++j)
+              {
+                const double a_ij = 0.5 * (block_A(i, j) + block_A(j, i));
+                const double b_ij = 0.5 * (block_B(i, j) + block_B(j, i));
+                projected_A(offsets[b] + i, offsets[b] + j) = a_ij;
+                projected_A(offsets[b] + j, offsets[b] + i) = a_ij;
+                projected_B(offsets[b] + i, offsets[b] + j) = b_ij;
+                projected_B(offsets[b] + j, offsets[b] + i) = b_ij;
+              }
+      }
+
+  std::vector<Vector<double>> ritz_vectors(n_eigenpairs);
+  projected_A.compute_generalized_eigenvalues_symmetric(projected_B,
+                                                        ritz_vectors);
+
+  eigenvalues.resize(n_eigenpairs);
+  Y.reinit(n, n_eigenpairs);
+  for (unsigned int j = 0; j < n_eigenpairs; ++j)
+    {
+      eigenvalues[j] = projected_A.eigenvalue(j).real();
+      for (unsigned int i = 0; i < n; ++i)
+        Y(i, j) = ritz_vectors[j](i);
+    }
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType,
+          typename MassMatrixType,
+          typename PreconditionerType>
+void
+EigenLOBPCG<VectorType>::solve(const MatrixType &        A,
+                               const MassMatrixType &    B,
+                               const PreconditionerType &preconditioner,
+                               std::vector<double> &     eigenvalues,
+                               MultiVector<VectorType> & X)
+{
+  using internal::MultiVectorImplementation::vmult;
+
+  const unsigned int m = X.n_vectors();
+  Assert(m > 0, ExcMessage("At least one initial vector must be given."));
+  Assert(3 * m <= X.size(),
+         ExcMessage("The block of vectors must be smaller than a third of "
+                    "the vector size."));
+
+  n_products = 0;
+
+  MultiVector<VectorType> AX, R, W, AW, P, AP, tmp;
+
+  // for the standard eigenvalue problem, the blocks multiplied by B are the
+  // blocks themselves and are neither stored nor updated separately
+  const bool B_is_identity =
+    std::is_same<MassMatrixType, PreconditionIdentity>::value;
+  MultiVector<VectorType>  BX_storage, BW_storage, BP_storage;
+  MultiVector<VectorType> &BX = B_is_identity ? X : BX_storage;
+  MultiVector<VectorType> &BW = B_is_identity ? W : BW_storage;
+  MultiVector<VectorType> &BP = B_is_identity ? P : BP_storage;
+
+  AX.reinit(X, true);
+
+  // B-orthonormalize the initial vectors twice for full accuracy and
+  // diagonalize them with a first Rayleigh-Ritz step
+  if (!B_is_identity)
+    {
+      BX.reinit(X, true);
+      vmult(B, BX, X);
+    }
+  for (unsigned int pass = 0; pass < 2; ++pass)
+    AssertThrow(orthonormalize(X, BX, nullptr) == m,
+                ExcMessage("The initial vectors must be linearly "
+                           "independent."));
+  vmult(A, AX, X);
+  n_products += m;
+
+  FullMatrix<value_type> Y;
+  rayleigh_ritz({&X}, {&AX}, {&BX}, m, eigenvalues, Y);
+  tmp.reinit(X, true);
+  X.mmult(tmp, Y);
+  X.swap(tmp);
+  AX.mmult(tmp, Y);
+  AX.swap(tmp);
+  if (!B_is_identity)
+    {
+      BX.mmult(tmp, Y);
+      BX.swap(tmp);
+    }
+
+  std::vector<typename MultiVector<VectorType>::real_type> residual_norms;
+  std::vector<unsigned int>                                active;
+  SolverControl::State conv = SolverControl::iterate;
+  for (unsigned int iteration = 0;; ++iteration)
+    {
+      // residuals and convergence check
+      R.reinit(X, true);
+      for (unsigned int j = 0; j < m; ++j)
+        {
+          R[j] = AX[j];
+          R[j].add(-eigenvalues[j], BX[j]);
+        }
+      R.l2_norms(residual_norms);
+
+      const double max_residual =
+        *std::max_element(residual_norms.begin(), residual_norms.end());
+      conv = this->iteration_status(iteration, max_residual, X[0]);
+      if (conv != SolverControl::iterate)
+        break;
+
+      active.clear();
+      for (unsigned int j = 0; j < m; ++j)
+        if (!additional_data.soft_locking ||
+            residual_norms[j] > solver_control.tolerance())
+          active.push_back(j);
+
+      // preconditioned residuals of the active pairs, B-orthonormal to X
+      R.select_vectors(active);
+      W.reinit(active.size(), X[0], true);
+      vmult(preconditioner, W, R);
+      orthogonalize_against(X, AX, BX, W, nullptr, nullptr);
+      if (!B_is_identity)
+        {
+          BW.reinit(W.n_vectors(), X[0], true);
+          vmult(B, BW, W);
+        }
+      for (unsigned int pass = 0; pass < 2; ++pass)
+        {
+          orthogonalize_against(X, AX, BX, W, nullptr, &BW);
+          orthonormalize(W, BW, nullptr);
+        }
+      AW.reinit(W.n_vectors(), X[0], true);
+      vmult(A, AW, W);
+      n_products += W.n_vectors();
+
+      // directions of the active pairs, B-orthonormal to X and W
+      if (iteration > 0)
+        {
+          P.select_vectors(active);
+          AP.select_vectors(active);
+          if (!B_is_identity)
+            BP.select_vectors(active);
+          for (unsigned int pass = 0; pass < 2; ++pass)
+            {
+              orthogonalize_against(X, AX, BX, P, &AP, &BP);
+              orthogonalize_against(W, AW, BW, P, &AP, &BP);
+              orthonormalize(P, BP, &AP);
+            }
+        }
+
+      // Rayleigh-Ritz step in the space spanned by X, W, and P. The blocks
+      // without vectors, like P in the first iteration, are left out
+      std::vector<const MultiVector<VectorType> *> basis(1, &X);
+      std::vector<const MultiVector<VectorType> *> A_basis(1, &AX);
+      std::vector<const MultiVector<VectorType> *> B_basis(1, &BX);
+      if (W.n_vectors() > 0)
+        {
+          basis.push_back(&W);
+          A_basis.push_back(&AW);
+          B_basis.push_back(&BW);
+        }
+      if (P.n_vectors() > 0)
+        {
+          basis.push_back(&P);
+          A_basis.push_back(&AP);
+          B_basis.push_back(&BP);
+        }
+      rayleigh_ritz(basis, A_basis, B_basis, m, eigenvalues, Y);
+
+      const unsigned int     n_w = W.n_vectors(), n_p = P.n_vectors();
+      FullMatrix<value_type> Y_X(m, m), Y_W(n_w, m), Y_P(n_p, m);
+      Y_X.fill(Y, 0, 0, 0, 0);
+      if (n_w > 0)
+        Y_W.fill(Y, 0, 0, m, 0);
+      if (n_p > 0)
+        Y_P.fill(Y, 0, 0, m + n_w, 0);
+
+      // the new directions P = W Y_W + P Y_P and the new approximations
+      // X = X Y_X + P, and the same for the blocks multiplied by A and B
+      const auto update = [&](MultiVector<VectorType> &      X_block,
+                              const MultiVector<VectorType> &W_block,
+                              MultiVector<VectorType> &      P_block) {
+        // the product with W overwrites tmp, so tmp only needs to be zeroed
+        // if W is empty
+        tmp.reinit(X, n_w > 0);
+        if (n_w > 0)
+          W_block.mmult(tmp, Y_W);
+        if (n_p > 0)
+          P_block.mmult(tmp, Y_P, true);
+        P_block.swap(tmp);
+        tmp.reinit(X, true);
+        X_block.mmult(tmp, Y_X);
+        for (unsigned int j = 0; j < m; ++j)
+          tmp[j] += P_block[j];
+        X_block.swap(tmp);
+      };
+      update(X, W, P);
+      update(AX, AW, AP);
+      if (!B_is_identity)
+        update(BX, BW, BP);
+    }
+
+  AssertThrow(conv == SolverControl::success,
+              SolverControl::NoConvergence(solver_control.last_step(),
+                                           solver_control.last_value()));
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+EigenLOBPCG<VectorType>::solve(const MatrixType &        A,
+                               const PreconditionerType &preconditioner,
+                               std::vector<double> &     eigenvalues,
+                               MultiVector<VectorType> & eigenvectors)
+{
+  solve(A, PreconditionIdentity(), preconditioner, eigenvalues, eigenvectors);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -22,14 +22,17 @@
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/numbers.h>
 #include <deal.II/base/partitioner.h>
+#include <deal.II/base/shared_memory_partitioner.h>
 #include <deal.II/base/thread_management.h>
 
 #include <deal.II/lac/vector_operation.h>
 #include <deal.II/lac/vector_space_vector.h>
 #include <deal.II/lac/vector_type_traits.h>
 
+#include <array>
 #include <iomanip>
 #include <memory>
+#include <type_traits>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -42,7 +45,28 @@ namespace LinearAlgebra
   {
     template <typename>
     class BlockVector;
-  }
+
+    template <typename Operation>
+    class VectorExpression;
+
+    namespace internal
+    {
+      namespace VectorExpressions
+      {
+        /**
+         * A type trait that is true if @p T is a VectorExpression.
+         */
+        template <typename T>
+        struct is_vector_expression : std::false_type
+        {};
+
+        template <typename Operation>
+        struct is_vector_expression<VectorExpression<Operation>>
+          : std::true_type
+        {};
+      } // namespace VectorExpressions
+    }   // namespace internal
+  }     // namespace distributed
 } // namespace LinearAlgebra
 
 namespace LinearAlgebra
@@ -360,6 +384,39 @@ namespace LinearAlgebra
       reinit(
         const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner);
 
+      /**
+       * Initialize the vector given to the parallel partitioning described in
+       * @p partitioner, allocating the locally owned and ghost entries in an
+       * MPI-3 shared memory window among the processes of @p comm_sm. The
+       * communicator @p comm_sm must contain processes of the communicator of
+       * @p partitioner that can share memory, typically the processes on the
+       * same compute node as obtained by
+       * <code>MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+       * MPI_INFO_NULL, &comm_sm)</code>.
+       *
+       * In update_ghost_values(), ghost entries owned by processes in @p
+       * comm_sm are then read directly from the memory of the owner, and in
+       * compress(), each owner directly reads the contributions from the
+       * ghost entries of the other processes in @p comm_sm. Only ghost
+       * entries owned by processes outside of @p comm_sm are exchanged by
+       * messages. Both operations synchronize the processes of @p comm_sm
+       * with barriers. Additional vectors with the same layout (and the same
+       * shared memory setup) can be created with the reinit() function taking
+       * a vector argument.
+       *
+       * The shared memory window is allocated and freed collectively. All
+       * processes of @p comm_sm must hence call any function that reinitializes
+       * the vector or destroys it at the same time. Only
+       * MemorySpace::Host is supported.
+       *
+       * Without MPI, this function is equivalent to the reinit() function
+       * without @p comm_sm argument.
+       */
+      void
+      reinit(
+        const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+        const MPI_Comm &                                          comm_sm);
+
       /**
        * Swap the contents of this vector and the other vector @p v. One could
        * do this operation with a temporary variable and copying over the data
@@ -833,6 +890,55 @@ namespace LinearAlgebra
       virtual Vector<Number, MemorySpace> &
       operator=(const Number s) override;
 
+      /**
+       * Evaluate the vector expression @p expression for all locally owned
+       * entries and store the result in this vector, in a single pass over
+       * all vectors involved. See the documentation of VectorExpression for
+       * how to build expressions.
+       *
+       * This function is only available for vectors stored on the host. It
+       * only takes part in overload resolution if @p Expression is a
+       * VectorExpression. Like assign_and_reduce(), it is defined in the file
+       * la_parallel_vector_expressions.h, which needs to be included by code
+       * that builds expressions.
+       */
+      template <typename Expression,
+                typename = typename std::enable_if<
+                  internal::VectorExpressions::is_vector_expression<
+                    Expression>::value>::type>
+      Vector<Number, MemorySpace> &
+      operator=(const Expression &expression);
+
+      /**
+       * Evaluate the vector expression @p expression and store the result in
+       * this vector as in the assignment operator above, and compute the
+       * reductions @p reductions of the assigned values in the same pass
+       * over the vectors. The reductions are created by the functions in the
+       * namespace VectorReductions, and the function returns their values,
+       * summed over all processors, in the same order. For example,
+       * @code
+       * const std::array<double, 2> results = x.assign_and_reduce(
+       *   make_vector_expression(x) - alpha * make_vector_expression(v),
+       *   VectorReductions::dot(w),
+       *   VectorReductions::norm_sqr());
+       * @endcode
+       * computes the same as the calls
+       * @code
+       * x.add(-alpha, v);
+       * results[0] = x * w;
+       * results[1] = x.norm_sqr();
+       * @endcode
+       * but loads the vector @p x only once. The sums are computed with the
+       * same algorithm as in the other reductions of this class, i.e., the
+       * results do not depend on the number of threads.
+       *
+       * This function is only available for vectors stored on the host.
+       */
+      template <typename Operation, typename... Reductions>
+      std::array<Number, sizeof...(Reductions)>
+      assign_and_reduce(const VectorExpression<Operation> &expression,
+                        const Reductions &... reductions);
+
       /**
        * This is a collective add operation that adds a whole set of values
        * stored in @p values to the vector components specified by @p indices.
@@ -1358,6 +1464,21 @@ namespace LinearAlgebra
        * operations. This class uses persistent MPI communicators.
        */
       mutable std::vector<MPI_Request> update_ghost_values_requests;
+
+      /**
+       * The exchange pattern through shared memory, set if the vector has
+       * been initialized with a shared-memory communicator.
+       */
+      std::shared_ptr<const Utilities::MPI::SharedMemoryPartitioner>
+        shared_memory_partitioner;
+
+      /**
+       * The shared memory window holding the locally owned and ghost entries
+       * in case the vector uses shared memory. The member @p data then points
+       * into this window.
+       */
+      std::unique_ptr<Utilities::MPI::SharedMemoryArray<Number>>
+        shared_memory_data;
 #endif
 
       /**
@@ -1380,6 +1501,15 @@ namespace LinearAlgebra
       void
       resize_val(const size_type new_allocated_size);
 
+      /**
+       * Return the partitioner that describes the exchange of ghost entries
+       * through MPI messages. For vectors in shared memory, this excludes
+       * the ghost entries owned by processes in the shared-memory
+       * communicator.
+       */
+      const Utilities::MPI::Partitioner &
+      get_communication_partitioner() const;
+
       /*
        * Make all other vector types friends.
        */
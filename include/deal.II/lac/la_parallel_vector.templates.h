@@ -80,6 +80,14 @@ namespace LinearAlgebra
 
 
 
+      // Deleter for the data of vectors in shared memory, which is owned by
+      // the shared memory window rather than by the unique_ptr
+      inline void
+      do_not_free(void *) noexcept
+      {}
+
+
+
       // Resize the underlying array on the host or on the device
       template <typename Number, typename MemorySpaceType>
       struct la_parallel_vector_templates_functions
@@ -401,6 +409,42 @@ namespace LinearAlgebra
     void
     Vector<Number, MemorySpaceType>::resize_val(const size_type new_alloc_size)
     {
+#ifdef DEAL_II_WITH_MPI
+      // release a previous shared memory window, making sure that the regular
+      // memory management below gets a pointer with the standard deleter
+      if (shared_memory_data != nullptr)
+        {
+          data.values = decltype(data.values)(nullptr, &free);
+          shared_memory_data.reset();
+          allocated_size = 0;
+        }
+
+      if (shared_memory_partitioner != nullptr)
+        {
+          Assert(
+            (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value),
+            ExcMessage("Vectors in shared memory are only supported for "
+                       "MemorySpace::Host"));
+
+          // release the memory allocated the regular way
+          internal::la_parallel_vector_templates_functions<
+            Number,
+            MemorySpaceType>::resize_val(0, allocated_size, data);
+
+          shared_memory_data =
+            std_cxx14::make_unique<Utilities::MPI::SharedMemoryArray<Number>>(
+              shared_memory_partitioner->get_shared_memory_communicator(),
+              new_alloc_size);
+          data.values = decltype(data.values)(shared_memory_data->data(),
+                                              &internal::do_not_free);
+          allocated_size = new_alloc_size;
+
+          thread_loop_partitioner =
+            std::make_shared<::dealii::parallel::internal::TBBPartitioner>();
+          return;
+        }
+#endif
+
       internal::la_parallel_vector_templates_functions<
         Number,
         MemorySpaceType>::resize_val(new_alloc_size, allocated_size, data);
@@ -411,6 +455,19 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number, typename MemorySpaceType>
+    const Utilities::MPI::Partitioner &
+    Vector<Number, MemorySpaceType>::get_communication_partitioner() const
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (shared_memory_partitioner != nullptr)
+        return *shared_memory_partitioner->get_off_node_partitioner();
+#endif
+      return *partitioner;
+    }
+
+
+
     template <typename Number, typename MemorySpaceType>
     void
     Vector<Number, MemorySpaceType>::reinit(const size_type size,
@@ -418,6 +475,10 @@ namespace LinearAlgebra
     {
       clear_mpi_requests();
 
+#ifdef DEAL_II_WITH_MPI
+      shared_memory_partitioner.reset();
+#endif
+
       // check whether we need to reallocate
       resize_val(size);
 
@@ -450,8 +511,15 @@ namespace LinearAlgebra
       // check whether the partitioners are
       // different (check only if the are allocated
       // differently, not if the actual data is
-      // different)
-      if (partitioner.get() != v.partitioner.get())
+      // different). vectors in shared memory also need to be reallocated if
+      // the shared memory setup is different
+      bool must_reallocate = (partitioner.get() != v.partitioner.get());
+#ifdef DEAL_II_WITH_MPI
+      must_reallocate |=
+        (shared_memory_partitioner.get() != v.shared_memory_partitioner.get());
+      shared_memory_partitioner = v.shared_memory_partitioner;
+#endif
+      if (must_reallocate)
         {
           partitioner = v.partitioner;
           const size_type new_allocated_size =
@@ -514,6 +582,9 @@ namespace LinearAlgebra
     {
       clear_mpi_requests();
       partitioner = partitioner_in;
+#ifdef DEAL_II_WITH_MPI
+      shared_memory_partitioner.reset();
+#endif
 
       // set vector size and allocate memory
       const size_type new_allocated_size =
@@ -536,6 +607,37 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number, typename MemorySpaceType>
+    void
+    Vector<Number, MemorySpaceType>::reinit(
+      const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner_in,
+      const MPI_Comm &                                          comm_sm)
+    {
+#ifdef DEAL_II_WITH_MPI
+      clear_mpi_requests();
+      partitioner = partitioner_in;
+      shared_memory_partitioner =
+        std::make_shared<Utilities::MPI::SharedMemoryPartitioner>(
+          partitioner_in, comm_sm);
+
+      // allocate the memory in the shared window
+      resize_val(partitioner->local_size() + partitioner->n_ghost_indices());
+
+      // initialize to zero
+      this->operator=(Number());
+
+      import_data.values.reset();
+      import_data.values_dev.reset();
+
+      vector_is_ghosted = false;
+#else
+      (void)comm_sm;
+      reinit(partitioner_in);
+#endif
+    }
+
+
+
     template <typename Number, typename MemorySpaceType>
     Vector<Number, MemorySpaceType>::Vector()
       : partitioner(new Utilities::MPI::Partitioner())
@@ -888,8 +990,26 @@ namespace LinearAlgebra
       // make this function thread safe
       std::lock_guard<std::mutex> lock(mutex);
 
+      const Utilities::MPI::Partitioner &comm_partitioner =
+        get_communication_partitioner();
+
+      // combine the contributions of the other processes on this node by
+      // reading their ghost entries directly. the first synchronization
+      // makes sure that all processes have finished writing to their ghost
+      // entries, the second one that all reads have completed before the
+      // ghost entries get modified by the message exchange
+      if (shared_memory_data != nullptr)
+        {
+          shared_memory_data->synchronize();
+          shared_memory_partitioner->import_from_ghosted_array(
+            operation,
+            shared_memory_data->get_arrays(),
+            ArrayView<Number>(data.values.get(), partitioner->local_size()));
+          shared_memory_data->synchronize();
+        }
+
       // allocate import_data in case it is not set up yet
-      if (partitioner->n_import_indices() > 0)
+      if (comm_partitioner.n_import_indices() > 0)
         {
 #  if defined(DEAL_II_COMPILER_CUDA_AWARE) && \
     defined(DEAL_II_WITH_CUDA_AWARE_MPI)
@@ -900,7 +1020,7 @@ namespace LinearAlgebra
           if (import_data.values_dev == nullptr)
             import_data.values_dev.reset(
               Utilities::CUDA::allocate_device_data<Number>(
-                partitioner->n_import_indices()));
+                comm_partitioner.n_import_indices()));
 #  else
 #    ifdef DEAL_II_WITH_CUDA_AWARE_MPI
           static_assert(
@@ -913,7 +1033,7 @@ namespace LinearAlgebra
               Utilities::System::posix_memalign(
                 reinterpret_cast<void **>(&new_val),
                 64,
-                sizeof(Number) * partitioner->n_import_indices());
+                sizeof(Number) * comm_partitioner.n_import_indices());
               import_data.values.reset(new_val);
             }
 #  endif
@@ -941,24 +1061,24 @@ namespace LinearAlgebra
 
 #  if !(defined(DEAL_II_COMPILER_CUDA_AWARE) && \
         defined(DEAL_II_WITH_CUDA_AWARE_MPI))
-      partitioner->import_from_ghosted_array_start(
+      comm_partitioner.import_from_ghosted_array_start(
         operation,
         counter,
         ArrayView<Number, MemorySpace::Host>(data.values.get() +
                                                partitioner->local_size(),
                                              partitioner->n_ghost_indices()),
-        ArrayView<Number, MemorySpace::Host>(import_data.values.get(),
-                                             partitioner->n_import_indices()),
+        ArrayView<Number, MemorySpace::Host>(
+          import_data.values.get(), comm_partitioner.n_import_indices()),
         compress_requests);
 #  else
-      partitioner->import_from_ghosted_array_start(
+      comm_partitioner.import_from_ghosted_array_start(
         operation,
         counter,
         ArrayView<Number, MemorySpace::CUDA>(data.values_dev.get() +
                                                partitioner->local_size(),
                                              partitioner->n_ghost_indices()),
-        ArrayView<Number, MemorySpace::CUDA>(import_data.values_dev.get(),
-                                             partitioner->n_import_indices()),
+        ArrayView<Number, MemorySpace::CUDA>(
+          import_data.values_dev.get(), comm_partitioner.n_import_indices()),
         compress_requests);
 #  endif
 #endif
@@ -980,29 +1100,40 @@ namespace LinearAlgebra
 
       // make this function thread safe
       std::lock_guard<std::mutex> lock(mutex);
+
+      const Utilities::MPI::Partitioner &comm_partitioner =
+        get_communication_partitioner();
 #  if !(defined(DEAL_II_COMPILER_CUDA_AWARE) && \
         defined(DEAL_II_WITH_CUDA_AWARE_MPI))
-      Assert(partitioner->n_import_indices() == 0 ||
+      Assert(comm_partitioner.n_import_indices() == 0 ||
                import_data.values != nullptr,
              ExcNotInitialized());
-      partitioner->import_from_ghosted_array_finish<Number, MemorySpace::Host>(
+      comm_partitioner.import_from_ghosted_array_finish(
         operation,
         ArrayView<const Number, MemorySpace::Host>(
-          import_data.values.get(), partitioner->n_import_indices()),
+          import_data.values.get(), comm_partitioner.n_import_indices()),
         ArrayView<Number, MemorySpace::Host>(data.values.get(),
                                              partitioner->local_size()),
         ArrayView<Number, MemorySpace::Host>(data.values.get() +
                                                partitioner->local_size(),
                                              partitioner->n_ghost_indices()),
         compress_requests);
+
+      // the message exchange only clears the ghost entries owned by processes
+      // on other nodes
+      if (shared_memory_data != nullptr)
+        std::fill(data.values.get() + partitioner->local_size(),
+                  data.values.get() + partitioner->local_size() +
+                    partitioner->n_ghost_indices(),
+                  Number());
 #  else
-      Assert(partitioner->n_import_indices() == 0 ||
+      Assert(comm_partitioner.n_import_indices() == 0 ||
                import_data.values_dev != nullptr,
              ExcNotInitialized());
-      partitioner->import_from_ghosted_array_finish<Number, MemorySpace::CUDA>(
+      comm_partitioner.import_from_ghosted_array_finish(
         operation,
         ArrayView<const Number, MemorySpace::CUDA>(
-          import_data.values_dev.get(), partitioner->n_import_indices()),
+          import_data.values_dev.get(), comm_partitioner.n_import_indices()),
         ArrayView<Number, MemorySpace::CUDA>(data.values_dev.get(),
                                              partitioner->local_size()),
         ArrayView<Number, MemorySpace::CUDA>(data.values_dev.get() +
@@ -1040,16 +1171,21 @@ namespace LinearAlgebra
       const unsigned int counter) const
     {
 #ifdef DEAL_II_WITH_MPI
-      // nothing to do when we neither have import nor ghost indices.
-      if (partitioner->n_ghost_indices() == 0 &&
-          partitioner->n_import_indices() == 0)
+      const Utilities::MPI::Partitioner &comm_partitioner =
+        get_communication_partitioner();
+
+      // nothing to do when we neither have import nor ghost indices. for
+      // vectors in shared memory, the ghost entries on the same node are
+      // filled in update_ghost_values_finish()
+      if (comm_partitioner.n_ghost_indices() == 0 &&
+          comm_partitioner.n_import_indices() == 0)
         return;
 
       // make this function thread safe
       std::lock_guard<std::mutex> lock(mutex);
 
       // allocate import_data in case it is not set up yet
-      if (partitioner->n_import_indices() > 0)
+      if (comm_partitioner.n_import_indices() > 0)
         {
 #  if defined(DEAL_II_COMPILER_CUDA_AWARE) && \
     defined(DEAL_II_WITH_CUDA_AWARE_MPI)
@@ -1060,7 +1196,7 @@ namespace LinearAlgebra
           if (import_data.values_dev == nullptr)
             import_data.values_dev.reset(
               Utilities::CUDA::allocate_device_data<Number>(
-                partitioner->n_import_indices()));
+                comm_partitioner.n_import_indices()));
 #  else
 #    ifdef DEAL_II_WITH_CUDA_AWARE_MPI
           static_assert(
@@ -1073,7 +1209,7 @@ namespace LinearAlgebra
               Utilities::System::posix_memalign(
                 reinterpret_cast<void **>(&new_val),
                 64,
-                sizeof(Number) * partitioner->n_import_indices());
+                sizeof(Number) * comm_partitioner.n_import_indices());
               import_data.values.reset(new_val);
             }
 #  endif
@@ -1101,23 +1237,23 @@ namespace LinearAlgebra
 
 #  if !(defined(DEAL_II_COMPILER_CUDA_AWARE) && \
         defined(DEAL_II_WITH_CUDA_AWARE_MPI))
-      partitioner->export_to_ghosted_array_start<Number, MemorySpace::Host>(
+      comm_partitioner.export_to_ghosted_array_start<Number, MemorySpace::Host>(
         counter,
         ArrayView<const Number, MemorySpace::Host>(data.values.get(),
                                                    partitioner->local_size()),
-        ArrayView<Number, MemorySpace::Host>(import_data.values.get(),
-                                             partitioner->n_import_indices()),
+        ArrayView<Number, MemorySpace::Host>(
+          import_data.values.get(), comm_partitioner.n_import_indices()),
         ArrayView<Number, MemorySpace::Host>(data.values.get() +
                                                partitioner->local_size(),
                                              partitioner->n_ghost_indices()),
         update_ghost_values_requests);
 #  else
-      partitioner->export_to_ghosted_array_start<Number, MemorySpace::CUDA>(
+      comm_partitioner.export_to_ghosted_array_start<Number, MemorySpace::CUDA>(
         counter,
         ArrayView<const Number, MemorySpace::CUDA>(data.values_dev.get(),
                                                    partitioner->local_size()),
-        ArrayView<Number, MemorySpace::CUDA>(import_data.values_dev.get(),
-                                             partitioner->n_import_indices()),
+        ArrayView<Number, MemorySpace::CUDA>(
+          import_data.values_dev.get(), comm_partitioner.n_import_indices()),
         ArrayView<Number, MemorySpace::CUDA>(data.values_dev.get() +
                                                partitioner->local_size(),
                                              partitioner->n_ghost_indices()),
@@ -1136,10 +1272,13 @@ namespace LinearAlgebra
     Vector<Number, MemorySpaceType>::update_ghost_values_finish() const
     {
 #ifdef DEAL_II_WITH_MPI
+      const Utilities::MPI::Partitioner &comm_partitioner =
+        get_communication_partitioner();
+
       // wait for both sends and receives to complete, even though only
       // receives are really necessary. this gives (much) better performance
-      AssertDimension(partitioner->ghost_targets().size() +
-                        partitioner->import_targets().size(),
+      AssertDimension(comm_partitioner.ghost_targets().size() +
+                        comm_partitioner.import_targets().size(),
                       update_ghost_values_requests.size());
       if (update_ghost_values_requests.size() > 0)
         {
@@ -1148,13 +1287,13 @@ namespace LinearAlgebra
 
 #  if !(defined(DEAL_II_COMPILER_CUDA_AWARE) && \
         defined(DEAL_II_WITH_CUDA_AWARE_MPI))
-          partitioner->export_to_ghosted_array_finish(
+          comm_partitioner.export_to_ghosted_array_finish(
             ArrayView<Number, MemorySpace::Host>(
               data.values.get() + partitioner->local_size(),
               partitioner->n_ghost_indices()),
             update_ghost_values_requests);
 #  else
-          partitioner->export_to_ghosted_array_finish(
+          comm_partitioner.export_to_ghosted_array_finish(
             ArrayView<Number, MemorySpace::CUDA>(
               data.values_dev.get() + partitioner->local_size(),
               partitioner->n_ghost_indices()),
@@ -1162,6 +1301,23 @@ namespace LinearAlgebra
 #  endif
         }
 
+      // read the ghost entries owned by other processes on this node
+      // directly from their memory. this must happen after the message
+      // exchange which might temporarily use the whole ghost range. the
+      // first synchronization makes sure that the owners have finished
+      // writing, the second one that they do not modify their entries
+      // before all reads have completed
+      if (shared_memory_data != nullptr)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          shared_memory_data->synchronize();
+          shared_memory_partitioner->export_to_ghosted_array(
+            shared_memory_data->get_arrays(),
+            ArrayView<Number>(data.values.get() + partitioner->local_size(),
+                              partitioner->n_ghost_indices()));
+          shared_memory_data->synchronize();
+        }
+
 #  if defined DEAL_II_COMPILER_CUDA_AWARE && \
     !defined  DEAL_II_WITH_CUDA_AWARE_MPI
       // The communication is done on the host, so we need to
@@ -1308,6 +1464,8 @@ namespace LinearAlgebra
 
       std::swap(compress_requests, v.compress_requests);
       std::swap(update_ghost_values_requests, v.update_ghost_values_requests);
+      std::swap(shared_memory_partitioner, v.shared_memory_partitioner);
+      std::swap(shared_memory_data, v.shared_memory_data);
 #endif
 
       std::swap(partitioner, v.partitioner);
@@ -1999,7 +2157,16 @@ namespace LinearAlgebra
     Vector<Number, MemorySpaceType>::memory_consumption() const
     {
       std::size_t memory = sizeof(*this);
+#ifdef DEAL_II_WITH_MPI
+      // for vectors in shared memory, the locally owned and ghost entries are
+      // the part of the shared memory window owned by this process
+      if (shared_memory_data != nullptr)
+        memory += shared_memory_data->memory_consumption();
+      else
+        memory += sizeof(Number) * static_cast<std::size_t>(allocated_size);
+#else
       memory += sizeof(Number) * static_cast<std::size_t>(allocated_size);
+#endif
 
       // if the partitioner is shared between more processors, just count a
       // fraction of that memory, since we're not actually using more memory
@@ -2007,8 +2174,15 @@ namespace LinearAlgebra
       if (partitioner.use_count() > 0)
         memory +=
           partitioner->memory_consumption() / partitioner.use_count() + 1;
+#ifdef DEAL_II_WITH_MPI
+      if (shared_memory_partitioner.use_count() > 0)
+        memory += shared_memory_partitioner->memory_consumption() /
+                    shared_memory_partitioner.use_count() +
+                  1;
+#endif
       if (import_data.values != nullptr || import_data.values_dev != nullptr)
-        memory += (static_cast<std::size_t>(partitioner->n_import_indices()) *
+        memory += (static_cast<std::size_t>(
+                     get_communication_partitioner().n_import_indices()) *
                    sizeof(Number));
       return memory;
     }
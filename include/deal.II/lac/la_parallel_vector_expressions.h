@@ -0,0 +1,834 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_la_parallel_vector_expressions_h
+#define dealii_la_parallel_vector_expressions_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/complex_overloads.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/types.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector_operations_internal.h>
+
+#include <array>
+#include <type_traits>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    namespace internal
+    {
+      /**
+       * The building blocks of the expressions represented by the class
+       * VectorExpression. Each class provides the value of the expression
+       * for a locally owned index through a function value(), and the values
+       * for VectorizedArray::n_array_elements consecutive indices through a
+       * function vectorized_value().
+       */
+      namespace VectorExpressions
+      {
+        using size_type = types::global_dof_index;
+
+        /**
+         * The locally owned entries of a vector.
+         */
+        template <typename Number>
+        struct VectorEntries
+        {
+          using value_type = Number;
+
+          VectorEntries(const Number *values, const size_type local_size)
+            : values(values)
+            , local_size(local_size)
+          {}
+
+          Number
+          value(const size_type i) const
+          {
+            return values[i];
+          }
+
+          VectorizedArray<Number>
+          vectorized_value(const size_type i) const
+          {
+            VectorizedArray<Number> result;
+            result.load(values + i);
+            return result;
+          }
+
+          const Number *  values;
+          const size_type local_size;
+        };
+
+
+
+        /**
+         * An expression multiplied by a scalar factor.
+         */
+        template <typename Operand>
+        struct Scaled
+        {
+          using value_type = typename Operand::value_type;
+
+          Scaled(const value_type factor, const Operand &operand)
+            : factor(factor)
+            , operand(operand)
+            , local_size(operand.local_size)
+          {}
+
+          value_type
+          value(const size_type i) const
+          {
+            return factor * operand.value(i);
+          }
+
+          VectorizedArray<value_type>
+          vectorized_value(const size_type i) const
+          {
+            return factor * operand.vectorized_value(i);
+          }
+
+          const value_type factor;
+          const Operand    operand;
+          const size_type  local_size;
+        };
+
+
+
+        /**
+         * The sum of two expressions.
+         */
+        template <typename Left, typename Right>
+        struct Sum
+        {
+          using value_type = typename Left::value_type;
+
+          Sum(const Left &left, const Right &right)
+            : left(left)
+            , right(right)
+            , local_size(left.local_size)
+          {
+            AssertDimension(left.local_size, right.local_size);
+          }
+
+          value_type
+          value(const size_type i) const
+          {
+            return left.value(i) + right.value(i);
+          }
+
+          VectorizedArray<value_type>
+          vectorized_value(const size_type i) const
+          {
+            return left.vectorized_value(i) + right.vectorized_value(i);
+          }
+
+          const Left      left;
+          const Right     right;
+          const size_type local_size;
+        };
+
+
+
+        /**
+         * The difference of two expressions.
+         */
+        template <typename Left, typename Right>
+        struct Difference
+        {
+          using value_type = typename Left::value_type;
+
+          Difference(const Left &left, const Right &right)
+            : left(left)
+            , right(right)
+            , local_size(left.local_size)
+          {
+            AssertDimension(left.local_size, right.local_size);
+          }
+
+          value_type
+          value(const size_type i) const
+          {
+            return left.value(i) - right.value(i);
+          }
+
+          VectorizedArray<value_type>
+          vectorized_value(const size_type i) const
+          {
+            return left.vectorized_value(i) - right.vectorized_value(i);
+          }
+
+          const Left      left;
+          const Right     right;
+          const size_type local_size;
+        };
+
+
+
+        /**
+         * The entry-wise product of two expressions.
+         */
+        template <typename Left, typename Right>
+        struct EntrywiseProduct
+        {
+          using value_type = typename Left::value_type;
+
+          EntrywiseProduct(const Left &left, const Right &right)
+            : left(left)
+            , right(right)
+            , local_size(left.local_size)
+          {
+            AssertDimension(left.local_size, right.local_size);
+          }
+
+          value_type
+          value(const size_type i) const
+          {
+            return left.value(i) * right.value(i);
+          }
+
+          VectorizedArray<value_type>
+          vectorized_value(const size_type i) const
+          {
+            return left.vectorized_value(i) * right.vectorized_value(i);
+          }
+
+          const Left      left;
+          const Right     right;
+          const size_type local_size;
+        };
+
+
+
+        /**
+         * An expression whose values are written into the locally owned
+         * entries of a vector while the expression is evaluated.
+         */
+        template <typename Operand>
+        struct Stored
+        {
+          using value_type = typename Operand::value_type;
+
+          Stored(value_type *values, const Operand &operand)
+            : values(values)
+            , operand(operand)
+            , local_size(operand.local_size)
+          {}
+
+          value_type
+          value(const size_type i) const
+          {
+            const value_type result = operand.value(i);
+            values[i]               = result;
+            return result;
+          }
+
+          VectorizedArray<value_type>
+          vectorized_value(const size_type i) const
+          {
+            const VectorizedArray<value_type> result =
+              operand.vectorized_value(i);
+            result.store(values + i);
+            return result;
+          }
+
+          value_type *const values;
+          const Operand     operand;
+          const size_type   local_size;
+        };
+
+
+
+        /**
+         * The inner product of the assigned values with the locally owned
+         * entries of a vector. For complex-valued vectors, the entries of
+         * the vector are conjugated.
+         */
+        template <typename Number>
+        struct DotProduct
+        {
+          DotProduct(const Number *values, const size_type local_size)
+            : values(values)
+            , local_size(local_size)
+          {}
+
+          Number
+          value(const Number x, const size_type i) const
+          {
+            return x *
+                   Number(numbers::NumberTraits<Number>::conjugate(values[i]));
+          }
+
+          VectorizedArray<Number>
+          vectorized_value(const VectorizedArray<Number> &x,
+                           const size_type                i) const
+          {
+            // VectorizedArray only works on real numbers, so there is no
+            // conjugation to be done
+            VectorizedArray<Number> y;
+            y.load(values + i);
+            return x * y;
+          }
+
+          void
+          check_local_size(const size_type size) const
+          {
+            AssertDimension(size, local_size);
+            (void)size;
+          }
+
+          const Number *  values;
+          const size_type local_size;
+        };
+
+
+
+        /**
+         * The square of the $l_2$ norm of the assigned values.
+         */
+        struct NormSquare
+        {
+          void
+          check_local_size(const size_type) const
+          {}
+
+          template <typename Number>
+          Number
+          value(const Number x, const size_type) const
+          {
+            return x * Number(numbers::NumberTraits<Number>::conjugate(x));
+          }
+
+          template <typename Number>
+          VectorizedArray<Number>
+          vectorized_value(const VectorizedArray<Number> &x,
+                           const size_type) const
+          {
+            return x * x;
+          }
+        };
+
+
+
+        /**
+         * Translate the operands accepted by the functions that build vector
+         * expressions into the classes above. Types that are not operands
+         * do not define a member type @p type.
+         */
+        template <typename T>
+        struct OperationOf
+        {};
+
+        template <typename Number>
+        struct OperationOf<
+          ::dealii::LinearAlgebra::distributed::
+            Vector<Number, ::dealii::MemorySpace::Host>>
+        {
+          using type = VectorEntries<Number>;
+
+          static type
+          get(const ::dealii::LinearAlgebra::distributed::
+                Vector<Number, ::dealii::MemorySpace::Host> &vector)
+          {
+            return type(vector.begin(), vector.local_size());
+          }
+        };
+
+        template <typename Operation>
+        struct OperationOf<VectorExpression<Operation>>
+        {
+          using type = Operation;
+
+          static const type &
+          get(const VectorExpression<Operation> &expression)
+          {
+            return expression.get_operation();
+          }
+        };
+      } // namespace VectorExpressions
+    }   // namespace internal
+
+
+
+    /*! @addtogroup Vectors
+     *@{
+     */
+
+    /**
+     * An expression of the locally owned entries of
+     * LinearAlgebra::distributed::Vector objects on the host, such as linear
+     * combinations and entry-wise products of several vectors. Expressions
+     * are not evaluated when they are built, but only when they are assigned
+     * to a vector. The assignment then computes all entries in a single pass
+     * over the vectors involved, using the same thread partitioning and SIMD
+     * vectorization as the built-in vector operations, instead of one pass
+     * for each of the operations the expression is composed of. Since most
+     * vector operations are limited by memory transfer, this can save a
+     * substantial part of the run time of iterative solvers.
+     *
+     * Expressions start from the function make_vector_expression() and are
+     * combined with the usual arithmetic operators, with entrywise_product()
+     * and with store_in(). Once one of the operands of a sum or difference is
+     * an expression, the other one may also be a plain vector:
+     * @code
+     * const auto Y = make_vector_expression(y);
+     * const auto Z = make_vector_expression(z);
+     * const auto W = make_vector_expression(w);
+     * x = a * Y + b * Z - c * W;
+     * @endcode
+     * The arithmetic operators are not defined on plain vectors themselves,
+     * because these are already used by PackagedOperation, so a vector has to
+     * be wrapped into an expression before it is multiplied by a scalar. The
+     * function Vector::assign_and_reduce() additionally computes inner
+     * products and norms of the assigned values in the same pass, see the
+     * namespace VectorReductions:
+     * @code
+     * const std::array<double, 2> results = x.assign_and_reduce(
+     *   a * Y + b * Z - c * W,
+     *   VectorReductions::dot(v),
+     *   VectorReductions::norm_sqr());
+     * @endcode
+     *
+     * Expressions only store pointers to the locally owned entries of the
+     * vectors they refer to, i.e., the vectors must not be resized or
+     * destroyed before the expression is evaluated. Each entry of the result
+     * only depends on the entries with the same index, so the vector being
+     * assigned to may also appear in the expression. Ghost entries are not
+     * part of the expressions.
+     */
+    template <typename Operation>
+    class VectorExpression
+    {
+    public:
+      /**
+       * The number type of the entries of the expression.
+       */
+      using value_type = typename Operation::value_type;
+
+      /**
+       * Declare type for container size.
+       */
+      using size_type = types::global_dof_index;
+
+      /**
+       * Constructor.
+       */
+      explicit VectorExpression(const Operation &operation);
+
+      /**
+       * Return the value of the expression for the locally owned index @p i.
+       */
+      value_type
+      value(const size_type i) const;
+
+      /**
+       * Return the values of the expression for the
+       * VectorizedArray::n_array_elements locally owned indices starting at
+       * @p i.
+       */
+      VectorizedArray<value_type>
+      vectorized_value(const size_type i) const;
+
+      /**
+       * Return the number of locally owned entries of the vectors in the
+       * expression.
+       */
+      size_type
+      local_size() const;
+
+      /**
+       * Return the operation represented by this expression.
+       */
+      const Operation &
+      get_operation() const;
+
+      /**
+       * Multiply the expression @p expression by the scalar @p factor.
+       *
+       * The operator is only found through argument dependent lookup, so
+       * that it does not hide the other declarations of <tt>operator*</tt>,
+       * like the products of real and complex numbers in
+       * complex_overloads.h, from the code in this namespace.
+       */
+      friend VectorExpression<internal::VectorExpressions::Scaled<Operation>>
+      operator*(const value_type factor, const VectorExpression &expression)
+      {
+        return VectorExpression<
+          internal::VectorExpressions::Scaled<Operation>>(
+          internal::VectorExpressions::Scaled<Operation>(factor,
+                                                         expression.operation));
+      }
+
+    private:
+      /**
+       * The operation represented by this expression.
+       */
+      const Operation operation;
+    };
+
+
+
+    /**
+     * Create an expression representing the locally owned entries of the
+     * vector @p vector.
+     *
+     * @relatesalso VectorExpression
+     */
+    template <typename Number>
+    VectorExpression<internal::VectorExpressions::VectorEntries<Number>>
+    make_vector_expression(
+      const Vector<Number, ::dealii::MemorySpace::Host> &vector);
+
+    /**
+     * Negate the expression @p expression.
+     *
+     * @relatesalso VectorExpression
+     */
+    template <typename Operation>
+    VectorExpression<internal::VectorExpressions::Scaled<Operation>>
+    operator-(const VectorExpression<Operation> &expression);
+
+    /**
+     * Add two expressions. One of the two arguments may also be a vector.
+     *
+     * @relatesalso VectorExpression
+     */
+    template <typename Left,
+              typename Right,
+              typename = typename std::enable_if<
+                internal::VectorExpressions::is_vector_expression<
+                  Left>::value ||
+                internal::VectorExpressions::is_vector_expression<
+                  Right>::value>::type>
+    VectorExpression<internal::VectorExpressions::Sum<
+      typename internal::VectorExpressions::OperationOf<Left>::type,
+      typename internal::VectorExpressions::OperationOf<Right>::type>>
+    operator+(const Left &left, const Right &right);
+
+    /**
+     * Subtract two expressions. One of the two arguments may also be a
+     * vector.
+     *
+     * @relatesalso VectorExpression
+     */
+    template <typename Left,
+              typename Right,
+              typename = typename std::enable_if<
+                internal::VectorExpressions::is_vector_expression<
+                  Left>::value ||
+                internal::VectorExpressions::is_vector_expression<
+                  Right>::value>::type>
+    VectorExpression<internal::VectorExpressions::Difference<
+      typename internal::VectorExpressions::OperationOf<Left>::type,
+      typename internal::VectorExpressions::OperationOf<Right>::type>>
+    operator-(const Left &left, const Right &right);
+
+    /**
+     * Multiply two expressions or vectors entry by entry.
+     *
+     * @relatesalso VectorExpression
+     */
+    template <typename Left, typename Right>
+    VectorExpression<internal::VectorExpressions::EntrywiseProduct<
+      typename internal::VectorExpressions::OperationOf<Left>::type,
+      typename internal::VectorExpressions::OperationOf<Right>::type>>
+    entrywise_product(const Left &left, const Right &right);
+
+    /**
+     * Return an expression with the same values as @p expression that also
+     * writes these values into the locally owned entries of @p vector when
+     * it is evaluated. This allows to update several vectors in the same
+     * pass, as in the recurrence
+     * @code
+     * x = make_vector_expression(x) +
+     *     store_in(p, make_vector_expression(r) +
+     *                   beta * make_vector_expression(p));
+     * @endcode
+     * The ghost entries of @p vector are not updated. The vector @p vector
+     * must not be the one the whole expression is assigned to.
+     *
+     * @relatesalso VectorExpression
+     */
+    template <typename Number, typename Operation>
+    VectorExpression<internal::VectorExpressions::Stored<Operation>>
+    store_in(Vector<Number, ::dealii::MemorySpace::Host> &vector,
+             const VectorExpression<Operation> &           expression);
+
+    /**
+     * The reductions that Vector::assign_and_reduce() can compute together
+     * with the assignment of an expression.
+     */
+    namespace VectorReductions
+    {
+      /**
+       * Compute the inner product of the assigned values $x$ with the
+       * vector @p vector, $\sum_i x_i \bar{v_i}$.
+       */
+      template <typename Number>
+      internal::VectorExpressions::DotProduct<Number>
+      dot(const Vector<Number, ::dealii::MemorySpace::Host> &vector);
+
+      /**
+       * Compute the square of the $l_2$ norm of the assigned values. For
+       * complex-valued vectors, the result is stored in the real part.
+       */
+      inline internal::VectorExpressions::NormSquare
+      norm_sqr()
+      {
+        return internal::VectorExpressions::NormSquare();
+      }
+    } // namespace VectorReductions
+
+    /*@}*/
+
+
+    /*------------------------ Inline functions -----------------------------*/
+
+#ifndef DOXYGEN
+
+    template <typename Operation>
+    inline VectorExpression<Operation>::VectorExpression(
+      const Operation &operation)
+      : operation(operation)
+    {}
+
+
+
+    template <typename Operation>
+    inline typename VectorExpression<Operation>::value_type
+    VectorExpression<Operation>::value(const size_type i) const
+    {
+      return operation.value(i);
+    }
+
+
+
+    template <typename Operation>
+    inline VectorizedArray<typename VectorExpression<Operation>::value_type>
+    VectorExpression<Operation>::vectorized_value(const size_type i) const
+    {
+      return operation.vectorized_value(i);
+    }
+
+
+
+    template <typename Operation>
+    inline typename VectorExpression<Operation>::size_type
+    VectorExpression<Operation>::local_size() const
+    {
+      return operation.local_size;
+    }
+
+
+
+    template <typename Operation>
+    inline const Operation &
+    VectorExpression<Operation>::get_operation() const
+    {
+      return operation;
+    }
+
+
+
+    template <typename Number>
+    inline VectorExpression<internal::VectorExpressions::VectorEntries<Number>>
+    make_vector_expression(
+      const Vector<Number, ::dealii::MemorySpace::Host> &vector)
+    {
+      return VectorExpression<
+        internal::VectorExpressions::VectorEntries<Number>>(
+        internal::VectorExpressions::VectorEntries<Number>(
+          vector.begin(), vector.local_size()));
+    }
+
+
+
+    template <typename Operation>
+    inline VectorExpression<internal::VectorExpressions::Scaled<Operation>>
+    operator-(const VectorExpression<Operation> &expression)
+    {
+      return typename Operation::value_type(-1.) * expression;
+    }
+
+
+
+    template <typename Left, typename Right, typename>
+    inline VectorExpression<internal::VectorExpressions::Sum<
+      typename internal::VectorExpressions::OperationOf<Left>::type,
+      typename internal::VectorExpressions::OperationOf<Right>::type>>
+    operator+(const Left &left, const Right &right)
+    {
+      using namespace internal::VectorExpressions;
+      using OperationType = Sum<typename OperationOf<Left>::type,
+                                typename OperationOf<Right>::type>;
+      return VectorExpression<OperationType>(OperationType(
+        OperationOf<Left>::get(left), OperationOf<Right>::get(right)));
+    }
+
+
+
+    template <typename Left, typename Right, typename>
+    inline VectorExpression<internal::VectorExpressions::Difference<
+      typename internal::VectorExpressions::OperationOf<Left>::type,
+      typename internal::VectorExpressions::OperationOf<Right>::type>>
+    operator-(const Left &left, const Right &right)
+    {
+      using namespace internal::VectorExpressions;
+      using OperationType = Difference<typename OperationOf<Left>::type,
+                                       typename OperationOf<Right>::type>;
+      return VectorExpression<OperationType>(OperationType(
+        OperationOf<Left>::get(left), OperationOf<Right>::get(right)));
+    }
+
+
+
+    template <typename Left, typename Right>
+    inline VectorExpression<internal::VectorExpressions::EntrywiseProduct<
+      typename internal::VectorExpressions::OperationOf<Left>::type,
+      typename internal::VectorExpressions::OperationOf<Right>::type>>
+    entrywise_product(const Left &left, const Right &right)
+    {
+      using namespace internal::VectorExpressions;
+      using OperationType =
+        EntrywiseProduct<typename OperationOf<Left>::type,
+                         typename OperationOf<Right>::type>;
+      return VectorExpression<OperationType>(OperationType(
+        OperationOf<Left>::get(left), OperationOf<Right>::get(right)));
+    }
+
+
+
+    template <typename Number, typename Operation>
+    inline VectorExpression<internal::VectorExpressions::Stored<Operation>>
+    store_in(Vector<Number, ::dealii::MemorySpace::Host> &vector,
+             const VectorExpression<Operation> &           expression)
+    {
+      static_assert(
+        std::is_same<Number, typename Operation::value_type>::value,
+        "The vector must have the same number type as the expression.");
+      AssertDimension(vector.local_size(), expression.local_size());
+      return VectorExpression<internal::VectorExpressions::Stored<Operation>>(
+        internal::VectorExpressions::Stored<Operation>(
+          vector.begin(), expression.get_operation()));
+    }
+
+
+
+    namespace VectorReductions
+    {
+      template <typename Number>
+      inline internal::VectorExpressions::DotProduct<Number>
+      dot(const Vector<Number, ::dealii::MemorySpace::Host> &vector)
+      {
+        return internal::VectorExpressions::DotProduct<Number>(
+          vector.begin(), vector.local_size());
+      }
+    } // namespace VectorReductions
+
+
+
+    template <typename Number, typename MemorySpace>
+    template <typename Expression, typename>
+    inline Vector<Number, MemorySpace> &
+    Vector<Number, MemorySpace>::operator=(const Expression &expression)
+    {
+      static_assert(
+        std::is_same<MemorySpace, ::dealii::MemorySpace::Host>::value,
+        "Vector expressions are only available for vectors on the host.");
+      static_assert(
+        std::is_same<Number, typename Expression::value_type>::value,
+        "The vector must have the same number type as the expression.");
+      AssertDimension(local_size(), expression.local_size());
+
+      dealii::internal::VectorOperations::
+        Vectorization_expression<Number, Expression>
+          assigner(data.values.get(), expression);
+      dealii::internal::VectorOperations::parallel_for(
+        assigner, 0, local_size(), thread_loop_partitioner);
+
+      if (vector_is_ghosted)
+        update_ghost_values();
+
+      return *this;
+    }
+
+
+
+    template <typename Number, typename MemorySpace>
+    template <typename Operation, typename... Reductions>
+    inline std::array<Number, sizeof...(Reductions)>
+    Vector<Number, MemorySpace>::assign_and_reduce(
+      const VectorExpression<Operation> &expression,
+      const Reductions &... reductions)
+    {
+      static_assert(
+        std::is_same<MemorySpace, ::dealii::MemorySpace::Host>::value,
+        "Vector expressions are only available for vectors on the host.");
+      static_assert(
+        std::is_same<Number, typename Operation::value_type>::value,
+        "The vector must have the same number type as the expression.");
+      static_assert(sizeof...(Reductions) > 0,
+                    "At least one reduction must be given.");
+      AssertDimension(local_size(), expression.local_size());
+
+      const int dummy[] = {
+        (reductions.check_local_size(local_size()), 0)...};
+      (void)dummy;
+
+      const dealii::internal::VectorOperations::
+        ExpressionAndReductions<Number,
+                                VectorExpression<Operation>,
+                                Reductions...>
+          op(data.values.get(), expression, reductions...);
+      Tensor<1, sizeof...(Reductions), Number> local_result;
+      dealii::internal::VectorOperations::parallel_reduce(
+        op, 0, local_size(), local_result, thread_loop_partitioner);
+
+      std::array<Number, sizeof...(Reductions)> result;
+      for (unsigned int i = 0; i < result.size(); ++i)
+        {
+          AssertIsFinite(local_result[i]);
+          result[i] = local_result[i];
+        }
+      if (partitioner->n_mpi_processes() > 1)
+        Utilities::MPI::sum(ArrayView<const Number>(result.data(),
+                                                    result.size()),
+                            partitioner->get_mpi_communicator(),
+                            ArrayView<Number>(result.data(), result.size()));
+
+      if (vector_is_ghosted)
+        update_ghost_values();
+
+      return result;
+    }
+
+#endif // DOXYGEN
+
+  } // namespace distributed
+} // namespace LinearAlgebra
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
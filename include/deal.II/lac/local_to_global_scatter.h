@@ -0,0 +1,597 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_local_to_global_scatter_h
+#define dealii_local_to_global_scatter_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+/**
+ * A class that stores, for a set of cells with fixed local-to-global
+ * index maps, the positions into the value array of a SparseMatrix (and
+ * the indices into a vector) that the entries of the cell matrices and cell
+ * vectors are written to. The constraints of an AffineConstraints object are
+ * resolved while setting up the object, so that the actual transfer of cell
+ * contributions into the global objects reduces to indexed additions,
+ * without sorting of indices, resolution of constraints, or searches for
+ * column indices within the rows of the sparse matrix.
+ *
+ * The typical use case is the repeated assembly of matrices on a fixed mesh,
+ * e.g. in Newton iterations or time stepping schemes with time-dependent
+ * coefficients. There, the cost of
+ * AffineConstraints::distribute_local_to_global() is often comparable to the
+ * cost of computing the cell matrices for low order elements. With this
+ * class, the scatter information is set up once by calling add_cell() (or
+ * add_cells()) for each cell, and each subsequent assembly calls one of the
+ * distribute_local_to_global() functions of this class instead:
+ * @code
+ *   LocalToGlobalScatter<double> scatter;
+ *   scatter.reinit(sparsity_pattern, constraints);
+ *   for (const auto &cell : dof_handler.active_cell_iterators())
+ *     {
+ *       cell->get_dof_indices(local_dof_indices);
+ *       scatter.add_cell(local_dof_indices);
+ *     }
+ *
+ *   // later, in each assembly:
+ *   unsigned int cell_index = 0;
+ *   for (const auto &cell : dof_handler.active_cell_iterators())
+ *     {
+ *       ... compute cell_matrix, cell_rhs ...
+ *       scatter.distribute_local_to_global(cell_index++,
+ *                                          cell_matrix,
+ *                                          cell_rhs,
+ *                                          system_matrix,
+ *                                          system_rhs);
+ *     }
+ * @endcode
+ * The functions that take an ArrayView of cell matrices scatter a whole
+ * batch of consecutively numbered cells at once, e.g. the cells of one chunk
+ * of a WorkStream::run() loop whose copier collects the local contributions
+ * of several cells.
+ *
+ * The result of the functions in this class is the same as the one of the
+ * respective AffineConstraints::distribute_local_to_global() functions, up
+ * to roundoff caused by a different order of summation. In particular,
+ * constrained degrees of freedom get the same diagonal entries, and
+ * inhomogeneous constraints are taken into account in the right hand side
+ * vector.
+ *
+ * For cells that are not affected by constraints, the matrix scatter
+ * information is simply a list of positions in the same order as the
+ * entries of the (row-major) cell matrix. For all other cells, the list
+ * contains for each position in the global matrix the index of the entry in
+ * the cell matrix and the weight by which it is multiplied, sorted by the
+ * position in the global matrix.
+ *
+ * @note Entries of the cell matrices whose global position is not part of
+ * the sparsity pattern are silently dropped. This is the typical situation
+ * for sparsity patterns that were created with DoFTools::make_sparsity_pattern
+ * using a coupling table, where the corresponding cell matrix entries are
+ * zero. In contrast to AffineConstraints::distribute_local_to_global(), this
+ * class cannot check that the dropped entries are indeed zero.
+ *
+ * @note The object stores pointers to the sparsity pattern and the
+ * constraints it was set up with. The scatter information becomes invalid
+ * if either of them is changed, and a SparseMatrix passed to the
+ * distribute_local_to_global() functions must be based on the same sparsity
+ * pattern object.
+ */
+template <typename number = double>
+class LocalToGlobalScatter : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Constructor. Leaves the object empty; use reinit() before adding cells.
+   */
+  LocalToGlobalScatter();
+
+  /**
+   * Set the sparsity pattern and the constraints used to translate local
+   * indices into positions in the global matrix, and delete all cells
+   * previously added.
+   *
+   * The constraints object must be closed.
+   */
+  void
+  reinit(const SparsityPattern &          sparsity_pattern,
+         const AffineConstraints<number> &constraints);
+
+  /**
+   * Delete all data and reset the object to the state after the default
+   * constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Compute and store the scatter information of a cell with the given
+   * global indices of its degrees of freedom. Returns the number of the
+   * cell within this object, i.e., the number by which it is to be
+   * referred to in the distribute_local_to_global() functions. Cells are
+   * numbered consecutively in the order in which they are added.
+   */
+  unsigned int
+  add_cell(const std::vector<size_type> &local_dof_indices);
+
+  /**
+   * Call add_cell() for each of the given index sets.
+   */
+  void
+  add_cells(const std::vector<std::vector<size_type>> &local_dof_indices);
+
+  /**
+   * Return the number of cells stored in this object.
+   */
+  unsigned int
+  n_cells() const;
+
+  /**
+   * Return the number of degrees of freedom of the given cell.
+   */
+  unsigned int
+  n_dofs_per_cell(const unsigned int cell) const;
+
+  /**
+   * Return whether the degrees of freedom of the given cell are affected by
+   * constraints, i.e., whether its scatter information needs weights.
+   */
+  bool
+  is_constrained(const unsigned int cell) const;
+
+  /**
+   * Add the cell matrix of the given cell into the global matrix.
+   */
+  void
+  distribute_local_to_global(const unsigned int        cell,
+                             const FullMatrix<number> &local_matrix,
+                             SparseMatrix<number> &    global_matrix) const;
+
+  /**
+   * Add the cell matrix and the cell vector of the given cell into the global
+   * matrix and vector. Inhomogeneous constraints are taken into account in
+   * the same way as in the respective function of AffineConstraints,
+   * including the effect of the argument @p use_inhomogeneities_for_rhs.
+   */
+  template <typename VectorType>
+  void
+  distribute_local_to_global(
+    const unsigned int        cell,
+    const FullMatrix<number> &local_matrix,
+    const Vector<number> &    local_vector,
+    SparseMatrix<number> &    global_matrix,
+    VectorType &              global_vector,
+    const bool                use_inhomogeneities_for_rhs = false) const;
+
+  /**
+   * Add the cell matrices of the cells <tt>first_cell, ...,
+   * first_cell+local_matrices.size()-1</tt> into the global matrix.
+   */
+  void
+  distribute_local_to_global(
+    const unsigned int                        first_cell,
+    const ArrayView<const FullMatrix<number>> &local_matrices,
+    SparseMatrix<number> &                    global_matrix) const;
+
+  /**
+   * Add the cell matrices and cell vectors of the cells <tt>first_cell, ...,
+   * first_cell+local_matrices.size()-1</tt> into the global matrix and
+   * vector.
+   */
+  template <typename VectorType>
+  void
+  distribute_local_to_global(
+    const unsigned int                        first_cell,
+    const ArrayView<const FullMatrix<number>> &local_matrices,
+    const ArrayView<const Vector<number>> &   local_vectors,
+    SparseMatrix<number> &                    global_matrix,
+    VectorType &                              global_vector,
+    const bool use_inhomogeneities_for_rhs = false) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg(ExcDifferentSparsityPattern,
+                   "The sparse matrix passed to this function is not based "
+                   "on the sparsity pattern this object was set up with.");
+
+  /**
+   * Exception
+   */
+  DeclException2(ExcMissingDiagonal,
+                 size_type,
+                 unsigned int,
+                 << "The diagonal entry in row " << arg1
+                 << " of constrained local degree of freedom " << arg2
+                 << " does not exist in the sparsity pattern.");
+
+private:
+  /**
+   * One entry of the scatter information of a constrained cell: the
+   * destination index in the global object (a position in the value array
+   * of the matrix or an index into the vector), the index of the source
+   * entry in the cell object (for matrices the row-major index
+   * <tt>i*n+j</tt>), and the weight by which the source entry is
+   * multiplied.
+   */
+  struct Entry
+  {
+    std::size_t  destination;
+    unsigned int source;
+    number       weight;
+  };
+
+  /**
+   * Entry to be added to the diagonal of a constrained row, together with
+   * its contribution to the right hand side for inhomogeneous constraints.
+   */
+  struct DiagonalEntry
+  {
+    std::size_t  position;
+    size_type    row;
+    unsigned int local_row;
+    number       inhomogeneity;
+  };
+
+  /**
+   * Offsets of the data of one cell within the various arrays below. The
+   * data of cell <tt>c</tt> is in the range from <tt>cell_offsets[c]</tt>
+   * to <tt>cell_offsets[c+1]</tt>.
+   */
+  struct Offsets
+  {
+    std::size_t matrix_direct;
+    std::size_t matrix_constrained;
+    std::size_t vector_direct;
+    std::size_t vector_constrained;
+    std::size_t rhs_from_matrix;
+    std::size_t diagonal;
+  };
+
+  /**
+   * Add the matrix contributions of one cell, without checks.
+   */
+  void
+  scatter_matrix(const unsigned int        cell,
+                 const FullMatrix<number> &local_matrix,
+                 number *                  matrix_values) const;
+
+  /**
+   * Add the matrix and vector contributions of one cell, without checks.
+   */
+  template <typename VectorType>
+  void
+  scatter_matrix_and_vector(const unsigned int        cell,
+                            const FullMatrix<number> &local_matrix,
+                            const Vector<number> &    local_vector,
+                            number *                  matrix_values,
+                            VectorType &              global_vector,
+                            const bool use_inhomogeneities_for_rhs) const;
+
+  /**
+   * Return a pointer to the value array of the given matrix, after checking
+   * that it is based on the sparsity pattern of this object.
+   */
+  number *
+  get_matrix_values(SparseMatrix<number> &global_matrix) const;
+
+  /**
+   * Pointer to the sparsity pattern used to compute matrix positions.
+   */
+  SmartPointer<const SparsityPattern, LocalToGlobalScatter<number>> sparsity;
+
+  /**
+   * Pointer to the constraints that are resolved by this object.
+   */
+  SmartPointer<const AffineConstraints<number>, LocalToGlobalScatter<number>>
+    constraints;
+
+  /**
+   * Number of degrees of freedom of each cell.
+   */
+  std::vector<unsigned int> dofs_per_cell;
+
+  /**
+   * Offsets into the data arrays, with one more element than there are
+   * cells.
+   */
+  std::vector<Offsets> cell_offsets;
+
+  /**
+   * Matrix positions for unconstrained cells, in the order of the entries
+   * of the cell matrix. Entries not present in the sparsity pattern are
+   * marked by SparsityPattern::invalid_entry.
+   */
+  std::vector<std::size_t> matrix_direct;
+
+  /**
+   * Matrix scatter information for constrained cells.
+   */
+  std::vector<Entry> matrix_constrained;
+
+  /**
+   * Vector indices for unconstrained cells, i.e., the local dof indices.
+   */
+  std::vector<size_type> vector_direct;
+
+  /**
+   * Vector scatter information for constrained cells.
+   */
+  std::vector<Entry> vector_constrained;
+
+  /**
+   * Contributions of cell matrix entries to the global vector due to
+   * inhomogeneous constraints.
+   */
+  std::vector<Entry> rhs_from_matrix;
+
+  /**
+   * Diagonal entries of constrained rows.
+   */
+  std::vector<DiagonalEntry> diagonal;
+};
+
+/*@}*/
+
+#ifndef DOXYGEN
+/*---------------------- Inline functions -----------------------------------*/
+
+
+template <typename number>
+inline unsigned int
+LocalToGlobalScatter<number>::n_cells() const
+{
+  return dofs_per_cell.size();
+}
+
+
+
+template <typename number>
+inline unsigned int
+LocalToGlobalScatter<number>::n_dofs_per_cell(const unsigned int cell) const
+{
+  AssertIndexRange(cell, n_cells());
+  return dofs_per_cell[cell];
+}
+
+
+
+template <typename number>
+inline bool
+LocalToGlobalScatter<number>::is_constrained(const unsigned int cell) const
+{
+  AssertIndexRange(cell, n_cells());
+  // every constrained degree of freedom of a cell gets a diagonal entry
+  return cell_offsets[cell + 1].diagonal > cell_offsets[cell].diagonal;
+}
+
+
+
+template <typename number>
+inline number *
+LocalToGlobalScatter<number>::get_matrix_values(
+  SparseMatrix<number> &global_matrix) const
+{
+  Assert(sparsity != nullptr, ExcNotInitialized());
+  Assert(&global_matrix.get_sparsity_pattern() == &*sparsity,
+         ExcDifferentSparsityPattern());
+  return global_matrix.val.get();
+}
+
+
+
+template <typename number>
+inline void
+LocalToGlobalScatter<number>::scatter_matrix(
+  const unsigned int        cell,
+  const FullMatrix<number> &local_matrix,
+  number *                  matrix_values) const
+{
+  const unsigned int n_dofs = dofs_per_cell[cell];
+  AssertDimension(local_matrix.m(), n_dofs);
+  AssertDimension(local_matrix.n(), n_dofs);
+  if (n_dofs == 0)
+    return;
+
+  const Offsets &begin       = cell_offsets[cell];
+  const Offsets &end         = cell_offsets[cell + 1];
+  const number * local_entry = &local_matrix(0, 0);
+
+  // cells without constraints: the positions are in the order of the cell
+  // matrix entries
+  const std::size_t *positions = matrix_direct.data() + begin.matrix_direct;
+  const std::size_t  n_direct  = end.matrix_direct - begin.matrix_direct;
+  for (std::size_t k = 0; k < n_direct; ++k)
+    if (positions[k] != SparsityPattern::invalid_entry)
+      matrix_values[positions[k]] += local_entry[k];
+
+  // cells with constraints: weighted contributions
+  for (std::size_t k = begin.matrix_constrained; k < end.matrix_constrained;
+       ++k)
+    {
+      const Entry &entry = matrix_constrained[k];
+      matrix_values[entry.destination] +=
+        entry.weight * local_entry[entry.source];
+    }
+
+  // diagonal entries of constrained rows, see
+  // internals::set_matrix_diagonals() in affine_constraints.templates.h
+  if (end.diagonal > begin.diagonal)
+    {
+      number average_diagonal = number();
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        average_diagonal += std::abs(local_matrix(i, i));
+      average_diagonal /= static_cast<number>(n_dofs);
+
+      for (std::size_t k = begin.diagonal; k < end.diagonal; ++k)
+        {
+          const unsigned int local_row = diagonal[k].local_row;
+          const number       local_diagonal =
+            std::abs(local_matrix(local_row, local_row));
+          matrix_values[diagonal[k].position] +=
+            (local_diagonal != number() ? local_diagonal : average_diagonal);
+        }
+    }
+}
+
+
+
+template <typename number>
+template <typename VectorType>
+inline void
+LocalToGlobalScatter<number>::scatter_matrix_and_vector(
+  const unsigned int        cell,
+  const FullMatrix<number> &local_matrix,
+  const Vector<number> &    local_vector,
+  number *                  matrix_values,
+  VectorType &              global_vector,
+  const bool                use_inhomogeneities_for_rhs) const
+{
+  scatter_matrix(cell, local_matrix, matrix_values);
+
+  AssertDimension(local_vector.size(), dofs_per_cell[cell]);
+  using VectorNumber = typename VectorType::value_type;
+
+  const Offsets &begin = cell_offsets[cell];
+  const Offsets &end   = cell_offsets[cell + 1];
+
+  for (std::size_t k = begin.vector_direct; k < end.vector_direct; ++k)
+    global_vector(vector_direct[k]) +=
+      static_cast<VectorNumber>(local_vector(k - begin.vector_direct));
+
+  for (std::size_t k = begin.vector_constrained; k < end.vector_constrained;
+       ++k)
+    {
+      const Entry &entry = vector_constrained[k];
+      global_vector(entry.destination) +=
+        static_cast<VectorNumber>(entry.weight * local_vector(entry.source));
+    }
+
+  if (end.rhs_from_matrix > begin.rhs_from_matrix)
+    {
+      const number *local_entry = &local_matrix(0, 0);
+      for (std::size_t k = begin.rhs_from_matrix; k < end.rhs_from_matrix; ++k)
+        {
+          const Entry &entry = rhs_from_matrix[k];
+          global_vector(entry.destination) +=
+            static_cast<VectorNumber>(entry.weight * local_entry[entry.source]);
+        }
+    }
+
+  if (use_inhomogeneities_for_rhs == true && end.diagonal > begin.diagonal)
+    {
+      // recompute the diagonal entries as in scatter_matrix()
+      number average_diagonal = number();
+      for (unsigned int i = 0; i < dofs_per_cell[cell]; ++i)
+        average_diagonal += std::abs(local_matrix(i, i));
+      average_diagonal /= static_cast<number>(dofs_per_cell[cell]);
+
+      for (std::size_t k = begin.diagonal; k < end.diagonal; ++k)
+        if (diagonal[k].inhomogeneity != number())
+          {
+            const number local_diagonal = std::abs(
+              local_matrix(diagonal[k].local_row, diagonal[k].local_row));
+            global_vector(diagonal[k].row) += static_cast<VectorNumber>(
+              (local_diagonal != number() ? local_diagonal : average_diagonal) *
+              diagonal[k].inhomogeneity);
+          }
+    }
+}
+
+
+
+template <typename number>
+template <typename VectorType>
+void
+LocalToGlobalScatter<number>::distribute_local_to_global(
+  const unsigned int        cell,
+  const FullMatrix<number> &local_matrix,
+  const Vector<number> &    local_vector,
+  SparseMatrix<number> &    global_matrix,
+  VectorType &              global_vector,
+  const bool                use_inhomogeneities_for_rhs) const
+{
+  AssertIndexRange(cell, n_cells());
+  scatter_matrix_and_vector(cell,
+                            local_matrix,
+                            local_vector,
+                            get_matrix_values(global_matrix),
+                            global_vector,
+                            use_inhomogeneities_for_rhs);
+}
+
+
+
+template <typename number>
+template <typename VectorType>
+void
+LocalToGlobalScatter<number>::distribute_local_to_global(
+  const unsigned int                        first_cell,
+  const ArrayView<const FullMatrix<number>> &local_matrices,
+  const ArrayView<const Vector<number>> &   local_vectors,
+  SparseMatrix<number> &                    global_matrix,
+  VectorType &                              global_vector,
+  const bool                                use_inhomogeneities_for_rhs) const
+{
+  AssertDimension(local_matrices.size(), local_vectors.size());
+  AssertIndexRange(first_cell + local_matrices.size(), n_cells() + 1);
+
+  number *matrix_values = get_matrix_values(global_matrix);
+  for (unsigned int c = 0; c < local_matrices.size(); ++c)
+    scatter_matrix_and_vector(first_cell + c,
+                              local_matrices[c],
+                              local_vectors[c],
+                              matrix_values,
+                              global_vector,
+                              use_inhomogeneities_for_rhs);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,655 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_multi_vector_h
+#define dealii_multi_vector_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+// forward declarations
+template <typename number>
+class SparseMatrix;
+
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename, typename>
+    class Vector;
+  } // namespace distributed
+} // namespace LinearAlgebra
+
+
+/*! @addtogroup Vectors
+ *@{
+ */
+
+/**
+ * A collection of vectors of the same size and layout, e.g., the solutions
+ * or the right hand sides of a linear system with several right hand sides.
+ * The vectors are often called the columns of the multivector, as in the
+ * matrix whose columns are the vectors.
+ *
+ * Besides the access to the individual vectors, the class provides the
+ * operations between multivectors that appear in block Krylov methods like
+ * SolverBlockCG and SolverBlockGMRES: the matrix of all inner products
+ * between the vectors of two multivectors, see Tmmult(), and linear
+ * combinations of all vectors with the coefficients given by a matrix, see
+ * mmult(). For VectorType equal to Vector<Number> or
+ * LinearAlgebra::distributed::Vector<Number>, these operations go through
+ * the vector entries only once for all vectors, instead of once for each
+ * pair of vectors, and run in parallel on several threads. For distributed
+ * vectors, all inner products are summed over the MPI processes in a single
+ * reduction.
+ *
+ * Operators act on multivectors through a function
+ * <tt>vmult(MultiVector<VectorType> &, const MultiVector<VectorType> &)</tt>.
+ * SparseMatrix provides such a function, which reads the matrix only once
+ * for all columns. For other operators, e.g., LinearOperator objects,
+ * preconditioners, or matrix-free operators, the solvers apply the operator
+ * to each column in turn, see
+ * internal::MultiVectorImplementation::vmult().
+ */
+template <typename VectorType>
+class MultiVector : public Subscriptor
+{
+public:
+  /**
+   * Declare standard types used in all containers.
+   */
+  using value_type = typename VectorType::value_type;
+  using real_type  = typename numbers::NumberTraits<value_type>::real_type;
+  using size_type  = types::global_dof_index;
+
+  /**
+   * Constructor. Creates a multivector without any vectors.
+   */
+  MultiVector() = default;
+
+  /**
+   * Constructor. Creates @p n_vectors vectors with the same layout as
+   * @p model, with all entries set to zero.
+   */
+  MultiVector(const unsigned int n_vectors, const VectorType &model);
+
+  /**
+   * Resize to @p n_vectors vectors with the same layout as @p model. The
+   * entries are set to zero unless @p omit_zeroing_entries is true.
+   */
+  void
+  reinit(const unsigned int n_vectors,
+         const VectorType & model,
+         const bool         omit_zeroing_entries = false);
+
+  /**
+   * Resize to the same number of vectors and the same layout as @p other.
+   * The entries are set to zero unless @p omit_zeroing_entries is true.
+   */
+  void
+  reinit(const MultiVector<VectorType> &other,
+         const bool                     omit_zeroing_entries = false);
+
+  /**
+   * Keep only the vectors with the given @p indices, in the order given,
+   * and drop all others. The vectors are moved, not copied.
+   */
+  void
+  select_vectors(const std::vector<unsigned int> &indices);
+
+  /**
+   * Swap the contents of this multivector and @p other.
+   */
+  void
+  swap(MultiVector<VectorType> &other);
+
+  /**
+   * Set all entries of all vectors to @p s.
+   */
+  MultiVector<VectorType> &
+  operator=(const value_type s);
+
+  /**
+   * Return the number of vectors.
+   */
+  unsigned int
+  n_vectors() const;
+
+  /**
+   * Return the size of each of the vectors.
+   */
+  size_type
+  size() const;
+
+  /**
+   * Access to the vector with the given index.
+   */
+  VectorType &operator[](const unsigned int index);
+
+  /**
+   * Read access to the vector with the given index.
+   */
+  const VectorType &operator[](const unsigned int index) const;
+
+  /**
+   * Compute the matrix of inner products $C = V^T W$ of the vectors of this
+   * object, $V$, and the vectors of @p W, i.e., $C_{ij} = v_i \cdot w_j$.
+   * The matrix @p C is resized to n_vectors() times <tt>W.n_vectors()</tt>,
+   * which is an empty matrix if either of the multivectors has no vectors.
+   */
+  void
+  Tmmult(FullMatrix<value_type> &C, const MultiVector<VectorType> &W) const;
+
+  /**
+   * Compute the linear combinations $D = V C$ of the vectors of this
+   * object, $V$, i.e., $d_j = \sum_i C_{ij} v_i$, and store them in @p D, or
+   * add them to @p D if @p adding is true. The multivector @p D must have
+   * as many vectors as @p C has columns, and must not be this object. If
+   * this object or @p D has no vectors, the sum is empty and @p C is not
+   * accessed.
+   */
+  void
+  mmult(MultiVector<VectorType> &     D,
+        const FullMatrix<value_type> &C,
+        const bool                    adding = false) const;
+
+  /**
+   * Compute the $l_2$ norm of each vector and store it in @p norms.
+   */
+  void
+  l2_norms(std::vector<real_type> &norms) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * The vectors.
+   */
+  std::vector<VectorType> vectors;
+};
+
+/*@}*/
+
+
+namespace internal
+{
+  namespace MultiVectorImplementation
+  {
+    /**
+     * Compute the inner products of all pairs of vectors one after the
+     * other.
+     */
+    template <typename VectorType>
+    void
+    Tmmult(FullMatrix<typename VectorType::value_type> &C,
+           const std::vector<VectorType> &              V,
+           const std::vector<VectorType> &              W)
+    {
+      for (unsigned int i = 0; i < V.size(); ++i)
+        for (unsigned int j = 0; j < W.size(); ++j)
+          C(i, j) = V[i] * W[j];
+    }
+
+
+
+    /**
+     * Compute the inner products of all pairs of vectors in one pass over
+     * the first @p n entries of the vectors, which must provide pointer
+     * access through <tt>begin()</tt>. As in
+     * internal::VectorOperations::parallel_reduce(), the entries are split
+     * into about four chunks per thread. Each chunk accumulates its
+     * contribution in one matrix, and the matrices of the chunks are added
+     * pairwise.
+     */
+    template <typename VectorType>
+    void
+    Tmmult_local(FullMatrix<typename VectorType::value_type> &C,
+                 const std::vector<VectorType> &              V,
+                 const std::vector<VectorType> &              W,
+                 const types::global_dof_index                n)
+    {
+      using Number    = typename VectorType::value_type;
+      using size_type = types::global_dof_index;
+
+      // the entries of all vectors within a block stay in cache while the
+      // block is processed
+      const size_type block_size = 512;
+      const size_type n_blocks   = (n + block_size - 1) / block_size;
+      const size_type n_chunks   = std::max<size_type>(
+        1,
+        std::min<size_type>(
+          4 * MultithreadInfo::n_threads(),
+          n / internal::VectorImplementation::minimum_parallel_grain_size));
+      const size_type blocks_per_chunk = (n_blocks + n_chunks - 1) / n_chunks;
+
+      std::vector<FullMatrix<Number>> chunk_sums(
+        n_chunks, FullMatrix<Number>(V.size(), W.size()));
+      parallel::apply_to_subranges(
+        size_type(0),
+        n_chunks,
+        [&](const size_type chunk_begin, const size_type chunk_end) {
+          for (size_type chunk = chunk_begin; chunk < chunk_end; ++chunk)
+            for (size_type block = chunk * blocks_per_chunk;
+                 block < std::min(n_blocks, (chunk + 1) * blocks_per_chunk);
+                 ++block)
+              {
+                const size_type begin = block * block_size;
+                const size_type end   = std::min(n, begin + block_size);
+                for (unsigned int i = 0; i < V.size(); ++i)
+                  for (unsigned int j = 0; j < W.size(); ++j)
+                    {
+                      const Number *v   = V[i].begin();
+                      const Number *w   = W[j].begin();
+                      Number        sum = Number();
+                      for (size_type k = begin; k < end; ++k)
+                        sum += v[k] *
+                               numbers::NumberTraits<Number>::conjugate(w[k]);
+                      chunk_sums[chunk](i, j) += sum;
+                    }
+              }
+        },
+        1);
+
+      for (size_type stride = 1; stride < n_chunks; stride *= 2)
+        for (size_type chunk = 0; chunk + stride < n_chunks;
+             chunk += 2 * stride)
+          chunk_sums[chunk].add(Number(1.), chunk_sums[chunk + stride]);
+      C = chunk_sums[0];
+    }
+
+
+
+    /**
+     * Compute the inner products of all pairs of vectors in one pass over
+     * the entries.
+     */
+    template <typename Number>
+    void
+    Tmmult(FullMatrix<Number> &               C,
+           const std::vector<Vector<Number>> &V,
+           const std::vector<Vector<Number>> &W)
+    {
+      Tmmult_local(C, V, W, V.empty() ? 0 : V[0].size());
+    }
+
+
+
+    /**
+     * Compute the inner products of all pairs of vectors in one pass over
+     * the locally owned entries, followed by a single MPI reduction of the
+     * whole matrix.
+     */
+    template <typename Number>
+    void
+    Tmmult(
+      FullMatrix<Number> &C,
+      const std::vector<LinearAlgebra::distributed::Vector<Number,
+                                                           MemorySpace::Host>>
+        &V,
+      const std::vector<LinearAlgebra::distributed::Vector<Number,
+                                                           MemorySpace::Host>>
+        &W)
+    {
+      if (V.empty())
+        return;
+
+      Tmmult_local(C, V, W, V[0].local_size());
+      if (C.m() * C.n() > 0)
+        Utilities::MPI::sum(ArrayView<const Number>(&C(0, 0), C.m() * C.n()),
+                            V[0].get_mpi_communicator(),
+                            ArrayView<Number>(&C(0, 0), C.m() * C.n()));
+    }
+
+
+
+    /**
+     * Compute the linear combinations of the vectors with one vector
+     * operation for each pair of vectors.
+     */
+    template <typename VectorType>
+    void
+    mmult(std::vector<VectorType> &                          D,
+          const std::vector<VectorType> &                    V,
+          const FullMatrix<typename VectorType::value_type> &C,
+          const bool                                         adding)
+    {
+      for (unsigned int j = 0; j < D.size(); ++j)
+        {
+          if (!adding)
+            D[j] = typename VectorType::value_type();
+          for (unsigned int i = 0; i < V.size(); ++i)
+            if (C(i, j) != typename VectorType::value_type())
+              D[j].add(C(i, j), V[i]);
+        }
+    }
+
+
+
+    /**
+     * Compute the linear combinations of the vectors in one pass over the
+     * first @p n entries of the vectors, which must provide pointer access
+     * through <tt>begin()</tt>.
+     */
+    template <typename VectorType>
+    void
+    mmult_local(std::vector<VectorType> &                          D,
+                const std::vector<VectorType> &                    V,
+                const FullMatrix<typename VectorType::value_type> &C,
+                const bool                                         adding,
+                const types::global_dof_index                      n)
+    {
+      using Number    = typename VectorType::value_type;
+      using size_type = types::global_dof_index;
+
+      const size_type chunk_size = 512;
+      const size_type n_chunks   = (n + chunk_size - 1) / chunk_size;
+
+      parallel::apply_to_subranges(
+        size_type(0),
+        n_chunks,
+        [&](const size_type chunk_begin, const size_type chunk_end) {
+          for (size_type chunk = chunk_begin; chunk < chunk_end; ++chunk)
+            {
+              const size_type begin = chunk * chunk_size;
+              const size_type end   = std::min(n, begin + chunk_size);
+              for (unsigned int j = 0; j < D.size(); ++j)
+                {
+                  Number *d = D[j].begin();
+                  if (!adding)
+                    std::fill(d + begin, d + end, Number());
+                  for (unsigned int i = 0; i < V.size(); ++i)
+                    {
+                      const Number  c = C(i, j);
+                      const Number *v = V[i].begin();
+                      for (size_type k = begin; k < end; ++k)
+                        d[k] += c * v[k];
+                    }
+                }
+            }
+        },
+        16);
+    }
+
+
+
+    /**
+     * Compute the linear combinations of the vectors in one pass over the
+     * entries.
+     */
+    template <typename Number>
+    void
+    mmult(std::vector<Vector<Number>> &      D,
+          const std::vector<Vector<Number>> &V,
+          const FullMatrix<Number> &         C,
+          const bool                         adding)
+    {
+      mmult_local(D, V, C, adding, D.empty() ? 0 : D[0].size());
+    }
+
+
+
+    /**
+     * Compute the linear combinations of the vectors in one pass over the
+     * locally owned entries. No communication is necessary.
+     */
+    template <typename Number>
+    void
+    mmult(
+      std::vector<LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+        &D,
+      const std::vector<LinearAlgebra::distributed::Vector<Number,
+                                                           MemorySpace::Host>>
+        &                       V,
+      const FullMatrix<Number> &C,
+      const bool                adding)
+    {
+      mmult_local(D, V, C, adding, D.empty() ? 0 : D[0].local_size());
+    }
+
+
+
+    /**
+     * Apply the operator @p A to each of the vectors of @p src in turn. This
+     * is the fallback for all operators that do not read their data only
+     * once for all vectors, like LinearOperator, the preconditioners, and the
+     * matrix-free operators.
+     */
+    template <typename MatrixType, typename VectorType>
+    void
+    vmult(const MatrixType &             A,
+          MultiVector<VectorType> &      dst,
+          const MultiVector<VectorType> &src)
+    {
+      AssertDimension(dst.n_vectors(), src.n_vectors());
+      for (unsigned int i = 0; i < src.n_vectors(); ++i)
+        A.vmult(dst[i], src[i]);
+    }
+
+
+
+    /**
+     * Apply a SparseMatrix to all vectors of @p src at once, reading the
+     * matrix only once.
+     */
+    template <typename number, typename number2>
+    void
+    vmult(const SparseMatrix<number> &        A,
+          MultiVector<Vector<number2>> &      dst,
+          const MultiVector<Vector<number2>> &src)
+    {
+      A.vmult(dst, src);
+    }
+  } // namespace MultiVectorImplementation
+} // namespace internal
+
+
+/*--------------------------- Inline functions ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename VectorType>
+inline MultiVector<VectorType>::MultiVector(const unsigned int n_vectors,
+                                            const VectorType & model)
+{
+  reinit(n_vectors, model);
+}
+
+
+
+template <typename VectorType>
+inline void
+MultiVector<VectorType>::reinit(const unsigned int n_vectors,
+                                const VectorType & model,
+                                const bool         omit_zeroing_entries)
+{
+  vectors.resize(n_vectors);
+  for (VectorType &vector : vectors)
+    vector.reinit(model, omit_zeroing_entries);
+}
+
+
+
+template <typename VectorType>
+inline void
+MultiVector<VectorType>::reinit(const MultiVector<VectorType> &other,
+                                const bool omit_zeroing_entries)
+{
+  Assert(other.n_vectors() > 0,
+         ExcMessage("The multivector to take the layout from is empty."));
+  reinit(other.n_vectors(), other[0], omit_zeroing_entries);
+}
+
+
+
+template <typename VectorType>
+inline void
+MultiVector<VectorType>::select_vectors(
+  const std::vector<unsigned int> &indices)
+{
+  std::vector<VectorType> selected(indices.size());
+  for (unsigned int i = 0; i < indices.size(); ++i)
+    {
+      AssertIndexRange(indices[i], vectors.size());
+      selected[i].swap(vectors[indices[i]]);
+    }
+  vectors.swap(selected);
+}
+
+
+
+template <typename VectorType>
+inline void
+MultiVector<VectorType>::swap(MultiVector<VectorType> &other)
+{
+  vectors.swap(other.vectors);
+}
+
+
+
+template <typename VectorType>
+inline MultiVector<VectorType> &
+MultiVector<VectorType>::operator=(const value_type s)
+{
+  for (VectorType &vector : vectors)
+    vector = s;
+  return *this;
+}
+
+
+
+template <typename VectorType>
+inline unsigned int
+MultiVector<VectorType>::n_vectors() const
+{
+  return vectors.size();
+}
+
+
+
+template <typename VectorType>
+inline typename MultiVector<VectorType>::size_type
+MultiVector<VectorType>::size() const
+{
+  return (vectors.empty() ? 0 : vectors[0].size());
+}
+
+
+
+template <typename VectorType>
+inline VectorType &MultiVector<VectorType>::operator[](const unsigned int index)
+{
+  AssertIndexRange(index, vectors.size());
+  return vectors[index];
+}
+
+
+
+template <typename VectorType>
+inline const VectorType &MultiVector<VectorType>::
+                         operator[](const unsigned int index) const
+{
+  AssertIndexRange(index, vectors.size());
+  return vectors[index];
+}
+
+
+
+template <typename VectorType>
+inline void
+MultiVector<VectorType>::Tmmult(FullMatrix<value_type> &       C,
+                                const MultiVector<VectorType> &W) const
+{
+  C.reinit(n_vectors(), W.n_vectors());
+  if (n_vectors() == 0 || W.n_vectors() == 0)
+    return;
+
+  for (unsigned int j = 0; j < W.n_vectors(); ++j)
+    AssertDimension(W[j].size(), size());
+  internal::MultiVectorImplementation::Tmmult(C, vectors, W.vectors);
+}
+
+
+
+template <typename VectorType>
+inline void
+MultiVector<VectorType>::mmult(MultiVector<VectorType> &     D,
+                               const FullMatrix<value_type> &C,
+                               const bool                    adding) const
+{
+  Assert(&D != this, ExcMessage("The result must not be this multivector."));
+
+  // a FullMatrix with zero rows or columns is stored as a 0x0 matrix, so
+  // the dimensions of C can only be checked if both multivectors have
+  // vectors
+  if (n_vectors() == 0 || D.n_vectors() == 0)
+    {
+      if (!adding)
+        D = value_type();
+      return;
+    }
+
+  AssertDimension(C.m(), n_vectors());
+  AssertDimension(C.n(), D.n_vectors());
+  for (unsigned int j = 0; j < D.n_vectors(); ++j)
+    AssertDimension(D[j].size(), size());
+  internal::MultiVectorImplementation::mmult(D.vectors, vectors, C, adding);
+}
+
+
+
+template <typename VectorType>
+inline void
+MultiVector<VectorType>::l2_norms(std::vector<real_type> &norms) const
+{
+  norms.resize(vectors.size());
+  for (unsigned int i = 0; i < vectors.size(); ++i)
+    norms[i] = vectors[i].l2_norm();
+}
+
+
+
+template <typename VectorType>
+inline std::size_t
+MultiVector<VectorType>::memory_consumption() const
+{
+  return sizeof(*this) + MemoryConsumption::memory_consumption(vectors);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
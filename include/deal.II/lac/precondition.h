@@ -28,7 +28,9 @@
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector_expressions.h>
 #include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/sparse_level_schedule.h>
 #include <deal.II/lac/vector_memory.h>
 
 DEAL_II_NAMESPACE_OPEN
@@ -569,6 +571,11 @@ public:
  * class satisfies the
  * @ref ConceptRelaxationType "relaxation concept".
  *
+ * If the matrix is a SparseMatrix and the vectors are of type Vector, vmult()
+ * and Tvmult() process the rows that do not depend on each other in parallel,
+ * see SparseLevelSchedule. The result is the same as the one of the
+ * sequential sweep.
+ *
  * @code
  * // Declare related objects
  *
@@ -600,6 +607,21 @@ public:
   using AdditionalData =
     typename PreconditionRelaxation<MatrixType>::AdditionalData;
 
+  /**
+   * An alias to the base class.
+   */
+  using BaseClass = PreconditionRelaxation<MatrixType>;
+
+  /**
+   * Initialize matrix and relaxation parameter. The matrix is just stored in
+   * the preconditioner object. If the matrix is a SparseMatrix, the level
+   * schedule of its sparsity pattern is computed as well.
+   */
+  void
+  initialize(const MatrixType &                        A,
+             const typename BaseClass::AdditionalData &parameters =
+               typename BaseClass::AdditionalData());
+
   /**
    * Apply preconditioner.
    */
@@ -627,6 +649,13 @@ public:
   template <class VectorType>
   void
   Tstep(VectorType &x, const VectorType &rhs) const;
+
+private:
+  /**
+   * The levels of the forward and the backward sweep if the matrix is a
+   * SparseMatrix, and an empty schedule otherwise.
+   */
+  SparseLevelSchedule level_schedule;
 };
 
 
@@ -638,6 +667,10 @@ public:
  * class satisfies the
  * @ref ConceptRelaxationType "relaxation concept".
  *
+ * As for PreconditionSOR, vmult() and Tvmult() process independent rows in
+ * parallel if the matrix is a SparseMatrix and the vectors are of type
+ * Vector.
+ *
  * @code
  * // Declare related objects
  *
@@ -726,6 +759,12 @@ private:
    * the diagonal is located.
    */
   std::vector<std::size_t> pos_right_of_diagonal;
+
+  /**
+   * The levels of the forward and the backward sweep if the matrix is a
+   * SparseMatrix, and an empty schedule otherwise.
+   */
+  SparseLevelSchedule level_schedule;
 };
 
 
@@ -930,6 +969,43 @@ private:
  * }
  * @endcode
  *
+ * <h4>Fourth-kind Chebyshev polynomials</h4>
+ *
+ * The classical Chebyshev polynomials of the first kind need a lower bound of
+ * the eigenvalue range they act on, which for multigrid smoothers is set via
+ * the smoothing range and must be tuned per problem. As an alternative,
+ * AdditionalData::polynomial_type can select the Chebyshev polynomials of the
+ * fourth kind, which only need an estimate of the largest eigenvalue and are
+ * designed to minimize a bound for the error of the multigrid V-cycle, see
+ * J. Lottes, "Optimal polynomial smoothers for multigrid V-cycles", Numer.
+ * Linear Algebra Appl. (2023), and M. Phillips and P. Fischer, "Optimal
+ * Chebyshev smoothers and one-sided V-cycles" (2022). The variant
+ * AdditionalData::PolynomialType::fourth_kind_optimal adds the weights that
+ * Lottes obtained by minimizing this bound over all polynomials of the given
+ * degree, which reduces the bound by another 10 to 20 percent. For these
+ * polynomials, the smoothing range is ignored and the number of steps is the
+ * degree plus one, i.e., vmult() performs as many matrix-vector products as
+ * for the first kind. These variants need one additional auxiliary vector.
+ *
+ * <h4>Eigenvalue estimates</h4>
+ *
+ * Besides the Lanczos estimate via SolverCG, the largest eigenvalue can be
+ * estimated by a power iteration by setting
+ * AdditionalData::eigenvalue_algorithm, which is cheaper per iteration but
+ * does not give a lower bound. The estimates obtained in the last call to
+ * vmult() or step() can be queried through get_eigenvalue_information(),
+ * e.g. for logging.
+ *
+ * When the matrix is re-initialized, e.g. in a multigrid method whose level
+ * matrices are rebuilt in every Newton step, the estimate of the previous
+ * initialization can be reused if
+ * AdditionalData::eigenvalue_reuse_tolerance is positive. In that case, a
+ * few steps of a power iteration that continue from the iteration vector of
+ * the previous check are run instead of the full estimation, and the old
+ * estimate is kept if the two estimates of the largest eigenvalue deviate by
+ * less than the given relative tolerance. Otherwise, the eigenvalues are
+ * estimated anew.
+ *
  * <h4>Requirements on the templated classes</h4>
  *
  * The class MatrixType must be derived from Subscriptor because a
@@ -973,15 +1049,59 @@ public:
    */
   struct AdditionalData
   {
+    /**
+     * Type of the Chebyshev polynomial.
+     */
+    enum class PolynomialType
+    {
+      /**
+       * Chebyshev polynomials of the first kind acting on the interval given
+       * by the estimated eigenvalues and the smoothing range.
+       */
+      first_kind,
+      /**
+       * Chebyshev polynomials of the fourth kind, which only depend on the
+       * largest eigenvalue.
+       */
+      fourth_kind,
+      /**
+       * Chebyshev polynomials of the fourth kind with the optimized weights
+       * by Lottes. Supports degrees up to 15.
+       */
+      fourth_kind_optimal
+    };
+
+    /**
+     * Algorithm used to estimate the eigenvalues of the preconditioned
+     * matrix.
+     */
+    enum class EigenvalueAlgorithm
+    {
+      /**
+       * Estimate the eigenvalues from the Lanczos matrix of a CG iteration,
+       * giving the smallest and the largest eigenvalue.
+       */
+      lanczos,
+      /**
+       * Estimate the largest eigenvalue by a power iteration, which is
+       * simpler than CG but gives no estimate of the smallest eigenvalue.
+       */
+      power_iteration
+    };
+
     /**
      * Constructor.
      */
-    AdditionalData(const unsigned int degree              = 0,
-                   const double       smoothing_range     = 0.,
-                   const bool         nonzero_starting    = false,
-                   const unsigned int eig_cg_n_iterations = 8,
-                   const double       eig_cg_residual     = 1e-2,
-                   const double       max_eigenvalue      = 1);
+    AdditionalData(const unsigned int        degree              = 0,
+                   const double              smoothing_range     = 0.,
+                   const bool                nonzero_starting    = false,
+                   const unsigned int        eig_cg_n_iterations = 8,
+                   const double              eig_cg_residual     = 1e-2,
+                   const double              max_eigenvalue      = 1,
+                   const PolynomialType      polynomial_type =
+                     PolynomialType::first_kind,
+                   const EigenvalueAlgorithm eigenvalue_algorithm =
+                     EigenvalueAlgorithm::lanczos);
 
     /**
      * This determines the degree of the Chebyshev polynomial. The degree of
@@ -1043,6 +1163,36 @@ public:
      */
     double max_eigenvalue;
 
+    /**
+     * The type of the Chebyshev polynomial, see the discussion in the main
+     * class.
+     */
+    PolynomialType polynomial_type;
+
+    /**
+     * The algorithm used for estimating the eigenvalues. The number of
+     * iterations is set by @p eig_cg_n_iterations in both cases. The power
+     * iteration only estimates the largest eigenvalue and therefore needs a
+     * smoothing range larger than one or one of the fourth-kind polynomials.
+     */
+    EigenvalueAlgorithm eigenvalue_algorithm;
+
+    /**
+     * If positive, the eigenvalue estimates from a previous initialization
+     * are reused when a check with @p eigenvalue_check_n_iterations steps of
+     * a power iteration gives a largest eigenvalue that differs from the
+     * previous estimate by less than this relative tolerance. Zero, the
+     * default, estimates the eigenvalues anew after each call to
+     * initialize().
+     */
+    double eigenvalue_reuse_tolerance;
+
+    /**
+     * Number of power iteration steps for checking whether the eigenvalue
+     * estimates of a previous initialization can be reused.
+     */
+    unsigned int eigenvalue_check_n_iterations;
+
     /**
      * Stores the inverse of the diagonal of the underlying matrix.
      *
@@ -1057,6 +1207,46 @@ public:
   };
 
 
+  /**
+   * Information about the eigenvalue estimation used by the preconditioner.
+   */
+  struct EigenvalueInformation
+  {
+    /**
+     * Constructor, setting all estimates to zero.
+     */
+    EigenvalueInformation();
+
+    /**
+     * The estimate of the smallest eigenvalue, or zero if the algorithm does
+     * not provide it.
+     */
+    double min_eigenvalue_estimate;
+
+    /**
+     * The estimate of the largest eigenvalue, before the safety factor is
+     * applied.
+     */
+    double max_eigenvalue_estimate;
+
+    /**
+     * The number of matrix-vector products spent in the last estimation,
+     * including the check for the reuse of a previous estimate.
+     */
+    unsigned int n_iterations;
+
+    /**
+     * The degree of the polynomial, which can differ from the one given in
+     * AdditionalData if the degree is determined automatically.
+     */
+    unsigned int degree;
+
+    /**
+     * Whether the estimate of a previous initialization has been reused.
+     */
+    bool reused_previous_estimate;
+  };
+
   PreconditionChebyshev();
 
   /**
@@ -1069,6 +1259,9 @@ public:
    * This function calculates an estimate of the eigenvalue range of the
    * matrix weighted by its diagonal using a modified CG iteration in case the
    * given number of iterations is positive.
+   *
+   * Eigenvalue estimates of a previous initialization are kept and can be
+   * reused according to AdditionalData::eigenvalue_reuse_tolerance.
    */
   void
   initialize(const MatrixType &    matrix,
@@ -1101,11 +1294,21 @@ public:
   Tstep(VectorType &dst, const VectorType &src) const;
 
   /**
-   * Resets the preconditioner.
+   * Resets the preconditioner, including the eigenvalue estimates kept for
+   * reuse.
    */
   void
   clear();
 
+  /**
+   * Return information about the eigenvalue estimates used by the
+   * preconditioner. The estimates are computed in the first call to vmult(),
+   * Tvmult(), step() or Tstep() after initialize(), so the result is only
+   * meaningful after one of these calls.
+   */
+  const EigenvalueInformation &
+  get_eigenvalue_information() const;
+
   /**
    * Return the dimension of the codomain (or range) space. Note that the
    * matrix is of dimension $m \times n$.
@@ -1144,6 +1347,17 @@ private:
    */
   mutable VectorType update3;
 
+  /**
+   * The iteration vector of the power iteration, kept as starting vector for
+   * the check whether eigenvalue estimates can be reused.
+   */
+  mutable VectorType eigenvector_estimate;
+
+  /**
+   * The eigenvalue estimates, kept between initializations.
+   */
+  mutable EigenvalueInformation eigenvalue_information;
+
   /**
    * Stores the additional data passed to the initialize function, obtained
    * through a copy operation.
@@ -1189,6 +1403,25 @@ private:
   void
   do_transpose_chebyshev_loop(VectorType &dst, const VectorType &src) const;
 
+  /**
+   * Apply the fourth-kind Chebyshev polynomial, starting either from a zero
+   * vector @p dst or from its current content, with the matrix or its
+   * transpose.
+   */
+  void
+  do_fourth_kind_loop(VectorType &      dst,
+                      const VectorType &src,
+                      const bool        start_zero,
+                      const bool        transpose) const;
+
+  /**
+   * Run @p n_iterations steps of a power iteration for the preconditioned
+   * matrix, continuing from the vector #eigenvector_estimate, and return the
+   * estimate of the largest eigenvalue.
+   */
+  double
+  power_iteration(const VectorType &src, const unsigned int n_iterations) const;
+
   /**
    * Initializes the factors theta and delta based on an eigenvalue
    * computation. If the user set provided values for the largest eigenvalue
@@ -1476,6 +1709,129 @@ PreconditionJacobi<MatrixType>::Tstep(VectorType &      dst,
 
 //---------------------------------------------------------------------------
 
+namespace internal
+{
+  namespace PreconditionRelaxationImplementation
+  {
+    // The SOR and SSOR sweeps for general matrices, which ignore the level
+    // schedule
+    template <typename MatrixType, typename VectorType>
+    inline void
+    precondition_SOR(const MatrixType &A,
+                     VectorType &      dst,
+                     const VectorType &src,
+                     const double      omega,
+                     const SparseLevelSchedule &)
+    {
+      A.precondition_SOR(dst, src, omega);
+    }
+
+
+
+    template <typename MatrixType, typename VectorType>
+    inline void
+    precondition_TSOR(const MatrixType &A,
+                      VectorType &      dst,
+                      const VectorType &src,
+                      const double      omega,
+                      const SparseLevelSchedule &)
+    {
+      A.precondition_TSOR(dst, src, omega);
+    }
+
+
+
+    template <typename MatrixType, typename VectorType>
+    inline void
+    precondition_SSOR(const MatrixType &              A,
+                      VectorType &                    dst,
+                      const VectorType &              src,
+                      const double                    omega,
+                      const std::vector<std::size_t> &pos_right_of_diagonal,
+                      const SparseLevelSchedule &)
+    {
+      A.precondition_SSOR(dst, src, omega, pos_right_of_diagonal);
+    }
+
+
+
+    // The sweeps for a SparseMatrix, which process the rows of each level
+    // of the schedule in parallel
+    template <typename number, typename somenumber>
+    inline void
+    precondition_SOR(const SparseMatrix<number> &A,
+                     Vector<somenumber> &        dst,
+                     const Vector<somenumber> &  src,
+                     const double                omega,
+                     const SparseLevelSchedule & level_schedule)
+    {
+      if (level_schedule.n_rows() == A.m())
+        A.precondition_SOR(dst, src, omega, level_schedule);
+      else
+        A.precondition_SOR(dst, src, omega);
+    }
+
+
+
+    template <typename number, typename somenumber>
+    inline void
+    precondition_TSOR(const SparseMatrix<number> &A,
+                      Vector<somenumber> &        dst,
+                      const Vector<somenumber> &  src,
+                      const double                omega,
+                      const SparseLevelSchedule & level_schedule)
+    {
+      if (level_schedule.n_rows() == A.m())
+        A.precondition_TSOR(dst, src, omega, level_schedule);
+      else
+        A.precondition_TSOR(dst, src, omega);
+    }
+
+
+
+    template <typename number, typename somenumber>
+    inline void
+    precondition_SSOR(const SparseMatrix<number> &    A,
+                      Vector<somenumber> &            dst,
+                      const Vector<somenumber> &      src,
+                      const double                    omega,
+                      const std::vector<std::size_t> &pos_right_of_diagonal,
+                      const SparseLevelSchedule &     level_schedule)
+    {
+      if (level_schedule.n_rows() == A.m() &&
+          pos_right_of_diagonal.size() == A.m())
+        A.precondition_SSOR(
+          dst, src, omega, pos_right_of_diagonal, level_schedule);
+      else
+        A.precondition_SSOR(dst, src, omega, pos_right_of_diagonal);
+    }
+  } // namespace PreconditionRelaxationImplementation
+} // namespace internal
+
+
+
+template <typename MatrixType>
+inline void
+PreconditionSOR<MatrixType>::initialize(
+  const MatrixType &                        rA,
+  const typename BaseClass::AdditionalData &parameters)
+{
+  this->PreconditionRelaxation<MatrixType>::initialize(rA, parameters);
+
+  // in case we have a SparseMatrix class, we can compute the levels of the
+  // sweeps
+  const SparseMatrix<typename MatrixType::value_type> *mat =
+    dynamic_cast<const SparseMatrix<typename MatrixType::value_type> *>(
+      &*this->A);
+
+  if (mat != nullptr)
+    level_schedule.initialize(mat->get_sparsity_pattern());
+  else
+    level_schedule.clear();
+}
+
+
+
 template <typename MatrixType>
 template <class VectorType>
 inline void
@@ -1486,7 +1842,8 @@ PreconditionSOR<MatrixType>::vmult(VectorType &dst, const VectorType &src) const
                 "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_SOR(dst, src, this->relaxation);
+  internal::PreconditionRelaxationImplementation::precondition_SOR(
+    *this->A, dst, src, this->relaxation, level_schedule);
 }
 
 
@@ -1502,7 +1859,8 @@ PreconditionSOR<MatrixType>::Tvmult(VectorType &      dst,
                 "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_TSOR(dst, src, this->relaxation);
+  internal::PreconditionRelaxationImplementation::precondition_TSOR(
+    *this->A, dst, src, this->relaxation, level_schedule);
 }
 
 
@@ -1571,7 +1929,10 @@ PreconditionSSOR<MatrixType>::initialize(
               break;
           pos_right_of_diagonal[row] = it - mat->begin();
         }
+      level_schedule.initialize(mat->get_sparsity_pattern());
     }
+  else
+    level_schedule.clear();
 }
 
 
@@ -1587,7 +1948,13 @@ PreconditionSSOR<MatrixType>::vmult(VectorType &      dst,
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR(dst, src, this->relaxation, pos_right_of_diagonal);
+  internal::PreconditionRelaxationImplementation::precondition_SSOR(
+    *this->A,
+    dst,
+    src,
+    this->relaxation,
+    pos_right_of_diagonal,
+    level_schedule);
 }
 
 
@@ -1604,7 +1971,13 @@ PreconditionSSOR<MatrixType>::Tvmult(VectorType &      dst,
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR(dst, src, this->relaxation, pos_right_of_diagonal);
+  internal::PreconditionRelaxationImplementation::precondition_SSOR(
+    *this->A,
+    dst,
+    src,
+    this->relaxation,
+    pos_right_of_diagonal,
+    level_schedule);
 }
 
 
@@ -1915,30 +2288,48 @@ namespace internal
       VectorUpdatesRange<Number>(upd, src.size());
     }
 
-    // selection for diagonal matrix around parallel deal.II vector
-    template <typename Number, typename MemorySpace>
+    // selection for diagonal matrix around parallel deal.II vector. Here, we
+    // express the updates as vector expressions, which update both vectors
+    // in a single pass and use the thread partitioning of the vectors
+    template <typename Number>
     inline void
     vector_updates(
-      const LinearAlgebra::distributed::Vector<Number, MemorySpace> &src,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &src,
       const DiagonalMatrix<
-        LinearAlgebra::distributed::Vector<Number, MemorySpace>> &jacobi,
-      const bool                                                  start_zero,
-      const double                                                factor1,
-      const double                                                factor2,
-      LinearAlgebra::distributed::Vector<Number, MemorySpace> &   update1,
-      LinearAlgebra::distributed::Vector<Number, MemorySpace> &   update2,
-      LinearAlgebra::distributed::Vector<Number, MemorySpace> &,
-      LinearAlgebra::distributed::Vector<Number, MemorySpace> &dst)
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+        &          jacobi,
+      const bool   start_zero,
+      const double factor1,
+      const double factor2,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &update1,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &update2,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &dst)
     {
-      VectorUpdater<Number> upd(src.begin(),
-                                jacobi.get_vector().begin(),
-                                start_zero,
-                                factor1,
-                                factor2,
-                                update1.begin(),
-                                update2.begin(),
-                                dst.begin());
-      VectorUpdatesRange<Number>(upd, src.local_size());
+      const auto diagonal = make_vector_expression(jacobi.get_vector());
+      if (Number(factor1) == Number())
+        {
+          if (start_zero)
+            update1 = -store_in(
+              dst,
+              entrywise_product(Number(factor2) * make_vector_expression(src),
+                                diagonal));
+          else
+            dst = make_vector_expression(dst) -
+                  store_in(update1,
+                           entrywise_product(
+                             Number(factor2) *
+                               (make_vector_expression(update2) - src),
+                             diagonal));
+        }
+      else
+        dst = make_vector_expression(dst) -
+              store_in(update1,
+                       Number(factor1) * make_vector_expression(update1) +
+                         Number(factor2) *
+                           entrywise_product(make_vector_expression(update2) -
+                                               src,
+                                             diagonal));
     }
 
     template <typename MatrixType,
@@ -2035,6 +2426,335 @@ namespace internal
       vector.add(-mean_value);
     }
 
+    // check whether a vector kept from a previous call can be reused for a
+    // vector of the same layout as the given one
+    template <typename VectorType>
+    bool
+    vectors_are_compatible(const VectorType &vector, const VectorType &other)
+    {
+      return vector.size() == other.size();
+    }
+
+    template <typename Number, typename MemorySpace>
+    bool
+    vectors_are_compatible(
+      const ::dealii::LinearAlgebra::distributed::Vector<Number, MemorySpace>
+        &vector,
+      const ::dealii::LinearAlgebra::distributed::Vector<Number, MemorySpace>
+        &other)
+    {
+      // the vector is re-initialized with collective operations, so all
+      // processes must agree on the result
+      return vector.size() == other.size() &&
+             vector.partitioners_are_globally_compatible(
+               *other.get_partitioner());
+    }
+
+    // vector updates of the fourth-kind Chebyshev iteration, which computes
+    // the residual r, either as r = src for a zero starting vector, as
+    // r = src - update2 with update2 = A dst, or as r = update2 - update3
+    // with update3 = A d, stores it in update2 and updates the search
+    // direction d = factor1 d + factor2 P r in update1 and the solution
+    // dst += beta d. The generic version works for all vector types
+    template <typename VectorType, typename PreconditionerType>
+    inline void
+    vector_updates_fourth_kind(const VectorType &        src,
+                               const PreconditionerType &preconditioner,
+                               const bool                start_zero,
+                               const bool                update_residual,
+                               const double              factor1,
+                               const double              factor2,
+                               const double              beta,
+                               VectorType &              update1,
+                               VectorType &              update2,
+                               VectorType &              update3,
+                               VectorType &              dst)
+    {
+      if (start_zero)
+        update2 = src;
+      else if (update_residual)
+        update2 -= update3;
+      else
+        update2.sadd(-1., 1., src);
+      preconditioner.vmult(update3, update2);
+      if (update_residual)
+        update1.sadd(factor1, factor2, update3);
+      else
+        update1.equ(factor2, update3);
+      if (start_zero)
+        dst.equ(beta, update1);
+      else
+        dst.add(beta, update1);
+    }
+
+    // selection for diagonal matrix around deal.II vector, working on all
+    // vectors in a single loop
+    template <typename Number>
+    inline void
+    vector_updates_fourth_kind(
+      const ::dealii::Vector<Number> &                src,
+      const DiagonalMatrix<::dealii::Vector<Number>> &jacobi,
+      const bool                                      start_zero,
+      const bool                                      update_residual,
+      const double                                    factor1,
+      const double                                    factor2,
+      const double                                    beta,
+      ::dealii::Vector<Number> &                      update1,
+      ::dealii::Vector<Number> &                      update2,
+      ::dealii::Vector<Number> &                      update3,
+      ::dealii::Vector<Number> &                      dst)
+    {
+      const Number *b        = src.begin();
+      const Number *diagonal = jacobi.get_vector().begin();
+      Number *      d        = update1.begin();
+      Number *      r        = update2.begin();
+      const Number *Ad       = update3.begin();
+      Number *      x        = dst.begin();
+      const Number  f1 = factor1, f2 = factor2, weight = beta;
+      if (start_zero)
+        parallel::apply_to_subranges(
+          std::size_t(0),
+          src.size(),
+          [=](const std::size_t begin, const std::size_t end) {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (std::size_t i = begin; i < end; ++i)
+              {
+                r[i] = b[i];
+                d[i] = f2 * diagonal[i] * b[i];
+                x[i] = weight * d[i];
+              }
+          },
+          internal::VectorImplementation::minimum_parallel_grain_size);
+      else if (update_residual == false)
+        parallel::apply_to_subranges(
+          std::size_t(0),
+          src.size(),
+          [=](const std::size_t begin, const std::size_t end) {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (std::size_t i = begin; i < end; ++i)
+              {
+                r[i] = b[i] - r[i];
+                d[i] = f2 * diagonal[i] * r[i];
+                x[i] += weight * d[i];
+              }
+          },
+          internal::VectorImplementation::minimum_parallel_grain_size);
+      else
+        parallel::apply_to_subranges(
+          std::size_t(0),
+          src.size(),
+          [=](const std::size_t begin, const std::size_t end) {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (std::size_t i = begin; i < end; ++i)
+              {
+                r[i] -= Ad[i];
+                d[i] = f1 * d[i] + f2 * diagonal[i] * r[i];
+                x[i] += weight * d[i];
+              }
+          },
+          internal::VectorImplementation::minimum_parallel_grain_size);
+    }
+
+    // selection for diagonal matrix around parallel deal.II vector, using
+    // vector expressions to update all vectors in a single pass
+    template <typename Number>
+    inline void
+    vector_updates_fourth_kind(
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &src,
+      const DiagonalMatrix<
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+        &          jacobi,
+      const bool   start_zero,
+      const bool   update_residual,
+      const double factor1,
+      const double factor2,
+      const double beta,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &update1,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &update2,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &update3,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &dst)
+    {
+      const auto diagonal = make_vector_expression(jacobi.get_vector());
+      if (start_zero)
+        dst = Number(beta) *
+              store_in(update1,
+                       Number(factor2) *
+                         entrywise_product(store_in(update2,
+                                                    make_vector_expression(
+                                                      src)),
+                                           diagonal));
+      else if (update_residual == false)
+        dst = make_vector_expression(dst) +
+              Number(beta) *
+                store_in(update1,
+                         Number(factor2) *
+                           entrywise_product(
+                             store_in(update2,
+                                      make_vector_expression(src) - update2),
+                             diagonal));
+      else
+        dst = make_vector_expression(dst) +
+              Number(beta) *
+                store_in(update1,
+                         Number(factor1) * make_vector_expression(update1) +
+                           Number(factor2) *
+                             entrywise_product(
+                               store_in(update2,
+                                        make_vector_expression(update2) -
+                                          update3),
+                               diagonal));
+    }
+
+    // weights of the optimized fourth-kind Chebyshev polynomials by Lottes
+    // for the given number of steps. The weights minimize the bound
+    // max_x x e(x)^2 / (1 - e(x)^2) for the error polynomial e on the
+    // eigenvalues x in (0, 1] of the matrix scaled by the largest eigenvalue,
+    // and have been computed with a Remez-type exchange algorithm
+    inline double
+    fourth_kind_optimal_weight(const unsigned int n_steps,
+                               const unsigned int step)
+    {
+      static const double weights[16][16] = {
+        {1.1250000000000000},
+        {1.0238728757031316, 1.2640890537108554},
+        {1.0084254478202830, 1.0886783920873089, 1.3375312590961857},
+        {1.0039131042728535,
+         1.0403581118859305,
+         1.1486349854625489,
+         1.3826886924100059},
+        {1.0021293014616472,
+         1.0217371154926093,
+         1.0787243319260303,
+         1.1981006529266301,
+         1.4132254279168217},
+        {1.0012851725594023,
+         1.0130429303523336,
+         1.0467821512411334,
+         1.1161648941967547,
+         1.2382902021844457,
+         1.4352429710674486},
+        {1.0008346439791245,
+         1.0084394943012288,
+         1.0300870776871385,
+         1.0740838409200376,
+         1.1503618670736634,
+         1.2711647404613994,
+         1.4518665864936390},
+        {1.0005724663119765,
+         1.0057742766241566,
+         1.0205018792294142,
+         1.0501980344456549,
+         1.1011557298494099,
+         1.1808604280685670,
+         1.2983858538257584,
+         1.4648607315109995},
+        {1.0004096007283280,
+         1.0041243950610662,
+         1.0146021214826653,
+         1.0356111362667179,
+         1.0713997252919417,
+         1.1268827371096287,
+         1.2078521914072923,
+         1.3212193071674656,
+         1.4752964282069959},
+        {1.0003031222965286,
+         1.0030484066079694,
+         1.0107702271538754,
+         1.0261901159764013,
+         1.0523172493375510,
+         1.0925574320754994,
+         1.1508337666397194,
+         1.2317225087089460,
+         1.3406080202445976,
+         1.4838612440701134},
+        {1.0002305859520938,
+         1.0023167502402850,
+         1.0081724539630486,
+         1.0198298656634228,
+         1.0395021023532466,
+         1.0696504270054150,
+         1.1130575429574262,
+         1.1729087627556436,
+         1.2528830057679239,
+         1.3572557991951932,
+         1.4910167256413897},
+        {1.0001794720082838,
+         1.0018018913961954,
+         1.0063486190730763,
+         1.0153786456630602,
+         1.0305694283076032,
+         1.0537601969394354,
+         1.0869986259207278,
+         1.1325918309791344,
+         1.1931627335817236,
+         1.2717129367511055,
+         1.3716933796979923,
+         1.4970841857556240},
+        {1.0001424192155960,
+         1.0014290693262963,
+         1.0050302898629815,
+         1.0121691051849532,
+         1.0241487434279264,
+         1.0423815888082023,
+         1.0684200812870087,
+         1.1039901093675977,
+         1.1510274824264574,
+         1.2117181191012485,
+         1.2885426486512817,
+         1.3843261938099123,
+         1.5022941875736912},
+        {1.0001149053826194,
+         1.0011524637691457,
+         1.0040535733326486,
+         1.0097959057315304,
+         1.0194130047299468,
+         1.0340142503543676,
+         1.0548059960662936,
+         1.0831142030181291,
+         1.1204089166089244,
+         1.1683309565544584,
+         1.2287212228823861,
+         1.3036530570781733,
+         1.3954681405367828,
+         1.5068164620958361},
+        {1.0000940475075260,
+         1.0009429169634347,
+         1.0033144905644487,
+         1.0080029483381600,
+         1.0158423625914055,
+         1.0277208331770479,
+         1.0445953542283166,
+         1.0675076120612524,
+         1.0976009254588976,
+         1.1361385536615722,
+         1.1845236142623623,
+         1.2443208730447571,
+         1.3172806908339291,
+         1.4053654389355993,
+         1.5107787250184531},
+        {1.0000779482817922,
+         1.0007812684725339,
+         1.0027448797440126,
+         1.0066229101701517,
+         1.0130985883697142,
+         1.0228944832933703,
+         1.0367832140998403,
+         1.0555987571989668,
+         1.0802484840556018,
+         1.1117260713149778,
+         1.1511254343107250,
+         1.1996558461497377,
+         1.2586584174494561,
+         1.3296241265666516,
+         1.4142136069557599,
+         1.5142789173034638},
+      };
+
+      AssertIndexRange(n_steps - 1, 16);
+      AssertIndexRange(step, n_steps);
+      return weights[n_steps - 1][step];
+    }
+
     struct EigenvalueTracker
     {
     public:
@@ -2055,18 +2775,37 @@ namespace internal
 
 template <typename MatrixType, class VectorType, typename PreconditionerType>
 inline PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
-  AdditionalData::AdditionalData(const unsigned int degree,
-                                 const double       smoothing_range,
-                                 const bool         nonzero_starting,
-                                 const unsigned int eig_cg_n_iterations,
-                                 const double       eig_cg_residual,
-                                 const double       max_eigenvalue)
+  AdditionalData::AdditionalData(
+    const unsigned int        degree,
+    const double              smoothing_range,
+    const bool                nonzero_starting,
+    const unsigned int        eig_cg_n_iterations,
+    const double              eig_cg_residual,
+    const double              max_eigenvalue,
+    const PolynomialType      polynomial_type,
+    const EigenvalueAlgorithm eigenvalue_algorithm)
   : degree(degree)
   , smoothing_range(smoothing_range)
   , nonzero_starting(nonzero_starting)
   , eig_cg_n_iterations(eig_cg_n_iterations)
   , eig_cg_residual(eig_cg_residual)
   , max_eigenvalue(max_eigenvalue)
+  , polynomial_type(polynomial_type)
+  , eigenvalue_algorithm(eigenvalue_algorithm)
+  , eigenvalue_reuse_tolerance(0.)
+  , eigenvalue_check_n_iterations(3)
+{}
+
+
+
+template <typename MatrixType, class VectorType, typename PreconditionerType>
+inline PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
+  EigenvalueInformation::EigenvalueInformation()
+  : min_eigenvalue_estimate(0.)
+  , max_eigenvalue_estimate(0.)
+  , n_iterations(0)
+  , degree(0)
+  , reused_previous_estimate(false)
 {}
 
 
@@ -2095,6 +2834,15 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::initialize(
 {
   matrix_ptr = &matrix;
   data       = additional_data;
+  Assert(data.polynomial_type !=
+             AdditionalData::PolynomialType::fourth_kind_optimal ||
+           data.degree < 16,
+         ExcMessage("The optimized fourth-kind Chebyshev polynomials are only "
+                    "available up to degree 15."));
+  Assert(data.polynomial_type == AdditionalData::PolynomialType::first_kind ||
+           data.degree != numbers::invalid_unsigned_int,
+         ExcMessage("The fourth-kind Chebyshev polynomials need to be given "
+                    "a degree."));
   internal::PreconditionChebyshevImplementation::initialize_preconditioner(
     matrix, data.preconditioner, data.matrix_diagonal_inverse);
   eigenvalues_are_initialized = false;
@@ -2115,12 +2863,56 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::clear()
     update1.reinit(empty_vector);
     update2.reinit(empty_vector);
     update3.reinit(empty_vector);
+    eigenvector_estimate.reinit(empty_vector);
   }
+  eigenvalue_information = EigenvalueInformation();
   data.preconditioner.reset();
 }
 
 
 
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline const typename PreconditionChebyshev<MatrixType,
+                                            VectorType,
+                                            PreconditionerType>::
+  EigenvalueInformation &
+  PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
+    get_eigenvalue_information() const
+{
+  return eigenvalue_information;
+}
+
+
+
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline double
+PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
+  power_iteration(const VectorType &src, const unsigned int n_iterations) const
+{
+  if (!internal::PreconditionChebyshevImplementation::vectors_are_compatible(
+        eigenvector_estimate, src))
+    {
+      eigenvector_estimate.reinit(src, true);
+      internal::PreconditionChebyshevImplementation::set_initial_guess(
+        eigenvector_estimate);
+    }
+  eigenvector_estimate /= eigenvector_estimate.l2_norm();
+
+  // the vector update1 is free during the eigenvalue estimation
+  double eigenvalue = 0.;
+  for (unsigned int i = 0; i < n_iterations; ++i)
+    {
+      matrix_ptr->vmult(update1, eigenvector_estimate);
+      data.preconditioner->vmult(eigenvector_estimate, update1);
+      eigenvalue = eigenvector_estimate.l2_norm();
+      Assert(eigenvalue > 0., ExcDivideByZero());
+      eigenvector_estimate /= eigenvalue;
+    }
+  return eigenvalue;
+}
+
+
+
 template <typename MatrixType, typename VectorType, typename PreconditionerType>
 inline void
 PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
@@ -2132,11 +2924,54 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
   update1.reinit(src);
   update2.reinit(src, true);
 
+  // check whether the estimate of a previous initialization can be reused
+  // by a few steps of a power iteration
+  EigenvalueInformation &info = eigenvalue_information;
+  info.reused_previous_estimate = false;
+  info.n_iterations             = 0;
+  if (data.eig_cg_n_iterations > 0 && data.eigenvalue_reuse_tolerance > 0. &&
+      info.max_eigenvalue_estimate > 0.)
+    {
+      const double check_estimate =
+        power_iteration(src, data.eigenvalue_check_n_iterations);
+      info.n_iterations = data.eigenvalue_check_n_iterations;
+      info.reused_previous_estimate =
+        std::abs(check_estimate - info.max_eigenvalue_estimate) <=
+        data.eigenvalue_reuse_tolerance * info.max_eigenvalue_estimate;
+    }
+
   // calculate largest eigenvalue using a hand-tuned CG iteration on the
   // matrix weighted by its diagonal. we start with a vector that consists of
   // ones only, weighted by the length.
   double max_eigenvalue, min_eigenvalue;
-  if (data.eig_cg_n_iterations > 0)
+  if (info.reused_previous_estimate)
+    {
+      min_eigenvalue = info.min_eigenvalue_estimate;
+      max_eigenvalue = 1.2 * info.max_eigenvalue_estimate;
+    }
+  else if (data.eig_cg_n_iterations > 0 &&
+           data.eigenvalue_algorithm ==
+             AdditionalData::EigenvalueAlgorithm::power_iteration)
+    {
+      Assert(data.polynomial_type !=
+                 AdditionalData::PolynomialType::first_kind ||
+               data.smoothing_range > 1.,
+             ExcMessage("The power iteration does not estimate the smallest "
+                        "eigenvalue, so a smoothing range is needed."));
+
+      // start from the high-frequency initial guess, or continue from the
+      // vector of a previous estimate
+      info.max_eigenvalue_estimate =
+        power_iteration(src, data.eig_cg_n_iterations);
+      info.min_eigenvalue_estimate = 0.;
+      info.n_iterations += data.eig_cg_n_iterations;
+
+      // include a safety factor since the power iteration will in general
+      // not be converged
+      min_eigenvalue = 0.;
+      max_eigenvalue = 1.2 * info.max_eigenvalue_estimate;
+    }
+  else if (data.eig_cg_n_iterations > 0)
     {
       Assert(data.eig_cg_n_iterations > 2,
              ExcMessage(
@@ -2169,6 +3004,7 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
         }
       catch (SolverControl::NoConvergence &)
         {}
+      info.n_iterations += control.last_step();
 
       // read the eigenvalues from the attached eigenvalue tracker
       if (eigenvalue_tracker.values.empty())
@@ -2181,11 +3017,15 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
           // be converged
           max_eigenvalue = 1.2 * eigenvalue_tracker.values.back();
         }
+      info.min_eigenvalue_estimate = min_eigenvalue;
+      info.max_eigenvalue_estimate = max_eigenvalue / 1.2;
     }
   else
     {
-      max_eigenvalue = data.max_eigenvalue;
-      min_eigenvalue = data.max_eigenvalue / data.smoothing_range;
+      max_eigenvalue               = data.max_eigenvalue;
+      min_eigenvalue               = data.max_eigenvalue / data.smoothing_range;
+      info.min_eigenvalue_estimate = min_eigenvalue;
+      info.max_eigenvalue_estimate = max_eigenvalue;
     }
 
   const double alpha = (data.smoothing_range > 1. ?
@@ -2211,6 +3051,7 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
               std::log(1. / eps + std::sqrt(1. / eps / eps - 1)) /
               std::log(1. / sigma));
     }
+  info.degree = data.degree;
 
   const_cast<
     PreconditionChebyshev<MatrixType, VectorType, PreconditionerType> *>(this)
@@ -2220,8 +3061,10 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
     ->theta = (max_eigenvalue + alpha) * 0.5;
 
   // We do not need the third auxiliary vector in case we have a
-  // DiagonalMatrix as preconditioner and use deal.II's own vectors
-  if (std::is_same<PreconditionerType, DiagonalMatrix<VectorType>>::value ==
+  // DiagonalMatrix as preconditioner and use deal.II's own vectors, except
+  // for the fourth-kind polynomials
+  if (data.polynomial_type != AdditionalData::PolynomialType::first_kind ||
+      std::is_same<PreconditionerType, DiagonalMatrix<VectorType>>::value ==
         false ||
       (std::is_same<VectorType,
                     dealii::Vector<typename VectorType::value_type>>::value ==
@@ -2304,6 +3147,70 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
 
 
 
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline void
+PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
+  do_fourth_kind_loop(VectorType &      dst,
+                      const VectorType &src,
+                      const bool        start_zero,
+                      const bool        transpose) const
+{
+  // the largest eigenvalue including the safety factor
+  const double       max_eigenvalue = theta + delta;
+  const unsigned int n_steps        = data.degree + 1;
+  const bool         optimal_weights =
+    data.polynomial_type == AdditionalData::PolynomialType::fourth_kind_optimal;
+  const auto weight = [&](const unsigned int step) {
+    return optimal_weights ?
+             internal::PreconditionChebyshevImplementation::
+               fourth_kind_optimal_weight(n_steps, step) :
+             1.;
+  };
+
+  // compute the residual of the starting vector unless it is zero
+  if (start_zero == false)
+    {
+      if (transpose)
+        matrix_ptr->Tvmult(update2, dst);
+      else
+        matrix_ptr->vmult(update2, dst);
+    }
+  internal::PreconditionChebyshevImplementation::vector_updates_fourth_kind(
+    src,
+    *data.preconditioner,
+    start_zero,
+    false,
+    0.,
+    4. / (3. * max_eigenvalue),
+    weight(0),
+    update1,
+    update2,
+    update3,
+    dst);
+
+  for (unsigned int k = 1; k < n_steps; ++k)
+    {
+      if (transpose)
+        matrix_ptr->Tvmult(update3, update1);
+      else
+        matrix_ptr->vmult(update3, update1);
+      internal::PreconditionChebyshevImplementation::vector_updates_fourth_kind(
+        src,
+        *data.preconditioner,
+        false,
+        true,
+        (2. * k - 1.) / (2. * k + 3.),
+        (8. * k + 4.) / ((2. * k + 3.) * max_eigenvalue),
+        weight(k),
+        update1,
+        update2,
+        update3,
+        dst);
+    }
+}
+
+
+
 template <typename MatrixType, typename VectorType, typename PreconditionerType>
 inline void
 PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::vmult(
@@ -2314,6 +3221,12 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::vmult(
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
 
+  if (data.polynomial_type != AdditionalData::PolynomialType::first_kind)
+    {
+      do_fourth_kind_loop(dst, src, true, false);
+      return;
+    }
+
   internal::PreconditionChebyshevImplementation::vector_updates(
     src,
     *data.preconditioner,
@@ -2340,6 +3253,12 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::Tvmult(
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
 
+  if (data.polynomial_type != AdditionalData::PolynomialType::first_kind)
+    {
+      do_fourth_kind_loop(dst, src, true, true);
+      return;
+    }
+
   internal::PreconditionChebyshevImplementation::vector_updates(
     src,
     *data.preconditioner,
@@ -2366,6 +3285,12 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::step(
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
 
+  if (data.polynomial_type != AdditionalData::PolynomialType::first_kind)
+    {
+      do_fourth_kind_loop(dst, src, false, false);
+      return;
+    }
+
   matrix_ptr->vmult(update2, dst);
   internal::PreconditionChebyshevImplementation::vector_updates(
     src,
@@ -2393,6 +3318,12 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::Tstep(
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
 
+  if (data.polynomial_type != AdditionalData::PolynomialType::first_kind)
+    {
+      do_fourth_kind_loop(dst, src, false, true);
+      return;
+    }
+
   matrix_ptr->Tvmult(update2, dst);
   internal::PreconditionChebyshevImplementation::vector_updates(
     src,
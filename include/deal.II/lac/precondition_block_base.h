@@ -81,7 +81,17 @@ public:
     /**
      * Use the singular value decomposition of LAPACKFullMatrix.
      */
-    svd
+    svd,
+    /**
+     * Use the LU decomposition of LAPACK (functions getrf and getri), and
+     * store the inverses of all blocks consecutively in a single array, see
+     * reinit_packed() and invert_packed(). This avoids one memory allocation
+     * per block, which pays off for many small blocks. Without LAPACK,
+     * FullMatrix::gauss_jordan() is used for the inversion.
+     *
+     * This method is only supported by the RelaxationBlock classes.
+     */
+    packed_lu
   };
 
   /**
@@ -112,6 +122,22 @@ public:
          bool         compress,
          Inversion    method = gauss_jordan);
 
+  /**
+   * Set up the storage of the inverses for the method #packed_lu with the
+   * given size of each block, which replaces the block size given to
+   * reinit(). If same_diagonal() is true, only the first size is used.
+   */
+  void
+  reinit_packed(const std::vector<size_type> &block_sizes);
+
+  /**
+   * Compute the inverse of @p matrix and store it as the inverse of block
+   * @p i for the method #packed_lu. Different blocks may be inverted
+   * concurrently.
+   */
+  void
+  invert_packed(const size_type i, const FullMatrix<number> &matrix);
+
   /**
    * Tell the class that inverses are computed.
    */
@@ -272,6 +298,18 @@ private:
    */
   std::vector<LAPACKFullMatrix<number>> var_inverse_svd;
 
+  /**
+   * Storage of the inverse matrices of the diagonal blocks for the method
+   * #packed_lu, in column major order, one block after the other.
+   */
+  std::vector<number> packed_inverses;
+
+  /**
+   * The position of the inverse of each block in #packed_inverses, with one
+   * additional entry that marks the end.
+   */
+  std::vector<std::size_t> packed_inverse_offsets;
+
   /**
    * Storage of the original diagonal blocks.
    *
@@ -323,6 +361,8 @@ PreconditionBlockBase<number>::clear()
     var_inverse_svd.erase(var_inverse_svd.begin(), var_inverse_svd.end());
   if (var_diagonal.size() != 0)
     var_diagonal.erase(var_diagonal.begin(), var_diagonal.end());
+  std::vector<number>().swap(packed_inverses);
+  std::vector<std::size_t>().swap(packed_inverse_offsets);
   var_same_diagonal  = false;
   var_inverses_ready = false;
   n_diagonal_blocks  = 0;
@@ -355,6 +395,9 @@ PreconditionBlockBase<number>::reinit(unsigned int n,
             var_inverse_svd.resize(1);
             var_inverse_svd[0].reinit(b, b);
             break;
+          case packed_lu:
+            reinit_packed(std::vector<size_type>(1, b));
+            break;
           default:
             Assert(false, ExcNotImplemented());
         }
@@ -399,6 +442,9 @@ PreconditionBlockBase<number>::reinit(unsigned int n,
               var_inverse_svd.swap(tmp);
               break;
             }
+          case packed_lu:
+            reinit_packed(std::vector<size_type>(n, b));
+            break;
           default:
             Assert(false, ExcNotImplemented());
         }
@@ -406,6 +452,25 @@ PreconditionBlockBase<number>::reinit(unsigned int n,
 }
 
 
+template <typename number>
+inline void
+PreconditionBlockBase<number>::reinit_packed(
+  const std::vector<size_type> &block_sizes)
+{
+  Assert(inversion == packed_lu, ExcInverseNotAvailable());
+
+  const size_type n_blocks = same_diagonal() ? 1U : n_diagonal_blocks;
+  AssertIndexRange(n_blocks - 1, block_sizes.size());
+
+  packed_inverse_offsets.resize(n_blocks + 1);
+  packed_inverse_offsets[0] = 0;
+  for (size_type i = 0; i < n_blocks; ++i)
+    packed_inverse_offsets[i + 1] =
+      packed_inverse_offsets[i] + block_sizes[i] * block_sizes[i];
+  packed_inverses.resize(packed_inverse_offsets.back());
+}
+
+
 template <typename number>
 inline unsigned int
 PreconditionBlockBase<number>::size() const
@@ -436,6 +501,25 @@ PreconditionBlockBase<number>::inverse_vmult(size_type              i,
         AssertIndexRange(ii, var_inverse_svd.size());
         var_inverse_svd[ii].vmult(dst, src);
         break;
+      case packed_lu:
+        {
+          AssertIndexRange(ii + 1, packed_inverse_offsets.size());
+          const size_type n = src.size();
+          AssertDimension(dst.size(), n);
+          AssertDimension(n * n,
+                          packed_inverse_offsets[ii + 1] -
+                            packed_inverse_offsets[ii]);
+          const number *values =
+            packed_inverses.data() + packed_inverse_offsets[ii];
+          dst = number2();
+          for (size_type c = 0; c < n; ++c, values += n)
+            {
+              const number2 src_c = src(c);
+              for (size_type r = 0; r < n; ++r)
+                dst(r) += number2(values[r]) * src_c;
+            }
+          break;
+        }
       default:
         Assert(false, ExcNotImplemented());
     }
@@ -465,6 +549,25 @@ PreconditionBlockBase<number>::inverse_Tvmult(size_type              i,
         AssertIndexRange(ii, var_inverse_svd.size());
         var_inverse_svd[ii].Tvmult(dst, src);
         break;
+      case packed_lu:
+        {
+          AssertIndexRange(ii + 1, packed_inverse_offsets.size());
+          const size_type n = src.size();
+          AssertDimension(dst.size(), n);
+          AssertDimension(n * n,
+                          packed_inverse_offsets[ii + 1] -
+                            packed_inverse_offsets[ii]);
+          const number *values =
+            packed_inverses.data() + packed_inverse_offsets[ii];
+          for (size_type c = 0; c < n; ++c, values += n)
+            {
+              number2 sum = number2();
+              for (size_type r = 0; r < n; ++r)
+                sum += number2(values[r]) * src(r);
+              dst(c) = sum;
+            }
+          break;
+        }
       default:
         Assert(false, ExcNotImplemented());
     }
@@ -655,6 +758,8 @@ PreconditionBlockBase<number>::log_statistics() const
     {}
   else if (inversion == gauss_jordan)
     {}
+  else if (inversion == packed_lu)
+    {}
   else
     {
       Assert(false, ExcNotImplemented());
@@ -671,6 +776,8 @@ PreconditionBlockBase<number>::memory_consumption() const
     mem += MemoryConsumption::memory_consumption(var_inverse_full[i]);
   for (size_type i = 0; i < var_diagonal.size(); ++i)
     mem += MemoryConsumption::memory_consumption(var_diagonal[i]);
+  mem += MemoryConsumption::memory_consumption(packed_inverses) +
+         MemoryConsumption::memory_consumption(packed_inverse_offsets);
   return mem;
 }
 
@@ -47,6 +47,11 @@ DEAL_II_NAMESPACE_OPEN
  * Parallel computations require you to specify an initialized
  * ghost vector in AdditionalData::temp_ghost_vector.
  *
+ * The blocks are processed one after the other, unless
+ * AdditionalData::use_coloring is set. Then, the blocks are colored such
+ * that blocks of the same color do not depend on each other, and all blocks
+ * of one color are processed in parallel on several threads.
+ *
  * @ingroup Preconditioners
  * @author Guido Kanschat
  * @date 2010
@@ -172,6 +177,28 @@ public:
      */
     std::vector<std::vector<unsigned int>> order;
 
+    /**
+     * If true, initialize() colors the blocks such that no block reads or
+     * writes a vector entry that another block of the same color writes. A
+     * block writes to the entries of its rows and reads the entries of all
+     * columns coupling to them. Blocks that only read the same entries may
+     * have the same color, e.g., every second line of a grid for blocks
+     * consisting of the lines of a five-point stencil. The blocks are
+     * colored greedily in their natural order. The relaxation methods then
+     * process the colors one after the other, and all blocks of one color in
+     * parallel.
+     *
+     * For RelaxationBlockSOR and RelaxationBlockSSOR, the blocks are then
+     * traversed in the order of the colors, so the result differs from the
+     * one without coloring. The coloring can not be combined with #order.
+     *
+     * @note The threads write to different entries of the same vector at the
+     * same time. This is supported by Vector, BlockVector, and
+     * LinearAlgebra::distributed::Vector, but not by the Trilinos and PETSc
+     * vector classes.
+     */
+    bool use_coloring = false;
+
     /**
      * Temporary ghost vector that is used in the relaxation method when
      * performing parallel MPI computations. The user is required to have this
@@ -227,6 +254,13 @@ public:
   void
   invert_diagblocks();
 
+  /**
+   * Return the number of colors of the blocks if AdditionalData::use_coloring
+   * is set, and zero otherwise.
+   */
+  unsigned int
+  n_colors() const;
+
 protected:
   /**
    * Perform one block relaxation step.
@@ -265,6 +299,30 @@ private:
    */
   void
   block_kernel(const size_type block_begin, const size_type block_end);
+
+  /**
+   * Compute the coloring of the blocks in #block_colors.
+   */
+  void
+  compute_block_coloring();
+
+  /**
+   * Perform the relaxation step of do_step() on a single block, using the
+   * vectors @p b_cell and @p x_cell as scratch space.
+   */
+  void
+  do_block(const unsigned int                       block,
+           VectorType &                             dst,
+           const VectorType &                       prev,
+           const VectorType &                       src,
+           Vector<typename VectorType::value_type> &b_cell,
+           Vector<typename VectorType::value_type> &x_cell) const;
+
+  /**
+   * The blocks of each color if AdditionalData::use_coloring is set, and an
+   * empty vector otherwise.
+   */
+  std::vector<std::vector<unsigned int>> block_colors;
 };
 
 
@@ -334,6 +392,10 @@ public:
    * Make function of base class public again.
    */
   using RelaxationBlock<MatrixType, InverseNumberType, VectorType>::inverse_svd;
+  /**
+   * Make function of base class public again.
+   */
+  using RelaxationBlock<MatrixType, InverseNumberType, VectorType>::n_colors;
   /**
    * Make function of base class public again.
    */
@@ -432,6 +494,10 @@ public:
    * Make function of base class public again.
    */
   using RelaxationBlock<MatrixType, InverseNumberType, VectorType>::inverse_svd;
+  /**
+   * Make function of base class public again.
+   */
+  using RelaxationBlock<MatrixType, InverseNumberType, VectorType>::n_colors;
   /**
    * Make function of base class public again.
    */
@@ -525,6 +591,10 @@ public:
    * Make function of base class public again.
    */
   using RelaxationBlock<MatrixType, InverseNumberType, VectorType>::inverse_svd;
+  /**
+   * Make function of base class public again.
+   */
+  using RelaxationBlock<MatrixType, InverseNumberType, VectorType>::n_colors;
   /**
    * Make function of base class public again.
    */
@@ -74,17 +74,99 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::initialize(
                additional_data->same_diagonal,
                additional_data->inversion);
 
+  if (additional_data->use_coloring)
+    {
+      Assert(additional_data->order.empty(),
+             ExcMessage("The coloring of the blocks can not be combined with "
+                        "a user-defined order of the blocks."));
+      compute_block_coloring();
+    }
+
   if (additional_data->invert_diagonal)
     invert_diagblocks();
 }
 
 
+template <typename MatrixType, typename InverseNumberType, typename VectorType>
+inline void
+RelaxationBlock<MatrixType, InverseNumberType, VectorType>::
+  compute_block_coloring()
+{
+  const SparsityPattern &block_list = additional_data->block_list;
+  const MatrixType &     M          = *A;
+
+  block_colors.clear();
+  if (block_list.n_rows() == 0)
+    return;
+
+  // a block writes to its own rows and reads from all columns coupling to
+  // them. two blocks conflict if one of them writes to an entry the other
+  // one reads, whereas reading the same entries is fine. since the
+  // conflicts are not given by overlapping index sets, find them through
+  // the blocks writing to each entry
+  const unsigned int                     n_blocks = block_list.n_rows();
+  std::vector<std::vector<unsigned int>> writing_blocks(block_list.n_cols());
+  for (unsigned int block = 0; block < n_blocks; ++block)
+    for (SparsityPattern::iterator row = block_list.begin(block);
+         row != block_list.end(block);
+         ++row)
+      writing_blocks[row->column()].push_back(block);
+
+  std::vector<std::vector<unsigned int>> conflicts(n_blocks);
+  for (unsigned int block = 0; block < n_blocks; ++block)
+    for (SparsityPattern::iterator row = block_list.begin(block);
+         row != block_list.end(block);
+         ++row)
+      for (typename MatrixType::const_iterator entry = M.begin(row->column());
+           entry != M.end(row->column());
+           ++entry)
+        for (const unsigned int other : writing_blocks[entry->column()])
+          if (other != block)
+            {
+              conflicts[block].push_back(other);
+              conflicts[other].push_back(block);
+            }
+
+  // color the blocks greedily in their natural order, giving each block the
+  // smallest color not used by any of its conflicting blocks colored so far
+  std::vector<unsigned int> block_color(n_blocks,
+                                        numbers::invalid_unsigned_int);
+  std::vector<unsigned int> color_used_by;
+  for (unsigned int block = 0; block < n_blocks; ++block)
+    {
+      for (const unsigned int other : conflicts[block])
+        if (block_color[other] != numbers::invalid_unsigned_int)
+          color_used_by[block_color[other]] = block;
+
+      unsigned int color = 0;
+      while (color < color_used_by.size() && color_used_by[color] == block)
+        ++color;
+      if (color == color_used_by.size())
+        {
+          color_used_by.push_back(numbers::invalid_unsigned_int);
+          block_colors.emplace_back();
+        }
+      block_color[block] = color;
+      block_colors[color].push_back(block);
+    }
+}
+
+
+template <typename MatrixType, typename InverseNumberType, typename VectorType>
+inline unsigned int
+RelaxationBlock<MatrixType, InverseNumberType, VectorType>::n_colors() const
+{
+  return block_colors.size();
+}
+
+
 template <typename MatrixType, typename InverseNumberType, typename VectorType>
 inline void
 RelaxationBlock<MatrixType, InverseNumberType, VectorType>::clear()
 {
   A               = nullptr;
   additional_data = nullptr;
+  block_colors.clear();
   PreconditionBlockBase<InverseNumberType>::clear();
 }
 
@@ -99,6 +181,18 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::invert_diagblocks()
     }
   else
     {
+      // the packed storage of the inverses is laid out before the blocks are
+      // inverted in parallel
+      if (this->inversion ==
+          PreconditionBlockBase<InverseNumberType>::packed_lu)
+        {
+          const SparsityPattern &block_list = additional_data->block_list;
+          std::vector<size_type> block_sizes(block_list.n_rows());
+          for (size_type block = 0; block < block_list.n_rows(); ++block)
+            block_sizes[block] = block_list.row_length(block);
+          this->reinit_packed(block_sizes);
+        }
+
       // compute blocks in parallel
       parallel::apply_to_subranges(
         0,
@@ -171,6 +265,9 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::block_kernel(
               this->inverse_svd(block).compute_inverse_svd(
                 this->additional_data->threshold);
             break;
+          case PreconditionBlockBase<InverseNumberType>::packed_lu:
+            this->invert_packed(block, M_cell);
+            break;
           default:
             Assert(false, ExcNotImplemented());
         }
@@ -217,6 +314,46 @@ namespace internal
 #endif // DEAL_II_WITH_TRILINOS
 } // end namespace internal
 
+template <typename MatrixType, typename InverseNumberType, typename VectorType>
+inline void
+RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_block(
+  const unsigned int                       block,
+  VectorType &                             dst,
+  const VectorType &                       prev,
+  const VectorType &                       src,
+  Vector<typename VectorType::value_type> &b_cell,
+  Vector<typename VectorType::value_type> &x_cell) const
+{
+  const MatrixType &M  = *this->A;
+  const size_type   bs = additional_data->block_list.row_length(block);
+
+  b_cell.reinit(bs);
+  x_cell.reinit(bs);
+  // Collect off-diagonal parts
+  SparsityPattern::iterator row = additional_data->block_list.begin(block);
+  for (size_type row_cell = 0; row_cell < bs; ++row_cell, ++row)
+    {
+      b_cell(row_cell) = src(row->column());
+      for (typename MatrixType::const_iterator entry = M.begin(row->column());
+           entry != M.end(row->column());
+           ++entry)
+        b_cell(row_cell) -= entry->value() * prev(entry->column());
+    }
+  // Apply inverse diagonal
+  this->inverse_vmult(block, x_cell, b_cell);
+#ifdef DEBUG
+  for (unsigned int i = 0; i < x_cell.size(); ++i)
+    {
+      AssertIsFinite(x_cell(i));
+    }
+#endif
+  // Store in result vector
+  row = additional_data->block_list.begin(block);
+  for (size_type row_cell = 0; row_cell < bs; ++row_cell, ++row)
+    dst(row->column()) += additional_data->relaxation * x_cell(row_cell);
+}
+
+
 template <typename MatrixType, typename InverseNumberType, typename VectorType>
 inline void
 RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_step(
@@ -230,8 +367,28 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_step(
   const VectorType &ghosted_prev =
     internal::prepare_ghost_vector(prev, additional_data->temp_ghost_vector);
 
-  const MatrixType &                      M = *this->A;
-  Vector<typename VectorType::value_type> b_cell, x_cell;
+  if (!block_colors.empty())
+    {
+      // blocks of the same color do not couple, so they can be processed in
+      // any order and in parallel
+      const unsigned int n_colors = block_colors.size();
+      for (unsigned int ci = 0; ci < n_colors; ++ci)
+        {
+          const std::vector<unsigned int> &color =
+            block_colors[backward ? (n_colors - ci - 1) : ci];
+          parallel::apply_to_subranges(
+            0U,
+            static_cast<unsigned int>(color.size()),
+            [&](const unsigned int begin, const unsigned int end) {
+              Vector<typename VectorType::value_type> b_cell, x_cell;
+              for (unsigned int i = begin; i < end; ++i)
+                do_block(color[i], dst, ghosted_prev, src, b_cell, x_cell);
+            },
+            16);
+        }
+      dst.compress(dealii::VectorOperation::add);
+      return;
+    }
 
   const bool         permutation_empty = additional_data->order.size() == 0;
   const unsigned int n_permutations =
@@ -242,6 +399,7 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_step(
     for (unsigned int i = 0; i < additional_data->order.size(); ++i)
       AssertDimension(additional_data->order[i].size(), this->size());
 
+  Vector<typename VectorType::value_type> b_cell, x_cell;
   for (unsigned int perm = 0; perm < n_permutations; ++perm)
     {
       for (unsigned int bi = 0; bi < n_blocks; ++bi)
@@ -254,36 +412,7 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_step(
                              ->order[n_permutations - 1 - perm][raw_block]) :
                           (additional_data->order[perm][raw_block]));
 
-          const size_type bs = additional_data->block_list.row_length(block);
-
-          b_cell.reinit(bs);
-          x_cell.reinit(bs);
-          // Collect off-diagonal parts
-          SparsityPattern::iterator row =
-            additional_data->block_list.begin(block);
-          for (size_type row_cell = 0; row_cell < bs; ++row_cell, ++row)
-            {
-              b_cell(row_cell) = src(row->column());
-              for (typename MatrixType::const_iterator entry =
-                     M.begin(row->column());
-                   entry != M.end(row->column());
-                   ++entry)
-                b_cell(row_cell) -=
-                  entry->value() * ghosted_prev(entry->column());
-            }
-          // Apply inverse diagonal
-          this->inverse_vmult(block, x_cell, b_cell);
-#ifdef DEBUG
-          for (unsigned int i = 0; i < x_cell.size(); ++i)
-            {
-              AssertIsFinite(x_cell(i));
-            }
-#endif
-          // Store in result vector
-          row = additional_data->block_list.begin(block);
-          for (size_type row_cell = 0; row_cell < bs; ++row_cell, ++row)
-            dst(row->column()) +=
-              additional_data->relaxation * x_cell(row_cell);
+          do_block(block, dst, ghosted_prev, src, b_cell, x_cell);
         }
     }
   dst.compress(dealii::VectorOperation::add);
@@ -20,13 +20,17 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/memory_space.h>
 #include <deal.II/base/signaling_nan.h>
 #include <deal.II/base/subscriptor.h>
 
+#include <deal.II/lac/la_parallel_vector_expressions.h>
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_control.h>
 
+#include <array>
 #include <cmath>
+#include <utility>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -295,6 +299,88 @@ private:
 
 #ifndef DOXYGEN
 
+namespace internal
+{
+  namespace SolverBicgstabImplementation
+  {
+    /**
+     * Compute the new search direction $p = r + \beta (p - \omega v)$. This
+     * is the general version for all vector types.
+     */
+    template <typename VectorType>
+    void
+    update_search_direction(const double      beta,
+                            const double      omega,
+                            const VectorType &r,
+                            const VectorType &v,
+                            VectorType &      p)
+    {
+      p.sadd(beta, 1., r);
+      p.add(-beta * omega, v);
+    }
+
+
+
+    /**
+     * Subtract $\omega t$ from the residual @p r and return the square of
+     * the norm of the new residual together with its inner product with
+     * @p rbar. This is the general version for all vector types.
+     */
+    template <typename VectorType>
+    std::pair<double, double>
+    update_residual(const double      omega,
+                    const VectorType &t,
+                    const VectorType &rbar,
+                    VectorType &      r)
+    {
+      const double norm_sqr = r.add_and_dot(-omega, t, r);
+      return std::make_pair(norm_sqr, r * rbar);
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which updates the search direction in a single pass over the vectors.
+     */
+    template <typename Number>
+    void
+    update_search_direction(
+      const double beta,
+      const double omega,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &r,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &v,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &      p)
+    {
+      p = Number(beta) * make_vector_expression(p) + r -
+          Number(beta * omega) * make_vector_expression(v);
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which computes the new residual, its norm and the inner product in a
+     * single pass over the vectors.
+     */
+    template <typename Number>
+    std::pair<double, double>
+    update_residual(
+      const double omega,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &t,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &rbar,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &      r)
+    {
+      const std::array<Number, 2> results = r.assign_and_reduce(
+        make_vector_expression(r) - Number(omega) * make_vector_expression(t),
+        LinearAlgebra::distributed::VectorReductions::norm_sqr(),
+        LinearAlgebra::distributed::VectorReductions::dot(rbar));
+      return std::make_pair(results[0], results[1]);
+    }
+  } // namespace SolverBicgstabImplementation
+} // namespace internal
+
+
 
 template <typename VectorType>
 SolverBicgstab<VectorType>::IterationResult::IterationResult(
@@ -395,11 +481,15 @@ SolverBicgstab<VectorType>::iterate(const MatrixType &        A,
   rbar         = r;
   bool startup = true;
 
+  // the inner product of the residual with rbar, which is computed together
+  // with the update of the residual at the end of each iteration
+  double r_dot_rbar = r * rbar;
+
   do
     {
       ++step;
 
-      rhobar = r * rbar;
+      rhobar = r_dot_rbar;
       beta   = rhobar * alpha / (rho * omega);
       rho    = rhobar;
       if (startup == true)
@@ -408,10 +498,8 @@ SolverBicgstab<VectorType>::iterate(const MatrixType &        A,
           startup = false;
         }
       else
-        {
-          p.sadd(beta, 1., r);
-          p.add(-beta * omega, v);
-        }
+        internal::SolverBicgstabImplementation::update_search_direction(
+          beta, omega, r, v, p);
 
       preconditioner.vmult(y, p);
       A.vmult(v, y);
@@ -448,10 +536,19 @@ SolverBicgstab<VectorType>::iterate(const MatrixType &        A,
       if (additional_data.exact_residual)
         {
           r.add(-omega, t);
-          res = criterion(A, *Vx, *Vb);
+          res        = criterion(A, *Vx, *Vb);
+          r_dot_rbar = r * rbar;
         }
       else
-        res = std::sqrt(r.add_and_dot(-omega, t, r));
+        {
+          const std::pair<double, double> norm_and_dot =
+            internal::SolverBicgstabImplementation::update_residual(omega,
+                                                                    t,
+                                                                    rbar,
+                                                                    r);
+          res        = std::sqrt(norm_and_dot.first);
+          r_dot_rbar = norm_and_dot.second;
+        }
 
       state = this->iteration_status(step, res, *Vx);
       print_vectors(step, *Vx, r, y);
@@ -0,0 +1,795 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_block_krylov_h
+#define dealii_solver_block_krylov_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/householder.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+namespace internal
+{
+  namespace SolverBlockKrylov
+  {
+    /**
+     * Return the residual norm below which a single column is considered
+     * converged and removed from the iteration. This is the value below
+     * which @p control reports success, given the largest residual norm
+     * @p initial_value at step zero.
+     */
+    inline double
+    deflation_tolerance(const SolverControl &control,
+                        const double         initial_value)
+    {
+      double tolerance = control.tolerance();
+      if (const ReductionControl *reduction_control =
+            dynamic_cast<const ReductionControl *>(&control))
+        tolerance =
+          std::max(tolerance, reduction_control->reduction() * initial_value);
+      return tolerance;
+    }
+
+
+
+    /**
+     * Compute the residuals $R = B - AX$ of the given columns of @p X and
+     * @p B, with @p R sized accordingly.
+     */
+    template <typename MatrixType, typename VectorType>
+    void
+    compute_residuals(const MatrixType &               A,
+                      const MultiVector<VectorType> &  X,
+                      const MultiVector<VectorType> &  B,
+                      const std::vector<unsigned int> &columns,
+                      MultiVector<VectorType> &        R,
+                      MultiVector<VectorType> &        tmp)
+    {
+      R.reinit(columns.size(), B[0], true);
+      tmp.reinit(columns.size(), B[0], true);
+      for (unsigned int i = 0; i < columns.size(); ++i)
+        tmp[i] = X[columns[i]];
+      internal::MultiVectorImplementation::vmult(A, R, tmp);
+      for (unsigned int i = 0; i < columns.size(); ++i)
+        R[i].sadd(-1., 1., B[columns[i]]);
+    }
+
+
+
+    /**
+     * Make the search directions @p P orthonormal with respect to the inner
+     * product induced by the matrix, given $AP$ in @p Q, which is transformed
+     * in the same way. The method is a Cholesky factorization of the Gram
+     * matrix $P^TAP$ that skips the columns whose pivot is lost in roundoff,
+     * i.e., search directions that are linearly dependent on the previous
+     * ones are dropped. Return the number of remaining search directions.
+     */
+    template <typename VectorType>
+    unsigned int
+    a_orthonormalize(MultiVector<VectorType> &P, MultiVector<VectorType> &Q)
+    {
+      using number = typename VectorType::value_type;
+
+      const unsigned int n = P.n_vectors();
+      if (n == 0)
+        return 0;
+
+      FullMatrix<number> gram;
+      P.Tmmult(gram, Q);
+
+      // Cholesky factorization gram = R^T R computed column by column. The
+      // columns of the coefficient matrix C = R^{-1} are built up at the
+      // same time, such that P C is A-orthonormal
+      const double              drop_tolerance = 1e-10;
+      std::vector<unsigned int> kept;
+      FullMatrix<double>        R(n, n);
+      FullMatrix<number>        C(n, n);
+      for (unsigned int j = 0; j < n; ++j)
+        {
+          const double gram_jj = gram(j, j);
+          double       d       = gram_jj;
+          for (unsigned int k = 0; k < kept.size(); ++k)
+            {
+              double r = 0.5 * (gram(kept[k], j) + gram(j, kept[k]));
+              for (unsigned int l = 0; l < k; ++l)
+                r -= R(kept[l], kept[k]) * R(kept[l], j);
+              R(kept[k], j) = r / R(kept[k], kept[k]);
+              d -= R(kept[k], j) * R(kept[k], j);
+            }
+          if (!(d > drop_tolerance * gram_jj) || gram_jj <= 0.)
+            continue;
+
+          R(j, j)           = std::sqrt(d);
+          C(j, kept.size()) = 1. / R(j, j);
+          for (unsigned int k = 0; k < kept.size(); ++k)
+            for (unsigned int i = 0; i < n; ++i)
+              C(i, kept.size()) -= R(kept[k], j) / R(j, j) * C(i, k);
+          kept.push_back(j);
+        }
+
+      if (kept.empty())
+        {
+          P.select_vectors(kept);
+          Q.select_vectors(kept);
+          return 0;
+        }
+
+      FullMatrix<number> C_kept(n, kept.size());
+      C_kept.fill(C, 0, 0, 0, 0);
+
+      MultiVector<VectorType> tmp(kept.size(), P[0]);
+      P.mmult(tmp, C_kept);
+      P.swap(tmp);
+      tmp.reinit(kept.size(), P[0], true);
+      Q.mmult(tmp, C_kept);
+      Q.swap(tmp);
+
+      return kept.size();
+    }
+  } // namespace SolverBlockKrylov
+} // namespace internal
+
+
+
+/**
+ * Block preconditioned conjugate gradient method (D. P. O'Leary, The block
+ * conjugate gradient algorithm and related methods, Linear Algebra Appl. 29
+ * (1980)) for several right hand sides of the same symmetric positive
+ * definite linear system. The right hand sides and the solutions are stored
+ * in MultiVector objects whose vectors are of type @p VectorType.
+ *
+ * Instead of one search direction per right hand side, the method uses the
+ * span of the search directions of all right hand sides, which usually
+ * reduces the number of iterations compared to solving for each right hand
+ * side with SolverCG. More importantly, the matrix is applied to all search
+ * directions at once through a function
+ * <tt>vmult(MultiVector<VectorType> &, const MultiVector<VectorType> &)</tt>,
+ * which for SparseMatrix reads the matrix only once per iteration for all
+ * right hand sides. Other operators and the preconditioner are applied to one
+ * vector after the other, see internal::MultiVectorImplementation::vmult().
+ * The inner products and vector updates are done through
+ * MultiVector::Tmmult() and MultiVector::mmult().
+ *
+ * <h3>Convergence and deflation</h3>
+ *
+ * The value passed to the SolverControl object in each iteration is the
+ * largest $l_2$ norm of the residuals of all right hand sides. Once the
+ * residual of a single right hand side falls below the tolerance of the
+ * SolverControl object, or below the reduction of a ReductionControl object
+ * relative to the largest initial residual, its solution is considered
+ * converged: it is no longer updated and its search direction is removed
+ * from the iteration (deflation), which saves work once some right hand
+ * sides have converged.
+ *
+ * The search directions are made orthonormal with respect to the inner
+ * product induced by the matrix through a Cholesky factorization of the
+ * small projected matrix that skips vanishing pivots, as done in
+ * EigenLOBPCG. Search directions that are linearly dependent on the others,
+ * for example because two right hand sides are identical or parallel, are
+ * thereby dropped as well, and the corresponding solutions are computed from
+ * the remaining search directions.
+ *
+ * @note The solution passed to the functions connected to the iteration
+ * status signal, see Solver::connect(), is only updated when columns are
+ * deflated and at the end of the solution process.
+ */
+template <typename VectorType = Vector<double>>
+class SolverBlockCG : public Solver<MultiVector<VectorType>>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver. There
+   * is no data in here for this class.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * Constructor.
+   */
+  SolverBlockCG(SolverControl &                        cn,
+                VectorMemory<MultiVector<VectorType>> &mem,
+                const AdditionalData &                 data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverBlockCG(SolverControl &       cn,
+                const AdditionalData &data = AdditionalData());
+
+  /**
+   * Solve the linear systems $AX=B$ for all vectors of @p X and @p B.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &             A,
+        MultiVector<VectorType> &      X,
+        const MultiVector<VectorType> &B,
+        const PreconditionerType &     preconditioner);
+
+protected:
+  /**
+   * The control object, whose tolerance determines when a single column is
+   * deflated.
+   */
+  SolverControl &solver_control;
+
+  /**
+   * Store a copy of the flags for this particular solver.
+   */
+  AdditionalData additional_data;
+};
+
+
+
+/**
+ * Block GMRES method for several right hand sides of the same linear system,
+ * with the right hand sides and the solutions stored in MultiVector objects.
+ * All right hand sides share a single Krylov space, built from blocks of
+ * basis vectors: each iteration applies the preconditioner and the matrix to
+ * the most recent block, orthogonalizes the result against all previous
+ * blocks with block classical Gram-Schmidt with reorthogonalization, see
+ * MultiVector::Tmmult() and MultiVector::mmult(), and orthonormalizes the
+ * vectors of the new block among themselves. As for SolverBlockCG, the
+ * matrix is applied to all vectors of a block at once if it provides a
+ * multivector <tt>vmult()</tt> function, like SparseMatrix.
+ *
+ * The method uses right preconditioning, so the residuals it minimizes and
+ * passes to the SolverControl object are those of the original systems. The
+ * value passed to the SolverControl object is the largest residual norm of
+ * all right hand sides. After AdditionalData::max_n_blocks iterations, the
+ * solution is updated and the method is restarted.
+ *
+ * <h3>Deflation</h3>
+ *
+ * Vectors that are numerically linearly dependent on the previous basis
+ * vectors, e.g., because the right hand sides are linearly dependent or
+ * because the Krylov space of some right hand side has become invariant, are
+ * removed from the basis, so the blocks may get smaller during an iteration.
+ * At each restart, the right hand sides whose residual has fallen below the
+ * tolerance are removed from the iteration, see the documentation of
+ * SolverBlockCG.
+ */
+template <typename VectorType = Vector<double>>
+class SolverBlockGMRES : public Solver<MultiVector<VectorType>>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, the method is restarted after ten blocks of
+     * basis vectors.
+     */
+    explicit AdditionalData(const unsigned int max_n_blocks = 10);
+
+    /**
+     * The maximal number of blocks of basis vectors, i.e., of iterations,
+     * before a restart. The basis then contains up to this number times the
+     * number of right hand sides vectors.
+     */
+    unsigned int max_n_blocks;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverBlockGMRES(SolverControl &                        cn,
+                   VectorMemory<MultiVector<VectorType>> &mem,
+                   const AdditionalData &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverBlockGMRES(SolverControl &       cn,
+                   const AdditionalData &data = AdditionalData());
+
+  /**
+   * Solve the linear systems $AX=B$ for all vectors of @p X and @p B.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &             A,
+        MultiVector<VectorType> &      X,
+        const MultiVector<VectorType> &B,
+        const PreconditionerType &     preconditioner);
+
+protected:
+  /**
+   * The type of the norms of the vectors.
+   */
+  using real_type = typename MultiVector<VectorType>::real_type;
+
+  /**
+   * Orthonormalize the vectors of @p W one after the other with the
+   * modified Gram-Schmidt method. Vectors whose norm drops below a small
+   * fraction of their norm in @p reference_norms are considered linearly
+   * dependent on the previous ones and removed from @p W. On return,
+   * @p W_old = @p W_new * @p factor, with @p factor having a row for each
+   * remaining vector and a column for each original vector.
+   */
+  static void
+  orthonormalize(MultiVector<VectorType> &                    W,
+                 const std::vector<real_type> &               reference_norms,
+                 FullMatrix<typename VectorType::value_type> &factor);
+
+  /**
+   * The control object, whose tolerance determines when a single column is
+   * deflated.
+   */
+  SolverControl &solver_control;
+
+  /**
+   * Store a copy of the flags for this particular solver.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename VectorType>
+SolverBlockCG<VectorType>::SolverBlockCG(
+  SolverControl &                        cn,
+  VectorMemory<MultiVector<VectorType>> &mem,
+  const AdditionalData &                 data)
+  : Solver<MultiVector<VectorType>>(cn, mem)
+  , solver_control(cn)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverBlockCG<VectorType>::SolverBlockCG(SolverControl &       cn,
+                                         const AdditionalData &data)
+  : Solver<MultiVector<VectorType>>(cn)
+  , solver_control(cn)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverBlockCG<VectorType>::solve(const MatrixType &             A,
+                                 MultiVector<VectorType> &      X,
+                                 const MultiVector<VectorType> &B,
+                                 const PreconditionerType &     preconditioner)
+{
+  using number    = typename VectorType::value_type;
+  using real_type = typename MultiVector<VectorType>::real_type;
+
+  AssertDimension(X.n_vectors(), B.n_vectors());
+  if (B.n_vectors() == 0)
+    return;
+
+  LogStream::Prefix prefix("block_cg");
+
+  typename VectorMemory<MultiVector<VectorType>>::Pointer R_pointer(
+    this->memory);
+  typename VectorMemory<MultiVector<VectorType>>::Pointer Z_pointer(
+    this->memory);
+  typename VectorMemory<MultiVector<VectorType>>::Pointer P_pointer(
+    this->memory);
+  typename VectorMemory<MultiVector<VectorType>>::Pointer Q_pointer(
+    this->memory);
+  typename VectorMemory<MultiVector<VectorType>>::Pointer X_active_pointer(
+    this->memory);
+
+  // define some aliases for simpler access. R, Z, P, and Q only contain the
+  // columns that are not yet converged, and X_active the corresponding
+  // columns of the solution
+  MultiVector<VectorType> &R        = *R_pointer;
+  MultiVector<VectorType> &Z        = *Z_pointer;
+  MultiVector<VectorType> &P        = *P_pointer;
+  MultiVector<VectorType> &Q        = *Q_pointer;
+  MultiVector<VectorType> &X_active = *X_active_pointer;
+
+  std::vector<unsigned int> active(B.n_vectors());
+  for (unsigned int i = 0; i < active.size(); ++i)
+    active[i] = i;
+
+  internal::SolverBlockKrylov::compute_residuals(A, X, B, active, R, Z);
+  std::vector<real_type> norms;
+  R.l2_norms(norms);
+
+  // the residual norms of all columns, including the converged ones
+  std::vector<real_type> all_norms(norms);
+  double res = *std::max_element(all_norms.begin(), all_norms.end());
+
+  unsigned int         it   = 0;
+  SolverControl::State conv = this->iteration_status(0, res, X);
+  if (conv != SolverControl::iterate)
+    return;
+
+  const double tolerance =
+    internal::SolverBlockKrylov::deflation_tolerance(solver_control, res);
+
+  FullMatrix<number>        alpha, beta;
+  std::vector<unsigned int> kept;
+  bool                      first_iteration = true;
+
+  while (conv == SolverControl::iterate)
+    {
+      // remove the converged columns from the iteration after storing their
+      // solution
+      kept.clear();
+      for (unsigned int i = 0; i < active.size(); ++i)
+        if (norms[i] > tolerance)
+          kept.push_back(i);
+        else if (!first_iteration)
+          X[active[i]] = X_active[i];
+      if (kept.empty())
+        {
+          active.clear();
+          conv = SolverControl::success;
+          break;
+        }
+
+      if (first_iteration)
+        {
+          X_active.reinit(kept.size(), B[0], true);
+          for (unsigned int i = 0; i < kept.size(); ++i)
+            X_active[i] = X[active[kept[i]]];
+        }
+      else
+        X_active.select_vectors(kept);
+      R.select_vectors(kept);
+      for (unsigned int i = 0; i < kept.size(); ++i)
+        active[i] = active[kept[i]];
+      active.resize(kept.size());
+
+      // apply the preconditioner and make the new search directions
+      // A-orthogonal to the previous ones, which are A-orthonormal
+      Z.reinit(R, true);
+      internal::MultiVectorImplementation::vmult(preconditioner, Z, R);
+      if (first_iteration)
+        P.swap(Z);
+      else
+        {
+          Q.Tmmult(beta, Z);
+          beta *= number(-1.);
+          P.mmult(Z, beta, true);
+          P.swap(Z);
+        }
+      first_iteration = false;
+
+      ++it;
+      Q.reinit(P, true);
+      internal::MultiVectorImplementation::vmult(A, Q, P);
+
+      // make the search directions A-orthonormal, dropping the ones that
+      // are linearly dependent on the others. the projected matrix P^T A P
+      // is then the identity matrix
+      if (internal::SolverBlockKrylov::a_orthonormalize(P, Q) == 0)
+        {
+          conv = SolverControl::failure;
+          break;
+        }
+
+      P.Tmmult(alpha, R);
+      P.mmult(X_active, alpha, true);
+      alpha *= number(-1.);
+      Q.mmult(R, alpha, true);
+
+      R.l2_norms(norms);
+      for (unsigned int i = 0; i < active.size(); ++i)
+        all_norms[active[i]] = norms[i];
+      res = *std::max_element(all_norms.begin(), all_norms.end());
+
+      conv = this->iteration_status(it, res, X);
+    }
+
+  for (unsigned int i = 0; i < active.size(); ++i)
+    X[active[i]] = X_active[i];
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence(it, res));
+  // otherwise exit as normal
+}
+
+
+
+template <typename VectorType>
+SolverBlockGMRES<VectorType>::AdditionalData::AdditionalData(
+  const unsigned int max_n_blocks)
+  : max_n_blocks(max_n_blocks)
+{}
+
+
+
+template <typename VectorType>
+SolverBlockGMRES<VectorType>::SolverBlockGMRES(
+  SolverControl &                        cn,
+  VectorMemory<MultiVector<VectorType>> &mem,
+  const AdditionalData &                 data)
+  : Solver<MultiVector<VectorType>>(cn, mem)
+  , solver_control(cn)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverBlockGMRES<VectorType>::SolverBlockGMRES(SolverControl &       cn,
+                                               const AdditionalData &data)
+  : Solver<MultiVector<VectorType>>(cn)
+  , solver_control(cn)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+void
+SolverBlockGMRES<VectorType>::orthonormalize(
+  MultiVector<VectorType> &                    W,
+  const std::vector<real_type> &               reference_norms,
+  FullMatrix<typename VectorType::value_type> &factor)
+{
+  using number = typename VectorType::value_type;
+
+  AssertDimension(reference_norms.size(), W.n_vectors());
+  const unsigned int n_vectors = W.n_vectors();
+
+  // the relative size below which a vector is considered linearly
+  // dependent on the previous ones
+  const double dependence_tolerance = 1e-10;
+
+  FullMatrix<number>        full_factor(n_vectors, n_vectors);
+  std::vector<unsigned int> kept;
+  for (unsigned int j = 0; j < n_vectors; ++j)
+    {
+      for (const unsigned int i : kept)
+        {
+          const number r    = W[j] * W[i];
+          full_factor(i, j) = r;
+          W[j].add(-r, W[i]);
+        }
+      const double norm = W[j].l2_norm();
+      if (norm > dependence_tolerance * reference_norms[j])
+        {
+          W[j] /= norm;
+          full_factor(j, j) = norm;
+          kept.push_back(j);
+        }
+    }
+
+  factor.reinit(kept.size(), n_vectors);
+  for (unsigned int i = 0; i < kept.size(); ++i)
+    for (unsigned int j = 0; j < n_vectors; ++j)
+      factor(i, j) = full_factor(kept[i], j);
+  W.select_vectors(kept);
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverBlockGMRES<VectorType>::solve(
+  const MatrixType &             A,
+  MultiVector<VectorType> &      X,
+  const MultiVector<VectorType> &B,
+  const PreconditionerType &     preconditioner)
+{
+  using number = typename VectorType::value_type;
+
+  AssertDimension(X.n_vectors(), B.n_vectors());
+  Assert(additional_data.max_n_blocks > 0, ExcLowerRange(0, 1));
+  if (B.n_vectors() == 0)
+    return;
+
+  LogStream::Prefix prefix("block_gmres");
+
+  typename VectorMemory<MultiVector<VectorType>>::Pointer R_pointer(
+    this->memory);
+  typename VectorMemory<MultiVector<VectorType>>::Pointer W_pointer(
+    this->memory);
+  typename VectorMemory<MultiVector<VectorType>>::Pointer U_pointer(
+    this->memory);
+
+  MultiVector<VectorType> &R = *R_pointer;
+  MultiVector<VectorType> &W = *W_pointer;
+  MultiVector<VectorType> &U = *U_pointer;
+
+  // the blocks of basis vectors
+  std::vector<MultiVector<VectorType>> basis(additional_data.max_n_blocks +
+                                             1);
+
+  std::vector<unsigned int> active(B.n_vectors());
+  for (unsigned int i = 0; i < active.size(); ++i)
+    active[i] = i;
+
+  internal::SolverBlockKrylov::compute_residuals(A, X, B, active, R, W);
+  std::vector<real_type> norms;
+  R.l2_norms(norms);
+
+  std::vector<real_type> all_norms(norms);
+  double res = *std::max_element(all_norms.begin(), all_norms.end());
+
+  unsigned int         it   = 0;
+  SolverControl::State conv = this->iteration_status(0, res, X);
+  if (conv != SolverControl::iterate)
+    return;
+
+  const double tolerance =
+    internal::SolverBlockKrylov::deflation_tolerance(solver_control, res);
+
+  FullMatrix<number>        S, C, factor, H, H_k, Y;
+  std::vector<unsigned int> block_starts;
+  std::vector<unsigned int> kept;
+  Vector<number>            ls_rhs, ls_solution;
+  std::vector<real_type>    reference_norms;
+
+  while (conv == SolverControl::iterate)
+    {
+      // remove the converged columns from the iteration
+      kept.clear();
+      for (unsigned int i = 0; i < active.size(); ++i)
+        if (norms[i] > tolerance)
+          kept.push_back(i);
+      R.select_vectors(kept);
+      if (kept.empty())
+        {
+          conv = SolverControl::success;
+          break;
+        }
+      for (unsigned int i = 0; i < kept.size(); ++i)
+        active[i] = active[kept[i]];
+      active.resize(kept.size());
+      const unsigned int n_active = active.size();
+
+      // the first block of basis vectors spans the residuals, R = V_0 S
+      R.l2_norms(reference_norms);
+      basis[0].swap(R);
+      orthonormalize(basis[0], reference_norms, S);
+
+      const unsigned int max_basis_size =
+        (additional_data.max_n_blocks + 1) * n_active;
+      H.reinit(max_basis_size, max_basis_size);
+      block_starts.assign(1, 0);
+      block_starts.push_back(basis[0].n_vectors());
+
+      unsigned int k = 0;
+      for (; k < additional_data.max_n_blocks && basis[k].n_vectors() > 0;)
+        {
+          // next block: A M^{-1} V_k
+          U.reinit(basis[k], true);
+          internal::MultiVectorImplementation::vmult(preconditioner,
+                                                     U,
+                                                     basis[k]);
+          W.reinit(basis[k], true);
+          internal::MultiVectorImplementation::vmult(A, W, U);
+          W.l2_norms(reference_norms);
+
+          // block classical Gram-Schmidt against all previous blocks, done
+          // twice for stability
+          for (unsigned int pass = 0; pass < 2; ++pass)
+            for (unsigned int i = 0; i <= k; ++i)
+              {
+                basis[i].Tmmult(C, W);
+                for (unsigned int r = 0; r < C.m(); ++r)
+                  for (unsigned int c = 0; c < C.n(); ++c)
+                    H(block_starts[i] + r, block_starts[k] + c) += C(r, c);
+                C *= number(-1.);
+                basis[i].mmult(W, C, true);
+              }
+
+          orthonormalize(W, reference_norms, factor);
+          for (unsigned int r = 0; r < factor.m(); ++r)
+            for (unsigned int c = 0; c < factor.n(); ++c)
+              H(block_starts[k + 1] + r, block_starts[k] + c) = factor(r, c);
+          basis[k + 1].swap(W);
+          block_starts.push_back(block_starts[k + 1] +
+                                 basis[k + 1].n_vectors());
+          ++k;
+
+          // solve the least squares problems min |E_1 S - H y| for all
+          // columns; their residuals are the residuals of the systems
+          const unsigned int n_rows = block_starts[k + 1];
+          const unsigned int n_cols = block_starts[k];
+          H_k.reinit(n_rows, n_cols);
+          for (unsigned int r = 0; r < n_rows; ++r)
+            for (unsigned int c = 0; c < n_cols; ++c)
+              H_k(r, c) = H(r, c);
+          const Householder<number> householder(H_k);
+
+          Y.reinit(n_cols, n_active);
+          ls_rhs.reinit(n_rows);
+          ls_solution.reinit(n_cols);
+          for (unsigned int c = 0; c < n_active; ++c)
+            {
+              ls_rhs = number();
+              for (unsigned int r = 0; r < S.m(); ++r)
+                ls_rhs(r) = S(r, c);
+              norms[c] = householder.least_squares(ls_solution, ls_rhs);
+              for (unsigned int r = 0; r < n_cols; ++r)
+                Y(r, c) = ls_solution(r);
+              all_norms[active[c]] = norms[c];
+            }
+          res = *std::max_element(all_norms.begin(), all_norms.end());
+
+          ++it;
+          conv = this->iteration_status(it, res, X);
+          if (conv != SolverControl::iterate)
+            break;
+        }
+
+      // update the solution with M^{-1} V Y
+      W.reinit(n_active, B[0]);
+      for (unsigned int i = 0; i < k; ++i)
+        {
+          C.reinit(basis[i].n_vectors(), n_active);
+          for (unsigned int r = 0; r < C.m(); ++r)
+            for (unsigned int c = 0; c < n_active; ++c)
+              C(r, c) = Y(block_starts[i] + r, c);
+          basis[i].mmult(W, C, true);
+        }
+      U.reinit(W, true);
+      internal::MultiVectorImplementation::vmult(preconditioner, U, W);
+      for (unsigned int c = 0; c < n_active; ++c)
+        X[active[c]] += U[c];
+
+      // restart with the true residuals of the remaining columns
+      if (conv == SolverControl::iterate)
+        {
+          internal::SolverBlockKrylov::compute_residuals(
+            A, X, B, active, R, W);
+          R.l2_norms(norms);
+          for (unsigned int c = 0; c < n_active; ++c)
+            all_norms[active[c]] = norms[c];
+        }
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence(it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,569 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_deflated_cg_h
+#define dealii_solver_deflated_cg_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * This class implements a deflated preconditioned Conjugate Gradient method
+ * that recycles information between the solution of a sequence of linear
+ * systems with the same or slowly changing symmetric positive definite
+ * matrices, as they appear in implicit time stepping or in optimization
+ * loops. The algorithm follows the deflated CG method by Y. Saad, M.
+ * Yeung, J. Erhel and F. Guyomarc'h, "A deflated version of the conjugate
+ * gradient algorithm", SIAM J. Sci. Comput. 21 (2000), pp. 1909-1926.
+ *
+ * The solver keeps a deflation space spanned by the vectors $W=[w_1,\ldots,
+ * w_k]$ that approximate the eigenvectors of the matrix belonging to its
+ * smallest eigenvalues. In each solve, the initial guess is first corrected
+ * such that the residual is orthogonal to $W$, and all search directions
+ * are kept $A$-orthogonal to $W$. This removes the smallest eigenvalues from
+ * the spectrum seen by CG and thus reduces the number of iterations for
+ * ill-conditioned problems. At the beginning of each call to solve(), the
+ * products $AW$ are recomputed with the current matrix, at the cost of $k$
+ * matrix-vector products, such that the matrix can change between solves.
+ *
+ * During each solve, the first AdditionalData::n_stored_directions search
+ * directions are stored, normalized in the energy norm. After the solve,
+ * the deflation space is replaced by the harmonic Ritz vectors belonging to
+ * the AdditionalData::deflation_space_size smallest harmonic Ritz values of
+ * the matrix with respect to the space spanned by the old deflation vectors
+ * and the stored directions. Since the stored directions are $A$-orthogonal
+ * to each other and to the old deflation space, the small generalized
+ * eigenvalue problem for the harmonic Ritz values is well conditioned; it is
+ * solved with LAPACK. The first solve starts with an empty deflation space
+ * and is equivalent to SolverCG, except for the storage of the directions.
+ *
+ * @note The update of the deflation space needs LAPACK, so this class can
+ * only be used if deal.II was configured with LAPACK. Otherwise, an
+ * exception is thrown at the end of the first call to solve() that stored
+ * search directions.
+ *
+ * The solver works with any vector type, matrix and symmetric
+ * preconditioner supported by SolverCG. It stores $k$ deflation vectors and
+ * their products with the matrix as well as two vectors per stored search
+ * direction, which are reused between calls to solve(). The deflation space
+ * is tied to the object of this class, so the same solver object must be
+ * used for the whole sequence of linear systems.
+ *
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence. The number of iterations saved
+ * by the recycling can be queried by iteration_savings(), which compares
+ * the number of iterations of the last solve to the number of iterations of
+ * the last solve with an empty deflation space.
+ */
+template <typename VectorType = Vector<double>>
+class SolverDeflatedCG : public Solver<VectorType>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, eight vectors are recycled, which are
+     * extracted from the first twenty search directions of each solve.
+     */
+    explicit AdditionalData(const unsigned int deflation_space_size = 8,
+                            const unsigned int n_stored_directions  = 20);
+
+    /**
+     * The maximal number of vectors in the deflation space.
+     */
+    unsigned int deflation_space_size;
+
+    /**
+     * The number of search directions that are stored in each solve in
+     * order to update the deflation space.
+     */
+    unsigned int n_stored_directions;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverDeflatedCG(SolverControl &           cn,
+                   VectorMemory<VectorType> &mem,
+                   const AdditionalData &    data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverDeflatedCG(SolverControl &       cn,
+                   const AdditionalData &data = AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverDeflatedCG() override = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x, using the current deflation space,
+   * and update the deflation space afterwards.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        VectorType &              x,
+        const VectorType &        b,
+        const PreconditionerType &preconditioner);
+
+  /**
+   * Return the number of vectors currently in the deflation space.
+   */
+  unsigned int
+  n_deflation_vectors() const;
+
+  /**
+   * Return the vectors currently spanning the deflation space.
+   */
+  const std::vector<VectorType> &
+  get_deflation_vectors() const;
+
+  /**
+   * Return the difference between the number of iterations of the last
+   * solve with an empty deflation space and the number of iterations of the
+   * last solve. The result is negative if recycling increased the number of
+   * iterations, and zero if no solve has been done yet.
+   */
+  int
+  iteration_savings() const;
+
+  /**
+   * Remove all vectors from the deflation space, e.g. when the matrix has
+   * changed so much that the old vectors are of no use anymore. The next
+   * solve then starts from scratch.
+   */
+  void
+  clear_deflation_space();
+
+protected:
+  /**
+   * Replace the deflation space by the harmonic Ritz vectors with respect to
+   * the space spanned by the current deflation vectors and the stored search
+   * directions.
+   */
+  void
+  update_deflation_space(const VectorType &x);
+
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The vectors spanning the deflation space.
+   */
+  std::vector<VectorType> deflation_vectors;
+
+  /**
+   * The products of the matrix with the deflation vectors, computed at the
+   * beginning of each solve.
+   */
+  std::vector<VectorType> deflation_products;
+
+  /**
+   * The search directions of the current solve, normalized in the energy
+   * norm, and their products with the matrix. The vectors are kept between
+   * solves to avoid reallocation, and only the first
+   * #n_directions_in_use of them belong to the current solve.
+   */
+  std::vector<VectorType> stored_directions;
+  std::vector<VectorType> stored_products;
+
+  /**
+   * The number of stored search directions of the current solve.
+   */
+  unsigned int n_directions_in_use;
+
+  /**
+   * The number of iterations of the last solve with an empty deflation
+   * space, or numbers::invalid_unsigned_int if there was no such solve.
+   */
+  unsigned int iterations_without_deflation;
+
+  /**
+   * The number of iterations of the last solve.
+   */
+  unsigned int last_n_iterations;
+};
+
+/*@}*/
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename VectorType>
+SolverDeflatedCG<VectorType>::AdditionalData::AdditionalData(
+  const unsigned int deflation_space_size,
+  const unsigned int n_stored_directions)
+  : deflation_space_size(deflation_space_size)
+  , n_stored_directions(n_stored_directions)
+{}
+
+
+
+template <typename VectorType>
+SolverDeflatedCG<VectorType>::SolverDeflatedCG(SolverControl &           cn,
+                                               VectorMemory<VectorType> &mem,
+                                               const AdditionalData &    data)
+  : Solver<VectorType>(cn, mem)
+  , additional_data(data)
+  , n_directions_in_use(0)
+  , iterations_without_deflation(numbers::invalid_unsigned_int)
+  , last_n_iterations(numbers::invalid_unsigned_int)
+{}
+
+
+
+template <typename VectorType>
+SolverDeflatedCG<VectorType>::SolverDeflatedCG(SolverControl &       cn,
+                                               const AdditionalData &data)
+  : Solver<VectorType>(cn)
+  , additional_data(data)
+  , n_directions_in_use(0)
+  , iterations_without_deflation(numbers::invalid_unsigned_int)
+  , last_n_iterations(numbers::invalid_unsigned_int)
+{}
+
+
+
+template <typename VectorType>
+unsigned int
+SolverDeflatedCG<VectorType>::n_deflation_vectors() const
+{
+  return deflation_vectors.size();
+}
+
+
+
+template <typename VectorType>
+const std::vector<VectorType> &
+SolverDeflatedCG<VectorType>::get_deflation_vectors() const
+{
+  return deflation_vectors;
+}
+
+
+
+template <typename VectorType>
+int
+SolverDeflatedCG<VectorType>::iteration_savings() const
+{
+  if (iterations_without_deflation == numbers::invalid_unsigned_int ||
+      last_n_iterations == numbers::invalid_unsigned_int)
+    return 0;
+  return static_cast<int>(iterations_without_deflation) -
+         static_cast<int>(last_n_iterations);
+}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::clear_deflation_space()
+{
+  deflation_vectors.clear();
+  deflation_products.clear();
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverDeflatedCG<VectorType>::solve(const MatrixType &        A,
+                                    VectorType &              x,
+                                    const VectorType &        b,
+                                    const PreconditionerType &preconditioner)
+{
+  using number = typename VectorType::value_type;
+
+  SolverControl::State conv = SolverControl::iterate;
+
+  LogStream::Prefix prefix("DeflatedCG");
+
+  // Memory allocation
+  typename VectorMemory<VectorType>::Pointer r_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer z_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer Ap_pointer(this->memory);
+
+  // define some aliases for simpler access
+  VectorType &r  = *r_pointer;
+  VectorType &z  = *z_pointer;
+  VectorType &p  = *p_pointer;
+  VectorType &Ap = *Ap_pointer;
+
+  r.reinit(x, true);
+  z.reinit(x, true);
+  p.reinit(x, true);
+  Ap.reinit(x, true);
+
+  // discard a deflation space that belongs to a problem of different size
+  if (deflation_vectors.size() > 0 && deflation_vectors[0].size() != x.size())
+    clear_deflation_space();
+  const bool empty_deflation_space = deflation_vectors.empty();
+
+  // compute the products with the current matrix and the Galerkin matrix
+  // W^T A W of the deflation space
+  const unsigned int n_old = deflation_vectors.size();
+  deflation_products.resize(n_old);
+  FullMatrix<double> galerkin_matrix(n_old, n_old);
+  for (unsigned int i = 0; i < n_old; ++i)
+    {
+      deflation_products[i].reinit(x, true);
+      A.vmult(deflation_products[i], deflation_vectors[i]);
+      for (unsigned int j = 0; j <= i; ++j)
+        galerkin_matrix(i, j) = galerkin_matrix(j, i) =
+          deflation_vectors[j] * deflation_products[i];
+    }
+
+  // drop the deflation vectors that are linearly dependent on the previous
+  // ones, which would make the Galerkin matrix singular. they are detected
+  // by a vanishing pivot in the Cholesky factorization of the Galerkin
+  // matrix, computed column by column for the kept vectors only
+  const double              drop_tolerance = 1e-10;
+  std::vector<unsigned int> kept;
+  {
+    FullMatrix<double> R(n_old, n_old);
+    for (unsigned int j = 0; j < n_old; ++j)
+      {
+        double d = galerkin_matrix(j, j);
+        for (unsigned int k = 0; k < kept.size(); ++k)
+          {
+            double r = galerkin_matrix(kept[k], j);
+            for (unsigned int l = 0; l < k; ++l)
+              r -= R(kept[l], kept[k]) * R(kept[l], j);
+            R(kept[k], j) = r / R(kept[k], kept[k]);
+            d -= R(kept[k], j) * R(kept[k], j);
+          }
+        if (d > drop_tolerance * galerkin_matrix(j, j) &&
+            galerkin_matrix(j, j) > 0.)
+          {
+            R(j, j) = std::sqrt(d);
+            kept.push_back(j);
+          }
+      }
+  }
+  const unsigned int n_deflation = kept.size();
+  for (unsigned int i = 0; i < n_deflation; ++i)
+    if (kept[i] != i)
+      {
+        deflation_vectors[i].swap(deflation_vectors[kept[i]]);
+        deflation_products[i].swap(deflation_products[kept[i]]);
+      }
+  deflation_vectors.resize(n_deflation);
+  deflation_products.resize(n_deflation);
+
+  FullMatrix<double> galerkin_inverse(n_deflation, n_deflation);
+  for (unsigned int i = 0; i < n_deflation; ++i)
+    for (unsigned int j = 0; j < n_deflation; ++j)
+      galerkin_inverse(i, j) = galerkin_matrix(kept[i], kept[j]);
+  if (n_deflation > 0)
+    galerkin_inverse.gauss_jordan();
+
+  // compute the coefficients (W^T A W)^{-1} V^T v for either V=W or V=AW
+  Vector<double> projection(n_deflation), coefficients(n_deflation);
+
+  const auto compute_coefficients = [&](const std::vector<VectorType> &V,
+                                        const VectorType &             v) {
+    for (unsigned int i = 0; i < n_deflation; ++i)
+      projection(i) = V[i] * v;
+    galerkin_inverse.vmult(coefficients, projection);
+  };
+
+  n_directions_in_use = 0;
+
+  unsigned int it  = 0;
+  double       res = -std::numeric_limits<double>::max();
+
+  // compute the residual and make it orthogonal to the deflation space by a
+  // Galerkin correction of the initial guess
+  if (!x.all_zero())
+    {
+      A.vmult(r, x);
+      r.sadd(-1., 1., b);
+    }
+  else
+    r = b;
+  compute_coefficients(deflation_vectors, r);
+  for (unsigned int i = 0; i < n_deflation; ++i)
+    {
+      x.add(coefficients(i), deflation_vectors[i]);
+      r.add(-coefficients(i), deflation_products[i]);
+    }
+  res = r.l2_norm();
+
+  conv = this->iteration_status(0, res, x);
+
+  number rz = 0;
+  if (conv == SolverControl::iterate)
+    {
+      preconditioner.vmult(z, r);
+      rz = r * z;
+      p  = z;
+      compute_coefficients(deflation_products, z);
+      for (unsigned int i = 0; i < n_deflation; ++i)
+        p.add(-coefficients(i), deflation_vectors[i]);
+    }
+
+  while (conv == SolverControl::iterate)
+    {
+      ++it;
+      A.vmult(Ap, p);
+
+      const number pAp = p * Ap;
+      Assert(std::abs(pAp) != 0., ExcDivideByZero());
+      const number alpha = rz / pAp;
+
+      x.add(alpha, p);
+      res = std::sqrt(std::abs(r.add_and_dot(-alpha, Ap, r)));
+
+      // store the normalized search direction for the update of the
+      // deflation space
+      if (n_directions_in_use < additional_data.n_stored_directions &&
+          pAp > 0)
+        {
+          if (stored_directions.size() == n_directions_in_use)
+            {
+              stored_directions.emplace_back();
+              stored_products.emplace_back();
+            }
+          VectorType &direction = stored_directions[n_directions_in_use];
+          VectorType &product   = stored_products[n_directions_in_use];
+          direction.reinit(x, true);
+          product.reinit(x, true);
+          const number scaling = number(1.) / std::sqrt(pAp);
+          direction.equ(scaling, p);
+          product.equ(scaling, Ap);
+          ++n_directions_in_use;
+        }
+
+      conv = this->iteration_status(it, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      preconditioner.vmult(z, r);
+      const number rz_old = rz;
+      Assert(std::abs(rz_old) != 0., ExcDivideByZero());
+      rz                = r * z;
+      const number beta = rz / rz_old;
+
+      // new search direction, A-orthogonal to the deflation space
+      p.sadd(beta, 1., z);
+      compute_coefficients(deflation_products, z);
+      for (unsigned int i = 0; i < n_deflation; ++i)
+        p.add(-coefficients(i), deflation_vectors[i]);
+    }
+
+  update_deflation_space(x);
+
+  last_n_iterations = it;
+  if (empty_deflation_space)
+    iterations_without_deflation = it;
+
+  // in case of failure: throw exception
+  AssertThrow(conv == SolverControl::success,
+              SolverControl::NoConvergence(it, res));
+  // otherwise exit as normal
+}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::update_deflation_space(const VectorType &x)
+{
+  const unsigned int n_old   = deflation_vectors.size();
+  const unsigned int n_basis = n_old + n_directions_in_use;
+  const unsigned int n_new =
+    std::min(additional_data.deflation_space_size, n_basis);
+  if (n_directions_in_use == 0 || n_new == 0)
+    return;
+
+#ifdef DEAL_II_WITH_LAPACK
+  const auto basis = [&](const unsigned int i) -> const VectorType & {
+    return i < n_old ? deflation_vectors[i] : stored_directions[i - n_old];
+  };
+  const auto basis_product = [&](const unsigned int i) -> const VectorType & {
+    return i < n_old ? deflation_products[i] : stored_products[i - n_old];
+  };
+
+  // the harmonic Ritz pairs (theta, y) with respect to the space Z spanned
+  // by the basis satisfy (AZ)^T AZ y = theta Z^T AZ y
+  LAPACKFullMatrix<double> product_matrix(n_basis, n_basis);
+  LAPACKFullMatrix<double> galerkin_matrix(n_basis, n_basis);
+  for (unsigned int i = 0; i < n_basis; ++i)
+    for (unsigned int j = 0; j <= i; ++j)
+      {
+        product_matrix(i, j) = product_matrix(j, i) =
+          basis_product(i) * basis_product(j);
+        galerkin_matrix(i, j) = galerkin_matrix(j, i) =
+          basis(i) * basis_product(j);
+      }
+
+  // the eigenvalues are sorted in ascending order, so the first n_new
+  // eigenvectors belong to the smallest harmonic Ritz values
+  std::vector<Vector<double>> eigenvectors(n_new);
+  product_matrix.compute_generalized_eigenvalues_symmetric(galerkin_matrix,
+                                                           eigenvectors);
+
+  std::vector<VectorType> new_vectors(n_new);
+  for (unsigned int j = 0; j < n_new; ++j)
+    {
+      new_vectors[j].reinit(x);
+      for (unsigned int i = 0; i < n_basis; ++i)
+        new_vectors[j].add(eigenvectors[j](i), basis(i));
+    }
+  deflation_vectors.swap(new_vectors);
+#else
+  (void)x;
+  AssertThrow(false, ExcNeedsLAPACK());
+#endif
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -21,22 +21,38 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/std_cxx14/memory.h>
 #include <deal.II/base/subscriptor.h>
 
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/householder.h>
+#include <deal.II/lac/la_parallel_vector_expressions.h>
 #include <deal.II/lac/lapack_full_matrix.h>
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_control.h>
 #include <deal.II/lac/vector.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
+// forward declarations
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename, typename>
+    class Vector;
+  } // namespace distributed
+} // namespace LinearAlgebra
+
 /*!@addtogroup Solvers */
 /*@{*/
 
@@ -153,6 +169,28 @@ namespace internal
  * class, see the documentation of the Solver base class.
  *
  *
+ * <h3>Orthogonalization</h3>
+ *
+ * By default, each new vector of the Arnoldi basis is orthogonalized against
+ * the previous ones with the modified Gram-Schmidt algorithm, which computes
+ * one inner product after the other. For a basis of size $k$, this means $k$
+ * global reductions per iteration, which limits the scalability of the solver
+ * on many MPI processes. With the strategy
+ * AdditionalData::OrthogonalizationStrategy::classical_gram_schmidt, all
+ * inner products are computed in one pass over the vectors with a single
+ * global reduction, and the new vector is updated in a second pass, which
+ * also computes its norm with a second global reduction. Both passes work on
+ * several basis vectors at a time to reduce the memory traffic. This is done
+ * for the types dealii::Vector and LinearAlgebra::distributed::Vector, while
+ * all other vector types fall back to separate inner products. The passes are
+ * split into chunks that are worked on in parallel by several threads, and
+ * the sums are computed pairwise as in the vector operations of these types.
+ * If the norm of the vector dropped below $1/\sqrt{2}$ times its norm before
+ * the orthogonalization, which indicates that the classical Gram-Schmidt
+ * algorithm may not be accurate enough, the orthogonalization is repeated
+ * once for this vector (selective re-orthogonalization).
+ *
+ *
  * <h3>Observing the progress of linear solver iterations</h3>
  *
  * The solve() function of this class uses the mechanism described in the
@@ -183,16 +221,39 @@ public:
    */
   struct AdditionalData
   {
+    /**
+     * The algorithm used to orthogonalize the vectors of the Arnoldi basis,
+     * see the section on orthogonalization in the documentation of the
+     * class.
+     */
+    enum class OrthogonalizationStrategy
+    {
+      /**
+       * The modified Gram-Schmidt algorithm with one global reduction per
+       * basis vector.
+       */
+      modified_gram_schmidt,
+      /**
+       * The classical Gram-Schmidt algorithm with two global reductions for
+       * all basis vectors and selective re-orthogonalization.
+       */
+      classical_gram_schmidt
+    };
+
     /**
      * Constructor. By default, set the number of temporary vectors to 30,
      * i.e. do a restart every 28 iterations. Also set preconditioning from
      * left, the residual of the stopping criterion to the default residual,
-     * and re-orthogonalization only if necessary.
+     * re-orthogonalization only if necessary, and the modified Gram-Schmidt
+     * algorithm.
      */
-    explicit AdditionalData(const unsigned int max_n_tmp_vectors     = 30,
-                            const bool         right_preconditioning = false,
-                            const bool         use_default_residual  = true,
-                            const bool force_re_orthogonalization    = false);
+    explicit AdditionalData(
+      const unsigned int              max_n_tmp_vectors          = 30,
+      const bool                      right_preconditioning      = false,
+      const bool                      use_default_residual       = true,
+      const bool                      force_re_orthogonalization = false,
+      const OrthogonalizationStrategy orthogonalization_strategy =
+        OrthogonalizationStrategy::modified_gram_schmidt);
 
     /**
      * Maximum number of temporary vectors. This parameter controls the size
@@ -223,6 +284,11 @@ public:
      * if necessary.
      */
     bool force_re_orthogonalization;
+
+    /**
+     * The algorithm used to orthogonalize the vectors of the Arnoldi basis.
+     */
+    OrthogonalizationStrategy orthogonalization_strategy;
   };
 
   /**
@@ -411,6 +477,29 @@ protected:
     const boost::signals2::signal<void(int)> &re_orthogonalize_signal =
       boost::signals2::signal<void(int)>());
 
+  /**
+   * Orthogonalize the vector @p vv against the @p dim (orthogonal) vectors
+   * given by the first argument using the classical Gram-Schmidt algorithm,
+   * i.e., compute all inner products with one global reduction before @p vv
+   * is updated. The factors used for orthogonalization are stored in @p h.
+   * If @p force_re_orthogonalize is true, or if the norm of @p vv dropped
+   * below $1/\sqrt{2}$ times its norm before the orthogonalization, the
+   * algorithm is applied a second time. In the latter case, the signal
+   * @p re_orthogonalize_signal is called if it is connected. Return the norm
+   * of the orthogonalized vector.
+   */
+  static double
+  classical_gram_schmidt(
+    const internal::SolverGMRESImplementation::TmpVectors<VectorType>
+      &                                       orthogonal_vectors,
+    const unsigned int                        dim,
+    const unsigned int                        accumulated_iterations,
+    VectorType &                              vv,
+    Vector<double> &                          h,
+    const bool                                force_re_orthogonalize,
+    const boost::signals2::signal<void(int)> &re_orthogonalize_signal =
+      boost::signals2::signal<void(int)>());
+
   /**
    * Estimates the eigenvalues from the Hessenberg matrix, H_orig, generated
    * during the inner iterations. Uses these estimate to compute the condition
@@ -586,6 +675,477 @@ namespace internal
 
 
 
+    /**
+     * Compute the inner products of @p vv with the first @p dim vectors of
+     * @p orthogonal_vectors into @p h, and the square of the norm of @p vv
+     * into @p norm_sqr. This is the general version for all vector types,
+     * which computes one inner product after the other.
+     */
+    template <class VectorType>
+    void
+    multi_dot_and_norm(const TmpVectors<VectorType> &orthogonal_vectors,
+                       const unsigned int            dim,
+                       const VectorType &            vv,
+                       Vector<double> &              h,
+                       double &                      norm_sqr)
+    {
+      for (unsigned int i = 0; i < dim; ++i)
+        h(i) = vv * orthogonal_vectors[i];
+      norm_sqr = vv.norm_sqr();
+    }
+
+
+
+    /**
+     * Subtract the first @p dim vectors of @p orthogonal_vectors, multiplied
+     * by the entries of @p h, from @p vv and return the square of the norm
+     * of the result. This is the general version for all vector types.
+     */
+    template <class VectorType>
+    double
+    subtract_multiple_and_norm(
+      const TmpVectors<VectorType> &orthogonal_vectors,
+      const unsigned int            dim,
+      const Vector<double> &        h,
+      VectorType &                  vv)
+    {
+      for (unsigned int i = 0; i < dim; ++i)
+        vv.add(-h(i), orthogonal_vectors[i]);
+      return vv.norm_sqr();
+    }
+
+
+
+    /**
+     * Length of the ranges below which the functions below sum up the
+     * contributions of the vector entries in a straight loop. Longer ranges
+     * are split into two halves whose sums are added, as in
+     * internal::VectorOperations::accumulate_recursive(), which keeps the
+     * roundoff error of the sums small for long vectors.
+     */
+    const std::size_t multi_dot_recursion_threshold = 128;
+
+
+
+    /**
+     * Compute the inner products of the @p n_vectors vectors starting at
+     * @p basis with the array @p vv on the range [@p first, @p last) in a
+     * single pass over the arrays, and store them in the first @p n_vectors
+     * entries of @p result. The entry <tt>result[n_vectors]</tt> is set to
+     * the square of the norm of @p vv on this range.
+     */
+    template <unsigned int n_vectors, typename Number>
+    void
+    local_multi_dot(const Number *const *basis,
+                    const Number *       vv,
+                    const std::size_t    first,
+                    const std::size_t    last,
+                    double *             result)
+    {
+      double sums[n_vectors + 1] = {};
+      if (last - first > multi_dot_recursion_threshold)
+        {
+          // split at a multiple of 32 entries
+          const std::size_t middle = first + (last - first) / 64 * 32;
+          double            second_sums[n_vectors + 1];
+          local_multi_dot<n_vectors>(basis, vv, first, middle, sums);
+          local_multi_dot<n_vectors>(basis, vv, middle, last, second_sums);
+          for (unsigned int k = 0; k <= n_vectors; ++k)
+            sums[k] += second_sums[k];
+        }
+      else
+        for (std::size_t j = first; j < last; ++j)
+          {
+            const double v = vv[j];
+            for (unsigned int k = 0; k < n_vectors; ++k)
+              sums[k] += basis[k][j] * v;
+            sums[n_vectors] += v * v;
+          }
+      for (unsigned int k = 0; k <= n_vectors; ++k)
+        result[k] = sums[k];
+    }
+
+
+
+    /**
+     * Subtract the @p n_vectors vectors starting at @p basis, multiplied by
+     * the entries of @p factors, from the array @p vv on the range
+     * [@p first, @p last) in a single pass over the arrays. Return the
+     * square of the norm of the result on this range.
+     */
+    template <unsigned int n_vectors, typename Number>
+    double
+    local_subtract_multiple(const Number *const *basis,
+                            const double *       factors,
+                            const std::size_t    first,
+                            const std::size_t    last,
+                            Number *             vv)
+    {
+      if (last - first > multi_dot_recursion_threshold)
+        {
+          const std::size_t middle = first + (last - first) / 64 * 32;
+          return local_subtract_multiple<n_vectors>(
+                   basis, factors, first, middle, vv) +
+                 local_subtract_multiple<n_vectors>(
+                   basis, factors, middle, last, vv);
+        }
+
+      Number f[n_vectors];
+      for (unsigned int k = 0; k < n_vectors; ++k)
+        f[k] = factors[k];
+      double vv_sqr = 0;
+      for (std::size_t j = first; j < last; ++j)
+        {
+          Number sum = 0;
+          for (unsigned int k = 0; k < n_vectors; ++k)
+            sum += f[k] * basis[k][j];
+          vv[j] -= sum;
+          vv_sqr += static_cast<double>(vv[j]) * vv[j];
+        }
+      return vv_sqr;
+    }
+
+
+
+    /**
+     * Number of basis vectors that are handled together in one pass over
+     * the vectors by the functions below.
+     */
+    const unsigned int n_vectors_per_pass = 4;
+
+
+
+    /**
+     * Return the size of the chunks into which a range of length @p size is
+     * split for working on it in parallel. As in
+     * internal::VectorOperations::parallel_reduce(), ranges shorter than four
+     * times the minimum grain size are not split, and longer ones are split
+     * into about four chunks per thread, whose length is rounded up to a
+     * multiple of 512.
+     */
+    inline std::size_t
+    get_chunk_size(const std::size_t size)
+    {
+      const std::size_t grain_size =
+        internal::VectorImplementation::minimum_parallel_grain_size;
+      if (MultithreadInfo::n_threads() == 1 || size < 4 * grain_size)
+        return std::max<std::size_t>(size, 1);
+
+      std::size_t chunk_size =
+        size / std::min<std::size_t>(4 * MultithreadInfo::n_threads(),
+                                     size / grain_size);
+      if (chunk_size > 512)
+        chunk_size = (chunk_size + 511) / 512 * 512;
+      return chunk_size;
+    }
+
+
+
+    /**
+     * Add the @p n_chunks consecutive blocks of @p n_entries numbers in
+     * @p chunk_results pairwise, such that the sum ends up in the first
+     * block. For the same number of chunks, the order of the additions does
+     * not depend on the number of threads that computed the blocks.
+     */
+    inline void
+    sum_chunks_pairwise(std::vector<double> &chunk_results,
+                        const std::size_t    n_entries,
+                        std::size_t          n_chunks)
+    {
+      while (n_chunks > 1)
+        {
+          for (std::size_t c = 0; c + 1 < n_chunks; c += 2)
+            for (std::size_t k = 0; k < n_entries; ++k)
+              chunk_results[c / 2 * n_entries + k] =
+                chunk_results[c * n_entries + k] +
+                chunk_results[(c + 1) * n_entries + k];
+          if (n_chunks % 2 == 1)
+            for (std::size_t k = 0; k < n_entries; ++k)
+              chunk_results[n_chunks / 2 * n_entries + k] =
+                chunk_results[(n_chunks - 1) * n_entries + k];
+          n_chunks = (n_chunks + 1) / 2;
+        }
+    }
+
+
+
+    /**
+     * Compute the local contributions of the inner products of @p vv with
+     * the vectors @p basis into the first entries of @p result, and the
+     * square of the norm of @p vv into the last entry. The vectors are split
+     * into chunks that are worked on in parallel, and each chunk is worked
+     * on with n_vectors_per_pass basis vectors at a time. The contributions
+     * of the chunks are added pairwise.
+     */
+    template <typename Number>
+    void
+    local_multi_dot_and_norm(const std::vector<const Number *> &basis,
+                             const Number *                     vv,
+                             const std::size_t                  size,
+                             std::vector<double> &              result)
+    {
+      const unsigned int dim = basis.size();
+      Assert(dim > 0, ExcInternalError());
+
+      const std::size_t   chunk_size = get_chunk_size(size);
+      const std::size_t   n_chunks   = (size + chunk_size - 1) / chunk_size;
+      std::vector<double> chunk_results(std::max<std::size_t>(n_chunks, 1) *
+                                          (dim + 1),
+                                        0.);
+      parallel::apply_to_subranges(
+        std::size_t(0),
+        n_chunks,
+        [&](const std::size_t begin, const std::size_t end) {
+          for (std::size_t c = begin; c < end; ++c)
+            {
+              const std::size_t first = c * chunk_size;
+              const std::size_t last  = std::min(size, first + chunk_size);
+              double *          chunk_result = &chunk_results[c * (dim + 1)];
+              for (unsigned int i = 0; i < dim; i += n_vectors_per_pass)
+                {
+                  const unsigned int n = std::min(dim - i, n_vectors_per_pass);
+                  double             sums[n_vectors_per_pass + 1];
+                  switch (n)
+                    {
+                      case 1:
+                        local_multi_dot<1>(&basis[i], vv, first, last, sums);
+                        break;
+                      case 2:
+                        local_multi_dot<2>(&basis[i], vv, first, last, sums);
+                        break;
+                      case 3:
+                        local_multi_dot<3>(&basis[i], vv, first, last, sums);
+                        break;
+                      default:
+                        local_multi_dot<4>(&basis[i], vv, first, last, sums);
+                        break;
+                    }
+                  for (unsigned int k = 0; k < n; ++k)
+                    chunk_result[i + k] = sums[k];
+                  // the norm is taken from the first pass
+                  if (i == 0)
+                    chunk_result[dim] = sums[n];
+                }
+            }
+        },
+        1);
+
+      sum_chunks_pairwise(chunk_results, dim + 1, n_chunks);
+      result.assign(chunk_results.begin(), chunk_results.begin() + dim + 1);
+    }
+
+
+
+    /**
+     * Subtract the vectors @p basis, multiplied by the entries of @p h, from
+     * @p vv and return the local contribution to the square of the norm of
+     * the result. The vectors are split into chunks that are worked on in
+     * parallel, and each chunk is worked on with n_vectors_per_pass basis
+     * vectors at a time. The contributions of the chunks to the norm are
+     * added pairwise.
+     */
+    template <typename Number>
+    double
+    local_subtract_multiple_and_norm(const std::vector<const Number *> &basis,
+                                     const Vector<double> &             h,
+                                     const std::size_t                  size,
+                                     Number *                           vv)
+    {
+      const unsigned int  dim        = basis.size();
+      const std::size_t   chunk_size = get_chunk_size(size);
+      const std::size_t   n_chunks   = (size + chunk_size - 1) / chunk_size;
+      std::vector<double> chunk_norms(std::max<std::size_t>(n_chunks, 1), 0.);
+      parallel::apply_to_subranges(
+        std::size_t(0),
+        n_chunks,
+        [&](const std::size_t begin, const std::size_t end) {
+          for (std::size_t c = begin; c < end; ++c)
+            {
+              const std::size_t first = c * chunk_size;
+              const std::size_t last  = std::min(size, first + chunk_size);
+              // the norm is taken from the last pass
+              for (unsigned int i = 0; i < dim; i += n_vectors_per_pass)
+                {
+                  const double *factors = h.begin() + i;
+                  switch (std::min(dim - i, n_vectors_per_pass))
+                    {
+                      case 1:
+                        chunk_norms[c] = local_subtract_multiple<1>(
+                          &basis[i], factors, first, last, vv);
+                        break;
+                      case 2:
+                        chunk_norms[c] = local_subtract_multiple<2>(
+                          &basis[i], factors, first, last, vv);
+                        break;
+                      case 3:
+                        chunk_norms[c] = local_subtract_multiple<3>(
+                          &basis[i], factors, first, last, vv);
+                        break;
+                      default:
+                        chunk_norms[c] = local_subtract_multiple<4>(
+                          &basis[i], factors, first, last, vv);
+                        break;
+                    }
+                }
+            }
+        },
+        1);
+
+      sum_chunks_pairwise(chunk_norms, 1, n_chunks);
+      return chunk_norms[0];
+    }
+
+
+
+    /**
+     * Return pointers to the elements of the first @p dim vectors of
+     * @p orthogonal_vectors stored on the current process.
+     */
+    template <class VectorType>
+    std::vector<const typename VectorType::value_type *>
+    get_local_pointers(const TmpVectors<VectorType> &orthogonal_vectors,
+                       const unsigned int            dim)
+    {
+      std::vector<const typename VectorType::value_type *> basis(dim);
+      for (unsigned int i = 0; i < dim; ++i)
+        basis[i] = orthogonal_vectors[i].begin();
+      return basis;
+    }
+
+
+
+    /**
+     * Version of the function above for dealii::Vector, which works on
+     * several basis vectors per pass over the vectors.
+     */
+    template <typename Number>
+    void
+    multi_dot_and_norm(
+      const TmpVectors<dealii::Vector<Number>> &orthogonal_vectors,
+      const unsigned int                        dim,
+      const dealii::Vector<Number> &            vv,
+      Vector<double> &                          h,
+      double &                                  norm_sqr)
+    {
+      std::vector<double> result;
+      local_multi_dot_and_norm(get_local_pointers(orthogonal_vectors, dim),
+                               vv.begin(),
+                               vv.size(),
+                               result);
+      for (unsigned int i = 0; i < dim; ++i)
+        h(i) = result[i];
+      norm_sqr = result[dim];
+    }
+
+
+
+    /**
+     * Version of the function above for dealii::Vector, which works on
+     * several basis vectors per pass over the vectors.
+     */
+    template <typename Number>
+    double
+    subtract_multiple_and_norm(
+      const TmpVectors<dealii::Vector<Number>> &orthogonal_vectors,
+      const unsigned int                        dim,
+      const Vector<double> &                    h,
+      dealii::Vector<Number> &                  vv)
+    {
+      return local_subtract_multiple_and_norm(
+        get_local_pointers(orthogonal_vectors, dim), h, vv.size(), vv.begin());
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which works on several basis vectors per pass over the vectors and
+     * sums the contributions of all processes in one global reduction.
+     */
+    template <typename Number>
+    void
+    multi_dot_and_norm(
+      const TmpVectors<
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+        &                orthogonal_vectors,
+      const unsigned int dim,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &vv,
+      Vector<double> &                                                     h,
+      double &norm_sqr)
+    {
+      std::vector<double> local_result;
+      local_multi_dot_and_norm(get_local_pointers(orthogonal_vectors, dim),
+                               vv.begin(),
+                               vv.local_size(),
+                               local_result);
+      std::vector<double> result(dim + 1);
+      Utilities::MPI::sum(local_result, vv.get_mpi_communicator(), result);
+      for (unsigned int i = 0; i < dim; ++i)
+        h(i) = result[i];
+      norm_sqr = result[dim];
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which works on several basis vectors per pass over the vectors and
+     * sums the norm over all processes in one global reduction.
+     */
+    template <typename Number>
+    double
+    subtract_multiple_and_norm(
+      const TmpVectors<
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+        &                   orthogonal_vectors,
+      const unsigned int    dim,
+      const Vector<double> &h,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &vv)
+    {
+      const double local_norm_sqr = local_subtract_multiple_and_norm(
+        get_local_pointers(orthogonal_vectors, dim),
+        h,
+        vv.local_size(),
+        vv.begin());
+      return Utilities::MPI::sum(local_norm_sqr, vv.get_mpi_communicator());
+    }
+
+
+
+    /**
+     * Replace @p v, which contains the product of the matrix with the
+     * current solution, by the residual $b-v$ and return the norm of the
+     * residual. This is the general version for all vector types.
+     */
+    template <class VectorType>
+    double
+    residual_and_norm(const VectorType &b, VectorType &v)
+    {
+      v.sadd(-1., 1., b);
+      return v.l2_norm();
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which computes the residual and its norm in a single pass over the
+     * vectors.
+     */
+    template <typename Number>
+    double
+    residual_and_norm(
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &b,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &      v)
+    {
+      const std::array<Number, 1> norm_sqr = v.assign_and_reduce(
+        b - make_vector_expression(v),
+        LinearAlgebra::distributed::VectorReductions::norm_sqr());
+      return std::sqrt(norm_sqr[0]);
+    }
+
+
+
     // A comparator for better printing eigenvalues
     inline bool
     complex_less_pred(const std::complex<double> &x,
@@ -601,14 +1161,16 @@ namespace internal
 
 template <class VectorType>
 inline SolverGMRES<VectorType>::AdditionalData::AdditionalData(
-  const unsigned int max_n_tmp_vectors,
-  const bool         right_preconditioning,
-  const bool         use_default_residual,
-  const bool         force_re_orthogonalization)
+  const unsigned int              max_n_tmp_vectors,
+  const bool                      right_preconditioning,
+  const bool                      use_default_residual,
+  const bool                      force_re_orthogonalization,
+  const OrthogonalizationStrategy orthogonalization_strategy)
   : max_n_tmp_vectors(max_n_tmp_vectors)
   , right_preconditioning(right_preconditioning)
   , use_default_residual(use_default_residual)
   , force_re_orthogonalization(force_re_orthogonalization)
+  , orthogonalization_strategy(orthogonalization_strategy)
 {
   Assert(3 <= max_n_tmp_vectors,
          ExcMessage("SolverGMRES needs at least three "
@@ -737,6 +1299,57 @@ SolverGMRES<VectorType>::modified_gram_schmidt(
 
 
 
+template <class VectorType>
+inline double
+SolverGMRES<VectorType>::classical_gram_schmidt(
+  const internal::SolverGMRESImplementation::TmpVectors<VectorType>
+    &                                       orthogonal_vectors,
+  const unsigned int                        dim,
+  const unsigned int                        accumulated_iterations,
+  VectorType &                              vv,
+  Vector<double> &                          h,
+  const bool                                force_reorthogonalize,
+  const boost::signals2::signal<void(int)> &reorthogonalize_signal)
+{
+  Assert(dim > 0, ExcInternalError());
+
+  // Orthogonalization with one global reduction for the inner products and
+  // one for the norm of the result, which is computed while updating vv.
+  // Computing the norm from the norm before the orthogonalization and the
+  // inner products instead would save the second reduction, but suffers
+  // from cancellation as soon as vv loses a substantial part of its norm
+  double norm_vv_start_sqr = 0;
+  internal::SolverGMRESImplementation::multi_dot_and_norm(
+    orthogonal_vectors, dim, vv, h, norm_vv_start_sqr);
+  double norm_vv_sqr =
+    internal::SolverGMRESImplementation::subtract_multiple_and_norm(
+      orthogonal_vectors, dim, h, vv);
+
+  // Re-orthogonalization if the norm of vv dropped below 1/sqrt(2) times its
+  // norm before, i.e., if the inner products are not small compared to the
+  // result. Then, the classical Gram-Schmidt algorithm may lose
+  // orthogonality. Applying the algorithm twice is enough to recover it, see
+  // L. Giraud, J. Langou, M. Rozloznik, The loss of orthogonality in the
+  // Gram-Schmidt orthogonalization process, Comput. Math. Appl. 50 (2005).
+  if (force_reorthogonalize || norm_vv_sqr < 0.5 * norm_vv_start_sqr)
+    {
+      if (!force_reorthogonalize && !reorthogonalize_signal.empty())
+        reorthogonalize_signal(accumulated_iterations);
+
+      Vector<double> h_correction(dim);
+      internal::SolverGMRESImplementation::multi_dot_and_norm(
+        orthogonal_vectors, dim, vv, h_correction, norm_vv_sqr);
+      norm_vv_sqr =
+        internal::SolverGMRESImplementation::subtract_multiple_and_norm(
+          orthogonal_vectors, dim, h_correction, vv);
+      h += h_correction;
+    }
+
+  return std::sqrt(norm_vv_sqr);
+}
+
+
+
 template <class VectorType>
 inline void
 SolverGMRES<VectorType>::compute_eigs_and_cond(
@@ -879,19 +1492,19 @@ SolverGMRES<VectorType>::solve(const MatrixType &        A,
       // reset this vector to the right size
       h.reinit(n_tmp_vectors - 1);
 
+      double rho;
       if (left_precondition)
         {
           A.vmult(p, x);
           p.sadd(-1., 1., b);
           preconditioner.vmult(v, p);
+          rho = v.l2_norm();
         }
       else
         {
           A.vmult(v, x);
-          v.sadd(-1., 1., b);
-        };
-
-      double rho = v.l2_norm();
+          rho = internal::SolverGMRESImplementation::residual_and_norm(b, v);
+        }
 
       // check the residual here as well since it may be that we got the exact
       // (or an almost exact) solution vector at the outset. if we wouldn't
@@ -955,13 +1568,25 @@ SolverGMRES<VectorType>::solve(const MatrixType &        A,
 
           dim = inner_iteration + 1;
 
-          const double s         = modified_gram_schmidt(tmp_vectors,
-                                                 dim,
-                                                 accumulated_iterations,
-                                                 vv,
-                                                 h,
-                                                 re_orthogonalize,
-                                                 re_orthogonalize_signal);
+          const double s =
+            (additional_data.orthogonalization_strategy ==
+                 AdditionalData::OrthogonalizationStrategy::
+                   classical_gram_schmidt ?
+               classical_gram_schmidt(
+                 tmp_vectors,
+                 dim,
+                 accumulated_iterations,
+                 vv,
+                 h,
+                 additional_data.force_re_orthogonalization,
+                 re_orthogonalize_signal) :
+               modified_gram_schmidt(tmp_vectors,
+                                     dim,
+                                     accumulated_iterations,
+                                     vv,
+                                     h,
+                                     re_orthogonalize,
+                                     re_orthogonalize_signal));
           h(inner_iteration + 1) = s;
 
           // s=0 is a lucky breakdown, the solver will reach convergence,
@@ -1236,9 +1861,9 @@ SolverFGMRES<VectorType>::solve(const MatrixType &        A,
   do
     {
       A.vmult(*aux, x);
-      aux->sadd(-1., 1., b);
+      double beta =
+        internal::SolverGMRESImplementation::residual_and_norm(b, *aux);
 
-      double beta     = aux->l2_norm();
       res             = beta;
       iteration_state = this->iteration_status(accumulated_iterations, res, x);
       if (iteration_state == SolverControl::success)
@@ -0,0 +1,481 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_iterative_refinement_h
+#define dealii_solver_iterative_refinement_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/parallel.h>
+
+#include <deal.II/lac/la_parallel_vector_expressions.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Mixed-precision iterative refinement. This solver computes the residual
+ * $r=b-Ax$ of the current solution in the precision of the vector type
+ * @p VectorType, typically double, but solves for the correction $Ad=r$ with
+ * an inner solver that works on a second operator and a second vector type
+ * @p InnerVectorType of lower precision, typically float. The correction is
+ * then added to the solution in full precision. Since the residual is
+ * always computed in full precision, the iteration reaches the accuracy of
+ * @p VectorType even though all Krylov iterations run in the lower
+ * precision, as long as the inner solver reduces the error by some factor in
+ * each step. For operators whose application is limited by memory
+ * bandwidth, such as sparse matrices or matrix-free operators, the inner
+ * iterations are up to twice as fast in single precision.
+ *
+ * Each step of the method performs the following operations:
+ * <ol>
+ * <li> Compute $r=b-Ax$ and its norm, which is passed to the SolverControl
+ * object of this class to decide about convergence.
+ * <li> Convert the scaled residual $r/\|r\|$ to @p InnerVectorType. The
+ * scaling keeps the values of the right hand side of the inner problem in
+ * the range of the lower precision even when the residual becomes small.
+ * <li> Solve approximately for the correction $d$ with the inner solver,
+ * starting from zero.
+ * <li> Update $x \leftarrow x + \|r\| d$, converting $d$ back to
+ * @p VectorType.
+ * </ol>
+ * For LinearAlgebra::distributed::Vector and ::Vector, the conversions
+ * between the two precisions are done in a single pass over the vectors
+ * together with the scaling and the update of the solution, respectively,
+ * and for LinearAlgebra::distributed::Vector the residual and its norm are
+ * also computed in one pass. For other vector types, @p InnerVectorType
+ * must provide an assignment operator from @p VectorType and vice versa.
+ *
+ * The inner solver only needs to reduce the residual by a moderate factor,
+ * say $10^{-2}$ to $10^{-4}$, which is best expressed by a ReductionControl
+ * or an IterationNumberControl object. If the inner solver throws an
+ * exception of type SolverControl::NoConvergence, the correction it computed
+ * so far is used nevertheless. The temporary vectors of both precisions are
+ * taken from VectorMemory objects, by default of type GrowingVectorMemory,
+ * such that they are reused in subsequent calls to solve().
+ *
+ * A typical use with a sparse matrix looks like this:
+ * @code
+ * SparseMatrix<double> system_matrix;
+ * SparseMatrix<float>  system_matrix_float;
+ * system_matrix_float.reinit(sparsity_pattern);
+ * system_matrix_float.copy_from(system_matrix);
+ *
+ * PreconditionSSOR<SparseMatrix<float>> preconditioner;
+ * preconditioner.initialize(system_matrix_float);
+ *
+ * ReductionControl          inner_control(1000, 1e-30, 1e-3);
+ * SolverCG<Vector<float>> inner_solver(inner_control);
+ *
+ * SolverControl solver_control(100, 1e-12);
+ * SolverIterativeRefinement<Vector<double>, Vector<float>> solver(
+ *   solver_control);
+ * solver.solve(system_matrix,
+ *              solution,
+ *              system_rhs,
+ *              system_matrix_float,
+ *              inner_solver,
+ *              preconditioner);
+ * @endcode
+ *
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence, with one iteration being one
+ * refinement step. The inner solver reports its iterations through its own
+ * SolverControl object.
+ */
+template <typename VectorType      = Vector<double>,
+          typename InnerVectorType = Vector<float>>
+class SolverIterativeRefinement : public Solver<VectorType>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver. This
+   * solver does not need any additional data.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * Constructor. The vectors of the inner precision are allocated from
+   * @p inner_mem.
+   */
+  SolverIterativeRefinement(SolverControl &                cn,
+                            VectorMemory<VectorType> &     mem,
+                            VectorMemory<InnerVectorType> &inner_mem,
+                            const AdditionalData &data = AdditionalData());
+
+  /**
+   * Constructor. Use objects of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverIterativeRefinement(SolverControl &       cn,
+                            const AdditionalData &data = AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverIterativeRefinement() override = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for $x$, using the starting value given
+   * in @p x. The corrections are computed by calling
+   * <code>inner_solver.solve(inner_A, d, r, inner_preconditioner)</code>
+   * with vectors of type @p InnerVectorType, where @p inner_A is usually
+   * the same operator as @p A in lower precision.
+   */
+  template <typename MatrixType,
+            typename InnerMatrixType,
+            typename InnerSolverType,
+            typename InnerPreconditionerType>
+  void
+  solve(const MatrixType &             A,
+        VectorType &                   x,
+        const VectorType &             b,
+        const InnerMatrixType &        inner_A,
+        InnerSolverType &              inner_solver,
+        const InnerPreconditionerType &inner_preconditioner);
+
+protected:
+  /**
+   * A default vector memory for the vectors of the inner precision, used by
+   * the constructor without memory arguments.
+   */
+  mutable GrowingVectorMemory<InnerVectorType> static_inner_vector_memory;
+
+  /**
+   * The memory from which the vectors of the inner precision are allocated.
+   */
+  VectorMemory<InnerVectorType> &inner_memory;
+
+  /**
+   * Control parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+/*---------------------------- Implementation ------------------------------*/
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SolverIterativeRefinementImplementation
+  {
+    /**
+     * Replace @p r, which contains the product of the matrix with the
+     * current solution, by the residual $b-r$ and return its norm. This is
+     * the general version for all vector types.
+     */
+    template <typename VectorType>
+    double
+    residual_and_norm(const VectorType &b, VectorType &r)
+    {
+      r.sadd(-1., 1., b);
+      return r.l2_norm();
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which works in a single pass over the vectors.
+     */
+    template <typename Number>
+    double
+    residual_and_norm(
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &b,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &      r)
+    {
+      const std::array<Number, 1> norm_sqr = r.assign_and_reduce(
+        b - make_vector_expression(r),
+        LinearAlgebra::distributed::VectorReductions::norm_sqr());
+      return std::sqrt(norm_sqr[0]);
+    }
+
+
+
+    /**
+     * Set the @p size entries of @p dst to the entries of @p src multiplied
+     * by @p factor, converting them to the number type of @p dst.
+     */
+    template <typename Number, typename InnerNumber>
+    void
+    convert_scaled(const Number *    src,
+                   const Number      factor,
+                   const std::size_t size,
+                   InnerNumber *     dst)
+    {
+      parallel::apply_to_subranges(
+        std::size_t(0),
+        size,
+        [src, factor, dst](const std::size_t begin, const std::size_t end) {
+          DEAL_II_OPENMP_SIMD_PRAGMA
+          for (std::size_t i = begin; i < end; ++i)
+            dst[i] = static_cast<InnerNumber>(factor * src[i]);
+        },
+        internal::VectorImplementation::minimum_parallel_grain_size);
+    }
+
+
+
+    /**
+     * Add the @p size entries of @p src, converted to the number type of
+     * @p dst and multiplied by @p factor, to @p dst.
+     */
+    template <typename Number, typename InnerNumber>
+    void
+    add_converted(const InnerNumber *src,
+                  const Number       factor,
+                  const std::size_t  size,
+                  Number *           dst)
+    {
+      parallel::apply_to_subranges(
+        std::size_t(0),
+        size,
+        [src, factor, dst](const std::size_t begin, const std::size_t end) {
+          DEAL_II_OPENMP_SIMD_PRAGMA
+          for (std::size_t i = begin; i < end; ++i)
+            dst[i] += factor * static_cast<Number>(src[i]);
+        },
+        internal::VectorImplementation::minimum_parallel_grain_size);
+    }
+
+
+
+    /**
+     * Set @p dst to @p factor times @p src, where the two vectors are of
+     * different precision. This is the general version for all vector
+     * types, which first converts and then scales the vector.
+     */
+    template <typename VectorType, typename InnerVectorType>
+    void
+    convert_scaled(const VectorType &src,
+                   const double      factor,
+                   InnerVectorType & dst)
+    {
+      dst = src;
+      dst *= factor;
+    }
+
+
+
+    /**
+     * Add @p factor times @p src to @p dst, where the two vectors are of
+     * different precision. This is the general version for all vector
+     * types, which uses a temporary vector of the type of @p dst.
+     */
+    template <typename VectorType, typename InnerVectorType>
+    void
+    add_converted(const InnerVectorType &src,
+                  const double           factor,
+                  VectorType &           dst)
+    {
+      VectorType tmp;
+      tmp.reinit(dst, true);
+      tmp = src;
+      dst.add(factor, tmp);
+    }
+
+
+
+    /**
+     * Version of the function above for ::Vector, which works in a single
+     * pass over the vectors.
+     */
+    template <typename Number, typename InnerNumber>
+    void
+    convert_scaled(const dealii::Vector<Number> &src,
+                   const double                  factor,
+                   dealii::Vector<InnerNumber> & dst)
+    {
+      AssertDimension(src.size(), dst.size());
+      convert_scaled(src.begin(), Number(factor), src.size(), dst.begin());
+    }
+
+
+
+    /**
+     * Version of the function above for ::Vector, which works in a single
+     * pass over the vectors.
+     */
+    template <typename Number, typename InnerNumber>
+    void
+    add_converted(const dealii::Vector<InnerNumber> &src,
+                  const double                       factor,
+                  dealii::Vector<Number> &           dst)
+    {
+      AssertDimension(src.size(), dst.size());
+      add_converted(src.begin(), Number(factor), src.size(), dst.begin());
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which works on the locally owned entries in a single pass over the
+     * vectors.
+     */
+    template <typename Number, typename InnerNumber>
+    void
+    convert_scaled(
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &src,
+      const double factor,
+      LinearAlgebra::distributed::Vector<InnerNumber, MemorySpace::Host>
+        &dst)
+    {
+      AssertDimension(src.local_size(), dst.local_size());
+      convert_scaled(src.begin(),
+                     Number(factor),
+                     src.local_size(),
+                     dst.begin());
+      if (dst.has_ghost_elements())
+        dst.update_ghost_values();
+    }
+
+
+
+    /**
+     * Version of the function above for LinearAlgebra::distributed::Vector,
+     * which works on the locally owned entries in a single pass over the
+     * vectors.
+     */
+    template <typename Number, typename InnerNumber>
+    void
+    add_converted(
+      const LinearAlgebra::distributed::Vector<InnerNumber, MemorySpace::Host>
+        &          src,
+      const double factor,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &dst)
+    {
+      AssertDimension(src.local_size(), dst.local_size());
+      add_converted(src.begin(), Number(factor), src.local_size(), dst.begin());
+      if (dst.has_ghost_elements())
+        dst.update_ghost_values();
+    }
+  } // namespace SolverIterativeRefinementImplementation
+} // namespace internal
+
+
+
+template <typename VectorType, typename InnerVectorType>
+SolverIterativeRefinement<VectorType, InnerVectorType>::
+  SolverIterativeRefinement(SolverControl &                cn,
+                            VectorMemory<VectorType> &     mem,
+                            VectorMemory<InnerVectorType> &inner_mem,
+                            const AdditionalData &         data)
+  : Solver<VectorType>(cn, mem)
+  , inner_memory(inner_mem)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType, typename InnerVectorType>
+SolverIterativeRefinement<VectorType, InnerVectorType>::
+  SolverIterativeRefinement(SolverControl &cn, const AdditionalData &data)
+  : Solver<VectorType>(cn)
+  , inner_memory(static_inner_vector_memory)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType, typename InnerVectorType>
+template <typename MatrixType,
+          typename InnerMatrixType,
+          typename InnerSolverType,
+          typename InnerPreconditionerType>
+void
+SolverIterativeRefinement<VectorType, InnerVectorType>::solve(
+  const MatrixType &             A,
+  VectorType &                   x,
+  const VectorType &             b,
+  const InnerMatrixType &        inner_A,
+  InnerSolverType &              inner_solver,
+  const InnerPreconditionerType &inner_preconditioner)
+{
+  using namespace internal::SolverIterativeRefinementImplementation;
+
+  SolverControl::State conv = SolverControl::iterate;
+  double               res  = -std::numeric_limits<double>::max();
+
+  // 'Vr' holds the residual, 'Vr_inner' the scaled residual in the inner
+  // precision and 'Vd_inner' the correction
+  typename VectorMemory<VectorType>::Pointer      Vr(this->memory);
+  typename VectorMemory<InnerVectorType>::Pointer Vr_inner(inner_memory);
+  typename VectorMemory<InnerVectorType>::Pointer Vd_inner(inner_memory);
+
+  VectorType &r = *Vr;
+  r.reinit(x, true);
+  InnerVectorType &r_inner = *Vr_inner;
+  r_inner.reinit(x, true);
+  InnerVectorType &d_inner = *Vd_inner;
+  d_inner.reinit(x, true);
+
+  LogStream::Prefix prefix("IterativeRefinement");
+
+  unsigned int iter = 0;
+  while (true)
+    {
+      A.vmult(r, x);
+      res  = residual_and_norm(b, r);
+      conv = this->iteration_status(iter, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      convert_scaled(r, 1. / res, r_inner);
+      d_inner = 0.;
+      try
+        {
+          inner_solver.solve(inner_A, d_inner, r_inner, inner_preconditioner);
+        }
+      catch (SolverControl::NoConvergence &)
+        {
+          // the correction computed so far still improves the solution, and
+          // convergence is decided by the outer iteration
+        }
+      add_converted(d_inner, res, x);
+
+      ++iter;
+    }
+
+  // in case of failure: throw exception
+  AssertThrow(conv == SolverControl::success,
+              SolverControl::NoConvergence(iter, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,358 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_amg_h
+#define dealii_sparse_amg_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Preconditioners
+ *@{
+ */
+
+/**
+ * An algebraic multigrid preconditioner based on smoothed aggregation for
+ * matrices of type SparseMatrix<double>. It is meant for symmetric positive
+ * definite matrices of scalar elliptic problems, e.g., the Laplace operator,
+ * and it does not depend on any external library. Its convergence is
+ * largely independent of the mesh size, in contrast to PreconditionSSOR or
+ * SparseILU.
+ *
+ * The function initialize() builds a hierarchy of coarser matrices from the
+ * given matrix as follows (see P. Vanek, J. Mandel, M. Brezina, Algebraic
+ * multigrid by smoothed aggregation for second and fourth order elliptic
+ * problems, Computing 56 (1996)):
+ * <ol>
+ * <li> The entry $a_{ij}$ is a strong connection if $|a_{ij}| \ge \theta
+ * \sqrt{|a_{ii} a_{jj}|}$, with $\theta$ given by
+ * AdditionalData::strong_threshold.
+ * <li> The rows are grouped into aggregates of strongly connected rows. Rows
+ * without strong connections, e.g., the rows of constrained degrees of
+ * freedom, are not aggregated and only treated by the smoother.
+ * <li> The tentative prolongator interpolates the constant vector on each
+ * aggregate. It is smoothed with one damped Jacobi step with the filtered
+ * matrix, in which the weak connections are added to the diagonal.
+ * <li> The coarse matrix is the Galerkin product $P^T A P$ of the matrix and
+ * the smoothed prolongator $P$. The product is computed in parallel on
+ * several threads.
+ * </ol>
+ * The coarsening stops when the matrix has at most
+ * AdditionalData::coarse_size rows, when the number of levels reaches
+ * AdditionalData::max_levels, or when the aggregation does not reduce the
+ * size any more. On the coarsest level, the system is solved with the
+ * inverse of the matrix if it has at most AdditionalData::coarse_size rows,
+ * and smoothed otherwise. If deal.II is configured with LAPACK, the inverse
+ * is the pseudo-inverse computed from a singular value decomposition, which
+ * also works for singular matrices, e.g., from problems with pure Neumann
+ * boundary conditions. Otherwise, the coarse matrix must be invertible.
+ *
+ * Each call to vmult() performs one V-cycle. The smoother on each level is a
+ * PreconditionChebyshev object around the diagonal of the level matrix,
+ * either with a Chebyshev polynomial of degree AdditionalData::smoother_degree
+ * or with AdditionalData::smoother_degree damped Jacobi sweeps, see
+ * AdditionalData::SmootherType. The pre-smoother and the post-smoother are
+ * transposes of each other, so the V-cycle is symmetric and the
+ * preconditioner can be used with SolverCG:
+ * @code
+ *   SparseAMG amg;
+ *   amg.initialize(system_matrix);
+ *
+ *   SolverControl           solver_control(1000, 1e-12);
+ *   SolverCG<Vector<double>> solver(solver_control);
+ *   solver.solve(system_matrix, solution, system_rhs, amg);
+ * @endcode
+ *
+ * The levels are numbered from the finest one, level zero, which is the
+ * matrix given to initialize(), to the coarsest one.
+ *
+ * @note Without LAPACK, the coarse matrix must be invertible. For singular
+ * problems, e.g., the Laplace operator with pure Neumann boundary
+ * conditions, one row then has to be constrained before the preconditioner
+ * is set up. With LAPACK, the pseudo-inverse handles such problems without
+ * changes, see above.
+ *
+ * @note The vmult() function uses internal vectors on each level and must not
+ * be called simultaneously from several threads.
+ */
+class SparseAMG : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Standardized data struct to pipe additional parameters to the
+   * preconditioner.
+   */
+  struct AdditionalData
+  {
+    /**
+     * The smoothers to choose from.
+     */
+    enum SmootherType
+    {
+      /**
+       * A Chebyshev polynomial of degree AdditionalData::smoother_degree in
+       * the diagonally preconditioned matrix, see PreconditionChebyshev.
+       */
+      chebyshev,
+      /**
+       * AdditionalData::smoother_degree damped Jacobi sweeps.
+       */
+      jacobi
+    };
+
+    /**
+     * Constructor.
+     */
+    AdditionalData(const double       strong_threshold    = 0.08,
+                   const SmootherType smoother_type       = chebyshev,
+                   const unsigned int smoother_degree     = 2,
+                   const double       smoothing_range     = 20.,
+                   const unsigned int coarse_size         = 500,
+                   const unsigned int max_levels          = 20,
+                   const double       prolongator_damping = 4. / 3.);
+
+    /**
+     * The threshold $\theta$ of the strength of connection between two rows,
+     * see the documentation of the class. A larger value results in smaller
+     * aggregates. Zero makes all nonzero entries strong connections.
+     */
+    double strong_threshold;
+
+    /**
+     * The smoother used on each level.
+     */
+    SmootherType smoother_type;
+
+    /**
+     * The degree of the Chebyshev polynomial, or the number of Jacobi
+     * sweeps, of the pre- and post-smoother.
+     */
+    unsigned int smoother_degree;
+
+    /**
+     * The ratio between the largest eigenvalue of the diagonally
+     * preconditioned level matrix and the smallest eigenvalue the Chebyshev
+     * smoother acts on, see PreconditionChebyshev::AdditionalData. Not used
+     * for the Jacobi smoother.
+     */
+    double smoothing_range;
+
+    /**
+     * The coarsening stops once a matrix has at most this number of rows.
+     */
+    unsigned int coarse_size;
+
+    /**
+     * The maximal number of levels, including the finest one.
+     */
+    unsigned int max_levels;
+
+    /**
+     * The damping factor $\omega$ of the Jacobi step that smooths the
+     * tentative prolongator, which is used as $\omega / \rho$ with an upper
+     * bound $\rho$ of the spectral radius of the diagonally preconditioned
+     * filtered matrix.
+     */
+    double prolongator_damping;
+  };
+
+  /**
+   * Constructor. Does nothing, so you have to call initialize() before the
+   * object can be used.
+   */
+  SparseAMG() = default;
+
+  /**
+   * Build the multigrid hierarchy for @p matrix with the given parameters.
+   * The matrix is used by vmult() and must outlive this object.
+   */
+  void
+  initialize(const SparseMatrix<double> &matrix,
+             const AdditionalData &      additional_data = AdditionalData());
+
+  /**
+   * Release all memory and reset the object to the state after the default
+   * constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Apply one V-cycle to @p src, with zero initial guess, and store the
+   * result in @p dst.
+   */
+  void
+  vmult(Vector<double> &dst, const Vector<double> &src) const;
+
+  /**
+   * Apply the transposed preconditioner, which is the same as vmult() since
+   * the V-cycle is symmetric.
+   */
+  void
+  Tvmult(Vector<double> &dst, const Vector<double> &src) const;
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  size_type
+  m() const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  size_type
+  n() const;
+
+  /**
+   * Return the number of levels of the hierarchy, including the finest one.
+   */
+  unsigned int
+  n_levels() const;
+
+  /**
+   * Return the matrix of the given level, where level zero is the matrix
+   * given to initialize().
+   */
+  const SparseMatrix<double> &
+  get_matrix(const unsigned int level) const;
+
+  /**
+   * Return the prolongator from the given level to the next finer level,
+   * for level between one and n_levels()-1.
+   */
+  const SparseMatrix<double> &
+  get_prolongator(const unsigned int level) const;
+
+  /**
+   * Return the operator complexity, i.e., the number of nonzero entries of
+   * the matrices of all levels divided by the number of nonzero entries of
+   * the matrix on the finest level.
+   */
+  double
+  operator_complexity() const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * The smoother type on each level.
+   */
+  using Smoother = PreconditionChebyshev<SparseMatrix<double>, Vector<double>>;
+
+  /**
+   * Apply a V-cycle on the given level to the right hand side @p rhs with
+   * zero initial guess.
+   */
+  void
+  v_cycle(const unsigned int    level,
+          Vector<double> &      solution,
+          const Vector<double> &rhs) const;
+
+  /**
+   * Apply the pre-smoother on the given level, with zero initial guess.
+   */
+  void
+  pre_smooth(const unsigned int    level,
+             Vector<double> &      solution,
+             const Vector<double> &rhs) const;
+
+  /**
+   * Apply the post-smoother on the given level.
+   */
+  void
+  post_smooth(const unsigned int    level,
+              Vector<double> &      solution,
+              const Vector<double> &rhs) const;
+
+  /**
+   * The parameters given to initialize().
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The matrix on the finest level.
+   */
+  SmartPointer<const SparseMatrix<double>, SparseAMG> fine_matrix;
+
+  /**
+   * The sparsity patterns of the coarse matrices, starting with level one.
+   */
+  std::vector<std::unique_ptr<SparsityPattern>> coarse_sparsity_patterns;
+
+  /**
+   * The matrices on the coarse levels, starting with level one.
+   */
+  std::vector<std::unique_ptr<SparseMatrix<double>>> coarse_matrices;
+
+  /**
+   * The sparsity patterns of the prolongators, starting with the one from
+   * level one.
+   */
+  std::vector<std::unique_ptr<SparsityPattern>> prolongator_sparsity_patterns;
+
+  /**
+   * The prolongators from each coarse level to the next finer level,
+   * starting with the one from level one to level zero.
+   */
+  std::vector<std::unique_ptr<SparseMatrix<double>>> prolongators;
+
+  /**
+   * The smoothers on each level.
+   */
+  std::vector<std::unique_ptr<Smoother>> smoothers;
+
+  /**
+   * The inverse, or pseudo-inverse, of the matrix on the coarsest level, or
+   * an empty matrix if the coarsest level is smoothed.
+   */
+  FullMatrix<double> coarse_inverse;
+
+  /**
+   * The solution and the right hand side on the coarse levels, and the
+   * residual on all levels but the coarsest one.
+   */
+  mutable std::vector<Vector<double>> level_solution;
+  mutable std::vector<Vector<double>> level_rhs;
+  mutable std::vector<Vector<double>> level_residual;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -18,6 +18,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/lac/sparse_level_schedule.h>
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <cmath>
@@ -328,6 +329,13 @@ protected:
   void
   prebuild_lower_bound();
 
+  /**
+   * The levels of the forward and the backward substitution of the
+   * decomposition, which allow the derived classes to process the
+   * independent rows of each level in parallel. Computed by initialize().
+   */
+  SparseLevelSchedule level_schedule;
+
 private:
   /**
    * In general this pointer is zero except for the case that no
@@ -54,6 +54,7 @@ SparseLUDecomposition<number>::clear()
 {
   std::vector<const size_type *> tmp;
   tmp.swap(prebuilt_lower_bound);
+  level_schedule.clear();
 
   SparseMatrix<number>::clear();
 
@@ -76,6 +77,7 @@ SparseLUDecomposition<number>::initialize(
   const SparsityPattern &matrix_sparsity = matrix.get_sparsity_pattern();
 
   const SparsityPattern *sparsity_pattern_to_use = nullptr;
+  bool                   keep_level_schedule     = false;
 
   if (data.use_this_sparsity)
     sparsity_pattern_to_use = data.use_this_sparsity;
@@ -91,6 +93,8 @@ SparseLUDecomposition<number>::initialize(
       // iteration steps on an
       // unchanged grid.
       sparsity_pattern_to_use = &this->get_sparsity_pattern();
+      keep_level_schedule =
+        (level_schedule.n_rows() == sparsity_pattern_to_use->n_rows());
     }
   else if (data.extra_off_diagonals == 0)
     {
@@ -132,6 +136,11 @@ SparseLUDecomposition<number>::initialize(
     tmp.swap(prebuilt_lower_bound);
   }
   SparseMatrix<number>::reinit(*sparsity_pattern_to_use);
+
+  // the level schedule only depends on the sparsity pattern and can be
+  // kept if the previous sparsity pattern is used again
+  if (!keep_level_schedule)
+    level_schedule.initialize(*sparsity_pattern_to_use);
 }
 
 
@@ -237,7 +246,8 @@ std::size_t
 SparseLUDecomposition<number>::memory_consumption() const
 {
   return (SparseMatrix<number>::memory_consumption() +
-          MemoryConsumption::memory_consumption(prebuilt_lower_bound));
+          MemoryConsumption::memory_consumption(prebuilt_lower_bound) +
+          level_schedule.memory_consumption());
 }
 
 
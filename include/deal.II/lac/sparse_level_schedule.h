@@ -0,0 +1,261 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_level_schedule_h
+#define dealii_sparse_level_schedule_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/types.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+class SparsityPattern;
+
+/**
+ * A schedule for running the forward and the backward substitution of a
+ * sparse triangular solve on several threads. Such substitutions appear in
+ * SparseILU, SparseMIC, and the SOR and SSOR preconditioners of SparseMatrix.
+ *
+ * In the forward substitution, row $i$ can be processed once all rows $j<i$
+ * with a nonzero entry $(i,j)$ in the sparsity pattern are done. The function
+ * initialize() groups the rows into levels: a row is on level zero if it does
+ * not depend on any other row, and on level $k$ if the highest level of the
+ * rows it depends on is $k-1$. All rows of one level are independent of each
+ * other and can be processed in parallel, while the levels are processed one
+ * after the other. The backward substitution, in which row $i$ depends on
+ * the rows $j>i$ with a nonzero entry $(i,j)$, has its own set of levels.
+ *
+ * Since the computations within each row are done in the same order as in
+ * the sequential substitution, the results are identical to the ones of the
+ * sequential substitution. The rows of levels with fewer than
+ * internal::SparseMatrixImplementation::minimum_parallel_grain_size rows are
+ * processed sequentially, and so are all rows if the levels are too narrow on
+ * average or if only one thread is available.
+ *
+ * The number of levels depends on the numbering of the rows. For matrices
+ * from discretizations of partial differential equations, a lexicographic or
+ * Cuthill-McKee numbering results in levels that resemble wavefronts through
+ * the mesh, with a number of levels that grows with the number of rows. A
+ * multicolor numbering, see SparsityTools::reorder_multicolor(), results in
+ * at most as many levels as colors, at the price of a weaker preconditioner
+ * in the case of incomplete factorizations.
+ */
+class SparseLevelSchedule
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Constructor. Sets up an empty schedule.
+   */
+  SparseLevelSchedule();
+
+  /**
+   * Compute the levels of the forward and the backward substitution for the
+   * given square sparsity pattern.
+   */
+  void
+  initialize(const SparsityPattern &sparsity_pattern);
+
+  /**
+   * Reset the object to the state after the default constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Return the number of rows the schedule was computed for.
+   */
+  size_type
+  n_rows() const;
+
+  /**
+   * Return the number of levels of the forward substitution.
+   */
+  unsigned int
+  n_lower_levels() const;
+
+  /**
+   * Return the number of levels of the backward substitution.
+   */
+  unsigned int
+  n_upper_levels() const;
+
+  /**
+   * Call <tt>row_operation(row)</tt> for all rows in an order that is valid
+   * for a forward substitution, i.e., after the calls for all rows that
+   * <tt>row</tt> depends on have returned. Calls for rows of the same level
+   * may run concurrently.
+   */
+  template <typename RowOperation>
+  void
+  apply_lower(const RowOperation &row_operation) const;
+
+  /**
+   * Call <tt>row_operation(row)</tt> for all rows in an order that is valid
+   * for a backward substitution.
+   */
+  template <typename RowOperation>
+  void
+  apply_upper(const RowOperation &row_operation) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * Run @p row_operation over the levels described by @p level_starts and
+   * @p level_rows. If the levels are not processed in parallel, the rows are
+   * processed in the order of their numbers, or in the reverse order if
+   * @p backward is true.
+   */
+  template <typename RowOperation>
+  void
+  apply(const std::vector<size_type> &level_starts,
+        const std::vector<size_type> &level_rows,
+        const bool                    backward,
+        const RowOperation &          row_operation) const;
+
+  /**
+   * The number of rows.
+   */
+  size_type n;
+
+  /**
+   * The first position in #lower_rows of each level of the forward
+   * substitution, with one additional entry that marks the end.
+   */
+  std::vector<size_type> lower_level_starts;
+
+  /**
+   * The rows of the levels of the forward substitution.
+   */
+  std::vector<size_type> lower_rows;
+
+  /**
+   * The first position in #upper_rows of each level of the backward
+   * substitution, with one additional entry that marks the end.
+   */
+  std::vector<size_type> upper_level_starts;
+
+  /**
+   * The rows of the levels of the backward substitution.
+   */
+  std::vector<size_type> upper_rows;
+};
+
+
+/*---------------------- Inline functions -----------------------------------*/
+
+#ifndef DOXYGEN
+
+inline SparseLevelSchedule::size_type
+SparseLevelSchedule::n_rows() const
+{
+  return n;
+}
+
+
+
+inline unsigned int
+SparseLevelSchedule::n_lower_levels() const
+{
+  return (lower_level_starts.empty() ? 0 : lower_level_starts.size() - 1);
+}
+
+
+
+inline unsigned int
+SparseLevelSchedule::n_upper_levels() const
+{
+  return (upper_level_starts.empty() ? 0 : upper_level_starts.size() - 1);
+}
+
+
+
+template <typename RowOperation>
+inline void
+SparseLevelSchedule::apply_lower(const RowOperation &row_operation) const
+{
+  apply(lower_level_starts, lower_rows, false, row_operation);
+}
+
+
+
+template <typename RowOperation>
+inline void
+SparseLevelSchedule::apply_upper(const RowOperation &row_operation) const
+{
+  apply(upper_level_starts, upper_rows, true, row_operation);
+}
+
+
+
+template <typename RowOperation>
+void
+SparseLevelSchedule::apply(const std::vector<size_type> &level_starts,
+                           const std::vector<size_type> &level_rows,
+                           const bool                    backward,
+                           const RowOperation &          row_operation) const
+{
+  const size_type grain_size =
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size;
+
+  // the synchronization after each level only pays off if the levels are
+  // wide enough on average
+  if (MultithreadInfo::n_threads() == 1 || level_starts.size() < 2 ||
+      n < 2 * grain_size * (level_starts.size() - 1))
+    {
+      if (backward)
+        for (size_type row = n; row > 0; --row)
+          row_operation(row - 1);
+      else
+        for (size_type row = 0; row < n; ++row)
+          row_operation(row);
+      return;
+    }
+
+  for (unsigned int level = 0; level + 1 < level_starts.size(); ++level)
+    if (level_starts[level + 1] - level_starts[level] < grain_size)
+      for (size_type i = level_starts[level]; i < level_starts[level + 1]; ++i)
+        row_operation(level_rows[i]);
+    else
+      parallel::apply_to_subranges(
+        level_starts[level],
+        level_starts[level + 1],
+        [&](const size_type begin, const size_type end) {
+          for (size_type i = begin; i < end; ++i)
+            row_operation(level_rows[i]);
+        },
+        grain_size);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
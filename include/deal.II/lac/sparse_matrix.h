@@ -43,6 +43,11 @@ template <typename Matrix>
 class BlockMatrixBase;
 template <typename number>
 class SparseILU;
+template <typename number>
+class LocalToGlobalScatter;
+class SparseLevelSchedule;
+template <typename VectorType>
+class MultiVector;
 #  ifdef DEAL_II_WITH_MPI
 namespace Utilities
 {
@@ -1151,6 +1156,21 @@ public:
   void
   Tvmult_add(OutVector &dst, const InVector &src) const;
 
+  /**
+   * Matrix-multivector multiplication: let <i>dst[i] = M*src[i]</i> for all
+   * vectors of the two multivectors. In contrast to calling vmult() for each
+   * vector, the matrix is read from memory only once for all vectors, which
+   * is what block Krylov methods like SolverBlockCG rely on.
+   *
+   * Source and destination must not be the same multivector.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void
+  vmult(MultiVector<Vector<somenumber>> &      dst,
+        const MultiVector<Vector<somenumber>> &src) const;
+
   /**
    * Return the square of the norm of the vector $v$ with respect to the norm
    * induced by this matrix, i.e. $\left(v,Mv\right)$. This is useful, e.g. in
@@ -1351,6 +1371,43 @@ public:
                     const Vector<somenumber> &src,
                     const number              om = 1.) const;
 
+  /**
+   * Same as the precondition_SSOR() function above, but the forward and the
+   * backward sweep process the rows of each level of @p level_schedule in
+   * parallel. The schedule must have been computed for the sparsity pattern
+   * of this matrix. The result is the same as the one of the sequential
+   * function.
+   */
+  template <typename somenumber>
+  void
+  precondition_SSOR(Vector<somenumber> &            dst,
+                    const Vector<somenumber> &      src,
+                    const number                    omega,
+                    const std::vector<std::size_t> &pos_right_of_diagonal,
+                    const SparseLevelSchedule &     level_schedule) const;
+
+  /**
+   * Same as the precondition_SOR() function above, but with the rows of
+   * each level of @p level_schedule processed in parallel.
+   */
+  template <typename somenumber>
+  void
+  precondition_SOR(Vector<somenumber> &       dst,
+                   const Vector<somenumber> & src,
+                   const number               om,
+                   const SparseLevelSchedule &level_schedule) const;
+
+  /**
+   * Same as the precondition_TSOR() function above, but with the rows of
+   * each level of @p level_schedule processed in parallel.
+   */
+  template <typename somenumber>
+  void
+  precondition_TSOR(Vector<somenumber> &       dst,
+                    const Vector<somenumber> & src,
+                    const number               om,
+                    const SparseLevelSchedule &level_schedule) const;
+
   /**
    * Perform SSOR preconditioning in-place.  Apply the preconditioner matrix
    * without copying to a second vector.  <tt>omega</tt> is the relaxation
@@ -1715,6 +1772,12 @@ private:
   template <typename>
   friend class SparseILU;
 
+  /**
+   * To allow it direct access to the value array.
+   */
+  template <typename>
+  friend class LocalToGlobalScatter;
+
   /**
    * To allow it calling private prepare_add() and prepare_set().
    */
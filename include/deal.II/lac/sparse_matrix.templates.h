@@ -27,6 +27,8 @@
 
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/sparse_level_schedule.h>
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/vector.h>
@@ -792,6 +794,91 @@ SparseMatrix<number>::vmult(OutVector &dst, const InVector &src) const
 
 
 
+namespace internal
+{
+  namespace SparseMatrixImplementation
+  {
+    /**
+     * Perform the product of the given rows of the matrix with all vectors
+     * of a multivector. The entries of each row are read once and applied to
+     * all vectors.
+     */
+    template <typename number, typename somenumber>
+    void
+    vmult_multivector_on_subrange(
+      const size_type                         begin_row,
+      const size_type                         end_row,
+      const number *                          values,
+      const std::size_t *                     rowstart,
+      const size_type *                       colnums,
+      const MultiVector<Vector<somenumber>> &src,
+      MultiVector<Vector<somenumber>> &       dst)
+    {
+      const unsigned int n_vectors = src.n_vectors();
+
+      std::vector<const somenumber *> src_ptrs(n_vectors);
+      std::vector<somenumber *>       dst_ptrs(n_vectors);
+      for (unsigned int v = 0; v < n_vectors; ++v)
+        {
+          src_ptrs[v] = src[v].begin();
+          dst_ptrs[v] = dst[v].begin();
+        }
+
+      std::vector<somenumber> sums(n_vectors);
+      for (size_type row = begin_row; row < end_row; ++row)
+        {
+          std::fill(sums.begin(), sums.end(), somenumber());
+          for (std::size_t j = rowstart[row]; j < rowstart[row + 1]; ++j)
+            {
+              const somenumber value  = somenumber(values[j]);
+              const size_type  column = colnums[j];
+              for (unsigned int v = 0; v < n_vectors; ++v)
+                sums[v] += value * src_ptrs[v][column];
+            }
+          for (unsigned int v = 0; v < n_vectors; ++v)
+            dst_ptrs[v][row] = sums[v];
+        }
+    }
+  } // namespace SparseMatrixImplementation
+} // namespace internal
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::vmult(MultiVector<Vector<somenumber>> &      dst,
+                            const MultiVector<Vector<somenumber>> &src) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(dst.n_vectors(), src.n_vectors());
+  for (unsigned int v = 0; v < src.n_vectors(); ++v)
+    {
+      Assert(m() == dst[v].size(), ExcDimensionMismatch(m(), dst[v].size()));
+      Assert(n() == src[v].size(), ExcDimensionMismatch(n(), src[v].size()));
+    }
+
+  Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges(
+    0U,
+    m(),
+    [&](const size_type begin, const size_type end) {
+      internal::SparseMatrixImplementation::vmult_multivector_on_subrange(
+        begin,
+        end,
+        val.get(),
+        cols->rowstart.get(),
+        cols->colnums.get(),
+        src,
+        dst);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+}
+
+
+
 template <typename number>
 template <class OutVector, class InVector>
 void
@@ -1593,6 +1680,125 @@ SparseMatrix<number>::precondition_TSOR(Vector<somenumber> &      dst,
 }
 
 
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SSOR(
+  Vector<somenumber> &            dst,
+  const Vector<somenumber> &      src,
+  const number                    om,
+  const std::vector<std::size_t> &pos_right_of_diagonal,
+  const SparseLevelSchedule &     level_schedule) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  AssertDimension(pos_right_of_diagonal.size(), n());
+  AssertDimension(level_schedule.n_rows(), n());
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  const std::size_t *rowstart = cols->rowstart.get();
+  const size_type *  colnums  = cols->colnums.get();
+
+  // the operations on each row are the same as in the sequential function,
+  // only the order of the rows differs
+  level_schedule.apply_lower([&](const size_type row) {
+    number s = 0;
+    for (std::size_t j = rowstart[row] + 1; j < pos_right_of_diagonal[row];
+         ++j)
+      s += val[j] * number(dst(colnums[j]));
+
+    somenumber dst_row = src(row);
+    dst_row -= s * om;
+    dst_row /= val[rowstart[row]];
+    dst(row) = dst_row;
+  });
+
+  for (size_type row = 0; row < n(); ++row)
+    dst(row) *=
+      somenumber(om * (number(2.) - om)) * somenumber(val[rowstart[row]]);
+
+  level_schedule.apply_upper([&](const size_type row) {
+    number s = 0;
+    for (std::size_t j = pos_right_of_diagonal[row]; j < rowstart[row + 1];
+         ++j)
+      s += val[j] * number(dst(colnums[j]));
+
+    somenumber dst_row = dst(row);
+    dst_row -= s * om;
+    dst_row /= val[rowstart[row]];
+    dst(row) = dst_row;
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SOR(
+  Vector<somenumber> &       dst,
+  const Vector<somenumber> & src,
+  const number               om,
+  const SparseLevelSchedule &level_schedule) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  AssertDimension(level_schedule.n_rows(), n());
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  level_schedule.apply_lower([&](const size_type row) {
+    somenumber s = src(row);
+    for (size_type j = cols->rowstart[row]; j < cols->rowstart[row + 1]; ++j)
+      {
+        const size_type col = cols->colnums[j];
+        if (col < row)
+          s -= somenumber(val[j]) * dst(col);
+      }
+
+    dst(row) = s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_TSOR(
+  Vector<somenumber> &       dst,
+  const Vector<somenumber> & src,
+  const number               om,
+  const SparseLevelSchedule &level_schedule) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  AssertDimension(level_schedule.n_rows(), n());
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  level_schedule.apply_upper([&](const size_type row) {
+    somenumber s = src(row);
+    for (size_type j = cols->rowstart[row]; j < cols->rowstart[row + 1]; ++j)
+      if (cols->colnums[j] > row)
+        s -= somenumber(val[j]) * dst(cols->colnums[j]);
+
+    dst(row) = s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+  });
+}
+
+
 template <typename number>
 template <typename somenumber>
 void
@@ -20,6 +20,8 @@
 #include <deal.II/base/memory_space.h>
 #include <deal.II/base/multithread_info.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx14/utility.h>
+#include <deal.II/base/tensor.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/types.h>
 #include <deal.II/base/vectorization.h>
@@ -29,6 +31,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <tuple>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -956,6 +959,119 @@ namespace internal
       const Number        a;
     };
 
+    // Assignment of a vector expression as represented by
+    // LinearAlgebra::distributed::VectorExpression. The expression is copied
+    // into the functor, which only involves some pointers and scalars, such
+    // that the compiler can keep them in registers during the loop
+    template <typename Number, typename Expression>
+    struct Vectorization_expression
+    {
+      Vectorization_expression(Number *const val, const Expression &expression)
+        : val(val)
+        , expression(expression)
+      {}
+
+      void
+      operator()(const size_type begin, const size_type end) const
+      {
+        if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
+          {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (size_type i = begin; i < end; ++i)
+              val[i] = expression.value(i);
+          }
+        else
+          {
+            for (size_type i = begin; i < end; ++i)
+              val[i] = expression.value(i);
+          }
+      }
+
+      Number *const    val;
+      const Expression expression;
+    };
+
+    // Assignment of a vector expression combined with several reductions
+    // over the assigned values, such as inner products with other vectors
+    // and the norm. The results of all reductions are collected in a tensor,
+    // which is summed with the same algorithm as the scalar reductions
+    template <typename Number, typename Expression, typename... Reductions>
+    struct ExpressionAndReductions
+    {
+      static const bool vectorizes =
+        VectorizedArray<Number>::n_array_elements > 1;
+
+      static const int n_results = sizeof...(Reductions);
+
+      ExpressionAndReductions(Number *const     val,
+                              const Expression &expression,
+                              const Reductions &... reductions)
+        : val(val)
+        , expression(expression)
+        , reductions(reductions...)
+      {}
+
+      Tensor<1, n_results, Number>
+      operator()(const size_type i) const
+      {
+        const Number x = expression.value(i);
+        val[i]         = x;
+        // may only evaluate the reductions after storing in val because the
+        // reductions might refer to the same memory
+        Tensor<1, n_results, Number> result;
+        reduce(x, i, result, std_cxx14::index_sequence_for<Reductions...>());
+        return result;
+      }
+
+      Tensor<1, n_results, VectorizedArray<Number>>
+      do_vectorized(const size_type i) const
+      {
+        // the reductions in VectorizedArray do not take the complex
+        // conjugate of one argument, see the Dot operation above
+        static_assert(numbers::NumberTraits<Number>::is_complex == false,
+                      "This operation is not correctly implemented for "
+                      "complex-valued objects.");
+        const VectorizedArray<Number> x = expression.vectorized_value(i);
+        x.store(val + i);
+        Tensor<1, n_results, VectorizedArray<Number>> result;
+        reduce_vectorized(x,
+                          i,
+                          result,
+                          std_cxx14::index_sequence_for<Reductions...>());
+        return result;
+      }
+
+      template <std::size_t... indices>
+      void
+      reduce(const Number                  x,
+             const size_type               i,
+             Tensor<1, n_results, Number> &result,
+             std_cxx14::index_sequence<indices...>) const
+      {
+        const int dummy[] = {
+          (result[indices] = std::get<indices>(reductions).value(x, i), 0)...};
+        (void)dummy;
+      }
+
+      template <std::size_t... indices>
+      void
+      reduce_vectorized(const VectorizedArray<Number> &                x,
+                        const size_type                                i,
+                        Tensor<1, n_results, VectorizedArray<Number>> &result,
+                        std_cxx14::index_sequence<indices...>) const
+      {
+        const int dummy[] = {
+          (result[indices] =
+             std::get<indices>(reductions).vectorized_value(x, i),
+           0)...};
+        (void)dummy;
+      }
+
+      Number *const                  val;
+      const Expression               expression;
+      const std::tuple<Reductions...> reductions;
+    };
+
 
 
     // this is the main working loop for all vector sums using the templated
@@ -1243,6 +1359,72 @@ namespace internal
 
 
 
+    // this is the vectorized inner working routine for operations that
+    // compute several sums at once and return them in a tensor. It works in
+    // the same way as the function above, with the lanes of each component
+    // of the vectorized result written into the same positions of
+    // outer_results as there, such that each of the sums is computed in the
+    // same order as with a scalar operation
+    template <typename Operation, int n_results, typename Number>
+    void
+    accumulate_regular(
+      const Operation &op,
+      size_type &      n_chunks,
+      size_type &      index,
+      Tensor<1, n_results, Number> (
+        &outer_results)[vector_accumulation_recursion_threshold],
+      std::integral_constant<bool, true>)
+    {
+      const unsigned int nvecs = VectorizedArray<Number>::n_array_elements;
+      const size_type    regular_chunks = n_chunks / nvecs;
+      for (size_type i = 0; i < regular_chunks; ++i)
+        {
+          Tensor<1, n_results, VectorizedArray<Number>> r0 =
+            op.do_vectorized(index);
+          Tensor<1, n_results, VectorizedArray<Number>> r1 =
+            op.do_vectorized(index + nvecs);
+          Tensor<1, n_results, VectorizedArray<Number>> r2 =
+            op.do_vectorized(index + 2 * nvecs);
+          Tensor<1, n_results, VectorizedArray<Number>> r3 =
+            op.do_vectorized(index + 3 * nvecs);
+          index += nvecs * 4;
+          for (size_type j = 1; j < 8; ++j, index += nvecs * 4)
+            {
+              r0 += op.do_vectorized(index);
+              r1 += op.do_vectorized(index + nvecs);
+              r2 += op.do_vectorized(index + 2 * nvecs);
+              r3 += op.do_vectorized(index + 3 * nvecs);
+            }
+          r0 += r1;
+          r2 += r3;
+          r0 += r2;
+          for (unsigned int v = 0; v < nvecs; ++v)
+            for (unsigned int c = 0; c < n_results; ++c)
+              outer_results[i * nvecs + v][c] = r0[c][v];
+        }
+
+      AssertIndexRange(VectorizedArray<Number>::n_array_elements, 17);
+      Assert(16 % nvecs == 0, ExcInternalError());
+      if (n_chunks % VectorizedArray<Number>::n_array_elements != 0)
+        {
+          Tensor<1, n_results, VectorizedArray<Number>> r0, r1;
+          const size_type start_irreg = regular_chunks * nvecs;
+          for (size_type c = start_irreg; c < n_chunks; ++c)
+            for (size_type j = 0; j < 32; j += 2 * nvecs, index += 2 * nvecs)
+              {
+                r0 += op.do_vectorized(index);
+                r1 += op.do_vectorized(index + nvecs);
+              }
+          r0 += r1;
+          for (unsigned int v = 0; v < nvecs; ++v)
+            for (unsigned int c = 0; c < n_results; ++c)
+              outer_results[start_irreg + v][c] = r0[c][v];
+          n_chunks = start_irreg + VectorizedArray<Number>::n_array_elements;
+        }
+    }
+
+
+
 #ifdef DEAL_II_WITH_THREADS
     /**
      * This struct takes the loop range from the tbb parallel for loop and
@@ -0,0 +1,407 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_assembly_plan_h
+#define dealii_assembly_plan_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/work_stream.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/local_to_global_scatter.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A class that collects all the information needed to repeatedly assemble a
+ * SparseMatrix (and a right hand side vector) on a mesh that does not
+ * change, e.g. within Newton iterations or time stepping loops with
+ * time-dependent coefficients.
+ *
+ * The object is set up from a DoFHandler, an AffineConstraints object, and
+ * the SparsityPattern of the matrix to be assembled. During setup, it
+ * <ul>
+ * <li> stores the global indices of the degrees of freedom of all locally
+ * owned cells, so that cell values of a global vector can be gathered
+ * without going through the DoF accessors (see get_dof_values());
+ * <li> computes, for every cell, the positions within the value array of
+ * the sparse matrix that the entries of the cell matrix are added to, with
+ * constraints already resolved. This is done by a LocalToGlobalScatter
+ * object, see there for details. Adding cell contributions into the global
+ * matrix then becomes a pure scatter operation without index searches (see
+ * distribute_local_to_global());
+ * <li> colors the cells by the rows of the global matrix they write into,
+ * using GraphColoring::make_graph_coloring(). Two cells of the same color
+ * never write into the same matrix row or vector entry, including entries
+ * they reach through constraints. This allows to run the copier functions
+ * of a WorkStream loop in parallel without locks, see run().
+ * </ul>
+ *
+ * A typical assembly loop then looks as follows:
+ * @code
+ *   AssemblyPlan<DoFHandler<dim>> plan(dof_handler,
+ *                                      constraints,
+ *                                      sparsity_pattern);
+ *
+ *   // in each Newton step:
+ *   system_matrix = 0;
+ *   system_rhs    = 0;
+ *   plan.run(
+ *     [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+ *         ScratchData &                                         scratch,
+ *         CopyData &                                            copy) {
+ *       plan.get_dof_values(cell, current_solution, copy.cell_solution);
+ *       ... compute copy.cell_matrix and copy.cell_rhs ...
+ *       copy.cell = cell;
+ *     },
+ *     [&](const CopyData &copy) {
+ *       plan.distribute_local_to_global(copy.cell,
+ *                                       copy.cell_matrix,
+ *                                       copy.cell_rhs,
+ *                                       system_matrix,
+ *                                       system_rhs);
+ *     },
+ *     ScratchData(...),
+ *     CopyData(...));
+ * @endcode
+ *
+ * The object only stores information for locally owned cells. It needs to
+ * be reinitialized whenever the mesh, the degrees of freedom, the
+ * constraints or the sparsity pattern change.
+ *
+ * @tparam DoFHandlerType Either DoFHandler or hp::DoFHandler.
+ * @tparam number The number type of the constraints and of the matrix.
+ *
+ * @ingroup numerics
+ */
+template <typename DoFHandlerType, typename number = double>
+class AssemblyPlan : public Subscriptor
+{
+public:
+  /**
+   * An alias for the iterator type of the active cells of the DoFHandler.
+   */
+  using active_cell_iterator = typename DoFHandlerType::active_cell_iterator;
+
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Constructor. Leaves the object empty.
+   */
+  AssemblyPlan();
+
+  /**
+   * Constructor. Calls reinit() with the given arguments.
+   */
+  AssemblyPlan(const DoFHandlerType &           dof_handler,
+               const AffineConstraints<number> &constraints,
+               const SparsityPattern &          sparsity_pattern);
+
+  /**
+   * Compute the scatter information and the coloring of all locally owned
+   * cells of the given DoFHandler. The constraints object must be closed.
+   */
+  void
+  reinit(const DoFHandlerType &           dof_handler,
+         const AffineConstraints<number> &constraints,
+         const SparsityPattern &          sparsity_pattern);
+
+  /**
+   * Delete all data and reset the object to the state after the default
+   * constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Return the number of cells stored in this object, i.e., the number of
+   * locally owned active cells of the DoFHandler.
+   */
+  unsigned int
+  n_cells() const;
+
+  /**
+   * Return the number of the given cell within this object. The cells are
+   * numbered in the order in which they are traversed by
+   * DoFHandlerType::active_cell_iterators(), skipping cells that are not
+   * locally owned. This is also the number by which the cell is referred to
+   * in the underlying LocalToGlobalScatter object.
+   */
+  unsigned int
+  cell_index(const active_cell_iterator &cell) const;
+
+  /**
+   * Return the locally owned active cells in the numbering of this object.
+   */
+  const std::vector<active_cell_iterator> &
+  get_cells() const;
+
+  /**
+   * Return the cells grouped by colors. Cells of the same color do not write
+   * into the same rows of the global matrix. The return value can be passed
+   * to the WorkStream::run() variant that takes colored iterators.
+   */
+  const std::vector<std::vector<active_cell_iterator>> &
+  get_colored_cells() const;
+
+  /**
+   * Return the scatter object that holds the matrix positions of all cells.
+   */
+  const LocalToGlobalScatter<number> &
+  get_scatter() const;
+
+  /**
+   * Return the global indices of the degrees of freedom of the given cell,
+   * in the same order as DoFCellAccessor::get_dof_indices() returns them.
+   */
+  ArrayView<const size_type>
+  get_dof_indices(const active_cell_iterator &cell) const;
+
+  /**
+   * Gather the values of the given global vector at the degrees of freedom
+   * of the given cell, using the stored indices. The output vector is
+   * resized to the number of degrees of freedom of the cell.
+   */
+  template <typename VectorType, typename Number2>
+  void
+  get_dof_values(const active_cell_iterator &cell,
+                 const VectorType &          global_vector,
+                 Vector<Number2> &           local_values) const;
+
+  /**
+   * Add the cell matrix of the given cell into the global matrix. The matrix
+   * must be based on the sparsity pattern given to reinit().
+   */
+  void
+  distribute_local_to_global(const active_cell_iterator &cell,
+                             const FullMatrix<number> &  local_matrix,
+                             SparseMatrix<number> &      global_matrix) const;
+
+  /**
+   * Add the cell matrix and the cell vector of the given cell into the
+   * global matrix and vector. See
+   * AffineConstraints::distribute_local_to_global() for the meaning of the
+   * last argument.
+   */
+  template <typename VectorType>
+  void
+  distribute_local_to_global(
+    const active_cell_iterator &cell,
+    const FullMatrix<number> &  local_matrix,
+    const Vector<number> &      local_vector,
+    SparseMatrix<number> &      global_matrix,
+    VectorType &                global_vector,
+    const bool                  use_inhomogeneities_for_rhs = false) const;
+
+  /**
+   * Run WorkStream::run() over the colored cells of this object. Since the
+   * copier is called concurrently for cells of the same color, it may only
+   * write into the global objects through the distribute_local_to_global()
+   * functions of this class (or otherwise only into entries belonging to the
+   * rows of the cell's degrees of freedom and the degrees of freedom they are
+   * constrained to).
+   */
+  template <typename Worker,
+            typename Copier,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run(Worker             worker,
+      Copier             copier,
+      const ScratchData &sample_scratch_data,
+      const CopyData &   sample_copy_data,
+      const unsigned int queue_length = 2 * MultithreadInfo::n_threads(),
+      const unsigned int chunk_size   = 8) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg(ExcCellNotInPlan,
+                   "The given cell is not part of this AssemblyPlan. Only "
+                   "locally owned active cells of the DoFHandler given to "
+                   "reinit() are stored.");
+
+private:
+  /**
+   * Pointer to the DoFHandler the object was set up with.
+   */
+  SmartPointer<const DoFHandlerType, AssemblyPlan<DoFHandlerType, number>>
+    dof_handler;
+
+  /**
+   * The locally owned active cells.
+   */
+  std::vector<active_cell_iterator> cells;
+
+  /**
+   * The cells grouped by color.
+   */
+  std::vector<std::vector<active_cell_iterator>> colored_cells;
+
+  /**
+   * Map from the active cell index of a cell to its number within this
+   * object, or numbers::invalid_unsigned_int for cells that are not stored.
+   */
+  std::vector<unsigned int> cell_numbers;
+
+  /**
+   * The global dof indices of all cells, concatenated.
+   */
+  std::vector<size_type> dof_indices;
+
+  /**
+   * Start of the dof indices of each cell within @p dof_indices, with one
+   * more element than there are cells.
+   */
+  std::vector<std::size_t> dof_index_offsets;
+
+  /**
+   * The object doing the actual scatter operations.
+   */
+  LocalToGlobalScatter<number> scatter;
+};
+
+
+#ifndef DOXYGEN
+/*---------------------- Inline functions -----------------------------------*/
+
+
+template <typename DoFHandlerType, typename number>
+inline unsigned int
+AssemblyPlan<DoFHandlerType, number>::n_cells() const
+{
+  return cells.size();
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+inline unsigned int
+AssemblyPlan<DoFHandlerType, number>::cell_index(
+  const active_cell_iterator &cell) const
+{
+  Assert(dof_handler != nullptr, ExcNotInitialized());
+  Assert(&cell->get_dof_handler() == &*dof_handler, ExcCellNotInPlan());
+  AssertIndexRange(cell->active_cell_index(), cell_numbers.size());
+  const unsigned int index = cell_numbers[cell->active_cell_index()];
+  Assert(index != numbers::invalid_unsigned_int, ExcCellNotInPlan());
+  return index;
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+inline ArrayView<const types::global_dof_index>
+AssemblyPlan<DoFHandlerType, number>::get_dof_indices(
+  const active_cell_iterator &cell) const
+{
+  const unsigned int index = cell_index(cell);
+  return make_array_view(dof_indices.data() + dof_index_offsets[index],
+                         dof_indices.data() + dof_index_offsets[index + 1]);
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+template <typename VectorType, typename Number2>
+inline void
+AssemblyPlan<DoFHandlerType, number>::get_dof_values(
+  const active_cell_iterator &cell,
+  const VectorType &          global_vector,
+  Vector<Number2> &           local_values) const
+{
+  const ArrayView<const size_type> indices = get_dof_indices(cell);
+  local_values.reinit(indices.size(), true);
+  for (unsigned int i = 0; i < indices.size(); ++i)
+    local_values(i) = global_vector(indices[i]);
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+template <typename VectorType>
+inline void
+AssemblyPlan<DoFHandlerType, number>::distribute_local_to_global(
+  const active_cell_iterator &cell,
+  const FullMatrix<number> &  local_matrix,
+  const Vector<number> &      local_vector,
+  SparseMatrix<number> &      global_matrix,
+  VectorType &                global_vector,
+  const bool                  use_inhomogeneities_for_rhs) const
+{
+  scatter.distribute_local_to_global(cell_index(cell),
+                                     local_matrix,
+                                     local_vector,
+                                     global_matrix,
+                                     global_vector,
+                                     use_inhomogeneities_for_rhs);
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+template <typename Worker,
+          typename Copier,
+          typename ScratchData,
+          typename CopyData>
+inline void
+AssemblyPlan<DoFHandlerType, number>::run(
+  Worker             worker,
+  Copier             copier,
+  const ScratchData &sample_scratch_data,
+  const CopyData &   sample_copy_data,
+  const unsigned int queue_length,
+  const unsigned int chunk_size) const
+{
+  if (colored_cells.empty())
+    return;
+
+  WorkStream::run(colored_cells,
+                  worker,
+                  copier,
+                  sample_scratch_data,
+                  sample_copy_data,
+                  queue_length,
+                  chunk_size);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
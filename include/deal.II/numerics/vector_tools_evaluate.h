@@ -0,0 +1,150 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_vector_tools_evaluate_h
+#define dealii_vector_tools_evaluate_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/mpi_remote_point_evaluation.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/tensor.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace VectorTools
+{
+  /**
+   * Evaluate the finite element field given by @p dof_handler and @p vector
+   * at the points passed to Utilities::MPI::RemotePointEvaluation::reinit()
+   * of @p evaluation on the current process, which may lie in cells owned by
+   * other processes. The values of the @p n_components components of the
+   * field are returned in the order of the points. Points that were not found
+   * get zero values.
+   *
+   * This function is a collective operation on the communicator of the
+   * triangulation. The @p vector must contain the values of all degrees of
+   * freedom of the locally owned cells, i.e., a distributed vector must have
+   * its ghost values updated.
+   */
+  template <int n_components, int dim, int spacedim, typename VectorType>
+  std::vector<Tensor<1, n_components, typename VectorType::value_type>>
+  point_values(
+    const Utilities::MPI::RemotePointEvaluation<dim, spacedim> &evaluation,
+    const DoFHandler<dim, spacedim> &                           dof_handler,
+    const VectorType &                                          vector);
+
+  /**
+   * Like point_values(), but return the gradients of the @p n_components
+   * components of the field at the points.
+   */
+  template <int n_components, int dim, int spacedim, typename VectorType>
+  std::vector<Tensor<1,
+                     n_components,
+                     Tensor<1, spacedim, typename VectorType::value_type>>>
+  point_gradients(
+    const Utilities::MPI::RemotePointEvaluation<dim, spacedim> &evaluation,
+    const DoFHandler<dim, spacedim> &                           dof_handler,
+    const VectorType &                                          vector);
+
+
+
+#ifndef DOXYGEN
+
+  template <int n_components, int dim, int spacedim, typename VectorType>
+  std::vector<Tensor<1, n_components, typename VectorType::value_type>>
+  point_values(
+    const Utilities::MPI::RemotePointEvaluation<dim, spacedim> &evaluation,
+    const DoFHandler<dim, spacedim> &                           dof_handler,
+    const VectorType &                                          vector)
+  {
+    using Number = typename VectorType::value_type;
+    AssertDimension(dof_handler.get_fe().n_components(), n_components);
+
+    std::vector<Tensor<1, n_components, Number>> output;
+    evaluation.template evaluate_and_process<Tensor<1, n_components, Number>>(
+      output,
+      [&](const ArrayView<Tensor<1, n_components, Number>> &values,
+          const GridTools::PointLocations<dim, spacedim> &) {
+        std::vector<Vector<Number>> cell_values;
+        evaluation.loop_over_cells(
+          dof_handler,
+          update_values,
+          [&](const FEValues<dim, spacedim> &fe_values,
+              const unsigned int             offset) {
+            cell_values.resize(fe_values.n_quadrature_points,
+                               Vector<Number>(n_components));
+            fe_values.get_function_values(vector, cell_values);
+            for (unsigned int q = 0; q < cell_values.size(); ++q)
+              for (unsigned int d = 0; d < n_components; ++d)
+                values[offset + q][d] = cell_values[q][d];
+          });
+      });
+    return output;
+  }
+
+
+
+  template <int n_components, int dim, int spacedim, typename VectorType>
+  std::vector<Tensor<1,
+                     n_components,
+                     Tensor<1, spacedim, typename VectorType::value_type>>>
+  point_gradients(
+    const Utilities::MPI::RemotePointEvaluation<dim, spacedim> &evaluation,
+    const DoFHandler<dim, spacedim> &                           dof_handler,
+    const VectorType &                                          vector)
+  {
+    using Number   = typename VectorType::value_type;
+    using Gradient = Tensor<1, n_components, Tensor<1, spacedim, Number>>;
+    AssertDimension(dof_handler.get_fe().n_components(), n_components);
+
+    std::vector<Gradient> output;
+    evaluation.template evaluate_and_process<Gradient>(
+      output,
+      [&](const ArrayView<Gradient> &gradients,
+          const GridTools::PointLocations<dim, spacedim> &) {
+        std::vector<std::vector<Tensor<1, spacedim, Number>>> cell_gradients;
+        evaluation.loop_over_cells(
+          dof_handler,
+          update_gradients,
+          [&](const FEValues<dim, spacedim> &fe_values,
+              const unsigned int             offset) {
+            cell_gradients.resize(
+              fe_values.n_quadrature_points,
+              std::vector<Tensor<1, spacedim, Number>>(n_components));
+            fe_values.get_function_gradients(vector, cell_gradients);
+            for (unsigned int q = 0; q < cell_gradients.size(); ++q)
+              for (unsigned int d = 0; d < n_components; ++d)
+                gradients[offset + q][d] = cell_gradients[q][d];
+          });
+      });
+    return output;
+  }
+
+#endif
+
+} // namespace VectorTools
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
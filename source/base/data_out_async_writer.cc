@@ -0,0 +1,227 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/data_out_async_writer.h>
+#include <deal.II/base/memory_consumption.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace DataOutAsyncWriterImplementation
+  {
+    /**
+     * A copy of the patches, the names of the data sets, and the output
+     * flags of a DataOutInterface object that can be written independently
+     * of the original object.
+     */
+    template <int dim, int spacedim>
+    class Snapshot : public DataOutInterface<dim, spacedim>
+    {
+    public:
+      /**
+       * Constructor. The output flags are copied from @p data_out.
+       */
+      Snapshot(
+        const DataOutInterface<dim, spacedim> &                data_out,
+        const std::vector<DataOutBase::Patch<dim, spacedim>> &patches,
+        const std::vector<std::string> &                      dataset_names,
+        const std::vector<
+          std::tuple<unsigned int,
+                     unsigned int,
+                     std::string,
+                     DataComponentInterpretation::DataComponentInterpretation>>
+          &nonscalar_data_ranges)
+        : DataOutInterface<dim, spacedim>(data_out)
+        , patches(patches)
+        , dataset_names(dataset_names)
+        , nonscalar_data_ranges(nonscalar_data_ranges)
+      {}
+
+    protected:
+      virtual const std::vector<DataOutBase::Patch<dim, spacedim>> &
+      get_patches() const override
+      {
+        return patches;
+      }
+
+      virtual std::vector<std::string>
+      get_dataset_names() const override
+      {
+        return dataset_names;
+      }
+
+      virtual std::vector<
+        std::tuple<unsigned int,
+                   unsigned int,
+                   std::string,
+                   DataComponentInterpretation::DataComponentInterpretation>>
+      get_nonscalar_data_ranges() const override
+      {
+        return nonscalar_data_ranges;
+      }
+
+    private:
+      const std::vector<DataOutBase::Patch<dim, spacedim>> patches;
+      const std::vector<std::string>                       dataset_names;
+      const std::vector<
+        std::tuple<unsigned int,
+                   unsigned int,
+                   std::string,
+                   DataComponentInterpretation::DataComponentInterpretation>>
+        nonscalar_data_ranges;
+    };
+  } // namespace DataOutAsyncWriterImplementation
+} // namespace internal
+
+
+
+template <int dim, int spacedim>
+DataOutAsyncWriter<dim, spacedim>::DataOutAsyncWriter(
+  const unsigned int max_pending_writes,
+  const std::size_t  max_pending_memory)
+  : max_pending_writes(max_pending_writes)
+  , max_pending_memory(max_pending_memory)
+  , pending_memory(0)
+{
+  AssertThrow(max_pending_writes > 0,
+              ExcInvalidNumberOfWrites(max_pending_writes));
+}
+
+
+
+template <int dim, int spacedim>
+DataOutAsyncWriter<dim, spacedim>::~DataOutAsyncWriter()
+{
+  // the exceptions of the writes can not be reported from a destructor, so
+  // only wait for the tasks
+  for (PendingWrite &pending_write : pending_writes)
+    pending_write.task.join();
+}
+
+
+
+template <int dim, int spacedim>
+std::shared_future<void>
+DataOutAsyncWriter<dim, spacedim>::write(
+  const DataOutInterface<dim, spacedim> &data_out,
+  const std::string &                    filename,
+  const DataOutBase::OutputFormat        output_format)
+{
+  const std::vector<DataOutBase::Patch<dim, spacedim>> &patches =
+    data_out.get_patches();
+  const std::size_t memory = MemoryConsumption::memory_consumption(patches);
+
+  // apply back-pressure before the snapshot is taken, so that the memory
+  // limit also bounds the peak memory consumption
+  while (!pending_writes.empty() &&
+         (pending_writes.size() >= max_pending_writes ||
+          pending_memory + memory > max_pending_memory))
+    wait_for_oldest();
+
+  const auto snapshot = std::make_shared<
+    const internal::DataOutAsyncWriterImplementation::Snapshot<dim, spacedim>>(
+    data_out,
+    patches,
+    data_out.get_dataset_names(),
+    data_out.get_nonscalar_data_ranges());
+  const auto promise = std::make_shared<std::promise<void>>();
+
+  const std::shared_future<void> future = promise->get_future().share();
+  const Threads::Task<void>      task =
+    Threads::new_task([snapshot, promise, filename, output_format]() {
+      try
+        {
+          std::ofstream out(filename);
+          AssertThrow(out, ExcFileNotOpen(filename));
+          snapshot->write(out, output_format);
+          out.close();
+          AssertThrow(out, ExcIO());
+          promise->set_value();
+        }
+      catch (...)
+        {
+          promise->set_exception(std::current_exception());
+        }
+    });
+
+  pending_writes.push_back(PendingWrite{task, future, memory});
+  pending_memory += memory;
+  return future;
+}
+
+
+
+template <int dim, int spacedim>
+void
+DataOutAsyncWriter<dim, spacedim>::wait()
+{
+  // wait for all writes before reporting the first exception, so that no
+  // write is left behind
+  for (PendingWrite &pending_write : pending_writes)
+    pending_write.task.join();
+  while (!pending_writes.empty())
+    wait_for_oldest();
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+DataOutAsyncWriter<dim, spacedim>::n_pending_writes() const
+{
+  unsigned int n_pending = 0;
+  for (const PendingWrite &pending_write : pending_writes)
+    if (pending_write.future.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready)
+      ++n_pending;
+  return n_pending;
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+DataOutAsyncWriter<dim, spacedim>::memory_consumption() const
+{
+  return pending_memory;
+}
+
+
+
+template <int dim, int spacedim>
+void
+DataOutAsyncWriter<dim, spacedim>::wait_for_oldest()
+{
+  Assert(!pending_writes.empty(), ExcInternalError());
+  const PendingWrite pending_write = pending_writes.front();
+  pending_writes.pop_front();
+  pending_memory -= pending_write.memory;
+
+  pending_write.task.join();
+  pending_write.future.get();
+}
+
+
+// explicit instantiations
+#include "data_out_async_writer.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -34,6 +34,7 @@
 #include <deal.II/base/data_out_base.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
@@ -41,12 +42,15 @@
 #include <deal.II/numerics/data_component_interpretation.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <sstream>
 
@@ -253,6 +257,12 @@ namespace
   /**
    * Do a zlib compression followed by a base64 encoding of the given data. The
    * result is then written to the given stream.
+   *
+   * The data is split into blocks of VtkFlags::compression_block_size bytes
+   * that are compressed in parallel. The header in front of the compressed
+   * data lists the number of blocks, the uncompressed size of the blocks and
+   * of the last block, and the compressed size of each block, as expected by
+   * VTK's readers for compressed data arrays.
    */
   template <typename T>
   void
@@ -262,37 +272,78 @@ namespace
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing data and do so
-        uLongf compressed_data_length = compressBound(data.size() * sizeof(T));
-        char * compressed_data        = new char[compressed_data_length];
-        int    err =
-          compress2(reinterpret_cast<Bytef *>(compressed_data),
-                    &compressed_data_length,
-                    reinterpret_cast<const Bytef *>(data.data()),
-                    data.size() * sizeof(T),
-                    get_zlib_compression_level(flags.compression_level));
-        (void)err;
-        Assert(err == Z_OK, ExcInternalError());
-
-        // now encode the compression header
-        const uint32_t compression_header[4] = {
-          1,                                              /* number of blocks */
-          static_cast<uint32_t>(data.size() * sizeof(T)), /* size of block */
-          static_cast<uint32_t>(data.size() *
-                                sizeof(T)), /* size of last block */
-          static_cast<uint32_t>(
-            compressed_data_length)}; /* list of compressed sizes of blocks */
+        Assert(flags.compression_block_size > 0,
+               ExcMessage("The block size for compression must be positive."));
+        const std::size_t uncompressed_size = data.size() * sizeof(T);
+        const std::size_t block_size =
+          std::min<std::size_t>(flags.compression_block_size,
+                                uncompressed_size);
+        const std::size_t n_blocks =
+          (uncompressed_size + block_size - 1) / block_size;
+        const std::size_t last_block_size =
+          uncompressed_size - (n_blocks - 1) * block_size;
+        const int compression_level =
+          get_zlib_compression_level(flags.compression_level);
+
+        // compress the blocks independently of each other into separate
+        // buffers
+        std::vector<std::vector<Bytef>> compressed_blocks(n_blocks);
+        parallel::apply_to_subranges(
+          std::size_t(0),
+          n_blocks,
+          [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t b = begin; b < end; ++b)
+              {
+                const uLong size =
+                  (b == n_blocks - 1) ? last_block_size : block_size;
+                uLongf compressed_length = compressBound(size);
+                compressed_blocks[b].resize(compressed_length);
+                const int err = compress2(
+                  compressed_blocks[b].data(),
+                  &compressed_length,
+                  reinterpret_cast<const Bytef *>(data.data()) +
+                    b * block_size,
+                  size,
+                  compression_level);
+                (void)err;
+                Assert(err == Z_OK, ExcInternalError());
+                compressed_blocks[b].resize(compressed_length);
+              }
+          },
+          1);
+
+        // now encode the compression header: the number of blocks, the size
+        // of a block, the size of the last block, and the list of compressed
+        // sizes of the blocks
+        std::vector<uint32_t> compression_header(3 + n_blocks);
+        compression_header[0] = static_cast<uint32_t>(n_blocks);
+        compression_header[1] = static_cast<uint32_t>(block_size);
+        compression_header[2] = static_cast<uint32_t>(last_block_size);
+        std::size_t compressed_data_length = 0;
+        for (std::size_t b = 0; b < n_blocks; ++b)
+          {
+            compression_header[3 + b] =
+              static_cast<uint32_t>(compressed_blocks[b].size());
+            compressed_data_length += compressed_blocks[b].size();
+          }
 
         char *encoded_header =
-          encode_block(reinterpret_cast<const char *>(&compression_header[0]),
-                       4 * sizeof(compression_header[0]));
+          encode_block(reinterpret_cast<const char *>(
+                         compression_header.data()),
+                       compression_header.size() * sizeof(uint32_t));
         output_stream << encoded_header;
         delete[] encoded_header;
 
-        // next do the compressed data encoding in base64
+        // next do the compressed data encoding in base64, which has to be done
+        // in one go for all blocks
+        std::vector<char> compressed_data;
+        compressed_data.reserve(compressed_data_length);
+        for (const std::vector<Bytef> &block : compressed_blocks)
+          compressed_data.insert(compressed_data.end(),
+                                 block.begin(),
+                                 block.end());
         char *encoded_data =
-          encode_block(compressed_data, compressed_data_length);
-        delete[] compressed_data;
+          encode_block(compressed_data.data(), compressed_data.size());
 
         output_stream << encoded_data;
         delete[] encoded_data;
@@ -1279,7 +1330,23 @@ namespace
     std::ostream &
     operator<<(const std::vector<T> &);
 
+    /**
+     * Set a map from the numbers of the vertices of the patches to the
+     * numbers of the vertices written to the file, which is applied to the
+     * vertex numbers of all cells written afterwards. This is used when
+     * duplicate vertices are filtered.
+     */
+    void
+    set_vertex_map(const std::vector<unsigned int> &map);
+
   private:
+    /**
+     * Return the number under which the vertex @p index of the patches is
+     * written to the file.
+     */
+    unsigned int
+    vertex_number(const unsigned int index) const;
+
     /**
      * A list of vertices and cells, to be used in case we want to compress the
      * data.
@@ -1290,6 +1357,12 @@ namespace
      */
     std::vector<float>   vertices;
     std::vector<int32_t> cells;
+
+    /**
+     * The map set by set_vertex_map(), or an empty vector if the vertices
+     * are written as they are numbered in the patches.
+     */
+    std::vector<unsigned int> vertex_map;
   };
 
 
@@ -1656,36 +1729,39 @@ namespace
                         unsigned int d3)
   {
 #if !defined(DEAL_II_WITH_ZLIB)
-    stream << start;
+    stream << vertex_number(start);
     if (dim >= 1)
       {
-        stream << '\t' << start + d1;
+        stream << '\t' << vertex_number(start + d1);
         if (dim >= 2)
           {
-            stream << '\t' << start + d2 + d1 << '\t' << start + d2;
+            stream << '\t' << vertex_number(start + d2 + d1) << '\t'
+                   << vertex_number(start + d2);
             if (dim >= 3)
               {
-                stream << '\t' << start + d3 << '\t' << start + d3 + d1 << '\t'
-                       << start + d3 + d2 + d1 << '\t' << start + d3 + d2;
+                stream << '\t' << vertex_number(start + d3) << '\t'
+                       << vertex_number(start + d3 + d1) << '\t'
+                       << vertex_number(start + d3 + d2 + d1) << '\t'
+                       << vertex_number(start + d3 + d2);
               }
           }
       }
     stream << '\n';
 #else
-    cells.push_back(start);
+    cells.push_back(vertex_number(start));
     if (dim >= 1)
       {
-        cells.push_back(start + d1);
+        cells.push_back(vertex_number(start + d1));
         if (dim >= 2)
           {
-            cells.push_back(start + d2 + d1);
-            cells.push_back(start + d2);
+            cells.push_back(vertex_number(start + d2 + d1));
+            cells.push_back(vertex_number(start + d2));
             if (dim >= 3)
               {
-                cells.push_back(start + d3);
-                cells.push_back(start + d3 + d1);
-                cells.push_back(start + d3 + d2 + d1);
-                cells.push_back(start + d3 + d2);
+                cells.push_back(vertex_number(start + d3));
+                cells.push_back(vertex_number(start + d3 + d1));
+                cells.push_back(vertex_number(start + d3 + d2 + d1));
+                cells.push_back(vertex_number(start + d3 + d2));
               }
           }
       }
@@ -1700,11 +1776,11 @@ namespace
   {
 #if !defined(DEAL_II_WITH_ZLIB)
     for (const auto &c : connectivity)
-      stream << '\t' << start + c;
+      stream << '\t' << vertex_number(start + c);
     stream << '\n';
 #else
     for (const auto &c : connectivity)
-      cells.push_back(start + c);
+      cells.push_back(vertex_number(start + c));
 #endif
   }
 
@@ -1720,6 +1796,23 @@ namespace
   }
 
 
+  void
+  VtuStream::set_vertex_map(const std::vector<unsigned int> &map)
+  {
+    vertex_map = map;
+  }
+
+
+  inline unsigned int
+  VtuStream::vertex_number(const unsigned int index) const
+  {
+    if (vertex_map.empty())
+      return index;
+    AssertIndexRange(index, vertex_map.size());
+    return vertex_map[index];
+  }
+
+
   template <typename T>
   std::ostream &
   VtuStream::operator<<(const std::vector<T> &data)
@@ -2409,12 +2502,16 @@ namespace DataOutBase
                      const unsigned int                   cycle,
                      const bool                           print_date_and_time,
                      const VtkFlags::ZlibCompressionLevel compression_level,
-                     const bool write_higher_order_cells)
+                     const bool write_higher_order_cells,
+                     const unsigned int compression_block_size,
+                     const bool         filter_duplicate_vertices)
     : time(time)
     , cycle(cycle)
     , print_date_and_time(print_date_and_time)
     , compression_level(compression_level)
     , write_higher_order_cells(write_higher_order_cells)
+    , filter_duplicate_vertices(filter_duplicate_vertices)
+    , compression_block_size(compression_block_size)
   {}
 
 
@@ -2634,6 +2731,185 @@ namespace DataOutBase
   }
 
 
+  /**
+   * Find the nodes of the patches that coincide. The patches do not know
+   * about the vertices or degrees of freedom of the mesh they were created
+   * from, but they know the patches they share a face with. The nodes on
+   * such a face are the same for both patches up to the relative
+   * orientation of the face, which is deduced from the corners of the face.
+   * Nodes of patches without neighbor information, or on faces to patches
+   * with a different number of subdivisions, are not merged.
+   *
+   * On return, @p nodes contains the coordinates of all nodes, @p
+   * unique_nodes the number of the first node of each group of coinciding
+   * nodes in ascending order, and @p node_map, for each node, the position
+   * of the first node of its group in @p unique_nodes.
+   */
+  template <int dim, int spacedim>
+  void
+  compute_unique_nodes(const std::vector<Patch<dim, spacedim>> &patches,
+                       std::vector<Point<spacedim>> &           nodes,
+                       std::vector<unsigned int> &              unique_nodes,
+                       std::vector<unsigned int> &              node_map)
+  {
+    nodes.clear();
+    std::vector<unsigned int>            first_node_of_patch(patches.size());
+    std::map<unsigned int, unsigned int> patch_position;
+    for (unsigned int p = 0; p < patches.size(); ++p)
+      {
+        const Patch<dim, spacedim> &patch          = patches[p];
+        const unsigned int          n_subdivisions = patch.n_subdivisions;
+        const unsigned int          n              = n_subdivisions + 1;
+        const unsigned int          n1             = (dim > 0) ? n : 1;
+        const unsigned int          n2             = (dim > 1) ? n : 1;
+        const unsigned int          n3             = (dim > 2) ? n : 1;
+
+        first_node_of_patch[p]            = nodes.size();
+        patch_position[patch.patch_index] = p;
+        for (unsigned int i3 = 0; i3 < n3; ++i3)
+          for (unsigned int i2 = 0; i2 < n2; ++i2)
+            for (unsigned int i1 = 0; i1 < n1; ++i1)
+              nodes.push_back(compute_node(patch, i1, i2, i3, n_subdivisions));
+      }
+
+    // the first node of each group is found by a union-find structure in
+    // which the representative of a group is its node with the smallest
+    // number
+    std::vector<unsigned int> first_of_group(nodes.size());
+    std::iota(first_of_group.begin(), first_of_group.end(), 0U);
+    const auto find_first = [&first_of_group](unsigned int node) {
+      while (first_of_group[node] != node)
+        {
+          first_of_group[node] = first_of_group[first_of_group[node]];
+          node                 = first_of_group[node];
+        }
+      return node;
+    };
+
+    // the number of the node with coordinates (a,b) within face @p face of
+    // a patch with n nodes per direction, where a runs along the first and
+    // b along the second of the remaining coordinate directions
+    const auto face_node = [](const unsigned int face,
+                              const unsigned int n,
+                              const unsigned int a,
+                              const unsigned int b) {
+      const unsigned int          direction = face / 2;
+      std::array<unsigned int, 3> index     = {{0, 0, 0}};
+      index[direction]                      = (face % 2 == 1) ? n - 1 : 0;
+      index[direction == 0 ? 1 : 0]         = a;
+      index[direction == 2 ? 1 : 2]         = b;
+      return index[0] + n * (index[1] + n * index[2]);
+    };
+
+    for (unsigned int p = 0; p < patches.size(); ++p)
+      for (unsigned int face = 0; face < GeometryInfo<dim>::faces_per_cell;
+           ++face)
+        {
+          const Patch<dim, spacedim> &patch = patches[p];
+          const auto                  neighbor_position =
+            patch_position.find(patch.neighbors[face]);
+          if (patch.neighbors[face] == Patch<dim, spacedim>::no_neighbor ||
+              neighbor_position == patch_position.end() ||
+              neighbor_position->second <= p)
+            continue;
+
+          const unsigned int          q        = neighbor_position->second;
+          const Patch<dim, spacedim> &neighbor = patches[q];
+          if (neighbor.n_subdivisions != patch.n_subdivisions)
+            continue;
+          unsigned int neighbor_face = 0;
+          while (neighbor_face < GeometryInfo<dim>::faces_per_cell &&
+                 neighbor.neighbors[neighbor_face] != patch.patch_index)
+            ++neighbor_face;
+          if (neighbor_face == GeometryInfo<dim>::faces_per_cell)
+            continue;
+
+          const unsigned int n                   = patch.n_subdivisions + 1;
+          const unsigned int na                  = (dim > 1) ? n : 1;
+          const unsigned int nb                  = (dim > 2) ? n : 1;
+          const unsigned int first_node          = first_node_of_patch[p];
+          const unsigned int first_neighbor_node = first_node_of_patch[q];
+
+          // find the corners of the neighbor's face that coincide with the
+          // corners (0,0), (na-1,0), and (0,nb-1) of the face of this patch;
+          // they determine the map between the face nodes of the two
+          // patches for all orientations of the face
+          const auto matching_corner = [&](const unsigned int a,
+                                           const unsigned int b) {
+            const Point<spacedim> &point =
+              nodes[first_node + face_node(face, n, a, b)];
+            std::array<int, 2> best = {{0, 0}};
+            double best_distance    = std::numeric_limits<double>::max();
+            for (const unsigned int a_neighbor : {0U, na - 1})
+              for (const unsigned int b_neighbor : {0U, nb - 1})
+                {
+                  const double distance = point.distance(
+                    nodes[first_neighbor_node +
+                          face_node(neighbor_face, n, a_neighbor, b_neighbor)]);
+                  if (distance < best_distance)
+                    {
+                      best_distance = distance;
+                      best          = {{static_cast<int>(a_neighbor),
+                               static_cast<int>(b_neighbor)}};
+                    }
+                }
+            return best;
+          };
+          const std::array<int, 2> corner_0 = matching_corner(0, 0);
+          const std::array<int, 2> corner_a = matching_corner(na - 1, 0);
+          const std::array<int, 2> corner_b = matching_corner(0, nb - 1);
+          const int                length_a = std::max<int>(na - 1, 1);
+          const int                length_b = std::max<int>(nb - 1, 1);
+          const int step_a[2] = {(corner_a[0] - corner_0[0]) / length_a,
+                                 (corner_a[1] - corner_0[1]) / length_a};
+          const int step_b[2] = {(corner_b[0] - corner_0[0]) / length_b,
+                                 (corner_b[1] - corner_0[1]) / length_b};
+
+          // merge the face nodes, but only those that really coincide in
+          // case the patches do not fit together, e.g., because they were
+          // not created with the same mapping. the tolerance is small
+          // compared to the distance between the nodes of the patch, but
+          // large compared to roundoff also far away from the origin
+          const double tolerance =
+            1e-3 / patch.n_subdivisions *
+            nodes[first_node].distance(
+              nodes[first_node + Utilities::fixed_power<dim>(n) - 1]);
+          for (unsigned int b = 0; b < nb; ++b)
+            for (unsigned int a = 0; a < na; ++a)
+              {
+                const unsigned int a_neighbor =
+                  corner_0[0] + step_a[0] * a + step_b[0] * b;
+                const unsigned int b_neighbor =
+                  corner_0[1] + step_a[1] * a + step_b[1] * b;
+                const unsigned int node = first_node + face_node(face, n, a, b);
+                const unsigned int neighbor_node =
+                  first_neighbor_node +
+                  face_node(neighbor_face, n, a_neighbor, b_neighbor);
+                if (nodes[node].distance(nodes[neighbor_node]) > tolerance)
+                  continue;
+
+                const unsigned int first          = find_first(node);
+                const unsigned int first_neighbor = find_first(neighbor_node);
+                if (first < first_neighbor)
+                  first_of_group[first_neighbor] = first;
+                else
+                  first_of_group[first] = first_neighbor;
+              }
+        }
+
+    unique_nodes.clear();
+    node_map.resize(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+      if (find_first(i) == i)
+        {
+          node_map[i] = unique_nodes.size();
+          unique_nodes.push_back(i);
+        }
+      else
+        node_map[i] = node_map[find_first(i)];
+  }
+
+
   template <int dim, int spacedim, class StreamType>
   void
   write_data(const std::vector<Patch<dim, spacedim>> &patches,
@@ -5677,6 +5953,19 @@ namespace DataOutBase
         n_points_per_cell = n_nodes / n_cells;
       }
 
+    // if duplicate vertices are filtered, only the first node of each group
+    // of coinciding nodes is written, and the cells refer to these nodes
+    std::vector<Point<spacedim>> nodes;
+    std::vector<unsigned int>    unique_nodes;
+    if (flags.filter_duplicate_vertices)
+      {
+        std::vector<unsigned int> node_map;
+        compute_unique_nodes(patches, nodes, unique_nodes, node_map);
+        vtu_out.set_vertex_map(node_map);
+      }
+    const unsigned int n_written_nodes =
+      flags.filter_duplicate_vertices ? unique_nodes.size() : n_nodes;
+
     // in gmv format the vertex coordinates and the data have an order that is a
     // bit unpleasant (first all x coordinates, then all y coordinate, ...;
     // first all data of variable 1, then variable 2, etc), so we have to copy
@@ -5702,12 +5991,19 @@ namespace DataOutBase
     //
     // note that according to the standard, we have to print d=1..3 dimensions,
     // even if we are in reality in 2d, for example
-    out << "<Piece NumberOfPoints=\"" << n_nodes << "\" NumberOfCells=\""
-        << n_cells << "\" >\n";
+    out << "<Piece NumberOfPoints=\"" << n_written_nodes
+        << "\" NumberOfCells=\"" << n_cells << "\" >\n";
     out << "  <Points>\n";
     out << "    <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\""
         << ascii_or_binary << "\">\n";
-    write_nodes(patches, vtu_out);
+    if (flags.filter_duplicate_vertices)
+      {
+        for (unsigned int i = 0; i < unique_nodes.size(); ++i)
+          vtu_out.write_point(i, nodes[unique_nodes[i]]);
+        vtu_out.flush_points();
+      }
+    else
+      write_nodes(patches, vtu_out);
     out << "    </DataArray>\n";
     out << "  </Points>\n\n";
     /////////////////////////////////
@@ -5825,10 +6121,12 @@ namespace DataOutBase
 
         // now write data. pad all vectors to have three components
         std::vector<float> data;
-        data.reserve(n_nodes * n_components);
+        data.reserve(n_written_nodes * n_components);
 
-        for (unsigned int n = 0; n < n_nodes; ++n)
+        for (unsigned int i = 0; i < n_written_nodes; ++i)
           {
+            const unsigned int n =
+              flags.filter_duplicate_vertices ? unique_nodes[i] : i;
             if (!is_tensor)
               {
                 switch (last_component - first_component)
@@ -5905,8 +6203,13 @@ namespace DataOutBase
               << data_names[data_set] << "\" format=\"" << ascii_or_binary
               << "\">\n";
 
-          std::vector<float> data(data_vectors[data_set].begin(),
-                                  data_vectors[data_set].end());
+          std::vector<float> data;
+          if (flags.filter_duplicate_vertices)
+            for (const unsigned int n : unique_nodes)
+              data.push_back(data_vectors(data_set, n));
+          else
+            data.assign(data_vectors[data_set].begin(),
+                        data_vectors[data_set].end());
           vtu_out << data;
           out << "    </DataArray>\n";
         }
@@ -0,0 +1,563 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/data_out_hdf5_time_series.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#ifdef DEAL_II_WITH_HDF5
+#  include <hdf5.h>
+#endif
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+#ifdef DEAL_II_WITH_HDF5
+  /**
+   * Create a dataset of doubles or unsigned integers with the given
+   * dimensions. If @p chunk_dims is not a nullptr, the dataset is chunked
+   * with the given chunk dimensions and all its dimensions can be extended.
+   */
+  hid_t
+  create_dataset(const hid_t        location,
+                 const std::string &name,
+                 const hid_t        type,
+                 const int          rank,
+                 const hsize_t *    dims,
+                 const hsize_t *    chunk_dims)
+  {
+    herr_t status;
+
+    std::vector<hsize_t> max_dims(dims, dims + rank);
+    if (chunk_dims != nullptr)
+      std::fill(max_dims.begin(), max_dims.end(), H5S_UNLIMITED);
+    const hid_t dataspace = H5Screate_simple(rank, dims, max_dims.data());
+    AssertThrow(dataspace >= 0, ExcIO());
+
+    const hid_t create_plist = H5Pcreate(H5P_DATASET_CREATE);
+    AssertThrow(create_plist >= 0, ExcIO());
+    if (chunk_dims != nullptr)
+      {
+        status = H5Pset_chunk(create_plist, rank, chunk_dims);
+        AssertThrow(status >= 0, ExcIO());
+      }
+
+#  if H5Gcreate_vers == 1
+    const hid_t dataset =
+      H5Dcreate(location, name.c_str(), type, dataspace, create_plist);
+#  else
+    const hid_t dataset = H5Dcreate(location,
+                                    name.c_str(),
+                                    type,
+                                    dataspace,
+                                    H5P_DEFAULT,
+                                    create_plist,
+                                    H5P_DEFAULT);
+#  endif
+    AssertThrow(dataset >= 0, ExcIO());
+
+    status = H5Pclose(create_plist);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Sclose(dataspace);
+    AssertThrow(status >= 0, ExcIO());
+
+    return dataset;
+  }
+
+
+
+  /**
+   * Write @p data to the hyperslab of @p dataset given by @p offset and
+   * @p count, using the transfer property list @p transfer_plist.
+   */
+  void
+  write_hyperslab(const hid_t    dataset,
+                  const hid_t    type,
+                  const int      rank,
+                  const hsize_t *offset,
+                  const hsize_t *count,
+                  const hid_t    transfer_plist,
+                  const void *   data)
+  {
+    herr_t status;
+
+    const hid_t memory_dataspace = H5Screate_simple(rank, count, nullptr);
+    AssertThrow(memory_dataspace >= 0, ExcIO());
+
+    const hid_t file_dataspace = H5Dget_space(dataset);
+    AssertThrow(file_dataspace >= 0, ExcIO());
+    status = H5Sselect_hyperslab(
+      file_dataspace, H5S_SELECT_SET, offset, nullptr, count, nullptr);
+    AssertThrow(status >= 0, ExcIO());
+
+    status = H5Dwrite(
+      dataset, type, memory_dataspace, file_dataspace, transfer_plist, data);
+    AssertThrow(status >= 0, ExcIO());
+
+    status = H5Sclose(file_dataspace);
+    AssertThrow(status >= 0, ExcIO());
+    status = H5Sclose(memory_dataspace);
+    AssertThrow(status >= 0, ExcIO());
+  }
+#endif
+
+
+
+  /**
+   * Return the name of the group of the mesh with the given number.
+   */
+  std::string
+  mesh_group_name(const unsigned int mesh_number)
+  {
+    return "mesh_" + Utilities::int_to_string(mesh_number);
+  }
+
+
+
+  /**
+   * Return an indentation of the given level for the XDMF file.
+   */
+  std::string
+  xdmf_indent(const unsigned int indent_level)
+  {
+    return std::string(2 * indent_level, ' ');
+  }
+} // namespace
+
+
+
+template <int dim, int spacedim>
+DataOutHDF5TimeSeries<dim, spacedim>::DataOutHDF5TimeSeries(
+  const std::string &                    filename_base,
+  const MPI_Comm &                       comm,
+  const DataOutBase::DataOutFilterFlags &flags)
+  : filename_base(filename_base)
+  , communicator(comm)
+  , flags(flags)
+  , n_steps(0)
+  , n_mesh_versions(0)
+  , n_steps_on_mesh(0)
+  , global_node_cell_count{0, 0}
+  , xdmf_footer_position(0)
+{}
+
+
+
+template <int dim, int spacedim>
+void
+DataOutHDF5TimeSeries<dim, spacedim>::write(
+  const DataOutInterface<dim, spacedim> &data_out,
+  const double                           time,
+  const bool                             mesh_changed)
+{
+#ifndef DEAL_II_WITH_HDF5
+  (void)data_out;
+  (void)time;
+  (void)mesh_changed;
+  AssertThrow(false, ExcMessage("HDF5 support is disabled."));
+#else
+  // If HDF5 is not parallel and we're using multiple processes, abort
+#  ifndef H5_HAVE_PARALLEL
+  AssertThrow(
+    Utilities::MPI::n_mpi_processes(communicator) <= 1,
+    ExcMessage(
+      "Serial HDF5 output on multiple processes is not yet supported."));
+#  endif
+
+  DataOutBase::DataOutFilter data_filter(flags);
+  data_out.write_filtered_data(data_filter);
+
+  // Compute the global total number of nodes/cells and determine the offset
+  // of the data for this process
+  unsigned int local_node_cell_count[2], new_global_node_cell_count[2],
+    global_node_cell_offsets[2];
+  local_node_cell_count[0] = data_filter.n_nodes();
+  local_node_cell_count[1] = data_filter.n_cells();
+#  ifdef DEAL_II_WITH_MPI
+  int ierr = MPI_Allreduce(local_node_cell_count,
+                           new_global_node_cell_count,
+                           2,
+                           MPI_UNSIGNED,
+                           MPI_SUM,
+                           communicator);
+  AssertThrowMPI(ierr);
+  ierr = MPI_Scan(local_node_cell_count,
+                  global_node_cell_offsets,
+                  2,
+                  MPI_UNSIGNED,
+                  MPI_SUM,
+                  communicator);
+  AssertThrowMPI(ierr);
+  global_node_cell_offsets[0] -= local_node_cell_count[0];
+  global_node_cell_offsets[1] -= local_node_cell_count[1];
+#  else
+  new_global_node_cell_count[0] = local_node_cell_count[0];
+  new_global_node_cell_count[1] = local_node_cell_count[1];
+  global_node_cell_offsets[0] = global_node_cell_offsets[1] = 0;
+#  endif
+
+  const bool any_mesh_changed =
+    Utilities::MPI::max(static_cast<unsigned int>(mesh_changed),
+                        communicator) != 0;
+  const bool write_mesh =
+    n_mesh_versions == 0 || any_mesh_changed ||
+    new_global_node_cell_count[0] != global_node_cell_count[0] ||
+    new_global_node_cell_count[1] != global_node_cell_count[1];
+
+  herr_t status;
+
+  // Create file access properties
+  const hid_t file_plist_id = H5Pcreate(H5P_FILE_ACCESS);
+  AssertThrow(file_plist_id != -1, ExcIO());
+  // If MPI is enabled *and* HDF5 is parallel, we can do parallel output
+#  ifdef DEAL_II_WITH_MPI
+#    ifdef H5_HAVE_PARALLEL
+  status = H5Pset_fapl_mpio(file_plist_id, communicator, MPI_INFO_NULL);
+  AssertThrow(status >= 0, ExcIO());
+#    endif
+#  endif
+
+  // Create the property list for a collective write
+  const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+  AssertThrow(plist_id >= 0, ExcIO());
+#  ifdef DEAL_II_WITH_MPI
+#    ifdef H5_HAVE_PARALLEL
+  status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+  AssertThrow(status >= 0, ExcIO());
+#    endif
+#  endif
+
+  // The first time step overwrites any existing file, all others append to
+  // it
+  const std::string h5_filename = get_hdf5_filename();
+  const hid_t       h5_file_id =
+    (n_steps == 0 ?
+       H5Fcreate(
+         h5_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, file_plist_id) :
+       H5Fopen(h5_filename.c_str(), H5F_ACC_RDWR, file_plist_id));
+  AssertThrow(h5_file_id >= 0, ExcIO());
+
+  hid_t mesh_group_id;
+  if (write_mesh)
+    {
+      global_node_cell_count[0] = new_global_node_cell_count[0];
+      global_node_cell_count[1] = new_global_node_cell_count[1];
+      n_steps_on_mesh           = 0;
+      ++n_mesh_versions;
+
+#  if H5Gcreate_vers == 1
+      mesh_group_id =
+        H5Gcreate(h5_file_id, mesh_group_name(n_mesh_versions - 1).c_str(), 0);
+#  else
+      mesh_group_id = H5Gcreate(h5_file_id,
+                                mesh_group_name(n_mesh_versions - 1).c_str(),
+                                H5P_DEFAULT,
+                                H5P_DEFAULT,
+                                H5P_DEFAULT);
+#  endif
+      AssertThrow(mesh_group_id >= 0, ExcIO());
+
+      // HDF5/XDMF only supports 2- or 3-dimensional coordinates, so pad the
+      // coordinates of 1d meshes with zeros
+      const unsigned int  node_dim = (spacedim < 2) ? 2 : spacedim;
+      std::vector<double> node_data_vec;
+      data_filter.fill_node_data(node_data_vec);
+      if (node_dim != spacedim)
+        {
+          std::vector<double> padded_data(node_dim * local_node_cell_count[0]);
+          for (unsigned int i = 0; i < local_node_cell_count[0]; ++i)
+            for (unsigned int d = 0; d < spacedim; ++d)
+              padded_data[i * node_dim + d] = node_data_vec[i * spacedim + d];
+          node_data_vec.swap(padded_data);
+        }
+
+      hsize_t dims[2], offset[2], count[2];
+      dims[0]   = global_node_cell_count[0];
+      dims[1]   = node_dim;
+      offset[0] = global_node_cell_offsets[0];
+      offset[1] = 0;
+      count[0]  = local_node_cell_count[0];
+      count[1]  = node_dim;
+      const hid_t node_dataset = create_dataset(
+        mesh_group_id, "nodes", H5T_NATIVE_DOUBLE, 2, dims, nullptr);
+      write_hyperslab(node_dataset,
+                      H5T_NATIVE_DOUBLE,
+                      2,
+                      offset,
+                      count,
+                      plist_id,
+                      node_data_vec.data());
+      status = H5Dclose(node_dataset);
+      AssertThrow(status >= 0, ExcIO());
+
+      std::vector<unsigned int> cell_data_vec;
+      data_filter.fill_cell_data(global_node_cell_offsets[0], cell_data_vec);
+      dims[0]   = global_node_cell_count[1];
+      dims[1]   = GeometryInfo<dim>::vertices_per_cell;
+      offset[0] = global_node_cell_offsets[1];
+      count[0]  = local_node_cell_count[1];
+      count[1]  = GeometryInfo<dim>::vertices_per_cell;
+      const hid_t cell_dataset = create_dataset(
+        mesh_group_id, "cells", H5T_NATIVE_UINT, 2, dims, nullptr);
+      write_hyperslab(cell_dataset,
+                      H5T_NATIVE_UINT,
+                      2,
+                      offset,
+                      count,
+                      plist_id,
+                      cell_data_vec.data());
+      status = H5Dclose(cell_dataset);
+      AssertThrow(status >= 0, ExcIO());
+    }
+  else
+    {
+#  if H5Gopen_vers == 1
+      mesh_group_id =
+        H5Gopen(h5_file_id, mesh_group_name(n_mesh_versions - 1).c_str());
+#  else
+      mesh_group_id = H5Gopen(h5_file_id,
+                              mesh_group_name(n_mesh_versions - 1).c_str(),
+                              H5P_DEFAULT);
+#  endif
+      AssertThrow(mesh_group_id >= 0, ExcIO());
+    }
+
+  // Append the fields as a new row of their datasets. Fields that appear for
+  // the first time on this mesh get a new dataset, whose chunks hold the
+  // values of at most 2^20 numbers of one time step
+  for (unsigned int i = 0; i < data_filter.n_data_sets(); ++i)
+    {
+      const std::string  name   = data_filter.get_data_set_name(i);
+      const unsigned int n_comp = data_filter.get_data_set_dim(i);
+
+      hid_t dataset;
+      if (write_mesh ||
+          H5Lexists(mesh_group_id, name.c_str(), H5P_DEFAULT) <= 0)
+        {
+          const hsize_t dims[3]       = {0, global_node_cell_count[0], n_comp};
+          const hsize_t chunk_dims[3] = {
+            1,
+            std::max<hsize_t>(1,
+                              std::min<hsize_t>(global_node_cell_count[0],
+                                                (1U << 20) / n_comp)),
+            n_comp};
+          dataset = create_dataset(
+            mesh_group_id, name, H5T_NATIVE_DOUBLE, 3, dims, chunk_dims);
+        }
+      else
+        {
+#  if H5Dopen_vers == 1
+          dataset = H5Dopen(mesh_group_id, name.c_str());
+#  else
+          dataset = H5Dopen(mesh_group_id, name.c_str(), H5P_DEFAULT);
+#  endif
+          AssertThrow(dataset >= 0, ExcIO());
+        }
+
+      const hsize_t new_dims[3] = {n_steps_on_mesh + 1,
+                                   global_node_cell_count[0],
+                                   n_comp};
+      status = H5Dset_extent(dataset, new_dims);
+      AssertThrow(status >= 0, ExcIO());
+
+      const hsize_t offset[3] = {n_steps_on_mesh,
+                                 global_node_cell_offsets[0],
+                                 0};
+      const hsize_t count[3]  = {1, local_node_cell_count[0], n_comp};
+      write_hyperslab(dataset,
+                      H5T_NATIVE_DOUBLE,
+                      3,
+                      offset,
+                      count,
+                      plist_id,
+                      data_filter.get_data_set(i));
+
+      status = H5Dclose(dataset);
+      AssertThrow(status >= 0, ExcIO());
+    }
+
+  status = H5Gclose(mesh_group_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pclose(file_plist_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pclose(plist_id);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Fclose(h5_file_id);
+  AssertThrow(status >= 0, ExcIO());
+
+  if (Utilities::MPI::this_mpi_process(communicator) == 0)
+    write_xdmf_entry(data_filter, time);
+
+  ++n_steps_on_mesh;
+  ++n_steps;
+#endif
+}
+
+
+
+template <int dim, int spacedim>
+void
+DataOutHDF5TimeSeries<dim, spacedim>::write_xdmf_entry(
+  const DataOutBase::DataOutFilter &data_filter,
+  const double                      time)
+{
+  // the XDMF file refers to the HDF5 file relative to its own location
+  const std::string h5_filename =
+    get_hdf5_filename().substr(get_hdf5_filename().find_last_of('/') + 1);
+  const std::string  group    = mesh_group_name(n_mesh_versions - 1);
+  const unsigned int n_nodes  = global_node_cell_count[0];
+  const unsigned int n_cells  = global_node_cell_count[1];
+  const unsigned int node_dim = (spacedim < 2) ? 2 : spacedim;
+
+  // the entry describes the mesh and the datasets with their dimensions at
+  // this time step, so it never has to be updated later
+  std::stringstream ss;
+  ss << xdmf_indent(3) << "<Grid Name=\"mesh\" GridType=\"Uniform\">\n";
+  ss << xdmf_indent(4) << "<Time Value=\"" << time << "\"/>\n";
+  ss << xdmf_indent(4) << "<Geometry GeometryType=\""
+     << (node_dim == 2 ? "XY" : "XYZ") << "\">\n";
+  ss << xdmf_indent(5) << "<DataItem Dimensions=\"" << n_nodes << " "
+     << node_dim << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
+  ss << xdmf_indent(6) << h5_filename << ":/" << group << "/nodes\n";
+  ss << xdmf_indent(5) << "</DataItem>\n";
+  ss << xdmf_indent(4) << "</Geometry>\n";
+
+  static const char *topology_types[4] = {"Polyvertex",
+                                          "Polyline",
+                                          "Quadrilateral",
+                                          "Hexahedron"};
+  ss << xdmf_indent(4) << "<Topology TopologyType=\"" << topology_types[dim]
+     << "\" NumberOfElements=\"" << n_cells << "\"";
+  if (dim < 2)
+    ss << " NodesPerElement=\"" << GeometryInfo<dim>::vertices_per_cell
+       << "\"";
+  ss << ">\n";
+  ss << xdmf_indent(5) << "<DataItem Dimensions=\"" << n_cells << " "
+     << GeometryInfo<dim>::vertices_per_cell
+     << "\" NumberType=\"UInt\" Format=\"HDF\">\n";
+  ss << xdmf_indent(6) << h5_filename << ":/" << group << "/cells\n";
+  ss << xdmf_indent(5) << "</DataItem>\n";
+  ss << xdmf_indent(4) << "</Topology>\n";
+
+  // each field selects the row of the current time step of its dataset
+  for (unsigned int i = 0; i < data_filter.n_data_sets(); ++i)
+    {
+      const std::string  name   = data_filter.get_data_set_name(i);
+      const unsigned int n_comp = data_filter.get_data_set_dim(i);
+      ss << xdmf_indent(4) << "<Attribute Name=\"" << name
+         << "\" AttributeType=\"" << (n_comp > 1 ? "Vector" : "Scalar")
+         << "\" Center=\"Node\">\n";
+      ss << xdmf_indent(5) << "<DataItem ItemType=\"HyperSlab\" Dimensions=\""
+         << n_nodes << " " << n_comp << "\" Type=\"HyperSlab\">\n";
+      ss << xdmf_indent(6) << "<DataItem Dimensions=\"3 3\" "
+         << "NumberType=\"UInt\" Format=\"XML\">\n";
+      ss << xdmf_indent(7) << n_steps_on_mesh << " 0 0\n";
+      ss << xdmf_indent(7) << "1 1 1\n";
+      ss << xdmf_indent(7) << "1 " << n_nodes << " " << n_comp << "\n";
+      ss << xdmf_indent(6) << "</DataItem>\n";
+      ss << xdmf_indent(6) << "<DataItem Dimensions=\"" << n_steps_on_mesh + 1
+         << " " << n_nodes << " " << n_comp
+         << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
+      ss << xdmf_indent(7) << h5_filename << ":/" << group << "/" << name
+         << "\n";
+      ss << xdmf_indent(6) << "</DataItem>\n";
+      ss << xdmf_indent(5) << "</DataItem>\n";
+      ss << xdmf_indent(4) << "</Attribute>\n";
+    }
+  ss << xdmf_indent(3) << "</Grid>\n";
+
+  const std::string footer = "    </Grid>\n  </Domain>\n</Xdmf>\n";
+
+  // The first time step writes a new file. All later ones overwrite the
+  // closing tags, which are always shorter than the new entry
+  if (n_steps == 0)
+    {
+      std::ofstream xdmf_file(get_xdmf_filename());
+      AssertThrow(xdmf_file, ExcFileNotOpen(get_xdmf_filename()));
+      xdmf_file << "<?xml version=\"1.0\" ?>\n";
+      xdmf_file << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n";
+      xdmf_file << "<Xdmf Version=\"2.0\">\n";
+      xdmf_file << "  <Domain>\n";
+      xdmf_file
+        << "    <Grid Name=\"CellTime\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+      xdmf_file << ss.str();
+      xdmf_footer_position = xdmf_file.tellp();
+      xdmf_file << footer;
+      xdmf_file.close();
+      AssertThrow(xdmf_file, ExcIO());
+    }
+  else
+    {
+      std::fstream xdmf_file(get_xdmf_filename(),
+                             std::ios::in | std::ios::out);
+      AssertThrow(xdmf_file, ExcFileNotOpen(get_xdmf_filename()));
+      xdmf_file.seekp(xdmf_footer_position);
+      xdmf_file << ss.str();
+      xdmf_footer_position = xdmf_file.tellp();
+      xdmf_file << footer;
+      xdmf_file.close();
+      AssertThrow(xdmf_file, ExcIO());
+    }
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+DataOutHDF5TimeSeries<dim, spacedim>::n_time_steps() const
+{
+  return n_steps;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+DataOutHDF5TimeSeries<dim, spacedim>::n_meshes() const
+{
+  return n_mesh_versions;
+}
+
+
+
+template <int dim, int spacedim>
+std::string
+DataOutHDF5TimeSeries<dim, spacedim>::get_hdf5_filename() const
+{
+  return filename_base + ".h5";
+}
+
+
+
+template <int dim, int spacedim>
+std::string
+DataOutHDF5TimeSeries<dim, spacedim>::get_xdmf_filename() const
+{
+  return filename_base + ".xdmf";
+}
+
+
+// explicit instantiations
+#include "data_out_hdf5_time_series.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,331 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/mpi_remote_point_evaluation.h>
+
+#include <deal.II/distributed/tria_base.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+
+#include <algorithm>
+#include <map>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    template <int dim, int spacedim>
+    RemotePointEvaluation<dim, spacedim>::RemotePointEvaluation(
+      const double tolerance)
+      : tolerance(tolerance)
+      , communicator(MPI_COMM_SELF)
+      , n_requested_points(0)
+      , send_ptrs(1, 0)
+      , recv_ptrs(1, 0)
+    {}
+
+
+
+    template <int dim, int spacedim>
+    void
+    RemotePointEvaluation<dim, spacedim>::reinit(
+      const std::vector<Point<spacedim>> &points,
+      const Triangulation<dim, spacedim> &triangulation,
+      const Mapping<dim, spacedim> &      mapping)
+    {
+      this->triangulation = &triangulation;
+      this->mapping       = &mapping;
+      n_requested_points  = points.size();
+
+      communicator = MPI_COMM_SELF;
+      if (const auto tria_parallel =
+            dynamic_cast<const parallel::Triangulation<dim, spacedim> *>(
+              &triangulation))
+        communicator = tria_parallel->get_communicator();
+      const unsigned int my_rank = this_mpi_process(communicator);
+
+      // describe the locally owned domain by one bounding box for each cell
+      // on the first level of refinement, or on the coarse level if the
+      // mesh is not refined, that contains locally owned cells. a single
+      // box around all locally owned cells would in general also cover
+      // large parts of the domains of other processes, which would then be
+      // sent points they do not own
+      const unsigned int box_level =
+        std::min(1U, triangulation.n_levels() - 1);
+      std::map<std::pair<int, int>, BoundingBox<spacedim>> boxes;
+      for (const auto &cell : triangulation.active_cell_iterators())
+        if (cell->is_locally_owned())
+          {
+            typename Triangulation<dim, spacedim>::cell_iterator ancestor =
+              cell;
+            while (ancestor->level() > static_cast<int>(box_level))
+              ancestor = ancestor->parent();
+            const auto key =
+              std::make_pair(ancestor->level(), ancestor->index());
+            const auto box = boxes.find(key);
+            if (box == boxes.end())
+              boxes.emplace(key, cell->bounding_box());
+            else
+              box->second.merge_with(cell->bounding_box());
+          }
+      std::vector<BoundingBox<spacedim>> local_description;
+      for (const auto &box : boxes)
+        local_description.push_back(box.second);
+      const RTree<std::pair<BoundingBox<spacedim>, unsigned int>>
+        global_description =
+          GridTools::build_global_description_tree(local_description,
+                                                   communicator);
+
+      // send each point to all processes whose domain may contain it
+      std::map<unsigned int, std::vector<Point<spacedim>>> points_to_send;
+      std::map<unsigned int, std::vector<unsigned int>>    sent_indices;
+      std::vector<std::pair<BoundingBox<spacedim>, unsigned int>> owners;
+      std::vector<unsigned int> owner_ranks;
+      for (unsigned int i = 0; i < points.size(); ++i)
+        {
+          owners.clear();
+          global_description.query(
+            boost::geometry::index::intersects(points[i]),
+            std::back_inserter(owners));
+
+          // a point may lie in several boxes of the same process
+          owner_ranks.clear();
+          for (const auto &owner : owners)
+            owner_ranks.push_back(owner.second);
+          std::sort(owner_ranks.begin(), owner_ranks.end());
+          owner_ranks.erase(std::unique(owner_ranks.begin(), owner_ranks.end()),
+                            owner_ranks.end());
+          for (const unsigned int rank : owner_ranks)
+            {
+              points_to_send[rank].push_back(points[i]);
+              sent_indices[rank].push_back(i);
+            }
+        }
+
+      // the points of the current process are not sent through MPI
+      std::vector<Point<spacedim>> own_points;
+      if (points_to_send.find(my_rank) != points_to_send.end())
+        {
+          own_points.swap(points_to_send[my_rank]);
+          points_to_send.erase(my_rank);
+        }
+      std::map<unsigned int, std::vector<Point<spacedim>>> received_points =
+        some_to_some(communicator, points_to_send);
+      if (own_points.size() > 0)
+        received_points[my_rank].swap(own_points);
+
+      // locate all received points in the locally owned cells
+      std::vector<unsigned int>    requester_ranks;
+      std::vector<unsigned int>    requester_ptrs(1, 0);
+      std::vector<Point<spacedim>> all_points;
+      for (const auto &received : received_points)
+        {
+          requester_ranks.push_back(received.first);
+          all_points.insert(all_points.end(),
+                            received.second.begin(),
+                            received.second.end());
+          requester_ptrs.push_back(all_points.size());
+        }
+
+      const GridTools::Cache<dim, spacedim> cache(triangulation, mapping);
+      cell_data = GridTools::compute_point_locations_batched(
+        cache,
+        all_points,
+        tolerance,
+        [](const typename Triangulation<dim, spacedim>::active_cell_iterator
+             &cell) { return cell->is_locally_owned(); });
+
+      // sort the located points by requesting process and by their position
+      // in the list of points of that process, which defines the order in
+      // which the values are sent
+      std::vector<std::pair<unsigned int, unsigned int>> located_points(
+        cell_data.point_indices.size());
+      for (unsigned int j = 0; j < cell_data.point_indices.size(); ++j)
+        located_points[j] = std::make_pair(cell_data.point_indices[j], j);
+      std::sort(located_points.begin(), located_points.end());
+
+      std::map<unsigned int, std::vector<unsigned int>> found_positions;
+      send_indices.clear();
+      for (unsigned int j = 0, r = 0; j < located_points.size(); ++j)
+        {
+          while (located_points[j].first >= requester_ptrs[r + 1])
+            ++r;
+          found_positions[requester_ranks[r]].push_back(
+            located_points[j].first - requester_ptrs[r]);
+          send_indices.push_back(located_points[j].second);
+        }
+      send_ranks.clear();
+      send_ptrs.assign(1, 0);
+      for (const auto &found : found_positions)
+        {
+          send_ranks.push_back(found.first);
+          send_ptrs.push_back(send_ptrs.back() + found.second.size());
+        }
+
+      // tell the requesting processes which of their points were found
+      std::vector<unsigned int> own_positions;
+      if (found_positions.find(my_rank) != found_positions.end())
+        {
+          own_positions.swap(found_positions[my_rank]);
+          found_positions.erase(my_rank);
+        }
+      std::map<unsigned int, std::vector<unsigned int>> replies =
+        some_to_some(communicator, found_positions);
+      if (own_positions.size() > 0)
+        replies[my_rank].swap(own_positions);
+
+      // each point takes the value from the process with the lowest rank
+      // that found it
+      std::vector<bool> point_found(points.size(), false);
+      recv_ranks.clear();
+      recv_ptrs.assign(1, 0);
+      recv_point_indices.clear();
+      for (const auto &reply : replies)
+        {
+          recv_ranks.push_back(reply.first);
+          for (const unsigned int position : reply.second)
+            {
+              const unsigned int i = sent_indices[reply.first][position];
+              if (point_found[i] == false)
+                {
+                  point_found[i] = true;
+                  recv_point_indices.push_back(i);
+                }
+              else
+                recv_point_indices.push_back(numbers::invalid_unsigned_int);
+            }
+          recv_ptrs.push_back(recv_point_indices.size());
+        }
+
+      missing_points.clear();
+      for (unsigned int i = 0; i < points.size(); ++i)
+        if (point_found[i] == false)
+          missing_points.push_back(i);
+    }
+
+
+
+    template <int dim, int spacedim>
+    const GridTools::PointLocations<dim, spacedim> &
+    RemotePointEvaluation<dim, spacedim>::get_cell_data() const
+    {
+      return cell_data;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    RemotePointEvaluation<dim, spacedim>::loop_over_cells(
+      const DoFHandler<dim, spacedim> &dof_handler,
+      const UpdateFlags                update_flags,
+      const std::function<void(const FEValues<dim, spacedim> &,
+                               const unsigned int)> &evaluate_cell) const
+    {
+      Assert(triangulation != nullptr,
+             ExcMessage("You need to call reinit() first."));
+      Assert(&dof_handler.get_triangulation() == triangulation,
+             ExcMessage("The DoFHandler must be based on the triangulation "
+                        "passed to reinit()."));
+
+      // the points differ from cell to cell, so every cell needs its own
+      // quadrature formula. only one FEValues object exists at a time
+      for (unsigned int c = 0; c < cell_data.cells.size(); ++c)
+        {
+          FEValues<dim, spacedim> fe_values(
+            *mapping,
+            dof_handler.get_fe(),
+            Quadrature<dim>(std::vector<Point<dim>>(
+              cell_data.reference_points.begin() + cell_data.cell_ptrs[c],
+              cell_data.reference_points.begin() +
+                cell_data.cell_ptrs[c + 1])),
+            update_flags);
+
+          const typename DoFHandler<dim, spacedim>::active_cell_iterator cell(
+            &dof_handler.get_triangulation(),
+            cell_data.cells[c]->level(),
+            cell_data.cells[c]->index(),
+            &dof_handler);
+          fe_values.reinit(cell);
+          evaluate_cell(fe_values, cell_data.cell_ptrs[c]);
+        }
+    }
+
+
+
+    template <int dim, int spacedim>
+    const std::vector<unsigned int> &
+    RemotePointEvaluation<dim, spacedim>::get_missing_points() const
+    {
+      return missing_points;
+    }
+
+
+
+    template <int dim, int spacedim>
+    bool
+    RemotePointEvaluation<dim, spacedim>::all_points_found() const
+    {
+      return missing_points.empty();
+    }
+
+
+
+    template <int dim, int spacedim>
+    const Triangulation<dim, spacedim> &
+    RemotePointEvaluation<dim, spacedim>::get_triangulation() const
+    {
+      Assert(triangulation != nullptr,
+             ExcMessage("You need to call reinit() first."));
+      return *triangulation;
+    }
+
+
+
+    template <int dim, int spacedim>
+    const Mapping<dim, spacedim> &
+    RemotePointEvaluation<dim, spacedim>::get_mapping() const
+    {
+      Assert(mapping != nullptr,
+             ExcMessage("You need to call reinit() first."));
+      return *mapping;
+    }
+
+
+
+    template <int dim, int spacedim>
+    const MPI_Comm &
+    RemotePointEvaluation<dim, spacedim>::get_communicator() const
+    {
+      return communicator;
+    }
+
+  } // namespace MPI
+} // namespace Utilities
+
+#include "mpi_remote_point_evaluation.inst"
+
+DEAL_II_NAMESPACE_CLOSE
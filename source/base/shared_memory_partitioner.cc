@@ -0,0 +1,201 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/shared_memory_partitioner.h>
+#include <deal.II/base/shared_memory_partitioner.templates.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+#ifdef DEAL_II_WITH_MPI
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    SharedMemoryPartitioner::SharedMemoryPartitioner(
+      const std::shared_ptr<const Partitioner> &partitioner,
+      const MPI_Comm &                          communicator_sm)
+      : partitioner(partitioner)
+      , communicator_sm(communicator_sm)
+    {
+      const MPI_Comm &communicator = partitioner->get_mpi_communicator();
+      const unsigned int n_procs   = partitioner->n_mpi_processes();
+      const unsigned int n_procs_sm = n_mpi_processes(communicator_sm);
+
+      // translate the ranks of the partitioner's communicator into ranks of
+      // the shared-memory communicator, giving MPI_UNDEFINED for processes
+      // on other nodes
+      std::vector<int> ranks(n_procs), ranks_sm(n_procs);
+      for (unsigned int p = 0; p < n_procs; ++p)
+        ranks[p] = p;
+      {
+        MPI_Group group, group_sm;
+        int       ierr = MPI_Comm_group(communicator, &group);
+        AssertThrowMPI(ierr);
+        ierr = MPI_Comm_group(communicator_sm, &group_sm);
+        AssertThrowMPI(ierr);
+        ierr = MPI_Group_translate_ranks(
+          group, n_procs, ranks.data(), group_sm, ranks_sm.data());
+        AssertThrowMPI(ierr);
+        ierr = MPI_Group_free(&group_sm);
+        AssertThrowMPI(ierr);
+        ierr = MPI_Group_free(&group);
+        AssertThrowMPI(ierr);
+      }
+      AssertThrow(ranks_sm[partitioner->this_mpi_process()] ==
+                    static_cast<int>(this_mpi_process(communicator_sm)),
+                  ExcMessage("The shared-memory communicator must be a "
+                             "subset of the communicator of the partitioner "
+                             "that contains the current process."));
+
+      // the start of the locally owned range of the processes on this node,
+      // needed to translate global ghost indices into positions in the
+      // memory of the owner
+      const types::global_dof_index my_first = partitioner->local_range().first;
+      std::vector<types::global_dof_index> first_index_sm(n_procs_sm);
+      int ierr = MPI_Allgather(&my_first,
+                               1,
+                               DEAL_II_DOF_INDEX_MPI_TYPE,
+                               first_index_sm.data(),
+                               1,
+                               DEAL_II_DOF_INDEX_MPI_TYPE,
+                               communicator_sm);
+      AssertThrowMPI(ierr);
+
+      // go through the ghost entries, which are sorted by their owner, and
+      // split them into entries read from shared memory and entries that
+      // are still communicated. for the former, remember where in the ghost
+      // array the entries of each owner start, measured from the start of
+      // the locally owned array
+      std::vector<types::global_dof_index> ghost_indices;
+      partitioner->ghost_indices().fill_index_vector(ghost_indices);
+      IndexSet off_node_ghosts(partitioner->size());
+      std::vector<unsigned int> ghost_start_sm(n_procs_sm,
+                                               numbers::invalid_unsigned_int);
+      unsigned int              offset = 0;
+      for (const auto &target : partitioner->ghost_targets())
+        {
+          const int rank_sm = ranks_sm[target.first];
+          if (rank_sm == MPI_UNDEFINED)
+            off_node_ghosts.add_indices(ghost_indices.begin() + offset,
+                                        ghost_indices.begin() + offset +
+                                          target.second);
+          else
+            {
+              ghost_start_sm[rank_sm] = partitioner->local_size() + offset;
+              for (unsigned int i = offset; i < offset + target.second; ++i)
+                {
+                  const unsigned int remote_offset =
+                    ghost_indices[i] - first_index_sm[rank_sm];
+                  if (!ghost_chunks.empty() &&
+                      ghost_chunks.back().rank ==
+                        static_cast<unsigned int>(rank_sm) &&
+                      ghost_chunks.back().local_offset +
+                          ghost_chunks.back().length ==
+                        i &&
+                      ghost_chunks.back().remote_offset +
+                          ghost_chunks.back().length ==
+                        remote_offset)
+                    ++ghost_chunks.back().length;
+                  else
+                    ghost_chunks.push_back(Chunk{
+                      i, static_cast<unsigned int>(rank_sm), remote_offset, 1});
+                }
+            }
+          offset += target.second;
+        }
+      AssertDimension(offset, partitioner->n_ghost_indices());
+      off_node_ghosts.compress();
+
+      // tell the owners where our ghost entries start. the entries each
+      // process imports from us are the ghost entries we just found, in the
+      // same order
+      std::vector<unsigned int> import_start_sm(n_procs_sm);
+      ierr = MPI_Alltoall(ghost_start_sm.data(),
+                          1,
+                          MPI_UNSIGNED,
+                          import_start_sm.data(),
+                          1,
+                          MPI_UNSIGNED,
+                          communicator_sm);
+      AssertThrowMPI(ierr);
+
+      auto import_range = partitioner->import_indices().begin();
+      for (const auto &target : partitioner->import_targets())
+        {
+          const int    rank_sm   = ranks_sm[target.first];
+          unsigned int n_entries = 0;
+          while (n_entries < target.second)
+            {
+              Assert(import_range != partitioner->import_indices().end(),
+                     ExcInternalError());
+              if (rank_sm != MPI_UNDEFINED)
+                {
+                  Assert(import_start_sm[rank_sm] !=
+                           numbers::invalid_unsigned_int,
+                         ExcInternalError());
+                  import_chunks.push_back(
+                    Chunk{import_range->first,
+                          static_cast<unsigned int>(rank_sm),
+                          import_start_sm[rank_sm] + n_entries,
+                          import_range->second - import_range->first});
+                }
+              n_entries += import_range->second - import_range->first;
+              ++import_range;
+            }
+          AssertDimension(n_entries, target.second);
+        }
+
+      // the remaining ghost entries are exchanged by messages into their
+      // position in the full ghost array
+      auto off_node =
+        std::make_shared<Partitioner>(partitioner->locally_owned_range(),
+                                      communicator);
+      off_node->set_ghost_indices(off_node_ghosts,
+                                  partitioner->ghost_indices());
+      off_node_partitioner = off_node;
+    }
+
+
+
+    unsigned int
+    SharedMemoryPartitioner::n_shared_ghost_indices() const
+    {
+      unsigned int n_indices = 0;
+      for (const Chunk &chunk : ghost_chunks)
+        n_indices += chunk.length;
+      return n_indices;
+    }
+
+
+
+    std::size_t
+    SharedMemoryPartitioner::memory_consumption() const
+    {
+      return sizeof(*this) + off_node_partitioner->memory_consumption() +
+             (ghost_chunks.capacity() + import_chunks.capacity()) *
+               sizeof(Chunk);
+    }
+
+  } // namespace MPI
+} // namespace Utilities
+
+#endif
+
+// explicit instantiations from .templates.h file
+#include "shared_memory_partitioner.inst"
+
+DEAL_II_NAMESPACE_CLOSE
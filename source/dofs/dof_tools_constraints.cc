@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/thread_management.h>
@@ -47,6 +48,7 @@
 #include <algorithm>
 #include <array>
 #include <memory>
+#include <mutex>
 #include <numeric>
 
 DEAL_II_NAMESPACE_OPEN
@@ -301,6 +303,10 @@ namespace DoFTools
       /**
        * Make sure that the mask exists that determines which dofs will be the
        * masters on refined faces where an fe1 and a fe2 meet.
+       *
+       * Like the other ensure_existence_* functions below, this function may
+       * be called concurrently on the same cache entry by several threads.
+       * The given @p mutex guards the check and the creation of the object.
        */
       template <int dim, int spacedim>
       void
@@ -308,8 +314,10 @@ namespace DoFTools
         const FiniteElement<dim, spacedim> &fe1,
         const FiniteElement<dim, spacedim> &fe2,
         const FullMatrix<double> &          face_interpolation_matrix,
-        std::unique_ptr<std::vector<bool>> &master_dof_mask)
+        std::unique_ptr<std::vector<bool>> &master_dof_mask,
+        std::mutex &                        mutex)
       {
+        std::lock_guard<std::mutex> lock(mutex);
         if (master_dof_mask == nullptr)
           {
             master_dof_mask =
@@ -333,8 +341,10 @@ namespace DoFTools
       ensure_existence_of_face_matrix(
         const FiniteElement<dim, spacedim> & fe1,
         const FiniteElement<dim, spacedim> & fe2,
-        std::unique_ptr<FullMatrix<double>> &matrix)
+        std::unique_ptr<FullMatrix<double>> &matrix,
+        std::mutex &                         mutex)
       {
+        std::lock_guard<std::mutex> lock(mutex);
         if (matrix == nullptr)
           {
             matrix =
@@ -355,8 +365,10 @@ namespace DoFTools
         const FiniteElement<dim, spacedim> & fe1,
         const FiniteElement<dim, spacedim> & fe2,
         const unsigned int                   subface,
-        std::unique_ptr<FullMatrix<double>> &matrix)
+        std::unique_ptr<FullMatrix<double>> &matrix,
+        std::mutex &                         mutex)
       {
+        std::lock_guard<std::mutex> lock(mutex);
         if (matrix == nullptr)
           {
             matrix =
@@ -378,7 +390,8 @@ namespace DoFTools
         const FullMatrix<double> &face_interpolation_matrix,
         const std::vector<bool> & master_dof_mask,
         std::unique_ptr<std::pair<FullMatrix<double>, FullMatrix<double>>>
-          &split_matrix)
+          &         split_matrix,
+        std::mutex &mutex)
       {
         AssertDimension(master_dof_mask.size(), face_interpolation_matrix.m());
         Assert(std::count(master_dof_mask.begin(),
@@ -387,6 +400,7 @@ namespace DoFTools
                  static_cast<signed int>(face_interpolation_matrix.n()),
                ExcInternalError());
 
+        std::lock_guard<std::mutex> lock(mutex);
         if (split_matrix == nullptr)
           {
             split_matrix = std_cxx14::make_unique<
@@ -429,6 +443,9 @@ namespace DoFTools
       }
 
 
+
+
+
       // a template that can determine statically whether a given DoFHandler
       // class supports different finite element elements
       template <typename>
@@ -550,10 +567,74 @@ namespace DoFTools
     } // namespace
 
 
+
+    /**
+     * Caches for the face and subface interpolation matrices between
+     * different (or the same) finite elements, as well as the objects
+     * derived from them. The entries are computed only once, namely the
+     * first time they are needed, and then just reused. A single object
+     * of this type is shared by all threads that compute hanging node
+     * constraints on different parts of the mesh; the entries are created
+     * through the ensure_existence_* functions above under the lock of
+     * the mutex of the respective pair of elements, and are not changed
+     * afterwards.
+     */
+    struct InterpolationMatrixCache
+    {
+      InterpolationMatrixCache(const unsigned int n_fes,
+                               const unsigned int max_children_per_face)
+        : face_interpolation_matrices(n_fes, n_fes)
+        , subface_interpolation_matrices(n_fes, n_fes, max_children_per_face)
+        , split_face_interpolation_matrices(n_fes, n_fes)
+        , master_dof_masks(n_fes, n_fes)
+        , n_fes(n_fes)
+        , mutexes(n_fes * n_fes)
+      {}
+
+      Table<2, std::unique_ptr<FullMatrix<double>>>
+        face_interpolation_matrices;
+
+      Table<3, std::unique_ptr<FullMatrix<double>>>
+        subface_interpolation_matrices;
+
+      // the matrices that are split into their master and slave parts, and
+      // for which the master part is inverted. these two matrices are
+      // derived from the face interpolation matrix as described in the
+      // @ref hp_paper "hp paper"
+      Table<2,
+            std::unique_ptr<
+              std::pair<FullMatrix<double>, FullMatrix<double>>>>
+        split_face_interpolation_matrices;
+
+      // for each pair of finite elements, a mask that states which of the
+      // degrees of freedom on the coarse side of a refined face will act as
+      // master dofs
+      Table<2, std::unique_ptr<std::vector<bool>>> master_dof_masks;
+
+      // the mutex that guards the entries for the pair of finite elements
+      // with indices fe1 and fe2. threads that need the matrices of
+      // different pairs of elements do not wait for each other
+      std::mutex &
+      mutex(const unsigned int fe1, const unsigned int fe2)
+      {
+        return mutexes[fe1 * n_fes + fe2];
+      }
+
+    private:
+      const unsigned int      n_fes;
+      std::vector<std::mutex> mutexes;
+    };
+
+
+
     template <typename number>
     void
-    make_hp_hanging_node_constraints(const dealii::DoFHandler<1> &,
-                                     AffineConstraints<number> &)
+    make_hp_hanging_node_constraints(
+      const dealii::DoFHandler<1> &,
+      const typename dealii::DoFHandler<1>::active_cell_iterator &,
+      const typename dealii::DoFHandler<1>::active_cell_iterator &,
+      InterpolationMatrixCache &,
+      AffineConstraints<number> &)
     {
       // nothing to do for regular dof handlers in 1d
     }
@@ -561,9 +642,12 @@ namespace DoFTools
 
     template <typename number>
     void
-    make_oldstyle_hanging_node_constraints(const dealii::DoFHandler<1> &,
-                                           AffineConstraints<number> &,
-                                           std::integral_constant<int, 1>)
+    make_oldstyle_hanging_node_constraints(
+      const dealii::DoFHandler<1> &,
+      const typename dealii::DoFHandler<1>::active_cell_iterator &,
+      const typename dealii::DoFHandler<1>::active_cell_iterator &,
+      AffineConstraints<number> &,
+      std::integral_constant<int, 1>)
     {
       // nothing to do for regular dof handlers in 1d
     }
@@ -573,6 +657,11 @@ namespace DoFTools
     void
     make_hp_hanging_node_constraints(
       const dealii::hp::DoFHandler<1> & /*dof_handler*/,
+      const typename dealii::hp::DoFHandler<1>::active_cell_iterator
+        & /*begin*/,
+      const typename dealii::hp::DoFHandler<1>::active_cell_iterator
+        & /*end*/,
+      InterpolationMatrixCache & /*cache*/,
       AffineConstraints<number> & /*constraints*/)
     {
       // we may have to compute constraints for vertices. gotta think about that
@@ -586,6 +675,10 @@ namespace DoFTools
     void
     make_oldstyle_hanging_node_constraints(
       const dealii::hp::DoFHandler<1> & /*dof_handler*/,
+      const typename dealii::hp::DoFHandler<1>::active_cell_iterator
+        & /*begin*/,
+      const typename dealii::hp::DoFHandler<1>::active_cell_iterator
+        & /*end*/,
       AffineConstraints<number> & /*constraints*/,
       std::integral_constant<int, 1>)
     {
@@ -598,8 +691,12 @@ namespace DoFTools
 
     template <typename number>
     void
-    make_hp_hanging_node_constraints(const dealii::DoFHandler<1, 2> &,
-                                     AffineConstraints<number> &)
+    make_hp_hanging_node_constraints(
+      const dealii::DoFHandler<1, 2> &,
+      const typename dealii::DoFHandler<1, 2>::active_cell_iterator &,
+      const typename dealii::DoFHandler<1, 2>::active_cell_iterator &,
+      InterpolationMatrixCache &,
+      AffineConstraints<number> &)
     {
       // nothing to do for regular dof handlers in 1d
     }
@@ -607,9 +704,12 @@ namespace DoFTools
 
     template <typename number>
     void
-    make_oldstyle_hanging_node_constraints(const dealii::DoFHandler<1, 2> &,
-                                           AffineConstraints<number> &,
-                                           std::integral_constant<int, 1>)
+    make_oldstyle_hanging_node_constraints(
+      const dealii::DoFHandler<1, 2> &,
+      const typename dealii::DoFHandler<1, 2>::active_cell_iterator &,
+      const typename dealii::DoFHandler<1, 2>::active_cell_iterator &,
+      AffineConstraints<number> &,
+      std::integral_constant<int, 1>)
     {
       // nothing to do for regular dof handlers in 1d
     }
@@ -617,8 +717,12 @@ namespace DoFTools
 
     template <typename number>
     void
-    make_hp_hanging_node_constraints(const dealii::DoFHandler<1, 3> &,
-                                     AffineConstraints<number> &)
+    make_hp_hanging_node_constraints(
+      const dealii::DoFHandler<1, 3> &,
+      const typename dealii::DoFHandler<1, 3>::active_cell_iterator &,
+      const typename dealii::DoFHandler<1, 3>::active_cell_iterator &,
+      InterpolationMatrixCache &,
+      AffineConstraints<number> &)
     {
       // nothing to do for regular dof handlers in 1d
     }
@@ -626,9 +730,12 @@ namespace DoFTools
 
     template <typename number>
     void
-    make_oldstyle_hanging_node_constraints(const dealii::DoFHandler<1, 3> &,
-                                           AffineConstraints<number> &,
-                                           std::integral_constant<int, 1>)
+    make_oldstyle_hanging_node_constraints(
+      const dealii::DoFHandler<1, 3> &,
+      const typename dealii::DoFHandler<1, 3>::active_cell_iterator &,
+      const typename dealii::DoFHandler<1, 3>::active_cell_iterator &,
+      AffineConstraints<number> &,
+      std::integral_constant<int, 1>)
     {
       // nothing to do for regular dof handlers in 1d
     }
@@ -638,8 +745,10 @@ namespace DoFTools
     template <typename DoFHandlerType, typename number>
     void
     make_oldstyle_hanging_node_constraints(
-      const DoFHandlerType &     dof_handler,
-      AffineConstraints<number> &constraints,
+      const DoFHandlerType &,
+      const typename DoFHandlerType::active_cell_iterator &begin,
+      const typename DoFHandlerType::active_cell_iterator &end,
+      AffineConstraints<number> &                          constraints,
       std::integral_constant<int, 2>)
     {
       const unsigned int dim = 2;
@@ -657,10 +766,9 @@ namespace DoFTools
       // note that even though we may visit a face twice if the neighboring
       // cells are equally refined, we can only visit each face with hanging
       // nodes once
-      typename DoFHandlerType::active_cell_iterator cell = dof_handler
-                                                             .begin_active(),
-                                                    endc = dof_handler.end();
-      for (; cell != endc; ++cell)
+      for (typename DoFHandlerType::active_cell_iterator cell = begin;
+           cell != end;
+           ++cell)
         {
           // artificial cells can at best neighbor ghost cells, but we're not
           // interested in these interfaces
@@ -789,10 +897,13 @@ namespace DoFTools
     template <typename DoFHandlerType, typename number>
     void
     make_oldstyle_hanging_node_constraints(
-      const DoFHandlerType &     dof_handler,
-      AffineConstraints<number> &constraints,
+      const DoFHandlerType &                               dof_handler,
+      const typename DoFHandlerType::active_cell_iterator &begin,
+      const typename DoFHandlerType::active_cell_iterator &end,
+      AffineConstraints<number> &                          constraints,
       std::integral_constant<int, 3>)
     {
+      (void)dof_handler;
       const unsigned int dim = 3;
 
       std::vector<types::global_dof_index> dofs_on_mother;
@@ -806,10 +917,9 @@ namespace DoFTools
       // note that even though we may visit a face twice if the neighboring
       // cells are equally refined, we can only visit each face with hanging
       // nodes once
-      typename DoFHandlerType::active_cell_iterator cell = dof_handler
-                                                             .begin_active(),
-                                                    endc = dof_handler.end();
-      for (; cell != endc; ++cell)
+      for (typename DoFHandlerType::active_cell_iterator cell = begin;
+           cell != end;
+           ++cell)
         {
           // artificial cells can at best neighbor ghost cells, but we're not
           // interested in these interfaces
@@ -1026,8 +1136,12 @@ namespace DoFTools
 
     template <typename DoFHandlerType, typename number>
     void
-    make_hp_hanging_node_constraints(const DoFHandlerType &     dof_handler,
-                                     AffineConstraints<number> &constraints)
+    make_hp_hanging_node_constraints(
+      const DoFHandlerType &                               dof_handler,
+      const typename DoFHandlerType::active_cell_iterator &begin,
+      const typename DoFHandlerType::active_cell_iterator &end,
+      InterpolationMatrixCache &                           cache,
+      AffineConstraints<number> &                          constraints)
     {
       // note: this function is going to be hard to understand if you haven't
       // read the hp paper. however, we try to follow the notation laid out
@@ -1049,38 +1163,23 @@ namespace DoFTools
       std::vector<types::global_dof_index> slave_dofs;
       std::vector<types::global_dof_index> scratch_dofs;
 
-      // caches for the face and subface interpolation matrices between
-      // different (or the same) finite elements. we compute them only once,
-      // namely the first time they are needed, and then just reuse them
-      Table<2, std::unique_ptr<FullMatrix<double>>> face_interpolation_matrices(
-        n_finite_elements(dof_handler), n_finite_elements(dof_handler));
-      Table<3, std::unique_ptr<FullMatrix<double>>>
-        subface_interpolation_matrices(
-          n_finite_elements(dof_handler),
-          n_finite_elements(dof_handler),
-          GeometryInfo<dim>::max_children_per_face);
-
-      // similarly have a cache for the matrices that are split into their
-      // master and slave parts, and for which the master part is inverted.
-      // these two matrices are derived from the face interpolation matrix
-      // as described in the @ref hp_paper "hp paper"
-      Table<2,
-            std::unique_ptr<std::pair<FullMatrix<double>, FullMatrix<double>>>>
-        split_face_interpolation_matrices(n_finite_elements(dof_handler),
-                                          n_finite_elements(dof_handler));
-
-      // finally, for each pair of finite elements, have a mask that states
-      // which of the degrees of freedom on the coarse side of a refined face
-      // will act as master dofs.
-      Table<2, std::unique_ptr<std::vector<bool>>> master_dof_masks(
-        n_finite_elements(dof_handler), n_finite_elements(dof_handler));
+      // the caches for the face and subface interpolation matrices, shared
+      // with the other threads working on other parts of the mesh
+      auto &face_interpolation_matrices = cache.face_interpolation_matrices;
+      auto &subface_interpolation_matrices =
+        cache.subface_interpolation_matrices;
+      auto &split_face_interpolation_matrices =
+        cache.split_face_interpolation_matrices;
+      auto &master_dof_masks = cache.master_dof_masks;
 
       // loop over all faces
       //
       // note that even though we may visit a face twice if the neighboring
       // cells are equally refined, we can only visit each face with hanging
       // nodes once
-      for (const auto &cell : dof_handler.active_cell_iterators())
+      for (typename DoFHandlerType::active_cell_iterator cell = begin;
+           cell != end;
+           ++cell)
         {
           // artificial cells can at best neighbor ghost cells, but we're not
           // interested in these interfaces
@@ -1247,7 +1346,9 @@ namespace DoFTools
                               subface->get_fe(subface_fe_index),
                               c,
                               subface_interpolation_matrices
-                                [cell->active_fe_index()][subface_fe_index][c]);
+                                [cell->active_fe_index()][subface_fe_index][c],
+                              cache.mutex(cell->active_fe_index(),
+                                          subface_fe_index));
 
                             // Add constraints to global AffineConstraints
                             // object.
@@ -1320,7 +1421,9 @@ namespace DoFTools
                           dominating_fe,
                           cell->get_fe(),
                           face_interpolation_matrices[dominating_fe_index]
-                                                     [cell->active_fe_index()]);
+                                                     [cell->active_fe_index()],
+                          cache.mutex(dominating_fe_index,
+                                      cell->active_fe_index()));
 
                         // split this matrix into master and slave components.
                         // invert the master component
@@ -1330,7 +1433,9 @@ namespace DoFTools
                           (*face_interpolation_matrices
                              [dominating_fe_index][cell->active_fe_index()]),
                           master_dof_masks[dominating_fe_index]
-                                          [cell->active_fe_index()]);
+                                          [cell->active_fe_index()],
+                          cache.mutex(dominating_fe_index,
+                                      cell->active_fe_index()));
 
                         ensure_existence_of_split_face_matrix(
                           *face_interpolation_matrices[dominating_fe_index]
@@ -1338,7 +1443,9 @@ namespace DoFTools
                           (*master_dof_masks[dominating_fe_index]
                                             [cell->active_fe_index()]),
                           split_face_interpolation_matrices
-                            [dominating_fe_index][cell->active_fe_index()]);
+                            [dominating_fe_index][cell->active_fe_index()],
+                          cache.mutex(dominating_fe_index,
+                                      cell->active_fe_index()));
 
                         const FullMatrix<double>
                           &restrict_mother_to_virtual_master_inv =
@@ -1429,7 +1536,9 @@ namespace DoFTools
                               subface_fe,
                               sf,
                               subface_interpolation_matrices
-                                [dominating_fe_index][subface_fe_index][sf]);
+                                [dominating_fe_index][subface_fe_index][sf],
+                              cache.mutex(dominating_fe_index,
+                                          subface_fe_index));
 
                             const FullMatrix<double>
                               &restrict_subface_to_virtual = *(
@@ -1526,7 +1635,9 @@ namespace DoFTools
                               neighbor->get_fe(),
                               face_interpolation_matrices
                                 [cell->active_fe_index()]
-                                [neighbor->active_fe_index()]);
+                                [neighbor->active_fe_index()],
+                              cache.mutex(cell->active_fe_index(),
+                                          neighbor->active_fe_index()));
 
                             // Add constraints to global constraint matrix.
                             filter_constraints(
@@ -1629,7 +1740,9 @@ namespace DoFTools
                               dominating_fe,
                               cell->get_fe(),
                               face_interpolation_matrices
-                                [dominating_fe_index][cell->active_fe_index()]);
+                                [dominating_fe_index][cell->active_fe_index()],
+                              cache.mutex(dominating_fe_index,
+                                          cell->active_fe_index()));
 
                             // split this matrix into master and slave
                             // components. invert the master component
@@ -1640,7 +1753,9 @@ namespace DoFTools
                                  [dominating_fe_index]
                                  [cell->active_fe_index()]),
                               master_dof_masks[dominating_fe_index]
-                                              [cell->active_fe_index()]);
+                                              [cell->active_fe_index()],
+                              cache.mutex(dominating_fe_index,
+                                          cell->active_fe_index()));
 
                             ensure_existence_of_split_face_matrix(
                               *face_interpolation_matrices
@@ -1648,7 +1763,9 @@ namespace DoFTools
                               (*master_dof_masks[dominating_fe_index]
                                                 [cell->active_fe_index()]),
                               split_face_interpolation_matrices
-                                [dominating_fe_index][cell->active_fe_index()]);
+                                [dominating_fe_index][cell->active_fe_index()],
+                              cache.mutex(dominating_fe_index,
+                                          cell->active_fe_index()));
 
                             const FullMatrix<
                               double> &restrict_mother_to_virtual_master_inv =
@@ -1714,7 +1831,9 @@ namespace DoFTools
                               neighbor->get_fe(),
                               face_interpolation_matrices
                                 [dominating_fe_index]
-                                [neighbor->active_fe_index()]);
+                                [neighbor->active_fe_index()],
+                              cache.mutex(dominating_fe_index,
+                                          neighbor->active_fe_index()));
 
                             const FullMatrix<double>
                               &restrict_secondface_to_virtual =
@@ -1765,17 +1884,83 @@ namespace DoFTools
   make_hanging_node_constraints(const DoFHandlerType &     dof_handler,
                                 AffineConstraints<number> &constraints)
   {
+    using active_cell_iterator = typename DoFHandlerType::active_cell_iterator;
+    const unsigned int dim     = DoFHandlerType::dimension;
+
     // Decide whether to use the new or old make_hanging_node_constraints
     // function. If all the FiniteElement or all elements in a FECollection
     // support the new face constraint matrix, the new code will be used.
     // Otherwise, the old implementation is used for the moment.
-    if (dof_handler.get_fe_collection().hp_constraints_are_implemented())
-      internal::make_hp_hanging_node_constraints(dof_handler, constraints);
-    else
-      internal::make_oldstyle_hanging_node_constraints(
-        dof_handler,
-        constraints,
-        std::integral_constant<int, DoFHandlerType::dimension>());
+    const bool use_hp_constraints =
+      dof_handler.get_fe_collection().hp_constraints_are_implemented();
+
+    internal::InterpolationMatrixCache cache(
+      internal::n_finite_elements(dof_handler),
+      GeometryInfo<dim>::max_children_per_face);
+
+    const auto make_constraints_on_cells =
+      [&](const active_cell_iterator &begin,
+          const active_cell_iterator &end,
+          AffineConstraints<number> & cell_constraints) {
+        if (use_hp_constraints)
+          internal::make_hp_hanging_node_constraints(
+            dof_handler, begin, end, cache, cell_constraints);
+        else
+          internal::make_oldstyle_hanging_node_constraints(
+            dof_handler,
+            begin,
+            end,
+            cell_constraints,
+            std::integral_constant<int, dim>());
+      };
+
+    // Split the active cells into contiguous ranges that are worked on by
+    // separate tasks. Only the first task writes into the output object
+    // directly, all others collect their constraints in an object of their
+    // own. These objects are then merged into the output in the order of the
+    // cell ranges. Since both the loops over the cells and the merge let
+    // the constraints computed first win, the result is the same as the one
+    // of a single loop over all cells, and no locking is necessary.
+    const unsigned int min_cells_per_task = 256;
+    const unsigned int n_active_cells =
+      dof_handler.get_triangulation().n_active_cells();
+    const unsigned int n_tasks =
+      std::max(1U,
+               std::min(MultithreadInfo::n_threads(),
+                        n_active_cells / min_cells_per_task));
+
+    if (n_tasks == 1)
+      {
+        make_constraints_on_cells(dof_handler.begin_active(),
+                                  dof_handler.end(),
+                                  constraints);
+        return;
+      }
+
+    std::vector<active_cell_iterator> range_begin(n_tasks + 1);
+    range_begin[0] = dof_handler.begin_active();
+    for (unsigned int t = 1; t < n_tasks; ++t)
+      range_begin[t] = std::next(range_begin[t - 1], n_active_cells / n_tasks);
+    range_begin[n_tasks] = dof_handler.end();
+
+    std::vector<AffineConstraints<number>> task_constraints(n_tasks - 1);
+    for (auto &c : task_constraints)
+      c.reinit(constraints.get_local_lines());
+
+    Threads::TaskGroup<> tasks;
+    tasks += Threads::new_task([&]() {
+      make_constraints_on_cells(range_begin[0], range_begin[1], constraints);
+    });
+    for (unsigned int t = 1; t < n_tasks; ++t)
+      tasks += Threads::new_task([&, t]() {
+        make_constraints_on_cells(range_begin[t],
+                                  range_begin[t + 1],
+                                  task_constraints[t - 1]);
+      });
+    tasks.join_all();
+
+    for (const auto &c : task_constraints)
+      constraints.merge(c, AffineConstraints<number>::left_object_wins);
   }
 
 
@@ -0,0 +1,509 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_matrix_cache.h>
+
+#include <deal.II/lac/full_matrix.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * The identification at the start of each cache file, followed by the
+   * version number of the format. The version must be increased whenever the
+   * layout of the file or the meaning of the stored matrices changes.
+   */
+  const char          file_identifier[] = "deal.II FEMatrixCache";
+  const std::uint32_t file_version      = 1;
+
+  /**
+   * The matrices of one finite element, in the same layout as the
+   * corresponding member variables of FiniteElement.
+   */
+  struct Entry
+  {
+    unsigned int                                 dim;
+    unsigned int                                 spacedim;
+    unsigned int                                 dofs_per_cell;
+    FullMatrix<double>                           interface_constraints;
+    std::vector<std::vector<FullMatrix<double>>> prolongation;
+    std::vector<std::vector<FullMatrix<double>>> restriction;
+  };
+
+  std::mutex                   cache_mutex;
+  std::map<std::string, Entry> cache;
+  std::atomic<bool>            cache_enabled(false);
+  std::atomic<unsigned int>    cache_hits(0);
+
+
+
+  /**
+   * Return whether an element of the given name can be stored in the cache,
+   * i.e., whether the name describes the element uniquely.
+   */
+  bool
+  is_cacheable(const std::string &name)
+  {
+    return name.find("QUnknownNodes") == std::string::npos;
+  }
+
+
+
+  template <typename T>
+  void
+  write_value(const T &value, std::vector<char> &buffer)
+  {
+    const char *begin = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), begin, begin + sizeof(T));
+  }
+
+
+
+  void
+  write_matrix(const FullMatrix<double> &matrix, std::vector<char> &buffer)
+  {
+    write_value(static_cast<std::uint32_t>(matrix.m()), buffer);
+    write_value(static_cast<std::uint32_t>(matrix.n()), buffer);
+    for (unsigned int i = 0; i < matrix.m(); ++i)
+      for (unsigned int j = 0; j < matrix.n(); ++j)
+        write_value(matrix(i, j), buffer);
+  }
+
+
+
+  void
+  write_matrix_table(
+    const std::vector<std::vector<FullMatrix<double>>> &matrices,
+    std::vector<char> &                                 buffer)
+  {
+    write_value(static_cast<std::uint32_t>(matrices.size()), buffer);
+    for (const auto &matrices_of_case : matrices)
+      {
+        write_value(static_cast<std::uint32_t>(matrices_of_case.size()),
+                    buffer);
+        for (const auto &matrix : matrices_of_case)
+          write_matrix(matrix, buffer);
+      }
+  }
+
+
+
+  /**
+   * Read the data of a cache file sequentially, checking that no data is
+   * read beyond the end of the buffer.
+   */
+  class BufferReader
+  {
+  public:
+    BufferReader(const std::vector<char> &buffer,
+                 const std::string &      filename)
+      : buffer(buffer)
+      , position(0)
+      , filename(filename)
+    {}
+
+    template <typename T>
+    T
+    read_value()
+    {
+      AssertThrow(position + sizeof(T) <= buffer.size(),
+                  FEMatrixCache::ExcInvalidCacheFile(filename));
+      T value;
+      std::memcpy(&value, buffer.data() + position, sizeof(T));
+      position += sizeof(T);
+      return value;
+    }
+
+    std::string
+    read_string(const std::size_t length)
+    {
+      AssertThrow(position + length <= buffer.size(),
+                  FEMatrixCache::ExcInvalidCacheFile(filename));
+      const std::string string(buffer.data() + position, length);
+      position += length;
+      return string;
+    }
+
+    void
+    read_matrix(FullMatrix<double> &matrix)
+    {
+      const std::uint32_t m = read_value<std::uint32_t>();
+      const std::uint32_t n = read_value<std::uint32_t>();
+      AssertThrow(position + sizeof(double) * m * n <= buffer.size(),
+                  FEMatrixCache::ExcInvalidCacheFile(filename));
+      matrix.reinit(m, n);
+      for (unsigned int i = 0; i < m; ++i)
+        for (unsigned int j = 0; j < n; ++j)
+          matrix(i, j) = read_value<double>();
+    }
+
+    void
+    read_matrix_table(std::vector<std::vector<FullMatrix<double>>> &matrices)
+    {
+      matrices.resize(read_value<std::uint32_t>());
+      for (auto &matrices_of_case : matrices)
+        {
+          matrices_of_case.resize(read_value<std::uint32_t>());
+          for (auto &matrix : matrices_of_case)
+            read_matrix(matrix);
+        }
+    }
+
+    bool
+    at_end() const
+    {
+      return position == buffer.size();
+    }
+
+  private:
+    const std::vector<char> &buffer;
+    std::size_t              position;
+    const std::string        filename;
+  };
+
+
+
+  /**
+   * Check whether the stored table of transfer matrices has the same layout
+   * as the table of the element.
+   */
+  bool
+  same_layout(const std::vector<std::vector<FullMatrix<double>>> &matrices_1,
+              const std::vector<std::vector<FullMatrix<double>>> &matrices_2)
+  {
+    if (matrices_1.size() != matrices_2.size())
+      return false;
+    for (unsigned int i = 0; i < matrices_1.size(); ++i)
+      if (matrices_1[i].size() != matrices_2[i].size())
+        return false;
+    return true;
+  }
+
+
+
+  /**
+   * Copy those matrices of @p cached_matrices to @p matrices that are not
+   * yet initialized in @p matrices, and return whether any matrix was copied.
+   */
+  bool
+  copy_missing_matrices(
+    const std::vector<std::vector<FullMatrix<double>>> &cached_matrices,
+    const unsigned int                                  dofs_per_cell,
+    std::vector<std::vector<FullMatrix<double>>> &      matrices)
+  {
+    bool any_matrix_copied = false;
+    for (unsigned int i = 0; i < matrices.size(); ++i)
+      for (unsigned int c = 0; c < matrices[i].size(); ++c)
+        if (matrices[i][c].n() == 0 &&
+            cached_matrices[i][c].n() == dofs_per_cell)
+          {
+            matrices[i][c]    = cached_matrices[i][c];
+            any_matrix_copied = true;
+          }
+    return any_matrix_copied;
+  }
+} // namespace
+
+
+
+void
+FEMatrixCache::enable()
+{
+  cache_enabled = true;
+}
+
+
+
+void
+FEMatrixCache::disable()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache_enabled = false;
+  cache.clear();
+}
+
+
+
+bool
+FEMatrixCache::is_enabled()
+{
+  return cache_enabled;
+}
+
+
+
+unsigned int
+FEMatrixCache::n_entries()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache.size();
+}
+
+
+
+unsigned int
+FEMatrixCache::n_hits()
+{
+  return cache_hits;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEMatrixCache::add(const FiniteElement<dim, spacedim> &fe)
+{
+  const std::string name = fe.get_name();
+  if (is_cacheable(name) == false)
+    return;
+
+  // make sure that the lazily initialized matrices are computed
+  fe.isotropic_prolongation_is_implemented();
+  fe.isotropic_restriction_is_implemented();
+
+  Entry entry;
+  entry.dim                   = dim;
+  entry.spacedim              = spacedim;
+  entry.dofs_per_cell         = fe.dofs_per_cell;
+  entry.interface_constraints = fe.interface_constraints;
+  entry.prolongation          = fe.prolongation;
+  entry.restriction           = fe.restriction;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache[name] = std::move(entry);
+}
+
+
+
+void
+FEMatrixCache::write(const std::string &filename,
+                     const MPI_Comm &   mpi_communicator)
+{
+  // MPI need not be initialized for programs that run on a single process
+  if (Utilities::MPI::job_supports_mpi() &&
+      Utilities::MPI::this_mpi_process(mpi_communicator) != 0)
+    return;
+
+  std::vector<char> buffer(file_identifier,
+                           file_identifier + sizeof(file_identifier));
+  write_value(file_version, buffer);
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    write_value(static_cast<std::uint64_t>(cache.size()), buffer);
+    for (const auto &name_and_entry : cache)
+      {
+        const std::string &name  = name_and_entry.first;
+        const Entry &      entry = name_and_entry.second;
+        write_value(static_cast<std::uint64_t>(name.size()), buffer);
+        buffer.insert(buffer.end(), name.begin(), name.end());
+        write_value(static_cast<std::uint32_t>(entry.dim), buffer);
+        write_value(static_cast<std::uint32_t>(entry.spacedim), buffer);
+        write_value(static_cast<std::uint32_t>(entry.dofs_per_cell), buffer);
+        write_matrix(entry.interface_constraints, buffer);
+        write_matrix_table(entry.prolongation, buffer);
+        write_matrix_table(entry.restriction, buffer);
+      }
+  }
+
+  std::ofstream file(filename, std::ios::binary);
+  AssertThrow(file, ExcFileNotOpen(filename));
+  file.write(buffer.data(), buffer.size());
+  AssertThrow(file, ExcIO());
+}
+
+
+
+void
+FEMatrixCache::read(const std::string &filename,
+                    const MPI_Comm &   mpi_communicator)
+{
+  // read the file on the first process. use the largest possible size to
+  // signal that the file could not be opened, in order to let all processes
+  // throw the same exception
+  const std::uint64_t invalid_size = static_cast<std::uint64_t>(-1);
+  std::vector<char>   buffer;
+  std::uint64_t       size = invalid_size;
+  const bool use_mpi = Utilities::MPI::job_supports_mpi();
+  if (!use_mpi || Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+    {
+      std::ifstream file(filename, std::ios::binary);
+      if (file)
+        {
+          buffer.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+          size = buffer.size();
+        }
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  if (use_mpi && Utilities::MPI::n_mpi_processes(mpi_communicator) > 1)
+    {
+      int ierr = MPI_Bcast(&size, 1, MPI_UINT64_T, 0, mpi_communicator);
+      AssertThrowMPI(ierr);
+      if (size != invalid_size)
+        {
+          buffer.resize(size);
+          // send the data in pieces that can be described by an int
+          const std::uint64_t max_chunk = 1U << 30;
+          for (std::uint64_t offset = 0; offset < size; offset += max_chunk)
+            {
+              ierr = MPI_Bcast(buffer.data() + offset,
+                               static_cast<int>(
+                                 std::min(max_chunk, size - offset)),
+                               MPI_CHAR,
+                               0,
+                               mpi_communicator);
+              AssertThrowMPI(ierr);
+            }
+        }
+    }
+#endif
+
+  AssertThrow(size != invalid_size, ExcFileNotOpen(filename));
+
+  // parse the content into a separate map first, in order to not leave the
+  // cache in an inconsistent state if the file is corrupt
+  BufferReader reader(buffer, filename);
+  AssertThrow(reader.read_string(sizeof(file_identifier)) ==
+                  std::string(file_identifier, sizeof(file_identifier)) &&
+                reader.read_value<std::uint32_t>() == file_version,
+              ExcInvalidCacheFile(filename));
+
+  std::map<std::string, Entry> new_entries;
+  const std::uint64_t n_entries = reader.read_value<std::uint64_t>();
+  for (std::uint64_t e = 0; e < n_entries; ++e)
+    {
+      const std::string name =
+        reader.read_string(reader.read_value<std::uint64_t>());
+      Entry &entry        = new_entries[name];
+      entry.dim           = reader.read_value<std::uint32_t>();
+      entry.spacedim      = reader.read_value<std::uint32_t>();
+      entry.dofs_per_cell = reader.read_value<std::uint32_t>();
+      reader.read_matrix(entry.interface_constraints);
+      reader.read_matrix_table(entry.prolongation);
+      reader.read_matrix_table(entry.restriction);
+    }
+  AssertThrow(reader.at_end(), ExcInvalidCacheFile(filename));
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  for (auto &name_and_entry : new_entries)
+    cache[name_and_entry.first] = std::move(name_and_entry.second);
+  cache_enabled = true;
+}
+
+
+
+template <int dim, int spacedim>
+bool
+FEMatrixCache::fill_interface_constraints(FiniteElement<dim, spacedim> &fe)
+{
+  if (cache_enabled == false)
+    return false;
+
+  const std::string name = fe.get_name();
+  if (is_cacheable(name) == false)
+    return false;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  const auto entry = cache.find(name);
+  if (entry == cache.end() || entry->second.dim != dim ||
+      entry->second.spacedim != spacedim ||
+      entry->second.dofs_per_cell != fe.dofs_per_cell ||
+      entry->second.interface_constraints.m() == 0)
+    return false;
+
+  fe.interface_constraints = entry->second.interface_constraints;
+  ++cache_hits;
+  return true;
+}
+
+
+
+template <int dim, int spacedim>
+bool
+FEMatrixCache::fill_transfer_matrices(FiniteElement<dim, spacedim> &fe)
+{
+  if (cache_enabled == false)
+    return false;
+
+  const std::string name = fe.get_name();
+  if (is_cacheable(name) == false)
+    return false;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  const auto entry = cache.find(name);
+  if (entry == cache.end() || entry->second.dim != dim ||
+      entry->second.spacedim != spacedim ||
+      entry->second.dofs_per_cell != fe.dofs_per_cell ||
+      same_layout(entry->second.prolongation, fe.prolongation) == false ||
+      same_layout(entry->second.restriction, fe.restriction) == false)
+    return false;
+
+  const bool prolongation_copied =
+    copy_missing_matrices(entry->second.prolongation,
+                          fe.dofs_per_cell,
+                          fe.prolongation);
+  const bool restriction_copied =
+    copy_missing_matrices(entry->second.restriction,
+                          fe.dofs_per_cell,
+                          fe.restriction);
+  if (prolongation_copied || restriction_copied)
+    {
+      ++cache_hits;
+      return true;
+    }
+  return false;
+}
+
+
+
+std::size_t
+FEMatrixCache::memory_consumption()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  std::size_t                 memory = sizeof(cache);
+  for (const auto &name_and_entry : cache)
+    memory += MemoryConsumption::memory_consumption(name_and_entry.first) +
+              sizeof(Entry) +
+              name_and_entry.second.interface_constraints.memory_consumption() +
+              MemoryConsumption::memory_consumption(
+                name_and_entry.second.prolongation) +
+              MemoryConsumption::memory_consumption(
+                name_and_entry.second.restriction);
+  return memory;
+}
+
+
+
+// explicit instantiations
+#include "fe_matrix_cache.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -22,6 +22,7 @@
 
 #include <deal.II/dofs/dof_accessor.h>
 
+#include <deal.II/fe/fe_matrix_cache.h>
 #include <deal.II/fe/fe_nedelec.h>
 #include <deal.II/fe/fe_nothing.h>
 #include <deal.II/fe/fe_tools.h>
@@ -103,6 +104,19 @@ FE_Nedelec<dim>::FE_Nedelec(const unsigned int order)
   // initialized on demand in get_restriction_matrix and
   // get_prolongation_matrix
 
+  // the interface constraints are computed from the face embedding
+  // matrices, which is expensive for higher degrees. take them from the
+  // FEMatrixCache if possible
+  if (FEMatrixCache::fill_interface_constraints(*this) == false)
+    compute_interface_constraints(order);
+}
+
+
+
+template <int dim>
+void
+FE_Nedelec<dim>::compute_interface_constraints(const unsigned int order)
+{
 #ifdef DEBUG_NEDELEC
   deallog << "Face Embedding" << std::endl;
 #endif
@@ -2985,6 +2999,12 @@ FE_Nedelec<dim>::get_prolongation_matrix(
       // be able to modify them inside a const function
       FE_Nedelec<dim> &this_nonconst = const_cast<FE_Nedelec<dim> &>(*this);
 
+      // check whether the matrices can be taken from the cache
+      if (FEMatrixCache::fill_transfer_matrices(this_nonconst) &&
+          this->prolongation[refinement_case - 1][child].n() ==
+            this->dofs_per_cell)
+        return this->prolongation[refinement_case - 1][child];
+
       // Reinit the vectors of
       // restriction and prolongation
       // matrices to the right sizes.
@@ -3047,6 +3067,12 @@ FE_Nedelec<dim>::get_restriction_matrix(
       // be able to modify them inside a const function
       FE_Nedelec<dim> &this_nonconst = const_cast<FE_Nedelec<dim> &>(*this);
 
+      // check whether the matrices can be taken from the cache
+      if (FEMatrixCache::fill_transfer_matrices(this_nonconst) &&
+          this->restriction[refinement_case - 1][child].n() ==
+            this->dofs_per_cell)
+        return this->restriction[refinement_case - 1][child];
+
       // Reinit the vectors of
       // restriction and prolongation
       // matrices to the right sizes.
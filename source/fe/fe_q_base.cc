@@ -26,6 +26,7 @@
 
 #include <deal.II/fe/fe_dgp.h>
 #include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_matrix_cache.h>
 #include <deal.II/fe/fe_nothing.h>
 #include <deal.II/fe/fe_q_base.h>
 #include <deal.II/fe/fe_tools.h>
@@ -477,12 +478,23 @@ FE_Q_Base<PolynomialType, dim, spacedim>::initialize(
   }
 
   // Finally fill in support points on cell and face and initialize
-  // constraints. All of this can happen in parallel
+  // constraints. All of this can happen in parallel. If the constraints can
+  // be taken from the FEMatrixCache, we need the support points before the
+  // other tasks because they determine the name of the element
   Threads::TaskGroup<> tasks;
-  tasks += Threads::new_task([&]() { initialize_unit_support_points(points); });
+  bool                 constraints_from_cache = false;
+  if (FEMatrixCache::is_enabled())
+    {
+      initialize_unit_support_points(points);
+      constraints_from_cache = FEMatrixCache::fill_interface_constraints(*this);
+    }
+  else
+    tasks +=
+      Threads::new_task([&]() { initialize_unit_support_points(points); });
   tasks +=
     Threads::new_task([&]() { initialize_unit_face_support_points(points); });
-  tasks += Threads::new_task([&]() { initialize_constraints(points); });
+  if (constraints_from_cache == false)
+    tasks += Threads::new_task([&]() { initialize_constraints(points); });
   tasks +=
     Threads::new_task([&]() { this->initialize_quad_dof_index_permutation(); });
   tasks.join_all();
@@ -1194,6 +1206,13 @@ FE_Q_Base<PolynomialType, dim, spacedim>::get_prolongation_matrix(
           this->dofs_per_cell)
         return this->prolongation[refinement_case - 1][child];
 
+      // check whether the matrix can be taken from the cache
+      if (FEMatrixCache::fill_transfer_matrices(
+            const_cast<FE_Q_Base<PolynomialType, dim, spacedim> &>(*this)) &&
+          this->prolongation[refinement_case - 1][child].n() ==
+            this->dofs_per_cell)
+        return this->prolongation[refinement_case - 1][child];
+
       // distinguish q/q_dg0 case: only treat Q dofs first
       const unsigned int q_dofs_per_cell =
         Utilities::fixed_power<dim>(q_degree + 1);
@@ -1396,6 +1415,13 @@ FE_Q_Base<PolynomialType, dim, spacedim>::get_restriction_matrix(
           this->dofs_per_cell)
         return this->restriction[refinement_case - 1][child];
 
+      // check whether the matrix can be taken from the cache
+      if (FEMatrixCache::fill_transfer_matrices(
+            const_cast<FE_Q_Base<PolynomialType, dim, spacedim> &>(*this)) &&
+          this->restriction[refinement_case - 1][child].n() ==
+            this->dofs_per_cell)
+        return this->restriction[refinement_case - 1][child];
+
       FullMatrix<double> my_restriction(this->dofs_per_cell,
                                         this->dofs_per_cell);
       // distinguish q/q_dg0 case
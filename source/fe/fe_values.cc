@@ -20,12 +20,14 @@
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/signaling_nan.h>
 #include <deal.II/base/std_cxx14/memory.h>
+#include <deal.II/base/tensor_product_polynomials.h>
 
 #include <deal.II/differentiation/ad.h>
 
 #include <deal.II/dofs/dof_accessor.h>
 
 #include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_poly.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/fe/mapping_q1.h>
 
@@ -43,6 +45,9 @@
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/vector_element_access.h>
 
+#include <deal.II/matrix_free/evaluation_kernels.h>
+#include <deal.II/matrix_free/shape_info.h>
+
 #include <boost/container/small_vector.hpp>
 
 #include <iomanip>
@@ -3567,6 +3572,254 @@ namespace internal
               }
         }
   }
+
+
+
+  // Return the one-dimensional shape data used for evaluating scalar
+  // tensor-product elements with sum factorization, see the documentation of
+  // FEValuesBase::tensor_product_shape_info. The tensor product kernels are
+  // only set up for elements with dim==spacedim, so return an empty pointer
+  // in the general case.
+  template <int dim, int spacedim>
+  std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double>>
+  create_tensor_product_shape_info(const FiniteElement<dim, spacedim> &,
+                                   const Quadrature<dim> &)
+  {
+    return nullptr;
+  }
+
+
+
+  template <int dim>
+  std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double>>
+  create_tensor_product_shape_info(const FiniteElement<dim, dim> &fe,
+                                   const Quadrature<dim> &        quadrature)
+  {
+    // sum factorization does not pay off in 1d or for low polynomial
+    // degrees, where the summation over the shape function tables is
+    // equally fast
+    if (dim == 1 || fe.degree < 3 || fe.n_components() != 1 ||
+        fe.has_support_points() == false ||
+        dynamic_cast<const FE_Poly<TensorProductPolynomials<dim>, dim, dim> *>(
+          &fe) == nullptr ||
+        quadrature.is_tensor_product() == false)
+      return nullptr;
+
+    // the kernels need the same quadrature formula in all directions
+    const std::array<Quadrature<1>, dim> &quadrature_1d =
+      quadrature.get_tensor_basis();
+    for (unsigned int d = 1; d < dim; ++d)
+      if (!(quadrature_1d[d] == quadrature_1d[0]))
+        return nullptr;
+
+    const auto shape_info =
+      std::make_shared<MatrixFreeFunctions::ShapeInfo<double>>();
+    shape_info->reinit(quadrature_1d[0], fe);
+    return shape_info;
+  }
+
+
+
+  // run the sum factorization kernel with the polynomial degree and the
+  // number of quadrature points as compile-time constants for the common
+  // case of degree+1 points per direction and degrees up to six, which lets
+  // the compiler unroll the loops of the one-dimensional products. other
+  // cases use the kernel with loop bounds given at run time
+  template <int dim, int degree>
+  struct TensorProductKernel
+  {
+    static void
+    evaluate(const MatrixFreeFunctions::ShapeInfo<double> &shape_info,
+             double *                                      values_dofs,
+             double *                                      values_quad,
+             double *                                      gradients_quad,
+             double *                                      scratch,
+             const bool                                    evaluate_values,
+             const bool                                    evaluate_gradients)
+    {
+      if (shape_info.fe_degree == degree &&
+          shape_info.n_q_points_1d == degree + 1)
+        FEEvaluationImpl<MatrixFreeFunctions::tensor_general,
+                         dim,
+                         degree,
+                         degree + 1,
+                         1,
+                         double>::evaluate(shape_info,
+                                           values_dofs,
+                                           values_quad,
+                                           gradients_quad,
+                                           nullptr,
+                                           scratch,
+                                           evaluate_values,
+                                           evaluate_gradients,
+                                           false);
+      else
+        TensorProductKernel<dim, degree + 1>::evaluate(shape_info,
+                                                       values_dofs,
+                                                       values_quad,
+                                                       gradients_quad,
+                                                       scratch,
+                                                       evaluate_values,
+                                                       evaluate_gradients);
+    }
+  };
+
+
+
+  template <int dim>
+  struct TensorProductKernel<dim, 7>
+  {
+    static void
+    evaluate(const MatrixFreeFunctions::ShapeInfo<double> &shape_info,
+             double *                                      values_dofs,
+             double *                                      values_quad,
+             double *                                      gradients_quad,
+             double *                                      scratch,
+             const bool                                    evaluate_values,
+             const bool                                    evaluate_gradients)
+    {
+      FEEvaluationImpl<MatrixFreeFunctions::tensor_general,
+                       dim,
+                       -1,
+                       0,
+                       1,
+                       double>::evaluate(shape_info,
+                                         values_dofs,
+                                         values_quad,
+                                         gradients_quad,
+                                         nullptr,
+                                         scratch,
+                                         evaluate_values,
+                                         evaluate_gradients,
+                                         false);
+    }
+  };
+
+
+
+  // evaluate the values or the gradients on the reference cell of a scalar
+  // tensor-product element in the quadrature points with sum factorization.
+  // the degrees of freedom are given in the numbering of the finite element
+  // and get permuted to the lexicographic numbering of the kernels. the
+  // result is placed in the arrays of the scratch data, with the gradients
+  // stored component by component
+  template <int dim, int spacedim, typename Number>
+  void
+  evaluate_tensor_product(
+    const MatrixFreeFunctions::ShapeInfo<double> &shape_info,
+    const Number *                                dof_values_ptr,
+    const bool                                    evaluate_gradients,
+    FEValuesImplementation::TensorProductScratchData<dim, spacedim>
+      &scratch_data)
+  {
+    const unsigned int n_dofs = shape_info.dofs_per_component_on_cell;
+    AssertDimension(scratch_data.dof_values.size(), n_dofs);
+    for (unsigned int i = 0; i < n_dofs; ++i)
+      scratch_data.dof_values[i] =
+        dof_values_ptr[shape_info.lexicographic_numbering[i]];
+
+    TensorProductKernel<dim, 3>::evaluate(shape_info,
+                                          scratch_data.dof_values.begin(),
+                                          scratch_data.values_quad.begin(),
+                                          scratch_data.gradients_quad.begin(),
+                                          scratch_data.scratch.begin(),
+                                          !evaluate_gradients,
+                                          evaluate_gradients);
+  }
+
+
+
+  // the sum factorization path of get_function_values() for scalar elements,
+  // used for floating point numbers only. return whether the values could be
+  // computed
+  template <int dim, int spacedim, typename Number>
+  bool
+  do_function_values_tensor_product(
+    const MatrixFreeFunctions::ShapeInfo<double> *shape_info,
+    const Number *                                dof_values_ptr,
+    FEValuesImplementation::TensorProductScratchData<dim, spacedim>
+      &                  scratch_data,
+    std::vector<Number> &values,
+    std::true_type)
+  {
+    if (shape_info == nullptr)
+      return false;
+    AssertDimension(values.size(), shape_info->n_q_points);
+
+    evaluate_tensor_product(*shape_info, dof_values_ptr, false, scratch_data);
+    std::copy(scratch_data.values_quad.begin(),
+              scratch_data.values_quad.end(),
+              values.begin());
+    return true;
+  }
+
+
+
+  template <int dim, int spacedim, typename Number>
+  bool
+  do_function_values_tensor_product(
+    const MatrixFreeFunctions::ShapeInfo<double> *,
+    const Number *,
+    FEValuesImplementation::TensorProductScratchData<dim, spacedim> &,
+    std::vector<Number> &,
+    std::false_type)
+  {
+    return false;
+  }
+
+
+
+  // the sum factorization path of get_function_gradients() for scalar
+  // elements, used for floating point numbers only. the gradients on the
+  // reference cell are transformed to the real cell by the covariant
+  // transformation of the mapping
+  template <int dim, int spacedim, typename Number>
+  bool
+  do_function_gradients_tensor_product(
+    const MatrixFreeFunctions::ShapeInfo<double> *           shape_info,
+    const Number *                                           dof_values_ptr,
+    const Mapping<dim, spacedim> &                           mapping,
+    const typename Mapping<dim, spacedim>::InternalDataBase &mapping_data,
+    FEValuesImplementation::TensorProductScratchData<dim, spacedim>
+      &                                       scratch_data,
+    std::vector<Tensor<1, spacedim, Number>> &gradients,
+    std::true_type)
+  {
+    if (shape_info == nullptr)
+      return false;
+    const unsigned int n_q_points = shape_info->n_q_points;
+    AssertDimension(gradients.size(), n_q_points);
+
+    evaluate_tensor_product(*shape_info, dof_values_ptr, true, scratch_data);
+
+    for (unsigned int q = 0; q < n_q_points; ++q)
+      for (unsigned int d = 0; d < dim; ++d)
+        scratch_data.reference_gradients[q][d] =
+          scratch_data.gradients_quad[d * n_q_points + q];
+    mapping.transform(make_array_view(scratch_data.reference_gradients),
+                      mapping_covariant,
+                      mapping_data,
+                      make_array_view(scratch_data.real_gradients));
+    for (unsigned int q = 0; q < n_q_points; ++q)
+      gradients[q] = scratch_data.real_gradients[q];
+    return true;
+  }
+
+
+
+  template <int dim, int spacedim, typename Number>
+  bool
+  do_function_gradients_tensor_product(
+    const MatrixFreeFunctions::ShapeInfo<double> *,
+    const Number *,
+    const Mapping<dim, spacedim> &,
+    const typename Mapping<dim, spacedim>::InternalDataBase &,
+    FEValuesImplementation::TensorProductScratchData<dim, spacedim> &,
+    std::vector<Tensor<1, spacedim, Number>> &,
+    std::false_type)
+  {
+    return false;
+  }
 } // namespace internal
 
 
@@ -3579,7 +3832,9 @@ FEValuesBase<dim, spacedim>::get_function_values(
   std::vector<typename InputVector::value_type> &values) const
 {
   using Number = typename InputVector::value_type;
-  Assert(this->update_flags & update_values,
+  Assert((this->update_flags & update_values) ||
+           (tensor_product_shape_info != nullptr &&
+            std::is_floating_point<Number>::value),
          ExcAccessToUninitializedField("update_values"));
   AssertDimension(fe->n_components(), 1);
   Assert(present_cell.get() != nullptr,
@@ -3589,9 +3844,15 @@ FEValuesBase<dim, spacedim>::get_function_values(
   // get function values of dofs on this cell
   Vector<Number> dof_values(dofs_per_cell);
   present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_values(dof_values.begin(),
-                               this->finite_element_output.shape_values,
-                               values);
+  if (internal::do_function_values_tensor_product(
+        tensor_product_shape_info.get(),
+        dof_values.begin(),
+        tensor_product_scratch_data,
+        values,
+        std::is_floating_point<Number>()) == false)
+    internal::do_function_values(dof_values.begin(),
+                                 this->finite_element_output.shape_values,
+                                 values);
 }
 
 
@@ -3605,7 +3866,9 @@ FEValuesBase<dim, spacedim>::get_function_values(
   std::vector<typename InputVector::value_type> & values) const
 {
   using Number = typename InputVector::value_type;
-  Assert(this->update_flags & update_values,
+  Assert((this->update_flags & update_values) ||
+           (tensor_product_shape_info != nullptr &&
+            std::is_floating_point<Number>::value),
          ExcAccessToUninitializedField("update_values"));
   AssertDimension(fe->n_components(), 1);
   AssertDimension(indices.size(), dofs_per_cell);
@@ -3613,9 +3876,15 @@ FEValuesBase<dim, spacedim>::get_function_values(
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   for (unsigned int i = 0; i < dofs_per_cell; ++i)
     dof_values[i] = internal::get_vector_element(fe_function, indices[i]);
-  internal::do_function_values(dof_values.data(),
-                               this->finite_element_output.shape_values,
-                               values);
+  if (internal::do_function_values_tensor_product(
+        tensor_product_shape_info.get(),
+        dof_values.data(),
+        tensor_product_scratch_data,
+        values,
+        std::is_floating_point<Number>()) == false)
+    internal::do_function_values(dof_values.data(),
+                                 this->finite_element_output.shape_values,
+                                 values);
 }
 
 
@@ -3721,7 +3990,9 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   const
 {
   using Number = typename InputVector::value_type;
-  Assert(this->update_flags & update_gradients,
+  Assert((this->update_flags & update_gradients) ||
+           (tensor_product_shape_info != nullptr &&
+            std::is_floating_point<Number>::value),
          ExcAccessToUninitializedField("update_gradients"));
   AssertDimension(fe->n_components(), 1);
   Assert(present_cell.get() != nullptr,
@@ -3731,9 +4002,18 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   // get function values of dofs on this cell
   Vector<Number> dof_values(dofs_per_cell);
   present_cell->get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_derivatives(dof_values.begin(),
-                                    this->finite_element_output.shape_gradients,
-                                    gradients);
+  if (internal::do_function_gradients_tensor_product(
+        tensor_product_shape_info.get(),
+        dof_values.begin(),
+        *mapping,
+        *mapping_data,
+        tensor_product_scratch_data,
+        gradients,
+        std::is_floating_point<Number>()) == false)
+    internal::do_function_derivatives(
+      dof_values.begin(),
+      this->finite_element_output.shape_gradients,
+      gradients);
 }
 
 
@@ -3748,7 +4028,9 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   const
 {
   using Number = typename InputVector::value_type;
-  Assert(this->update_flags & update_gradients,
+  Assert((this->update_flags & update_gradients) ||
+           (tensor_product_shape_info != nullptr &&
+            std::is_floating_point<Number>::value),
          ExcAccessToUninitializedField("update_gradients"));
   AssertDimension(fe->n_components(), 1);
   AssertDimension(indices.size(), dofs_per_cell);
@@ -3756,9 +4038,18 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   for (unsigned int i = 0; i < dofs_per_cell; ++i)
     dof_values[i] = internal::get_vector_element(fe_function, indices[i]);
-  internal::do_function_derivatives(dof_values.data(),
-                                    this->finite_element_output.shape_gradients,
-                                    gradients);
+  if (internal::do_function_gradients_tensor_product(
+        tensor_product_shape_info.get(),
+        dof_values.data(),
+        *mapping,
+        *mapping_data,
+        tensor_product_scratch_data,
+        gradients,
+        std::is_floating_point<Number>()) == false)
+    internal::do_function_derivatives(
+      dof_values.data(),
+      this->finite_element_output.shape_gradients,
+      gradients);
 }
 
 
@@ -4454,7 +4745,31 @@ FEValues<dim, spacedim>::initialize(const UpdateFlags update_flags)
                       "triangulation it refers to is embedded in a higher "
                       "dimensional space."));
 
-  const UpdateFlags flags = this->compute_update_flags(update_flags);
+  // check whether function values and gradients can be evaluated with sum
+  // factorization. the gradients on the reference cell are then transformed
+  // by the mapping, which needs to compute the covariant transformation
+  // even if the shape function gradients are not requested
+  this->tensor_product_shape_info =
+    internal::create_tensor_product_shape_info(*this->fe, quadrature);
+  UpdateFlags extra_flags = update_default;
+  if (this->tensor_product_shape_info != nullptr)
+    {
+      extra_flags = update_covariant_transformation;
+
+      auto &scratch_data = this->tensor_product_scratch_data;
+      const unsigned int n_dofs =
+        this->tensor_product_shape_info->dofs_per_component_on_cell;
+      const unsigned int n_q_points = this->n_quadrature_points;
+      scratch_data.dof_values.resize_fast(n_dofs);
+      scratch_data.values_quad.resize_fast(n_q_points);
+      scratch_data.gradients_quad.resize_fast(dim * n_q_points);
+      scratch_data.scratch.resize_fast(3 * (n_dofs + 1) + 2 * n_q_points);
+      scratch_data.reference_gradients.resize(n_q_points);
+      scratch_data.real_gradients.resize(n_q_points);
+    }
+
+  const UpdateFlags flags =
+    this->compute_update_flags(update_flags | extra_flags);
 
   // initialize the base classes
   if (flags & update_mapping)
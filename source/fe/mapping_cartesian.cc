@@ -1131,6 +1131,30 @@ MappingCartesian<dim, spacedim>::transform_real_to_unit_cell(
 }
 
 
+
+template <int dim, int spacedim>
+void
+MappingCartesian<dim, spacedim>::transform_points_real_to_unit_cell(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+  const ArrayView<const Point<spacedim>> &                    real_points,
+  const ArrayView<Point<dim>> &                               unit_points) const
+{
+  AssertThrow(dim == spacedim, ExcNotImplemented());
+  AssertDimension(real_points.size(), unit_points.size());
+
+  const Point<spacedim> start = cell->vertex(0);
+  Tensor<1, dim>        inverse_extent;
+  for (unsigned int d = 0; d < dim; ++d)
+    inverse_extent[d] =
+      1. / (cell->vertex(GeometryInfo<dim>::vertices_per_cell - 1)[d] -
+            start[d]);
+
+  for (unsigned int i = 0; i < real_points.size(); ++i)
+    for (unsigned int d = 0; d < dim; ++d)
+      unit_points[i][d] = (real_points[i][d] - start[d]) * inverse_extent[d];
+}
+
+
 template <int dim, int spacedim>
 std::unique_ptr<Mapping<dim, spacedim>>
 MappingCartesian<dim, spacedim>::clone() const
@@ -0,0 +1,298 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/std_cxx14/memory.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/work_stream.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_cache.h>
+
+#include <deal.II/grid/tria_iterator.h>
+
+#include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_vector.h>
+#include <deal.II/lac/petsc_block_vector.h>
+#include <deal.II/lac/petsc_vector.h>
+#include <deal.II/lac/trilinos_parallel_block_vector.h>
+#include <deal.II/lac/trilinos_vector.h>
+#include <deal.II/lac/vector.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+MappingQCache<dim, spacedim>::MappingQCache(
+  const unsigned int polynomial_degree)
+  : MappingQGeneric<dim, spacedim>(polynomial_degree)
+  , n_points_per_cell(Utilities::fixed_power<dim>(polynomial_degree + 1))
+{}
+
+
+
+template <int dim, int spacedim>
+MappingQCache<dim, spacedim>::MappingQCache(
+  const MappingQCache<dim, spacedim> &mapping)
+  : MappingQGeneric<dim, spacedim>(mapping)
+  , n_points_per_cell(mapping.n_points_per_cell)
+  , support_point_cache(mapping.support_point_cache)
+  , clear_signal(mapping.clear_signal)
+{}
+
+
+
+template <int dim, int spacedim>
+MappingQCache<dim, spacedim>::~MappingQCache() = default;
+
+
+
+template <int dim, int spacedim>
+std::unique_ptr<Mapping<dim, spacedim>>
+MappingQCache<dim, spacedim>::clone() const
+{
+  return std_cxx14::make_unique<MappingQCache<dim, spacedim>>(*this);
+}
+
+
+
+template <int dim, int spacedim>
+bool
+MappingQCache<dim, spacedim>::preserves_vertex_locations() const
+{
+  return false;
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQCache<dim, spacedim>::initialize(
+  const Triangulation<dim, spacedim> &  triangulation,
+  const MappingQGeneric<dim, spacedim> &mapping)
+{
+  AssertDimension(this->get_degree(), mapping.get_degree());
+  initialize(
+    triangulation,
+    [&mapping](
+      const typename Triangulation<dim, spacedim>::cell_iterator &cell) {
+      return mapping.compute_mapping_support_points(cell);
+    });
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQCache<dim, spacedim>::initialize(
+  const Triangulation<dim, spacedim> &triangulation,
+  const std::function<std::vector<Point<spacedim>>(
+    const typename Triangulation<dim, spacedim>::cell_iterator &)>
+    &compute_points_on_cell)
+{
+  // start from a new cache in order not to modify the points seen by
+  // copies of this object set up for another triangulation. the connection
+  // of the old cache stays with these copies
+  clear_signal.reset();
+  support_point_cache =
+    std::make_shared<std::vector<std::vector<Point<spacedim>>>>(
+      triangulation.n_levels());
+  for (unsigned int level = 0; level < triangulation.n_levels(); ++level)
+    (*support_point_cache)[level].resize(triangulation.n_raw_cells(level) *
+                                         n_points_per_cell);
+
+  // the cells only write into their own part of the cache, so no copier is
+  // needed
+  WorkStream::run(
+    triangulation.begin(),
+    triangulation.end(),
+    [&](const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+        void *,
+        void *) {
+      if (cell->active() && cell->is_artificial())
+        return;
+      const std::vector<Point<spacedim>> points = compute_points_on_cell(cell);
+      AssertDimension(points.size(), n_points_per_cell);
+      std::copy(points.begin(),
+                points.end(),
+                (*support_point_cache)[cell->level()].begin() +
+                  cell->index() * n_points_per_cell);
+    },
+    std::function<void(void *)>(),
+    /* scratch_data = */ nullptr,
+    /* copy_data = */ nullptr,
+    2 * MultithreadInfo::n_threads(),
+    /* chunk_size = */ 1);
+
+  // clear the cache when the triangulation changes. capture the cache by
+  // value rather than this object, so that copies sharing the cache see
+  // the change as well
+  const auto cache = support_point_cache;
+  clear_signal = std::make_shared<boost::signals2::scoped_connection>(
+    triangulation.signals.any_change.connect([cache]() { cache->clear(); }));
+}
+
+
+
+template <int dim, int spacedim>
+template <typename VectorType>
+void
+MappingQCache<dim, spacedim>::initialize(
+  const MappingQGeneric<dim, spacedim> &mapping,
+  const DoFHandler<dim, spacedim> &     dof_handler,
+  const VectorType &                    vector)
+{
+  AssertDimension(this->get_degree(), mapping.get_degree());
+  const FiniteElement<dim, spacedim> &fe = dof_handler.get_fe();
+  Assert(fe.n_components() >= spacedim,
+         ExcDimensionMismatch(fe.n_components(), spacedim));
+  AssertDimension(vector.size(), dof_handler.n_dofs());
+
+  // the support points of the mapping on the unit cell, in the order used by
+  // MappingQGeneric::compute_mapping_support_points(), i.e., the hierarchic
+  // numbering of FE_Q. The quadrature points of FEValues with this formula
+  // are the support points of the undeformed configuration.
+  const QGaussLobatto<dim> points_lexicographic(this->get_degree() + 1);
+  std::vector<unsigned int> renumber(points_lexicographic.size());
+  {
+    std::vector<unsigned int> dpo(dim + 1, 1U);
+    for (unsigned int i = 1; i < dpo.size(); ++i)
+      dpo[i] = dpo[i - 1] * (this->get_degree() - 1);
+    FETools::lexicographic_to_hierarchic_numbering(
+      FiniteElementData<dim>(dpo, 1, this->get_degree()), renumber);
+  }
+  std::vector<Point<dim>> unit_points(points_lexicographic.size());
+  for (unsigned int q = 0; q < unit_points.size(); ++q)
+    unit_points[renumber[q]] = points_lexicographic.point(q);
+  const Quadrature<dim> support_quadrature(unit_points);
+
+  Threads::ThreadLocalStorage<std::unique_ptr<FEValues<dim, spacedim>>>
+    fe_values_storage;
+
+  initialize(
+    dof_handler.get_triangulation(),
+    [&](const typename Triangulation<dim, spacedim>::cell_iterator &cell) {
+      if (cell->active() == false)
+        return mapping.compute_mapping_support_points(cell);
+
+      std::unique_ptr<FEValues<dim, spacedim>> &fe_values =
+        fe_values_storage.get();
+      if (fe_values.get() == nullptr)
+        fe_values = std_cxx14::make_unique<FEValues<dim, spacedim>>(
+          mapping,
+          fe,
+          support_quadrature,
+          update_values | update_quadrature_points);
+
+      const typename DoFHandler<dim, spacedim>::cell_iterator dof_cell(
+        *cell, &dof_handler);
+      fe_values->reinit(dof_cell);
+
+      std::vector<Vector<typename VectorType::value_type>> shift_vector(
+        support_quadrature.size(),
+        Vector<typename VectorType::value_type>(fe.n_components()));
+      fe_values->get_function_values(vector, shift_vector);
+
+      std::vector<Point<spacedim>> points(support_quadrature.size());
+      for (unsigned int q = 0; q < points.size(); ++q)
+        {
+          points[q] = fe_values->quadrature_point(q);
+          for (unsigned int d = 0; d < spacedim; ++d)
+            points[q][d] += shift_vector[q](d);
+        }
+      return points;
+    });
+}
+
+
+
+template <int dim, int spacedim>
+std::vector<Point<spacedim>>
+MappingQCache<dim, spacedim>::compute_mapping_support_points(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell) const
+{
+  Assert(support_point_cache.get() != nullptr &&
+           support_point_cache->empty() == false,
+         ExcMessage("Must call MappingQCache::initialize() before "
+                    "using the mapping, and again after the triangulation "
+                    "has changed."));
+  AssertIndexRange(cell->level(), support_point_cache->size());
+  AssertIndexRange((cell->index() + 1) * n_points_per_cell,
+                   (*support_point_cache)[cell->level()].size() + 1);
+  Assert(cell->active() == false || cell->is_artificial() == false,
+         ExcMessage("The support points of artificial cells are not "
+                    "available."));
+
+  const auto begin = (*support_point_cache)[cell->level()].begin() +
+                     cell->index() * n_points_per_cell;
+  return std::vector<Point<spacedim>>(begin, begin + n_points_per_cell);
+}
+
+
+
+template <int dim, int spacedim>
+std::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+MappingQCache<dim, spacedim>::get_vertices(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell) const
+{
+  Assert(support_point_cache.get() != nullptr &&
+           support_point_cache->empty() == false,
+         ExcMessage("Must call MappingQCache::initialize() before "
+                    "using the mapping, and again after the triangulation "
+                    "has changed."));
+  AssertIndexRange(cell->level(), support_point_cache->size());
+  AssertIndexRange((cell->index() + 1) * n_points_per_cell,
+                   (*support_point_cache)[cell->level()].size() + 1);
+
+  // the vertices are the first support points
+  std::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell> vertices;
+  std::copy((*support_point_cache)[cell->level()].begin() +
+              cell->index() * n_points_per_cell,
+            (*support_point_cache)[cell->level()].begin() +
+              cell->index() * n_points_per_cell +
+              GeometryInfo<dim>::vertices_per_cell,
+            vertices.begin());
+  return vertices;
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+MappingQCache<dim, spacedim>::memory_consumption() const
+{
+  if (support_point_cache.get() != nullptr)
+    return sizeof(*this) +
+           MemoryConsumption::memory_consumption(*support_point_cache);
+  else
+    return sizeof(*this);
+}
+
+
+
+// explicit instantiations
+#include "mapping_q_cache.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/array_view.h>
 #include <deal.II/base/derivative_form.h>
 #include <deal.II/base/memory_consumption.h>
@@ -23,6 +24,7 @@
 #include <deal.II/base/std_cxx14/memory.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/tensor_product_polynomials.h>
+#include <deal.II/base/vectorization.h>
 
 #include <deal.II/fe/fe_base.h>
 #include <deal.II/fe/fe_tools.h>
@@ -45,6 +47,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <numeric>
 
@@ -1507,6 +1510,370 @@ namespace internal
         return p_unit;
       }
 
+
+
+      /**
+       * Evaluate the polynomial mapping defined by the @p support_points in
+       * lexicographic ordering at the reference coordinates @p p_unit, which
+       * contain several points in the lanes of a VectorizedArray, and return
+       * the mapped points and the Jacobians. The mapping is the tensor product
+       * of the 1d Lagrange polynomials in the points @p line_points, which
+       * are evaluated by the product formula with the precomputed weights
+       * <code>lagrange_weights[i*n+j] = 1/(x_i-x_j)</code>.
+       */
+      template <int dim>
+      void
+      evaluate_lexicographic_mapping(
+        const std::vector<Point<dim>> &            support_points,
+        const std::vector<double> &                line_points,
+        const std::vector<double> &                lagrange_weights,
+        const Point<dim, VectorizedArray<double>> &p_unit,
+        AlignedVector<VectorizedArray<double>> &   shape_data,
+        Point<dim, VectorizedArray<double>> &      p_real,
+        Tensor<2, dim, VectorizedArray<double>> &  jacobian)
+      {
+        const unsigned int n = line_points.size();
+        AssertDimension(support_points.size(), Utilities::fixed_power<dim>(n));
+        shape_data.resize_fast(2 * dim * n);
+
+        // values and first derivatives of the 1d polynomials in all
+        // coordinate directions
+        for (unsigned int d = 0; d < dim; ++d)
+          for (unsigned int i = 0; i < n; ++i)
+            {
+              const double *          weights    = &lagrange_weights[i * n];
+              VectorizedArray<double> value      = make_vectorized_array(1.);
+              VectorizedArray<double> derivative = VectorizedArray<double>();
+              for (unsigned int j = 0; j < n; ++j)
+                if (j != i)
+                  {
+                    const VectorizedArray<double> factor =
+                      (p_unit[d] - line_points[j]) * weights[j];
+                    derivative = derivative * factor + value * weights[j];
+                    value *= factor;
+                  }
+              shape_data[2 * d * n + i]       = value;
+              shape_data[(2 * d + 1) * n + i] = derivative;
+            }
+
+        // sum factorization over the three coordinate directions, where
+        // directions beyond dim have a single entry with value one
+        const VectorizedArray<double> *values_0      = &shape_data[0];
+        const VectorizedArray<double> *derivatives_0 = &shape_data[n];
+        const VectorizedArray<double> *values_1 =
+          dim > 1 ? &shape_data[2 * n] : nullptr;
+        const VectorizedArray<double> *derivatives_1 =
+          dim > 1 ? &shape_data[3 * n] : nullptr;
+        const VectorizedArray<double> *values_2 =
+          dim > 2 ? &shape_data[4 * n] : nullptr;
+        const VectorizedArray<double> *derivatives_2 =
+          dim > 2 ? &shape_data[5 * n] : nullptr;
+
+        p_real   = Point<dim, VectorizedArray<double>>();
+        jacobian = Tensor<2, dim, VectorizedArray<double>>();
+        for (unsigned int i2 = 0, c = 0; i2 < (dim > 2 ? n : 1); ++i2)
+          {
+            // sums over the first two directions: the value, and the
+            // derivatives in the first and second direction
+            Tensor<1, dim, VectorizedArray<double>> sum_1[3];
+            for (unsigned int i1 = 0; i1 < (dim > 1 ? n : 1); ++i1)
+              {
+                Tensor<1, dim, VectorizedArray<double>> sum_0[2];
+                for (unsigned int i0 = 0; i0 < n; ++i0, ++c)
+                  for (unsigned int d = 0; d < dim; ++d)
+                    {
+                      sum_0[0][d] += support_points[c][d] * values_0[i0];
+                      sum_0[1][d] += support_points[c][d] * derivatives_0[i0];
+                    }
+                if (dim > 1)
+                  for (unsigned int d = 0; d < dim; ++d)
+                    {
+                      sum_1[0][d] += sum_0[0][d] * values_1[i1];
+                      sum_1[1][d] += sum_0[1][d] * values_1[i1];
+                      sum_1[2][d] += sum_0[0][d] * derivatives_1[i1];
+                    }
+                else
+                  {
+                    sum_1[0] = sum_0[0];
+                    sum_1[1] = sum_0[1];
+                  }
+              }
+            for (unsigned int d = 0; d < dim; ++d)
+              if (dim > 2)
+                {
+                  p_real[d] += sum_1[0][d] * values_2[i2];
+                  jacobian[d][0] += sum_1[1][d] * values_2[i2];
+                  jacobian[d][1] += sum_1[2][d] * values_2[i2];
+                  jacobian[d][dim - 1] += sum_1[0][d] * derivatives_2[i2];
+                }
+              else
+                {
+                  p_real[d] += sum_1[0][d];
+                  jacobian[d][0] += sum_1[1][d];
+                  if (dim > 1)
+                    jacobian[d][dim - 1] += sum_1[2][d];
+                }
+          }
+      }
+
+
+
+      /**
+       * Return the Euclidean norm of the entries of @p tensor in lane @p v.
+       */
+      template <int dim>
+      double
+      lane_norm(const Tensor<1, dim, VectorizedArray<double>> &tensor,
+                const unsigned int                             v)
+      {
+        double norm_square = 0;
+        for (unsigned int d = 0; d < dim; ++d)
+          norm_square += tensor[d][v] * tensor[d][v];
+        return std::sqrt(norm_square);
+      }
+
+
+
+      /**
+       * Implementation of transform_points_real_to_unit_cell for
+       * dim==spacedim. This function runs the same Newton iteration with line
+       * search as do_transform_real_to_unit_cell_internal(), but for as many
+       * points at once as there are lanes in VectorizedArray<double>. The
+       * support points of the mapping are passed in hierarchic ordering and
+       * are evaluated by sum factorization rather than through the
+       * InternalData object. Points for which the iteration fails get an
+       * infinite first coordinate.
+       */
+      template <int dim>
+      void
+      do_transform_points_real_to_unit_cell(
+        const std::vector<Point<dim>> &    support_points,
+        const std::vector<unsigned int> &  renumber,
+        const std::vector<Point<1>> &      line_support_points,
+        const double                       cell_diameter,
+        const ArrayView<const Point<dim>> &real_points,
+        const ArrayView<Point<dim>> &      unit_points)
+      {
+        const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+        const unsigned int n       = line_support_points.size();
+
+        std::vector<Point<dim>> lexicographic_points(support_points.size());
+        for (unsigned int i = 0; i < support_points.size(); ++i)
+          lexicographic_points[i] = support_points[renumber[i]];
+
+        std::vector<double> line_points(n), lagrange_weights(n * n);
+        for (unsigned int i = 0; i < n; ++i)
+          line_points[i] = line_support_points[i][0];
+        for (unsigned int i = 0; i < n; ++i)
+          for (unsigned int j = 0; j < n; ++j)
+            if (j != i)
+              lagrange_weights[i * n + j] =
+                1. / (line_points[i] - line_points[j]);
+
+        // the initial guess is the least-squares fit of an affine map to the
+        // vertices, x = A (x_unit - 1/2) + center, like in
+        // TriaAccessor::real_to_unit_cell_affine_approximation(), but
+        // computed only once for all points
+        const unsigned int n_vertices = GeometryInfo<dim>::vertices_per_cell;
+        Tensor<2, dim>     affine_matrix;
+        Point<dim>         center;
+        Point<dim>         unit_center;
+        for (unsigned int v = 0; v < n_vertices; ++v)
+          {
+            const Point<dim> unit_vertex =
+              GeometryInfo<dim>::unit_cell_vertex(v);
+            for (unsigned int d = 0; d < dim; ++d)
+              for (unsigned int e = 0; e < dim; ++e)
+                affine_matrix[d][e] += support_points[v][d] *
+                                       (unit_vertex[e] - 0.5) * 4. /
+                                       n_vertices;
+            center += support_points[v] / n_vertices;
+          }
+        for (unsigned int d = 0; d < dim; ++d)
+          unit_center[d] = 0.5;
+        const Tensor<2, dim> affine_inverse = invert(affine_matrix);
+
+        const double       eps                    = 1.e-11;
+        const unsigned int newton_iteration_limit = 20;
+
+        // the state of the points in the lanes of the current batch
+        enum class Status
+        {
+          iterating,
+          converged,
+          failed
+        };
+        Status status[n_lanes];
+        bool   searching[n_lanes];
+
+        AlignedVector<VectorizedArray<double>> shape_data;
+        for (unsigned int offset = 0; offset < real_points.size();
+             offset += n_lanes)
+          {
+            const unsigned int n_points =
+              std::min<unsigned int>(n_lanes, real_points.size() - offset);
+
+            // fill unused lanes with the last point of the batch
+            Point<dim, VectorizedArray<double>> p, p_unit;
+            for (unsigned int v = 0; v < n_lanes; ++v)
+              {
+                const Point<dim> &point =
+                  real_points[offset + std::min(v, n_points - 1)];
+                const Point<dim> initial_p_unit =
+                  GeometryInfo<dim>::project_to_unit_cell(
+                    unit_center + affine_inverse * (point - center));
+                for (unsigned int d = 0; d < dim; ++d)
+                  {
+                    p[d][v]      = point[d];
+                    p_unit[d][v] = initial_p_unit[d];
+                  }
+              }
+
+            Point<dim, VectorizedArray<double>>     p_real;
+            Tensor<2, dim, VectorizedArray<double>> df;
+            evaluate_lexicographic_mapping(lexicographic_points,
+                                           line_points,
+                                           lagrange_weights,
+                                           p_unit,
+                                           shape_data,
+                                           p_real,
+                                           df);
+            Tensor<1, dim, VectorizedArray<double>> f = p_real - p;
+
+            // early out for points that are already at the right place
+            bool any_iterating = false;
+            for (unsigned int v = 0; v < n_lanes; ++v)
+              {
+                const double norm = lane_norm(f, v);
+                if (v < n_points && norm * norm >= 1e-24 * cell_diameter *
+                                                     cell_diameter)
+                  {
+                    status[v]     = Status::iterating;
+                    any_iterating = true;
+                  }
+                else
+                  status[v] = Status::converged;
+              }
+
+            for (unsigned int newton_iteration = 0; any_iterating;)
+              {
+                // solve [f'(x)]d=f(x) in all lanes, with an identity matrix
+                // in the lanes that are not iterating any more in order to
+                // not divide by zero
+                Tensor<2, dim, VectorizedArray<double>> df_safe = df;
+                const VectorizedArray<double> det = determinant(df);
+                for (unsigned int v = 0; v < n_lanes; ++v)
+                  {
+                    if (status[v] == Status::iterating && !(det[v] > 0))
+                      status[v] = Status::failed;
+                    if (status[v] != Status::iterating)
+                      for (unsigned int d = 0; d < dim; ++d)
+                        for (unsigned int e = 0; e < dim; ++e)
+                          df_safe[d][e][v] = (d == e) ? 1. : 0.;
+                    searching[v] = (status[v] == Status::iterating);
+                  }
+                const Tensor<2, dim, VectorizedArray<double>> df_inverse =
+                  invert(df_safe);
+                const Tensor<1, dim, VectorizedArray<double>> delta =
+                  df_inverse * f;
+
+                // do a line search, halving the step length separately in
+                // each lane until the residual decreases
+                VectorizedArray<double> step_length = make_vectorized_array(1.);
+                for (bool any_searching = true; any_searching;)
+                  {
+                    Point<dim, VectorizedArray<double>> p_unit_trial = p_unit;
+                    for (unsigned int d = 0; d < dim; ++d)
+                      p_unit_trial[d] -= step_length * delta[d];
+
+                    Point<dim, VectorizedArray<double>>     p_real_trial;
+                    Tensor<2, dim, VectorizedArray<double>> df_trial;
+                    evaluate_lexicographic_mapping(lexicographic_points,
+                                                   line_points,
+                                                   lagrange_weights,
+                                                   p_unit_trial,
+                                                   shape_data,
+                                                   p_real_trial,
+                                                   df_trial);
+                    const Tensor<1, dim, VectorizedArray<double>> f_trial =
+                      p_real_trial - p;
+
+                    any_searching = false;
+                    for (unsigned int v = 0; v < n_lanes; ++v)
+                      if (searching[v])
+                        {
+                          if (lane_norm(f_trial, v) < lane_norm(f, v))
+                            {
+                              for (unsigned int d = 0; d < dim; ++d)
+                                {
+                                  p_unit[d][v] = p_unit_trial[d][v];
+                                  f[d][v]      = f_trial[d][v];
+                                  for (unsigned int e = 0; e < dim; ++e)
+                                    df[d][e][v] = df_trial[d][e][v];
+                                }
+                              searching[v] = false;
+                            }
+                          else if (step_length[v] > 0.05)
+                            {
+                              step_length[v] /= 2;
+                              any_searching = true;
+                            }
+                          else
+                            {
+                              status[v]    = Status::failed;
+                              searching[v] = false;
+                            }
+                        }
+                  }
+
+                ++newton_iteration;
+                const Tensor<1, dim, VectorizedArray<double>> f_weighted =
+                  df_inverse * f;
+                any_iterating = false;
+                for (unsigned int v = 0; v < n_lanes; ++v)
+                  if (status[v] == Status::iterating)
+                    {
+                      if (newton_iteration > newton_iteration_limit)
+                        status[v] = Status::failed;
+                      else if (lane_norm(f_weighted, v) <= eps)
+                        status[v] = Status::converged;
+                      else
+                        any_iterating = true;
+                    }
+              }
+
+            for (unsigned int v = 0; v < n_points; ++v)
+              if (status[v] == Status::converged)
+                for (unsigned int d = 0; d < dim; ++d)
+                  unit_points[offset + v][d] = p_unit[d][v];
+              else
+                {
+                  unit_points[offset + v]    = Point<dim>();
+                  unit_points[offset + v][0] =
+                    std::numeric_limits<double>::infinity();
+                }
+          }
+      }
+
+
+
+      /**
+       * The vectorized inverse mapping is only implemented for
+       * dim==spacedim, see the overload above.
+       */
+      template <int dim, int spacedim>
+      void
+      do_transform_points_real_to_unit_cell(
+        const std::vector<Point<spacedim>> &,
+        const std::vector<unsigned int> &,
+        const std::vector<Point<1>> &,
+        const double,
+        const ArrayView<const Point<spacedim>> &,
+        const ArrayView<Point<dim>> &)
+      {
+        Assert(false, ExcInternalError());
+      }
+
       /**
        * In case the quadrature formula is a tensor product, this is a
        * replacement for maybe_compute_q_points(), maybe_update_Jacobians() and
@@ -2265,6 +2632,12 @@ MappingQGeneric<dim, spacedim>::MappingQGeneric(const unsigned int p)
   , support_point_weights_cell(
       internal::MappingQGenericImplementation::
         compute_support_point_weights_cell<dim>(this->polynomial_degree))
+  , renumber_lexicographic_to_hierarchic(
+      FETools::lexicographic_to_hierarchic_numbering(FiniteElementData<dim>(
+        internal::MappingQGenericImplementation::get_dpo_vector<dim>(
+          this->polynomial_degree),
+        1,
+        this->polynomial_degree)))
 {
   Assert(p >= 1,
          ExcMessage("It only makes sense to create polynomial mappings "
@@ -2282,6 +2655,8 @@ MappingQGeneric<dim, spacedim>::MappingQGeneric(
   , support_point_weights_perimeter_to_interior(
       mapping.support_point_weights_perimeter_to_interior)
   , support_point_weights_cell(mapping.support_point_weights_cell)
+  , renumber_lexicographic_to_hierarchic(
+      mapping.renumber_lexicographic_to_hierarchic)
 {}
 
 
@@ -2658,6 +3033,38 @@ MappingQGeneric<dim, spacedim>::transform_real_to_unit_cell(
 
 
 
+template <int dim, int spacedim>
+void
+MappingQGeneric<dim, spacedim>::transform_points_real_to_unit_cell(
+  const typename Triangulation<dim, spacedim>::cell_iterator &cell,
+  const ArrayView<const Point<spacedim>> &                    real_points,
+  const ArrayView<Point<dim>> &                               unit_points) const
+{
+  AssertDimension(real_points.size(), unit_points.size());
+
+  // the vectorized Newton iteration is only implemented for dim==spacedim;
+  // use the function of the base class that maps one point at a time
+  // otherwise
+  if (dim != spacedim)
+    {
+      Mapping<dim, spacedim>::transform_points_real_to_unit_cell(cell,
+                                                                 real_points,
+                                                                 unit_points);
+      return;
+    }
+
+  internal::MappingQGenericImplementation::
+    do_transform_points_real_to_unit_cell<dim>(
+      this->compute_mapping_support_points(cell),
+      renumber_lexicographic_to_hierarchic,
+      line_support_points.get_points(),
+      cell->diameter(),
+      real_points,
+      unit_points);
+}
+
+
+
 template <int dim, int spacedim>
 UpdateFlags
 MappingQGeneric<dim, spacedim>::requires_update_flags(
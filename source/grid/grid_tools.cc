@@ -15,6 +15,7 @@
 
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/mpi.templates.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/thread_management.h>
 
@@ -56,8 +57,10 @@
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <list>
 #include <numeric>
@@ -4315,6 +4318,262 @@ namespace GridTools
 
 
 
+  namespace internal
+  {
+    namespace BatchedPointLocations
+    {
+      /**
+       * Return the position of the point @p p along a Morton (Z-order)
+       * space-filling curve through the box @p box, which is obtained by
+       * interleaving the bits of the integer coordinates of the point on a
+       * grid of 2^(63/spacedim) intervals per direction.
+       */
+      template <int spacedim>
+      std::uint64_t
+      morton_index(const Point<spacedim> &      p,
+                   const BoundingBox<spacedim> &box)
+      {
+        const unsigned int  n_bits = 63 / spacedim;
+        const std::uint64_t n_intervals = std::uint64_t(1) << n_bits;
+
+        std::uint64_t coordinates[spacedim];
+        for (unsigned int d = 0; d < spacedim; ++d)
+          {
+            const double lower  = box.get_boundary_points().first[d];
+            const double extent = box.get_boundary_points().second[d] - lower;
+            const double relative =
+              extent > 0 ? (p[d] - lower) / extent : 0.;
+            coordinates[d] = std::min<std::uint64_t>(
+              static_cast<std::uint64_t>(std::max(relative, 0.) * n_intervals),
+              n_intervals - 1);
+          }
+
+        std::uint64_t index = 0;
+        for (unsigned int b = 0; b < n_bits; ++b)
+          for (unsigned int d = 0; d < spacedim; ++d)
+            index |= ((coordinates[d] >> b) & 1) << (b * spacedim + d);
+        return index;
+      }
+
+
+
+      /**
+       * Return whether the point @p p lies in the box @p box enlarged by
+       * @p tolerance times its extent in each direction.
+       */
+      template <int spacedim>
+      bool
+      point_inside_enlarged_box(const Point<spacedim> &      p,
+                                const BoundingBox<spacedim> &box,
+                                const double                 tolerance)
+      {
+        const auto &corners = box.get_boundary_points();
+        for (unsigned int d = 0; d < spacedim; ++d)
+          {
+            const double margin =
+              tolerance * (corners.second[d] - corners.first[d]);
+            if (p[d] < corners.first[d] - margin ||
+                p[d] > corners.second[d] + margin)
+              return false;
+          }
+        return true;
+      }
+
+
+
+      /**
+       * A point found in a cell, as collected by the chunks of
+       * compute_point_locations_batched() before they are sorted by cell.
+       */
+      template <int dim, int spacedim>
+      struct FoundPoint
+      {
+        /**
+         * The cell the point lies in.
+         */
+        typename Triangulation<dim, spacedim>::active_cell_iterator cell;
+
+        /**
+         * The index of the point in the vector of all points.
+         */
+        unsigned int point_index;
+
+        /**
+         * The coordinates of the point on the reference cell.
+         */
+        Point<dim> reference_point;
+      };
+    } // namespace BatchedPointLocations
+  }   // namespace internal
+
+
+
+  template <int dim, int spacedim>
+  PointLocations<dim, spacedim>
+  compute_point_locations_batched(
+    const Cache<dim, spacedim> &        cache,
+    const std::vector<Point<spacedim>> &points,
+    const double                        tolerance,
+    const std::function<bool(
+      const typename Triangulation<dim, spacedim>::active_cell_iterator &)>
+      &predicate)
+  {
+    using namespace internal::BatchedPointLocations;
+    using CellIterator =
+      typename Triangulation<dim, spacedim>::active_cell_iterator;
+
+    PointLocations<dim, spacedim> result;
+    result.cell_ptrs.push_back(0);
+    if (points.empty())
+      return result;
+
+    // sort the points along a space-filling curve so that chunks of
+    // consecutive points are close to each other
+    BoundingBox<spacedim> point_box(std::make_pair(points[0], points[0]));
+    for (const auto &p : points)
+      point_box.merge_with(BoundingBox<spacedim>(std::make_pair(p, p)));
+    std::vector<std::pair<std::uint64_t, unsigned int>> sorted_points(
+      points.size());
+    for (unsigned int i = 0; i < points.size(); ++i)
+      sorted_points[i] = std::make_pair(morton_index(points[i], point_box), i);
+    std::sort(sorted_points.begin(), sorted_points.end());
+
+    // the R-tree and the bounding boxes are computed by the cache on first
+    // access, which must not happen concurrently
+    const auto &rtree = cache.get_cell_bounding_boxes_rtree();
+    const Mapping<dim, spacedim> &mapping = cache.get_mapping();
+
+    const unsigned int chunk_size = 64;
+    const unsigned int n_chunks =
+      (points.size() + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<FoundPoint<dim, spacedim>>> found_points(n_chunks);
+    std::vector<std::vector<unsigned int>> missing_points(n_chunks);
+
+    const auto locate_chunks = [&](const unsigned int begin,
+                                   const unsigned int end) {
+      std::vector<std::pair<BoundingBox<spacedim>, CellIterator>> candidates;
+      std::vector<unsigned int>    chunk_points, cell_points;
+      std::vector<bool>            found;
+      std::vector<Point<spacedim>> real_points;
+      std::vector<Point<dim>>      unit_points;
+      for (unsigned int chunk = begin; chunk < end; ++chunk)
+        {
+          chunk_points.clear();
+          for (unsigned int i = chunk * chunk_size;
+               i < std::min<std::size_t>((chunk + 1) * chunk_size,
+                                         points.size());
+               ++i)
+            chunk_points.push_back(sorted_points[i].second);
+          found.assign(chunk_points.size(), false);
+
+          // all points of the chunk share the candidate cells whose
+          // bounding boxes intersect the bounding box of the chunk, in the
+          // order of the active cell index
+          BoundingBox<spacedim> chunk_box(
+            std::make_pair(points[chunk_points[0]], points[chunk_points[0]]));
+          for (const unsigned int i : chunk_points)
+            chunk_box.merge_with(
+              BoundingBox<spacedim>(std::make_pair(points[i], points[i])));
+          candidates.clear();
+          rtree.query(boost::geometry::index::intersects(chunk_box),
+                      std::back_inserter(candidates));
+          std::sort(candidates.begin(),
+                    candidates.end(),
+                    [](const typename decltype(candidates)::value_type &a,
+                       const typename decltype(candidates)::value_type &b) {
+                      return a.second->active_cell_index() <
+                             b.second->active_cell_index();
+                    });
+
+          for (const auto &candidate : candidates)
+            {
+              if (predicate && !predicate(candidate.second))
+                continue;
+
+              cell_points.clear();
+              real_points.clear();
+              for (unsigned int i = 0; i < chunk_points.size(); ++i)
+                if (found[i] == false &&
+                    point_inside_enlarged_box(points[chunk_points[i]],
+                                              candidate.first,
+                                              tolerance))
+                  {
+                    cell_points.push_back(i);
+                    real_points.push_back(points[chunk_points[i]]);
+                  }
+              if (cell_points.empty())
+                continue;
+
+              unit_points.resize(real_points.size());
+              mapping.transform_points_real_to_unit_cell(
+                candidate.second,
+                make_array_view(real_points),
+                make_array_view(unit_points));
+              for (unsigned int j = 0; j < cell_points.size(); ++j)
+                if (unit_points[j][0] !=
+                      std::numeric_limits<double>::infinity() &&
+                    GeometryInfo<dim>::is_inside_unit_cell(unit_points[j],
+                                                           tolerance))
+                  {
+                    found[cell_points[j]] = true;
+                    found_points[chunk].push_back(
+                      {candidate.second,
+                       chunk_points[cell_points[j]],
+                       unit_points[j]});
+                  }
+            }
+
+          for (unsigned int i = 0; i < chunk_points.size(); ++i)
+            if (found[i] == false)
+              missing_points[chunk].push_back(chunk_points[i]);
+        }
+    };
+    parallel::apply_to_subranges(0U, n_chunks, locate_chunks, 1);
+
+    // collect the points of all chunks and sort them by cell
+    std::vector<FoundPoint<dim, spacedim>> all_points;
+    all_points.reserve(points.size());
+    for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+      {
+        all_points.insert(all_points.end(),
+                          found_points[chunk].begin(),
+                          found_points[chunk].end());
+        result.missing_points.insert(result.missing_points.end(),
+                                     missing_points[chunk].begin(),
+                                     missing_points[chunk].end());
+      }
+    std::sort(result.missing_points.begin(), result.missing_points.end());
+    std::sort(all_points.begin(),
+              all_points.end(),
+              [](const FoundPoint<dim, spacedim> &a,
+                 const FoundPoint<dim, spacedim> &b) {
+                return std::make_pair(a.cell->active_cell_index(),
+                                      a.point_index) <
+                       std::make_pair(b.cell->active_cell_index(),
+                                      b.point_index);
+              });
+
+    result.reference_points.reserve(all_points.size());
+    result.point_indices.reserve(all_points.size());
+    for (unsigned int i = 0; i < all_points.size(); ++i)
+      {
+        if (i > 0 && all_points[i].cell != all_points[i - 1].cell)
+          result.cell_ptrs.push_back(i);
+        if (i == 0 || all_points[i].cell != all_points[i - 1].cell)
+          result.cells.push_back(all_points[i].cell);
+        result.reference_points.push_back(all_points[i].reference_point);
+        result.point_indices.push_back(all_points[i].point_index);
+      }
+    // cell_ptrs already holds the zero entry that is needed when no point
+    // was found in any cell
+    if (result.cells.empty() == false)
+      result.cell_ptrs.push_back(all_points.size());
+
+    return result;
+  }
+
+
+
   namespace internal
   {
     // Functions are needed for distributed compute point locations
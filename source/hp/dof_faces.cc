@@ -29,8 +29,10 @@ namespace internal
     std::size_t
     DoFIndicesOnFacesOrEdges<structdim>::memory_consumption() const
     {
-      return (MemoryConsumption::memory_consumption(dofs) +
-              MemoryConsumption::memory_consumption(dof_offsets));
+      return (MemoryConsumption::memory_consumption(fe_offsets) +
+              MemoryConsumption::memory_consumption(active_fe_indices) +
+              MemoryConsumption::memory_consumption(dof_offsets) +
+              MemoryConsumption::memory_consumption(dofs));
     }
 
 
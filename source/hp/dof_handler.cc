@@ -39,6 +39,7 @@
 #include <boost/serialization/array.hpp>
 
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <set>
 
@@ -333,6 +334,28 @@ namespace internal
 
 
 
+        /**
+         * Return the object that stores the DoF indices on faces, i.e., on
+         * lines in 2d and on quads in 3d.
+         */
+        template <int spacedim>
+        static dealii::internal::hp::DoFIndicesOnFacesOrEdges<1> &
+        get_face_dof_indices(DoFHandler<2, spacedim> &dof_handler)
+        {
+          return dof_handler.faces->lines;
+        }
+
+
+
+        template <int spacedim>
+        static dealii::internal::hp::DoFIndicesOnFacesOrEdges<2> &
+        get_face_dof_indices(DoFHandler<3, spacedim> &dof_handler)
+        {
+          return dof_handler.faces->quads;
+        }
+
+
+
         /**
          * Do that part of reserving space that pertains to faces,
          * since this is the same in all space dimensions.
@@ -342,316 +365,113 @@ namespace internal
         reserve_space_faces(DoFHandler<dim, spacedim> &dof_handler)
         {
           // make the code generic between lines and quads
-          std::vector<unsigned int> &face_dof_offsets =
-            (dim == 2 ?
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<2> &>(
-                 *dof_handler.faces)
-                 .lines.dof_offsets :
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<3> &>(
-                 *dof_handler.faces)
-                 .quads.dof_offsets);
-
-          std::vector<types::global_dof_index> &face_dof_indices =
-            (dim == 2 ?
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<2> &>(
-                 *dof_handler.faces)
-                 .lines.dofs :
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<3> &>(
-                 *dof_handler.faces)
-                 .quads.dofs);
+          dealii::internal::hp::DoFIndicesOnFacesOrEdges<dim - 1> &face_dofs =
+            get_face_dof_indices(dof_handler);
 
           // FACE DOFS
           //
-          // Count face dofs, then allocate as much space
-          // as we need and prime the linked list for faces (see the
-          // description in hp::DoFLevel) with the indices we will
-          // need. Note that our task is more complicated than for the
-          // cell case above since two adjacent cells may have different
-          // active_fe_indices, in which case we need to allocate
-          // *two* sets of face dofs for the same face. But they don't
-          // *have* to be different, and so we need to prepare for this
+          // Determine the active_fe_indices that live on each face, then
+          // set up the compressed row storage for faces (see the
+          // description in hp::DoFIndicesOnFacesOrEdges) and allocate as
+          // much space as we need for the DoF indices. Note that our task is
+          // more complicated than for the cell case above since two adjacent
+          // cells may have different active_fe_indices, in which case we need
+          // to allocate *two* sets of face dofs for the same face. But they
+          // don't *have* to be different, and so we need to prepare for this
           // as well.
           //
           // The way we do things is that we loop over all active
           // cells (these are the only ones that have DoFs
-          // anyway) and all their faces. We note in the
-          // user flags whether we have previously visited a face and
-          // if so skip it (consequently, we have to save and later
-          // restore the face flags)
-          {
-            std::vector<bool> saved_face_user_flags;
-            switch (dim)
-              {
-                case 2:
-                  {
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .save_user_flags_line(saved_face_user_flags);
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .clear_user_flags_line();
-
-                    break;
-                  }
-
-                case 3:
-                  {
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .save_user_flags_quad(saved_face_user_flags);
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .clear_user_flags_quad();
-
-                    break;
-                  }
-
-                default:
-                  Assert(false, ExcNotImplemented());
-              }
-
-            // An array to hold how many slots (see the hp::DoFLevel
-            // class) we will have to store on each level
-            unsigned int n_face_slots = 0;
-
-            for (const auto &cell : dof_handler.active_cell_iterators())
-              if (!cell->is_artificial())
-                for (unsigned int face = 0;
-                     face < GeometryInfo<dim>::faces_per_cell;
-                     ++face)
-                  if (cell->face(face)->user_flag_set() == false)
-                    {
-                      // Ok, face has not been visited. So we need to
-                      // allocate space for it. Let's see how much we
-                      // need: we need one set if a) there is no
-                      // neighbor behind this face, or b) the neighbor
-                      // is either coarser or finer than we are, or c)
-                      // the neighbor is artificial, or d) the neighbor
-                      // is neither coarser nor finer, nor is artificial,
-                      // and just so happens to have the same active_fe_index :
-                      if (cell->at_boundary(face) ||
-                          cell->face(face)->has_children() ||
-                          cell->neighbor_is_coarser(face) ||
-                          (!cell->at_boundary(face) &&
-                           cell->neighbor(face)->is_artificial()) ||
-                          (!cell->at_boundary(face) &&
-                           !cell->neighbor(face)->is_artificial() &&
-                           (cell->active_fe_index() ==
-                            cell->neighbor(face)->active_fe_index())))
-                        // Ok, one set of dofs. that makes one active_fe_index,
-                        // 1 times dofs_per_face dofs, and one stop index
-                        n_face_slots +=
-                          1 +
-                          dof_handler.get_fe(cell->active_fe_index())
-                            .template n_dofs_per_object<dim - 1>() +
-                          1;
-
-                      // Otherwise we do indeed need two sets, i.e. two
-                      // active_fe_indices, two sets of dofs, and one stop
-                      // index:
-                      else
-                        n_face_slots +=
-                          (1 + // the active_fe_index
-                           dof_handler.get_fe(cell->active_fe_index())
-                             .template n_dofs_per_object<
-                               dim - 1>() // actual DoF indices
-                           + 1            // the second active_fe_index
-                           + dof_handler
-                               .get_fe(cell->neighbor(face)->active_fe_index())
-                               .template n_dofs_per_object<
-                                 dim - 1>() // actual DoF indices
-                           + 1);            // stop marker
-
-                      // mark this face as visited
-                      cell->face(face)->set_user_flag();
-                    }
-
-            // Now that we know how many face dofs we will have to
-            // have, allocate the memory. Note that we
-            // allocate offsets for all faces, though only the active
-            // ones will have a non-invalid value later on
-            face_dof_offsets =
-              std::vector<unsigned int>(dof_handler.tria->n_raw_faces(),
-                                        numbers::invalid_unsigned_int);
-            face_dof_indices =
-              std::vector<types::global_dof_index>(n_face_slots,
-                                                   numbers::invalid_dof_index);
-
-            // With the memory now allocated, loop over the
-            // dof_handler cells again and prime the _offset values as
-            // well as the fe_index fields
-            switch (dim)
-              {
-                case 2:
-                  {
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .clear_user_flags_line();
-
-                    break;
-                  }
-
-                case 3:
-                  {
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .clear_user_flags_quad();
-
-                    break;
-                  }
-
-                default:
-                  Assert(false, ExcNotImplemented());
-              }
-
-            unsigned int next_free_face_slot = 0;
-
-            for (const auto &cell : dof_handler.active_cell_iterators())
-              if (!cell->is_artificial())
-                for (unsigned int face = 0;
-                     face < GeometryInfo<dim>::faces_per_cell;
-                     ++face)
-                  if (!cell->face(face)->user_flag_set())
+          // anyway) and all their faces, and record the (at most two)
+          // active_fe_indices of each face the first time we visit it.
+          const unsigned int n_raw_faces = dof_handler.tria->n_raw_faces();
+          std::vector<std::array<unsigned int, 2>> face_fe_indices(
+            n_raw_faces,
+            {{numbers::invalid_unsigned_int, numbers::invalid_unsigned_int}});
+
+          for (const auto &cell : dof_handler.active_cell_iterators())
+            if (!cell->is_artificial())
+              for (unsigned int face = 0;
+                   face < GeometryInfo<dim>::faces_per_cell;
+                   ++face)
+                {
+                  std::array<unsigned int, 2> &fe_indices =
+                    face_fe_indices[cell->face(face)->index()];
+                  if (fe_indices[0] != numbers::invalid_unsigned_int)
+                    continue;
+
+                  // Ok, face has not been visited. Let's see how many
+                  // sets of dofs we need: we need one set if a) there is no
+                  // neighbor behind this face, or b) the neighbor
+                  // is either coarser or finer than we are, or c)
+                  // the neighbor is artificial, or d) the neighbor
+                  // is neither coarser nor finer, nor is artificial,
+                  // and just so happens to have the same active_fe_index :
+                  if (cell->at_boundary(face) ||
+                      cell->face(face)->has_children() ||
+                      cell->neighbor_is_coarser(face) ||
+                      (!cell->at_boundary(face) &&
+                       cell->neighbor(face)->is_artificial()) ||
+                      (!cell->at_boundary(face) &&
+                       !cell->neighbor(face)->is_artificial() &&
+                       (cell->active_fe_index() ==
+                        cell->neighbor(face)->active_fe_index())))
+                    fe_indices[0] = cell->active_fe_index();
+
+                  // Otherwise we do indeed need two sets. We sort the two
+                  // indices so that it does not matter which of the cells
+                  // adjacent to this face we visit first. In sequential
+                  // computations, this does not matter because the order in
+                  // which we visit these cells is deterministic and always
+                  // the same. But in parallel computations, we can get into
+                  // trouble because two processors visit the cells in
+                  // different order (because the mesh creation history on
+                  // the two processors is different), and in that case it
+                  // can happen that the order of active_fe_index values for
+                  // a given face is different on the two processes, even
+                  // though they agree on which two values need to be
+                  // stored. Since the DoF unification on faces takes into
+                  // account the order of the active_fe_indices, this leads
+                  // to quite subtle bugs. We could fix this in the place
+                  // where we do the DoF unification on cells, but it is
+                  // better to just make sure that every process stores the
+                  // exact same information (and in the same order) on each
+                  // face.
+                  else
                     {
-                      // Same decision tree as before
-                      if (cell->at_boundary(face) ||
-                          cell->face(face)->has_children() ||
-                          cell->neighbor_is_coarser(face) ||
-                          (!cell->at_boundary(face) &&
-                           cell->neighbor(face)->is_artificial()) ||
-                          (!cell->at_boundary(face) &&
-                           !cell->neighbor(face)->is_artificial() &&
-                           (cell->active_fe_index() ==
-                            cell->neighbor(face)->active_fe_index())))
-                        {
-                          // Only one active_fe_index lives on this
-                          // face
-                          face_dof_offsets[cell->face(face)->index()] =
-                            next_free_face_slot;
-
-                          // Set the first and only slot for this face to
-                          // active_fe_index of this face
-                          face_dof_indices[next_free_face_slot] =
-                            cell->active_fe_index();
-
-                          // The next dofs_per_face indices remain unset
-                          // for the moment (i.e. at invalid_dof_index).
-                          // Following this comes the stop index, which
-                          // also is invalid_dof_index and therefore
-                          // does not have to be explicitly set
-
-                          // Finally, move the current marker forward:
-                          next_free_face_slot +=
-                            1 // the active_fe_index
-                            + dof_handler.get_fe(cell->active_fe_index())
-                                .template n_dofs_per_object<
-                                  dim - 1>() // actual DoF indices
-                            + 1;             // the end marker
-                        }
-                      else
-                        {
-                          // There are two active_fe_indices that live on this
-                          // face.
-                          face_dof_offsets[cell->face(face)->index()] =
-                            next_free_face_slot;
-
-                          // Store the two indices we will have to deal with.
-                          // We sort these so that it does not matter which of
-                          // the cells adjacent to this face we visit first. In
-                          // sequential computations, this does not matter
-                          // because the order in which we visit these cells is
-                          // deterministic and always the same. But in parallel
-                          // computations, we can get into trouble because two
-                          // processors visit the cells in different order
-                          // (because the mesh creation history on the two
-                          // processors is different), and in that case it can
-                          // happen that the order of active_fe_index values for
-                          // a given face is different on the two processes,
-                          // even though they agree on which two values need to
-                          // be stored. Since the DoF unification on faces
-                          // takes into account the order of the
-                          // active_fe_indices, this leads to quite subtle bugs.
-                          // We could fix this in the place where we do the DoF
-                          // unification on cells, but it is better to just make
-                          // sure that every process stores the exact same
-                          // information (and in the same order) on each face.
-                          unsigned int active_fe_indices[2] = {
-                            cell->active_fe_index(),
-                            cell->neighbor(face)->active_fe_index()};
-                          if (active_fe_indices[1] < active_fe_indices[0])
-                            std::swap(active_fe_indices[0],
-                                      active_fe_indices[1]);
-
-                          // Set first slot for this face to
-                          // active_fe_index of this face
-                          face_dof_indices[next_free_face_slot] =
-                            active_fe_indices[0];
-
-                          // The next dofs_per_line/quad indices remain unset
-                          // for the moment (i.e. at invalid_dof_index).
-                          //
-                          // Then comes the fe_index for the second slot:
-                          face_dof_indices
-                            [next_free_face_slot + 1 +
-                             dof_handler.get_fe(active_fe_indices[0])
-                               .template n_dofs_per_object<dim - 1>()] =
-                              active_fe_indices[1];
-                          // Then again a set of dofs that we need not
-                          // set right now
-                          //
-                          // Following this comes the stop index, which
-                          // also is invalid_dof_index and therefore
-                          // does not have to be explicitly set
-
-                          // Finally, move the current marker forward:
-                          next_free_face_slot +=
-                            (1 // first active_fe_index
-                             + dof_handler.get_fe(active_fe_indices[0])
-                                 .template n_dofs_per_object<
-                                   dim - 1>() // actual DoF indices
-                             + 1              // second active_fe_index
-                             + dof_handler.get_fe(active_fe_indices[1])
-                                 .template n_dofs_per_object<
-                                   dim - 1>() // actual DoF indices
-                             + 1);            // end marker
-                        }
-
-                      // mark this face as visited
-                      cell->face(face)->set_user_flag();
+                      fe_indices[0] = cell->active_fe_index();
+                      fe_indices[1] = cell->neighbor(face)->active_fe_index();
+                      if (fe_indices[1] < fe_indices[0])
+                        std::swap(fe_indices[0], fe_indices[1]);
                     }
+                }
 
-            // we should have moved the cursor for each level to the
-            // total number of dofs on that level. check that
-            Assert(next_free_face_slot == n_face_slots, ExcInternalError());
-
-            // at the end, restore the user flags for the faces
-            switch (dim)
-              {
-                case 2:
-                  {
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .load_user_flags_line(saved_face_user_flags);
-
-                    break;
-                  }
-
-                case 3:
-                  {
-                    const_cast<dealii::Triangulation<dim, spacedim> &>(
-                      *dof_handler.tria)
-                      .load_user_flags_quad(saved_face_user_flags);
-
-                    break;
-                  }
-
-                default:
-                  Assert(false, ExcNotImplemented());
-              }
-          }
+          // Now that we know how many sets of dofs we will have to store
+          // on each face, set up the offsets. Note that we allocate
+          // offsets for all faces, though only the active ones will have a
+          // non-empty range of active_fe_indices later on
+          face_dofs.fe_offsets.resize(n_raw_faces + 1);
+          face_dofs.fe_offsets[0] = 0;
+          for (unsigned int face = 0; face < n_raw_faces; ++face)
+            face_dofs.fe_offsets[face + 1] =
+              face_dofs.fe_offsets[face] +
+              (face_fe_indices[face][0] != numbers::invalid_unsigned_int) +
+              (face_fe_indices[face][1] != numbers::invalid_unsigned_int);
+
+          face_dofs.active_fe_indices.resize(face_dofs.fe_offsets.back());
+          for (unsigned int face = 0; face < n_raw_faces; ++face)
+            for (unsigned int i = face_dofs.fe_offsets[face];
+                 i < face_dofs.fe_offsets[face + 1];
+                 ++i)
+              face_dofs.active_fe_indices[i] =
+                face_fe_indices[face][i - face_dofs.fe_offsets[face]];
+
+          // With this, allocate the memory for the DoF indices
+          face_dofs.allocate_dofs(dof_handler);
         }
 
 
+
         /**
          * Reserve enough space in the <tt>levels[]</tt> objects to
          * store the numbers of the degrees of freedom needed for the
@@ -753,71 +573,42 @@ namespace internal
                   line_fe_association[cell->active_fe_index()]
                                      [cell->line_index(l)] = true;
 
-            // first check which of the lines is used at all,
-            // i.e. is associated with a finite element. we do this
-            // since not all lines may actually be used, in which
-            // case we do not have to allocate any memory at all
-            std::vector<bool> line_is_used(dof_handler.tria->n_raw_lines(),
-                                           false);
-            for (unsigned int line = 0; line < dof_handler.tria->n_raw_lines();
-                 ++line)
-              for (unsigned int fe = 0; fe < dof_handler.fe_collection.size();
-                   ++fe)
-                if (line_fe_association[fe][line] == true)
-                  {
-                    line_is_used[line] = true;
-                    break;
-                  }
-
-            // next count how much memory we actually need. for each
-            // line, we need one slot per fe to store the fe_index,
-            // plus dofs_per_line for this fe. in addition, we need
-            // one slot as the end marker for the fe_indices. at the
-            // same time already fill the line_dofs_offsets field
-            dof_handler.faces->lines.dof_offsets.resize(
-              dof_handler.tria->n_raw_lines(), numbers::invalid_unsigned_int);
-
-            unsigned int line_slots_needed = 0;
-            for (unsigned int line = 0; line < dof_handler.tria->n_raw_lines();
-                 ++line)
-              if (line_is_used[line] == true)
-                {
-                  dof_handler.faces->lines.dof_offsets[line] =
-                    line_slots_needed;
+            // next count how many finite elements are associated with each
+            // line and set up the offsets into the array of
+            // active_fe_indices. lines that are not used at all get an empty
+            // range, so that we do not have to allocate any memory for them
+            dealii::internal::hp::DoFIndicesOnFacesOrEdges<1> &line_dofs =
+              dof_handler.faces->lines;
+
+            const unsigned int n_raw_lines = dof_handler.tria->n_raw_lines();
+            line_dofs.fe_offsets.resize(n_raw_lines + 1);
+            line_dofs.fe_offsets[0] = 0;
+            for (unsigned int line = 0; line < n_raw_lines; ++line)
+              {
+                unsigned int n_fes_on_line = 0;
+                for (unsigned int fe = 0;
+                     fe < dof_handler.fe_collection.size();
+                     ++fe)
+                  if (line_fe_association[fe][line] == true)
+                    ++n_fes_on_line;
+                line_dofs.fe_offsets[line + 1] =
+                  line_dofs.fe_offsets[line] + n_fes_on_line;
+              }
 
-                  for (unsigned int fe = 0;
-                       fe < dof_handler.fe_collection.size();
-                       ++fe)
-                    if (line_fe_association[fe][line] == true)
-                      line_slots_needed +=
-                        dof_handler.get_fe(fe).dofs_per_line + 1;
-                  ++line_slots_needed;
-                }
+            // then record the fe_indices, sorted by their value, and
+            // allocate the space for the DoF indices
+            line_dofs.active_fe_indices.resize(line_dofs.fe_offsets.back());
+            for (unsigned int line = 0; line < n_raw_lines; ++line)
+              {
+                unsigned int pointer = line_dofs.fe_offsets[line];
+                for (unsigned int fe = 0;
+                     fe < dof_handler.fe_collection.size();
+                     ++fe)
+                  if (line_fe_association[fe][line] == true)
+                    line_dofs.active_fe_indices[pointer++] = fe;
+              }
 
-            // now allocate the space we have determined we need,
-            // and set up the linked lists for each of the lines
-            dof_handler.faces->lines.dofs.resize(line_slots_needed,
-                                                 numbers::invalid_dof_index);
-            for (unsigned int line = 0; line < dof_handler.tria->n_raw_lines();
-                 ++line)
-              if (line_is_used[line] == true)
-                {
-                  unsigned int pointer =
-                    dof_handler.faces->lines.dof_offsets[line];
-                  for (unsigned int fe = 0;
-                       fe < dof_handler.fe_collection.size();
-                       ++fe)
-                    if (line_fe_association[fe][line] == true)
-                      {
-                        // if this line uses this fe, then set the
-                        // fe_index and move the pointer ahead
-                        dof_handler.faces->lines.dofs[pointer] = fe;
-                        pointer += dof_handler.get_fe(fe).dofs_per_line + 1;
-                      }
-                  // finally place the end marker
-                  dof_handler.faces->lines.dofs[pointer] =
-                    numbers::invalid_dof_index;
-                }
+            line_dofs.allocate_dofs(dof_handler);
           }
 
           // Ensure that everything is done at this point.
@@ -0,0 +1,244 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+
+#include <deal.II/lac/local_to_global_scatter.h>
+
+#include <algorithm>
+#include <utility>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename number>
+LocalToGlobalScatter<number>::LocalToGlobalScatter()
+{
+  clear();
+}
+
+
+
+template <typename number>
+void
+LocalToGlobalScatter<number>::reinit(
+  const SparsityPattern &          sparsity_pattern,
+  const AffineConstraints<number> &constraints)
+{
+  Assert(sparsity_pattern.is_compressed(),
+         SparsityPattern::ExcNotCompressed());
+
+  clear();
+  this->sparsity    = &sparsity_pattern;
+  this->constraints = &constraints;
+}
+
+
+
+template <typename number>
+void
+LocalToGlobalScatter<number>::clear()
+{
+  sparsity    = nullptr;
+  constraints = nullptr;
+
+  dofs_per_cell.clear();
+  cell_offsets.clear();
+  cell_offsets.push_back(Offsets{0, 0, 0, 0, 0, 0});
+  matrix_direct.clear();
+  matrix_constrained.clear();
+  vector_direct.clear();
+  vector_constrained.clear();
+  rhs_from_matrix.clear();
+  diagonal.clear();
+}
+
+
+
+template <typename number>
+unsigned int
+LocalToGlobalScatter<number>::add_cell(
+  const std::vector<size_type> &local_dof_indices)
+{
+  Assert(sparsity != nullptr, ExcNotInitialized());
+
+  const unsigned int n_dofs = local_dof_indices.size();
+  for (unsigned int i = 0; i < n_dofs; ++i)
+    AssertIndexRange(local_dof_indices[i], sparsity->n_rows());
+
+  bool has_constraints = false;
+  for (unsigned int i = 0; i < n_dofs; ++i)
+    if (constraints->is_constrained(local_dof_indices[i]))
+      {
+        has_constraints = true;
+        break;
+      }
+
+  if (has_constraints == false)
+    {
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        for (unsigned int j = 0; j < n_dofs; ++j)
+          matrix_direct.push_back(
+            (*sparsity)(local_dof_indices[i], local_dof_indices[j]));
+      vector_direct.insert(vector_direct.end(),
+                           local_dof_indices.begin(),
+                           local_dof_indices.end());
+    }
+  else
+    {
+      // expand each local degree of freedom into the list of global indices
+      // it contributes to, together with the respective weights. For
+      // unconstrained degrees of freedom this is the index itself, for
+      // constrained ones the entries of the constraint line (possibly none
+      // for degrees of freedom that are fixed to a value).
+      std::vector<std::vector<std::pair<size_type, number>>> expansion(n_dofs);
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        {
+          const size_type index = local_dof_indices[i];
+          if (constraints->is_constrained(index) == false)
+            expansion[i].emplace_back(index, number(1.));
+          else
+            {
+              const std::vector<std::pair<size_type, number>> *entries =
+                constraints->get_constraint_entries(index);
+              Assert(entries != nullptr, ExcInternalError());
+              expansion[i] = *entries;
+            }
+        }
+
+      const std::size_t first_matrix_entry = matrix_constrained.size();
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        for (const auto &row : expansion[i])
+          for (unsigned int j = 0; j < n_dofs; ++j)
+            for (const auto &column : expansion[j])
+              {
+                const std::size_t position =
+                  (*sparsity)(row.first, column.first);
+                if (position != SparsityPattern::invalid_entry)
+                  matrix_constrained.push_back(Entry{
+                    position, i * n_dofs + j, row.second * column.second});
+              }
+
+      // sort the entries by their position in the global matrix to get a
+      // more cache friendly access pattern in the scatter loop
+      std::stable_sort(matrix_constrained.begin() + first_matrix_entry,
+                       matrix_constrained.end(),
+                       [](const Entry &a, const Entry &b) {
+                         return a.destination < b.destination;
+                       });
+
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        for (const auto &row : expansion[i])
+          vector_constrained.push_back(Entry{row.first, i, row.second});
+
+      // eliminate the columns of inhomogeneously constrained degrees of
+      // freedom, moving their contribution to the right hand side
+      for (unsigned int j = 0; j < n_dofs; ++j)
+        if (constraints->is_inhomogeneously_constrained(local_dof_indices[j]))
+          {
+            const number inhomogeneity =
+              constraints->get_inhomogeneity(local_dof_indices[j]);
+            for (unsigned int i = 0; i < n_dofs; ++i)
+              for (const auto &row : expansion[i])
+                rhs_from_matrix.push_back(Entry{
+                  row.first, i * n_dofs + j, -row.second * inhomogeneity});
+          }
+
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        {
+          const size_type index = local_dof_indices[i];
+          if (constraints->is_constrained(index))
+            {
+              const std::size_t position = (*sparsity)(index, index);
+              AssertThrow(position != SparsityPattern::invalid_entry,
+                          ExcMissingDiagonal(index, i));
+              diagonal.push_back(DiagonalEntry{
+                position, index, i, constraints->get_inhomogeneity(index)});
+            }
+        }
+    }
+
+  dofs_per_cell.push_back(n_dofs);
+  cell_offsets.push_back(Offsets{matrix_direct.size(),
+                                 matrix_constrained.size(),
+                                 vector_direct.size(),
+                                 vector_constrained.size(),
+                                 rhs_from_matrix.size(),
+                                 diagonal.size()});
+
+  return n_cells() - 1;
+}
+
+
+
+template <typename number>
+void
+LocalToGlobalScatter<number>::add_cells(
+  const std::vector<std::vector<size_type>> &local_dof_indices)
+{
+  for (const auto &indices : local_dof_indices)
+    add_cell(indices);
+}
+
+
+
+template <typename number>
+void
+LocalToGlobalScatter<number>::distribute_local_to_global(
+  const unsigned int        cell,
+  const FullMatrix<number> &local_matrix,
+  SparseMatrix<number> &    global_matrix) const
+{
+  AssertIndexRange(cell, n_cells());
+  scatter_matrix(cell, local_matrix, get_matrix_values(global_matrix));
+}
+
+
+
+template <typename number>
+void
+LocalToGlobalScatter<number>::distribute_local_to_global(
+  const unsigned int                         first_cell,
+  const ArrayView<const FullMatrix<number>> &local_matrices,
+  SparseMatrix<number> &                     global_matrix) const
+{
+  AssertIndexRange(first_cell + local_matrices.size(), n_cells() + 1);
+
+  number *matrix_values = get_matrix_values(global_matrix);
+  for (unsigned int c = 0; c < local_matrices.size(); ++c)
+    scatter_matrix(first_cell + c, local_matrices[c], matrix_values);
+}
+
+
+
+template <typename number>
+std::size_t
+LocalToGlobalScatter<number>::memory_consumption() const
+{
+  return (MemoryConsumption::memory_consumption(dofs_per_cell) +
+          cell_offsets.capacity() * sizeof(Offsets) +
+          MemoryConsumption::memory_consumption(matrix_direct) +
+          matrix_constrained.capacity() * sizeof(Entry) +
+          MemoryConsumption::memory_consumption(vector_direct) +
+          vector_constrained.capacity() * sizeof(Entry) +
+          rhs_from_matrix.capacity() * sizeof(Entry) +
+          diagonal.capacity() * sizeof(DiagonalEntry));
+}
+
+
+template class LocalToGlobalScatter<float>;
+template class LocalToGlobalScatter<double>;
+
+DEAL_II_NAMESPACE_CLOSE
@@ -13,9 +13,61 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/lapack_support.h>
+#include <deal.II/lac/lapack_templates.h>
 #include <deal.II/lac/precondition_block.templates.h>
 #include <deal.II/lac/sparse_matrix.h>
 
 DEAL_II_NAMESPACE_OPEN
+
+template <typename number>
+void
+PreconditionBlockBase<number>::invert_packed(const size_type           i,
+                                             const FullMatrix<number> &matrix)
+{
+  Assert(inversion == packed_lu, ExcInverseNotAvailable());
+  const size_type ii = same_diagonal() ? 0U : i;
+  AssertIndexRange(ii + 1, packed_inverse_offsets.size());
+  AssertDimension(matrix.m(), matrix.n());
+  AssertDimension(matrix.m() * matrix.n(),
+                  packed_inverse_offsets[ii + 1] - packed_inverse_offsets[ii]);
+
+  const size_type n      = matrix.m();
+  number *const   values = packed_inverses.data() + packed_inverse_offsets[ii];
+  if (n == 0)
+    return;
+
+#ifdef DEAL_II_WITH_LAPACK
+  for (size_type c = 0; c < n; ++c)
+    for (size_type r = 0; r < n; ++r)
+      values[c * n + r] = matrix(r, c);
+
+  const types::blas_int        nn   = n;
+  types::blas_int              info = 0;
+  std::vector<types::blas_int> ipiv(n);
+  getrf(&nn, &nn, values, &nn, ipiv.data(), &info);
+  AssertThrow(info >= 0, LAPACKSupport::ExcErrorCode("getrf", info));
+  AssertThrow(info == 0, LACExceptions::ExcSingular());
+
+  // query the optimal size of the work array before the inversion
+  number                work_size = 0.;
+  const types::blas_int query     = -1;
+  getri(&nn, values, &nn, ipiv.data(), &work_size, &query, &info);
+  const types::blas_int lwork =
+    std::max<types::blas_int>(n, static_cast<types::blas_int>(work_size));
+  std::vector<number> work(lwork);
+  getri(&nn, values, &nn, ipiv.data(), work.data(), &lwork, &info);
+  AssertThrow(info == 0, LAPACKSupport::ExcErrorCode("getri", info));
+#else
+  FullMatrix<number> block_inverse(matrix);
+  block_inverse.gauss_jordan();
+  for (size_type c = 0; c < n; ++c)
+    for (size_type r = 0; r < n; ++r)
+      values[c * n + r] = block_inverse(r, c);
+#endif
+}
+
+
 #include "precondition_block.inst"
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,695 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_local_storage.h>
+
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/sparse_amg.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace SparseAMGImplementation
+  {
+    /**
+     * The rows of a sparse matrix, each given by its pairs of column index
+     * and value, in the format accepted by SparsityPattern::copy_from() and
+     * SparseMatrix::copy_from().
+     */
+    using Rows = std::vector<std::vector<std::pair<unsigned int, double>>>;
+
+
+
+    /**
+     * The strong connections of each row of a matrix, stored in compressed
+     * row format. The diagonal is not part of the strong connections.
+     */
+    struct StrongConnections
+    {
+      std::vector<unsigned int> row_starts;
+      std::vector<unsigned int> columns;
+    };
+
+
+
+    /**
+     * Determine the strong connections of @p matrix, see the documentation of
+     * the SparseAMG class.
+     */
+    StrongConnections
+    compute_strong_connections(const SparseMatrix<double> &matrix,
+                               const double                threshold)
+    {
+      const unsigned int  n_rows = matrix.m();
+      std::vector<double> diagonal(n_rows);
+      for (unsigned int i = 0; i < n_rows; ++i)
+        diagonal[i] = std::abs(matrix.diag_element(i));
+
+      StrongConnections strong;
+      strong.row_starts.resize(n_rows + 1);
+      strong.columns.reserve(matrix.n_nonzero_elements());
+      for (unsigned int i = 0; i < n_rows; ++i)
+        {
+          strong.row_starts[i] = strong.columns.size();
+          for (auto entry = matrix.begin(i); entry != matrix.end(i); ++entry)
+            if (entry->column() != i && entry->value() != 0. &&
+                std::abs(entry->value()) >=
+                  threshold *
+                    std::sqrt(diagonal[i] * diagonal[entry->column()]))
+              strong.columns.push_back(entry->column());
+        }
+      strong.row_starts[n_rows] = strong.columns.size();
+      return strong;
+    }
+
+
+
+    /**
+     * Group the rows into aggregates of strongly connected rows and return
+     * the number of aggregates. On exit, @p aggregates contains the aggregate
+     * of each row, or numbers::invalid_unsigned_int for rows without strong
+     * connections.
+     */
+    unsigned int
+    compute_aggregates(const StrongConnections &  strong,
+                       std::vector<unsigned int> &aggregates)
+    {
+      const unsigned int n_rows = strong.row_starts.size() - 1;
+      aggregates.assign(n_rows, numbers::invalid_unsigned_int);
+      unsigned int n_aggregates = 0;
+
+      // first pass: rows whose strong neighbors are all free form a new
+      // aggregate together with these neighbors
+      for (unsigned int i = 0; i < n_rows; ++i)
+        {
+          if (aggregates[i] != numbers::invalid_unsigned_int ||
+              strong.row_starts[i] == strong.row_starts[i + 1])
+            continue;
+          bool all_free = true;
+          for (unsigned int k = strong.row_starts[i];
+               k < strong.row_starts[i + 1];
+               ++k)
+            if (aggregates[strong.columns[k]] != numbers::invalid_unsigned_int)
+              {
+                all_free = false;
+                break;
+              }
+          if (all_free)
+            {
+              aggregates[i] = n_aggregates;
+              for (unsigned int k = strong.row_starts[i];
+                   k < strong.row_starts[i + 1];
+                   ++k)
+                aggregates[strong.columns[k]] = n_aggregates;
+              ++n_aggregates;
+            }
+        }
+
+      // second pass: the remaining rows join an aggregate of the first pass
+      // they are strongly connected to
+      const std::vector<unsigned int> first_pass_aggregates = aggregates;
+      for (unsigned int i = 0; i < n_rows; ++i)
+        if (aggregates[i] == numbers::invalid_unsigned_int)
+          for (unsigned int k = strong.row_starts[i];
+               k < strong.row_starts[i + 1];
+               ++k)
+            if (first_pass_aggregates[strong.columns[k]] !=
+                numbers::invalid_unsigned_int)
+              {
+                aggregates[i] = first_pass_aggregates[strong.columns[k]];
+                break;
+              }
+
+      // third pass: the rows that are still left form new aggregates with
+      // their free strong neighbors
+      for (unsigned int i = 0; i < n_rows; ++i)
+        if (aggregates[i] == numbers::invalid_unsigned_int &&
+            strong.row_starts[i] != strong.row_starts[i + 1])
+          {
+            aggregates[i] = n_aggregates;
+            for (unsigned int k = strong.row_starts[i];
+                 k < strong.row_starts[i + 1];
+                 ++k)
+              if (aggregates[strong.columns[k]] ==
+                  numbers::invalid_unsigned_int)
+                aggregates[strong.columns[k]] = n_aggregates;
+            ++n_aggregates;
+          }
+
+      return n_aggregates;
+    }
+
+
+
+    /**
+     * Sort the entries of a row by column and merge the entries with the
+     * same column.
+     */
+    void
+    sort_and_merge(std::vector<std::pair<unsigned int, double>> &row)
+    {
+      std::sort(row.begin(),
+                row.end(),
+                [](const std::pair<unsigned int, double> &a,
+                   const std::pair<unsigned int, double> &b) {
+                  return a.first < b.first;
+                });
+      unsigned int n_unique = 0;
+      for (unsigned int k = 0; k < row.size(); ++k)
+        if (n_unique > 0 && row[n_unique - 1].first == row[k].first)
+          row[n_unique - 1].second += row[k].second;
+        else
+          row[n_unique++] = row[k];
+      row.resize(n_unique);
+    }
+
+
+
+    /**
+     * Compute the rows of the smoothed prolongator
+     * $P = (I - \omega D_F^{-1} A_F) T$, where $T$ is the tentative
+     * prolongator of the aggregates and $A_F$ the filtered matrix with
+     * diagonal $D_F$.
+     */
+    Rows
+    compute_smoothed_prolongator(const SparseMatrix<double> &     matrix,
+                                 const double                     threshold,
+                                 const double                     damping,
+                                 const std::vector<unsigned int> &aggregates,
+                                 const unsigned int n_aggregates)
+    {
+      const unsigned int n_rows = matrix.m();
+
+      // the tentative prolongator interpolates the constant vector on each
+      // aggregate, scaled to unit norm
+      std::vector<unsigned int> aggregate_sizes(n_aggregates, 0);
+      for (unsigned int i = 0; i < n_rows; ++i)
+        if (aggregates[i] != numbers::invalid_unsigned_int)
+          ++aggregate_sizes[aggregates[i]];
+      std::vector<double> tentative_values(n_rows, 0.);
+      for (unsigned int i = 0; i < n_rows; ++i)
+        if (aggregates[i] != numbers::invalid_unsigned_int)
+          tentative_values[i] = 1. / std::sqrt(aggregate_sizes[aggregates[i]]);
+
+      // the filtered matrix adds the weak connections to the diagonal.
+      // Compute its diagonal and a Gershgorin bound of the spectral radius
+      // of the diagonally preconditioned filtered matrix
+      std::vector<double> diagonal(n_rows);
+      for (unsigned int i = 0; i < n_rows; ++i)
+        diagonal[i] = std::abs(matrix.diag_element(i));
+      std::vector<double> filtered_diagonal(n_rows);
+      double              spectral_radius = 0;
+      for (unsigned int i = 0; i < n_rows; ++i)
+        {
+          double diag = 0, off_diagonal_sum = 0;
+          for (auto entry = matrix.begin(i); entry != matrix.end(i); ++entry)
+            if (entry->column() == i)
+              diag += entry->value();
+            else if (std::abs(entry->value()) >=
+                     threshold *
+                       std::sqrt(diagonal[i] * diagonal[entry->column()]))
+              off_diagonal_sum += std::abs(entry->value());
+            else
+              diag += entry->value();
+          filtered_diagonal[i] = diag;
+          if (diag != 0.)
+            spectral_radius = std::max(spectral_radius,
+                                       1. + off_diagonal_sum / std::abs(diag));
+        }
+      const double omega =
+        (spectral_radius > 0. ? damping / spectral_radius : 0.);
+
+      Rows rows(n_rows);
+      parallel::apply_to_subranges(
+        0U,
+        n_rows,
+        [&](const unsigned int begin, const unsigned int end) {
+          for (unsigned int i = begin; i < end; ++i)
+            {
+              if (aggregates[i] == numbers::invalid_unsigned_int ||
+                  filtered_diagonal[i] == 0.)
+                continue;
+              std::vector<std::pair<unsigned int, double>> &row = rows[i];
+              const double factor = omega / filtered_diagonal[i];
+              row.emplace_back(aggregates[i],
+                               (1. - omega) * tentative_values[i]);
+              for (auto entry = matrix.begin(i); entry != matrix.end(i);
+                   ++entry)
+                {
+                  const unsigned int j = entry->column();
+                  if (j != i &&
+                      aggregates[j] != numbers::invalid_unsigned_int &&
+                      std::abs(entry->value()) >=
+                        threshold * std::sqrt(diagonal[i] * diagonal[j]))
+                    row.emplace_back(aggregates[j],
+                                     -factor * entry->value() *
+                                       tentative_values[j]);
+                }
+              sort_and_merge(row);
+            }
+        },
+        64);
+
+      return rows;
+    }
+
+
+
+    /**
+     * A dense accumulator for the entries of one row of a sparse matrix with
+     * a given number of columns, together with the list of its nonzero
+     * columns.
+     */
+    struct RowAccumulator
+    {
+      std::vector<double>       values;
+      std::vector<bool>         is_nonzero;
+      std::vector<unsigned int> nonzero_columns;
+    };
+
+
+
+    /**
+     * Compute the rows of the Galerkin product $P^T A P$, where the rows of
+     * $P$ are given by @p prolongator_rows. The rows of the product are
+     * computed independently on several threads, each with its own
+     * RowAccumulator of size @p n_coarse.
+     */
+    Rows
+    compute_galerkin_product(const SparseMatrix<double> &matrix,
+                             const Rows &                prolongator_rows,
+                             const unsigned int          n_coarse)
+    {
+      // the rows of the transpose of the prolongator
+      Rows restriction_rows(n_coarse);
+      for (unsigned int i = 0; i < prolongator_rows.size(); ++i)
+        for (const auto &entry : prolongator_rows[i])
+          restriction_rows[entry.first].emplace_back(i, entry.second);
+
+      // the accumulators are allocated once per thread rather than once per
+      // range of rows, and only the entries touched by a row are reset
+      // after the row is done
+      Threads::ThreadLocalStorage<RowAccumulator> accumulators;
+
+      Rows rows(n_coarse);
+      parallel::apply_to_subranges(
+        0U,
+        n_coarse,
+        [&](const unsigned int begin, const unsigned int end) {
+          RowAccumulator &accumulator = accumulators.get();
+          if (accumulator.values.size() != n_coarse)
+            {
+              accumulator.values.assign(n_coarse, 0.);
+              accumulator.is_nonzero.assign(n_coarse, false);
+            }
+          auto &values          = accumulator.values;
+          auto &is_nonzero      = accumulator.is_nonzero;
+          auto &nonzero_columns = accumulator.nonzero_columns;
+          for (unsigned int row = begin; row < end; ++row)
+            {
+              for (const auto &r : restriction_rows[row])
+                for (auto entry = matrix.begin(r.first);
+                     entry != matrix.end(r.first);
+                     ++entry)
+                  {
+                    const double ra = r.second * entry->value();
+                    for (const auto &p : prolongator_rows[entry->column()])
+                      {
+                        if (!is_nonzero[p.first])
+                          {
+                            is_nonzero[p.first] = true;
+                            nonzero_columns.push_back(p.first);
+                          }
+                        values[p.first] += ra * p.second;
+                      }
+                  }
+
+              std::sort(nonzero_columns.begin(), nonzero_columns.end());
+              rows[row].reserve(nonzero_columns.size());
+              for (const unsigned int column : nonzero_columns)
+                {
+                  rows[row].emplace_back(column, values[column]);
+                  values[column]     = 0.;
+                  is_nonzero[column] = false;
+                }
+              nonzero_columns.clear();
+            }
+        },
+        16);
+
+      return rows;
+    }
+
+
+
+    /**
+     * Set up @p sparsity_pattern and @p matrix with the given rows.
+     */
+    void
+    build_matrix(const Rows &          rows,
+                 const unsigned int    n_columns,
+                 SparsityPattern &     sparsity_pattern,
+                 SparseMatrix<double> &matrix)
+    {
+      sparsity_pattern.copy_from(rows.size(),
+                                 n_columns,
+                                 rows.begin(),
+                                 rows.end());
+      matrix.reinit(sparsity_pattern);
+      matrix.copy_from(rows.begin(), rows.end());
+    }
+  } // namespace SparseAMGImplementation
+} // namespace internal
+
+
+
+SparseAMG::AdditionalData::AdditionalData(const double       strong_threshold,
+                                          const SmootherType smoother_type,
+                                          const unsigned int smoother_degree,
+                                          const double       smoothing_range,
+                                          const unsigned int coarse_size,
+                                          const unsigned int max_levels,
+                                          const double prolongator_damping)
+  : strong_threshold(strong_threshold)
+  , smoother_type(smoother_type)
+  , smoother_degree(smoother_degree)
+  , smoothing_range(smoothing_range)
+  , coarse_size(coarse_size)
+  , max_levels(max_levels)
+  , prolongator_damping(prolongator_damping)
+{}
+
+
+
+void
+SparseAMG::initialize(const SparseMatrix<double> &matrix,
+                      const AdditionalData &      additional_data)
+{
+  Assert(matrix.m() == matrix.n(), ExcNotQuadratic());
+  Assert(additional_data.max_levels > 0,
+         ExcMessage("Need at least one level."));
+  Assert(additional_data.smoother_degree > 0,
+         ExcMessage("The smoother degree must be at least one."));
+
+  clear();
+  this->additional_data = additional_data;
+  fine_matrix           = &matrix;
+
+  // coarsen until the matrix is small enough or the aggregation does not
+  // reduce its size any more
+  const SparseMatrix<double> *current_matrix = &matrix;
+  while (coarse_matrices.size() + 1 < additional_data.max_levels &&
+         current_matrix->m() > additional_data.coarse_size)
+    {
+      using namespace internal::SparseAMGImplementation;
+
+      std::vector<unsigned int> aggregates;
+      const unsigned int        n_aggregates = compute_aggregates(
+        compute_strong_connections(*current_matrix,
+                                   additional_data.strong_threshold),
+        aggregates);
+      if (n_aggregates == 0 || n_aggregates >= current_matrix->m())
+        break;
+
+      const Rows prolongator_rows =
+        compute_smoothed_prolongator(*current_matrix,
+                                     additional_data.strong_threshold,
+                                     additional_data.prolongator_damping,
+                                     aggregates,
+                                     n_aggregates);
+      prolongator_sparsity_patterns.emplace_back(new SparsityPattern());
+      prolongators.emplace_back(new SparseMatrix<double>());
+      build_matrix(prolongator_rows,
+                   n_aggregates,
+                   *prolongator_sparsity_patterns.back(),
+                   *prolongators.back());
+
+      const Rows coarse_rows = compute_galerkin_product(*current_matrix,
+                                                        prolongator_rows,
+                                                        n_aggregates);
+      coarse_sparsity_patterns.emplace_back(new SparsityPattern());
+      coarse_matrices.emplace_back(new SparseMatrix<double>());
+      build_matrix(coarse_rows,
+                   n_aggregates,
+                   *coarse_sparsity_patterns.back(),
+                   *coarse_matrices.back());
+      current_matrix = coarse_matrices.back().get();
+    }
+
+  // the coarsest level is solved directly if it is small enough, all other
+  // levels are smoothed
+  const bool solve_coarsest =
+    current_matrix->m() <= additional_data.coarse_size;
+  if (solve_coarsest)
+    {
+      const unsigned int n = current_matrix->m();
+      coarse_inverse.reinit(n, n);
+#ifdef DEAL_II_WITH_LAPACK
+      // the coarse matrix is singular if the fine matrix is, e.g., for pure
+      // Neumann boundary conditions, since the aggregates preserve the
+      // constants. use the pseudo-inverse from a singular value
+      // decomposition, which drops the singular values that are zero up to
+      // roundoff, and store it column by column
+      LAPACKFullMatrix<double> svd(n, n);
+      svd = *current_matrix;
+      svd.compute_inverse_svd(1e-12);
+      Vector<double> unit_vector(n), column(n);
+      for (unsigned int j = 0; j < n; ++j)
+        {
+          unit_vector(j) = 1.;
+          svd.vmult(column, unit_vector);
+          unit_vector(j) = 0.;
+          for (unsigned int i = 0; i < n; ++i)
+            coarse_inverse(i, j) = column(i);
+        }
+#else
+      coarse_inverse.copy_from(*current_matrix);
+      coarse_inverse.gauss_jordan();
+#endif
+    }
+
+  smoothers.resize(n_levels() - (solve_coarsest ? 1 : 0));
+  for (unsigned int level = 0; level < smoothers.size(); ++level)
+    {
+      Smoother::AdditionalData smoother_data;
+      if (additional_data.smoother_type == AdditionalData::chebyshev)
+        {
+          smoother_data.degree          = additional_data.smoother_degree;
+          smoother_data.smoothing_range = additional_data.smoothing_range;
+        }
+      else
+        {
+          // a Chebyshev polynomial of degree zero is a damped Jacobi sweep.
+          // This smoothing range results in the damping factor 4/(3 lambda)
+          // for the largest eigenvalue lambda
+          smoother_data.degree          = 0;
+          smoother_data.smoothing_range = 2.;
+        }
+      smoother_data.eig_cg_n_iterations = 10;
+      smoothers[level].reset(new Smoother());
+      smoothers[level]->initialize(get_matrix(level), smoother_data);
+    }
+
+  level_solution.resize(n_levels());
+  level_rhs.resize(n_levels());
+  level_residual.resize(n_levels());
+  for (unsigned int level = 1; level < n_levels(); ++level)
+    {
+      level_solution[level].reinit(get_matrix(level).m());
+      level_rhs[level].reinit(get_matrix(level).m());
+    }
+  for (unsigned int level = 0; level + 1 < n_levels(); ++level)
+    level_residual[level].reinit(get_matrix(level).m());
+}
+
+
+
+void
+SparseAMG::clear()
+{
+  smoothers.clear();
+  prolongators.clear();
+  prolongator_sparsity_patterns.clear();
+  coarse_matrices.clear();
+  coarse_sparsity_patterns.clear();
+  coarse_inverse.reinit(0, 0);
+  level_solution.clear();
+  level_rhs.clear();
+  level_residual.clear();
+  fine_matrix = nullptr;
+}
+
+
+
+void
+SparseAMG::vmult(Vector<double> &dst, const Vector<double> &src) const
+{
+  Assert(fine_matrix != nullptr, ExcNotInitialized());
+  AssertDimension(dst.size(), m());
+  AssertDimension(src.size(), n());
+  v_cycle(0, dst, src);
+}
+
+
+
+void
+SparseAMG::Tvmult(Vector<double> &dst, const Vector<double> &src) const
+{
+  vmult(dst, src);
+}
+
+
+
+void
+SparseAMG::v_cycle(const unsigned int    level,
+                   Vector<double> &      solution,
+                   const Vector<double> &rhs) const
+{
+  // on the coarsest level, solve or smooth
+  if (level + 1 == n_levels())
+    {
+      if (coarse_inverse.m() > 0)
+        coarse_inverse.vmult(solution, rhs);
+      else
+        {
+          pre_smooth(level, solution, rhs);
+          post_smooth(level, solution, rhs);
+        }
+      return;
+    }
+
+  pre_smooth(level, solution, rhs);
+
+  // restrict the residual, compute the coarse correction, and add it
+  get_matrix(level).residual(level_residual[level], solution, rhs);
+  prolongators[level]->Tvmult(level_rhs[level + 1], level_residual[level]);
+  v_cycle(level + 1, level_solution[level + 1], level_rhs[level + 1]);
+  prolongators[level]->vmult_add(solution, level_solution[level + 1]);
+
+  post_smooth(level, solution, rhs);
+}
+
+
+
+void
+SparseAMG::pre_smooth(const unsigned int    level,
+                      Vector<double> &      solution,
+                      const Vector<double> &rhs) const
+{
+  smoothers[level]->vmult(solution, rhs);
+  if (additional_data.smoother_type == AdditionalData::jacobi)
+    for (unsigned int i = 1; i < additional_data.smoother_degree; ++i)
+      smoothers[level]->step(solution, rhs);
+}
+
+
+
+void
+SparseAMG::post_smooth(const unsigned int    level,
+                       Vector<double> &      solution,
+                       const Vector<double> &rhs) const
+{
+  const unsigned int n_steps =
+    (additional_data.smoother_type == AdditionalData::jacobi ?
+       additional_data.smoother_degree :
+       1);
+  for (unsigned int i = 0; i < n_steps; ++i)
+    smoothers[level]->Tstep(solution, rhs);
+}
+
+
+
+SparseAMG::size_type
+SparseAMG::m() const
+{
+  Assert(fine_matrix != nullptr, ExcNotInitialized());
+  return fine_matrix->m();
+}
+
+
+
+SparseAMG::size_type
+SparseAMG::n() const
+{
+  Assert(fine_matrix != nullptr, ExcNotInitialized());
+  return fine_matrix->n();
+}
+
+
+
+unsigned int
+SparseAMG::n_levels() const
+{
+  return (fine_matrix != nullptr ? coarse_matrices.size() + 1 : 0);
+}
+
+
+
+const SparseMatrix<double> &
+SparseAMG::get_matrix(const unsigned int level) const
+{
+  AssertIndexRange(level, n_levels());
+  return (level == 0 ? *fine_matrix : *coarse_matrices[level - 1]);
+}
+
+
+
+const SparseMatrix<double> &
+SparseAMG::get_prolongator(const unsigned int level) const
+{
+  Assert(level > 0, ExcIndexRange(level, 1, n_levels()));
+  AssertIndexRange(level, n_levels());
+  return *prolongators[level - 1];
+}
+
+
+
+double
+SparseAMG::operator_complexity() const
+{
+  Assert(fine_matrix != nullptr, ExcNotInitialized());
+  std::size_t n_nonzero = 0;
+  for (unsigned int level = 0; level < n_levels(); ++level)
+    n_nonzero += get_matrix(level).n_nonzero_elements();
+  return static_cast<double>(n_nonzero) / fine_matrix->n_nonzero_elements();
+}
+
+
+
+std::size_t
+SparseAMG::memory_consumption() const
+{
+  std::size_t memory = sizeof(*this) + coarse_inverse.memory_consumption() +
+                       MemoryConsumption::memory_consumption(level_solution) +
+                       MemoryConsumption::memory_consumption(level_rhs) +
+                       MemoryConsumption::memory_consumption(level_residual);
+  for (unsigned int i = 0; i < coarse_matrices.size(); ++i)
+    memory += coarse_sparsity_patterns[i]->memory_consumption() +
+              coarse_matrices[i]->memory_consumption() +
+              prolongator_sparsity_patterns[i]->memory_consumption() +
+              prolongators[i]->memory_consumption();
+  return memory;
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,124 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/sparse_level_schedule.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * Sort the rows by the given levels, keeping the order of the rows within
+   * each level, and store the result in compressed format.
+   */
+  void
+  sort_rows_by_level(const std::vector<unsigned int> &            levels,
+                     const unsigned int                           n_levels,
+                     std::vector<SparseLevelSchedule::size_type> &level_starts,
+                     std::vector<SparseLevelSchedule::size_type> &level_rows)
+  {
+    level_starts.assign(n_levels + 1, 0);
+    for (const unsigned int level : levels)
+      ++level_starts[level + 1];
+    for (unsigned int level = 0; level < n_levels; ++level)
+      level_starts[level + 1] += level_starts[level];
+
+    std::vector<SparseLevelSchedule::size_type> next_position(
+      level_starts.begin(), level_starts.end() - 1);
+    level_rows.resize(levels.size());
+    for (SparseLevelSchedule::size_type row = 0; row < levels.size(); ++row)
+      level_rows[next_position[levels[row]]++] = row;
+  }
+} // namespace
+
+
+
+SparseLevelSchedule::SparseLevelSchedule()
+  : n(0)
+{}
+
+
+
+void
+SparseLevelSchedule::initialize(const SparsityPattern &sparsity_pattern)
+{
+  AssertDimension(sparsity_pattern.n_rows(), sparsity_pattern.n_cols());
+  Assert(sparsity_pattern.is_compressed(), SparsityPattern::ExcNotCompressed());
+
+  n = sparsity_pattern.n_rows();
+  std::vector<unsigned int> levels(n, 0);
+
+  // forward substitution: the rows are visited in increasing order, so the
+  // levels of all rows a row depends on are known when the row is visited
+  unsigned int n_levels = (n > 0 ? 1 : 0);
+  for (size_type row = 0; row < n; ++row)
+    {
+      for (auto entry = sparsity_pattern.begin(row);
+           entry != sparsity_pattern.end(row);
+           ++entry)
+        if (entry->column() < row)
+          levels[row] = std::max(levels[row], levels[entry->column()] + 1);
+      n_levels = std::max(n_levels, levels[row] + 1);
+    }
+  sort_rows_by_level(levels, n_levels, lower_level_starts, lower_rows);
+
+  // backward substitution, with the rows visited in decreasing order
+  std::fill(levels.begin(), levels.end(), 0U);
+  n_levels = (n > 0 ? 1 : 0);
+  for (size_type row = n; row > 0;)
+    {
+      --row;
+      for (auto entry = sparsity_pattern.begin(row);
+           entry != sparsity_pattern.end(row);
+           ++entry)
+        if (entry->column() > row)
+          levels[row] = std::max(levels[row], levels[entry->column()] + 1);
+      n_levels = std::max(n_levels, levels[row] + 1);
+    }
+  sort_rows_by_level(levels, n_levels, upper_level_starts, upper_rows);
+}
+
+
+
+void
+SparseLevelSchedule::clear()
+{
+  n = 0;
+  lower_level_starts.clear();
+  lower_rows.clear();
+  upper_level_starts.clear();
+  upper_rows.clear();
+}
+
+
+
+std::size_t
+SparseLevelSchedule::memory_consumption() const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption(lower_level_starts) +
+          MemoryConsumption::memory_consumption(lower_rows) +
+          MemoryConsumption::memory_consumption(upper_level_starts) +
+          MemoryConsumption::memory_consumption(upper_rows));
+}
+
+DEAL_II_NAMESPACE_CLOSE
@@ -910,6 +910,57 @@ namespace SparsityTools
 
 
 
+  void
+  reorder_multicolor(
+    const DynamicSparsityPattern &                  sparsity,
+    std::vector<DynamicSparsityPattern::size_type> &new_indices)
+  {
+    using size_type = DynamicSparsityPattern::size_type;
+
+    AssertDimension(sparsity.n_rows(), sparsity.n_cols());
+    AssertDimension(sparsity.n_rows(), new_indices.size());
+    Assert(sparsity.row_index_set().size() == 0 ||
+             sparsity.row_index_set().size() == sparsity.n_rows(),
+           ExcMessage(
+             "Only valid for sparsity patterns which store all rows."));
+
+    // greedy coloring: each index gets the smallest color that none of its
+    // neighbors with a smaller index has. The array color_owner holds for
+    // each color the last index that marked it as used
+    const size_type           n = sparsity.n_rows();
+    std::vector<unsigned int> colors(n, numbers::invalid_unsigned_int);
+    std::vector<size_type>    color_owner;
+    std::vector<size_type>    color_sizes;
+    for (size_type row = 0; row < n; ++row)
+      {
+        for (auto entry = sparsity.begin(row); entry != sparsity.end(row);
+             ++entry)
+          if (entry->column() != row &&
+              colors[entry->column()] != numbers::invalid_unsigned_int)
+            color_owner[colors[entry->column()]] = row;
+
+        unsigned int color = 0;
+        while (color < color_owner.size() && color_owner[color] == row)
+          ++color;
+        if (color == color_owner.size())
+          {
+            color_owner.push_back(numbers::invalid_size_type);
+            color_sizes.push_back(0);
+          }
+        colors[row] = color;
+        ++color_sizes[color];
+      }
+
+    // number the indices by color
+    std::vector<size_type> next_index(color_sizes.size(), 0);
+    for (unsigned int color = 1; color < color_sizes.size(); ++color)
+      next_index[color] = next_index[color - 1] + color_sizes[color - 1];
+    for (size_type row = 0; row < n; ++row)
+      new_indices[row] = next_index[colors[row]]++;
+  }
+
+
+
 #ifdef DEAL_II_WITH_MPI
   void
   distribute_sparsity_pattern(
@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/memory_consumption.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe.h>
+
+#include <deal.II/hp/dof_handler.h>
+
+#include <deal.II/numerics/assembly_plan.h>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename DoFHandlerType, typename number>
+AssemblyPlan<DoFHandlerType, number>::AssemblyPlan()
+{
+  clear();
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+AssemblyPlan<DoFHandlerType, number>::AssemblyPlan(
+  const DoFHandlerType &           dof_handler,
+  const AffineConstraints<number> &constraints,
+  const SparsityPattern &          sparsity_pattern)
+{
+  reinit(dof_handler, constraints, sparsity_pattern);
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+void
+AssemblyPlan<DoFHandlerType, number>::reinit(
+  const DoFHandlerType &           dof_handler,
+  const AffineConstraints<number> &constraints,
+  const SparsityPattern &          sparsity_pattern)
+{
+  AssertDimension(sparsity_pattern.n_rows(), dof_handler.n_dofs());
+  AssertDimension(sparsity_pattern.n_cols(), dof_handler.n_dofs());
+
+  clear();
+  this->dof_handler = &dof_handler;
+  scatter.reinit(sparsity_pattern, constraints);
+
+  cell_numbers.resize(dof_handler.get_triangulation().n_active_cells(),
+                      numbers::invalid_unsigned_int);
+
+  // the rows of the global matrix each cell writes into, including the ones
+  // reached through constraints. these are the indices that must not be
+  // shared by two cells of the same color
+  std::vector<std::vector<size_type>> conflict_indices;
+
+  std::vector<size_type> local_dof_indices;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        local_dof_indices.resize(cell->get_fe().dofs_per_cell);
+        cell->get_dof_indices(local_dof_indices);
+
+        cell_numbers[cell->active_cell_index()] = cells.size();
+        cells.push_back(cell);
+        dof_indices.insert(dof_indices.end(),
+                           local_dof_indices.begin(),
+                           local_dof_indices.end());
+        dof_index_offsets.push_back(dof_indices.size());
+        scatter.add_cell(local_dof_indices);
+
+        conflict_indices.push_back(local_dof_indices);
+        constraints.resolve_indices(conflict_indices.back());
+      }
+
+  if (cells.empty())
+    return;
+
+  using CellIterator =
+    typename std::vector<active_cell_iterator>::const_iterator;
+  const CellIterator first_cell = cells.begin();
+  const std::function<std::vector<size_type>(const CellIterator &)>
+    get_conflict_indices = [&](const CellIterator &cell) {
+      return conflict_indices[cell - first_cell];
+    };
+
+  const std::vector<std::vector<CellIterator>> coloring =
+    GraphColoring::make_graph_coloring(cells.cbegin(),
+                                       cells.cend(),
+                                       get_conflict_indices);
+
+  colored_cells.resize(coloring.size());
+  for (unsigned int color = 0; color < coloring.size(); ++color)
+    {
+      colored_cells[color].reserve(coloring[color].size());
+      for (const CellIterator &cell : coloring[color])
+        colored_cells[color].push_back(*cell);
+    }
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+void
+AssemblyPlan<DoFHandlerType, number>::clear()
+{
+  dof_handler = nullptr;
+  cells.clear();
+  colored_cells.clear();
+  cell_numbers.clear();
+  dof_indices.clear();
+  dof_index_offsets.clear();
+  dof_index_offsets.push_back(0);
+  scatter.clear();
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+const std::vector<
+  typename AssemblyPlan<DoFHandlerType, number>::active_cell_iterator> &
+AssemblyPlan<DoFHandlerType, number>::get_cells() const
+{
+  return cells;
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+const std::vector<std::vector<
+  typename AssemblyPlan<DoFHandlerType, number>::active_cell_iterator>> &
+AssemblyPlan<DoFHandlerType, number>::get_colored_cells() const
+{
+  return colored_cells;
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+const LocalToGlobalScatter<number> &
+AssemblyPlan<DoFHandlerType, number>::get_scatter() const
+{
+  return scatter;
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+void
+AssemblyPlan<DoFHandlerType, number>::distribute_local_to_global(
+  const active_cell_iterator &cell,
+  const FullMatrix<number> &  local_matrix,
+  SparseMatrix<number> &      global_matrix) const
+{
+  scatter.distribute_local_to_global(cell_index(cell),
+                                     local_matrix,
+                                     global_matrix);
+}
+
+
+
+template <typename DoFHandlerType, typename number>
+std::size_t
+AssemblyPlan<DoFHandlerType, number>::memory_consumption() const
+{
+  std::size_t memory =
+    MemoryConsumption::memory_consumption(cells) +
+    MemoryConsumption::memory_consumption(cell_numbers) +
+    MemoryConsumption::memory_consumption(dof_indices) +
+    MemoryConsumption::memory_consumption(dof_index_offsets) +
+    scatter.memory_consumption();
+  for (const auto &color : colored_cells)
+    memory += MemoryConsumption::memory_consumption(color);
+  return memory;
+}
+
+
+// explicit instantiations
+#include "assembly_plan.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,129 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write a sequence of DataOut objects with DataOutAsyncWriter while the
+// vector and the DataOut object are changed after each write, and check
+// that the files are identical to the output written directly at the time
+// of the call. Also check that an error while writing is reported through
+// the future and by wait()
+
+#include <deal.II/base/data_out_async_writer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "dim = " << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  DataOutAsyncWriter<dim>  writer(2);
+  std::vector<std::string> reference(5);
+  Vector<double>           solution(dof_handler.n_dofs());
+  for (unsigned int step = 0; step < reference.size(); ++step)
+    {
+      for (unsigned int i = 0; i < solution.size(); ++i)
+        solution(i) = random_value<double>() + step;
+
+      DataOut<dim> data_out;
+      data_out.attach_dof_handler(dof_handler);
+      data_out.add_data_vector(solution, "solution");
+      data_out.build_patches(2);
+
+      std::ostringstream out;
+      data_out.write_vtu(out);
+      reference[step] = out.str();
+
+      writer.write(data_out,
+                   "output_" + Utilities::int_to_string(step) + ".vtu",
+                   DataOutBase::vtu);
+      deallog << "Pending writes at most 2: "
+              << (writer.n_pending_writes() <= 2) << std::endl;
+    }
+  writer.wait();
+  deallog << "Pending writes after wait: " << writer.n_pending_writes()
+          << ", memory: " << writer.memory_consumption() << std::endl;
+
+  for (unsigned int step = 0; step < reference.size(); ++step)
+    {
+      std::ifstream in("output_" + Utilities::int_to_string(step) + ".vtu");
+      std::ostringstream content;
+      content << in.rdbuf();
+      deallog << "Step " << step
+              << " identical: " << (content.str() == reference[step])
+              << std::endl;
+    }
+
+  // errors while writing are reported by the future and by wait()
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "solution");
+  data_out.build_patches();
+  std::shared_future<void> future =
+    writer.write(data_out,
+                 "nonexistent_directory/output.vtu",
+                 DataOutBase::vtu);
+  try
+    {
+      future.get();
+    }
+  catch (const ExcFileNotOpen &)
+    {
+      deallog << "Error reported by future" << std::endl;
+    }
+  try
+    {
+      writer.wait();
+    }
+  catch (const ExcFileNotOpen &)
+    {
+      deallog << "Error reported by wait" << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,177 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Check that VTU output compressed in blocks of
+// VtkFlags::compression_block_size bytes decodes to the same data as the
+// output compressed in a single block: decode the base64 encoded header and
+// data of each data array, decompress the blocks with zlib and compare the
+// results.
+
+#include <deal.II/base/data_out_base.h>
+
+#include <zlib.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../tests.h"
+#include "patches.h"
+
+
+std::vector<unsigned char>
+decode_base64(const std::string &encoded)
+{
+  const std::string alphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<unsigned char> decoded;
+  unsigned int               buffer = 0, n_bits = 0;
+  for (const char c : encoded)
+    {
+      if (c == '=')
+        break;
+      buffer = (buffer << 6) | alphabet.find(c);
+      n_bits += 6;
+      if (n_bits >= 8)
+        {
+          n_bits -= 8;
+          decoded.push_back((buffer >> n_bits) & 0xFF);
+        }
+    }
+  return decoded;
+}
+
+
+
+// decode one data array and return the number of blocks and the
+// uncompressed data
+std::pair<unsigned int, std::vector<unsigned char>>
+decode_data_array(const std::string &encoded)
+{
+  // the first eight characters encode the number of blocks, which determines
+  // the length of the encoded header
+  const std::vector<unsigned char> start = decode_base64(encoded.substr(0, 8));
+  uint32_t                         n_blocks;
+  std::memcpy(&n_blocks, start.data(), sizeof(uint32_t));
+  const unsigned int header_length = 4 * ((12 + 4 * n_blocks + 2) / 3);
+
+  const std::vector<unsigned char> header_bytes =
+    decode_base64(encoded.substr(0, header_length));
+  std::vector<uint32_t> header(3 + n_blocks);
+  std::memcpy(header.data(), header_bytes.data(), header.size() * 4);
+
+  const std::vector<unsigned char> compressed =
+    decode_base64(encoded.substr(header_length));
+  std::vector<unsigned char> data;
+  std::size_t                offset = 0;
+  for (unsigned int b = 0; b < n_blocks; ++b)
+    {
+      uLongf size = (b == n_blocks - 1) ? header[2] : header[1];
+      std::vector<unsigned char> block(size);
+      const int err = uncompress(block.data(),
+                                 &size,
+                                 compressed.data() + offset,
+                                 header[3 + b]);
+      AssertThrow(err == Z_OK, ExcInternalError());
+      data.insert(data.end(), block.begin(), block.begin() + size);
+      offset += header[3 + b];
+    }
+  return std::make_pair(n_blocks, data);
+}
+
+
+
+std::vector<std::pair<unsigned int, std::vector<unsigned char>>>
+decode_vtu(const std::string &vtu)
+{
+  std::vector<std::pair<unsigned int, std::vector<unsigned char>>> arrays;
+  const std::string tag = "format=\"binary\">";
+  for (std::size_t pos = vtu.find(tag); pos != std::string::npos;
+       pos              = vtu.find(tag, pos))
+    {
+      pos += tag.size();
+      std::istringstream in(vtu.substr(pos, vtu.find('<', pos) - pos));
+      std::string        encoded;
+      in >> encoded;
+      arrays.push_back(decode_data_array(encoded));
+    }
+  return arrays;
+}
+
+
+
+template <int dim, int spacedim>
+void
+check()
+{
+  std::vector<DataOutBase::Patch<dim, spacedim>> patches(10);
+  create_patches(patches);
+
+  std::vector<std::string> names(5);
+  names[0] = "x1";
+  names[1] = "x2";
+  names[2] = "x3";
+  names[3] = "x4";
+  names[4] = "i";
+  std::vector<
+    std::tuple<unsigned int,
+               unsigned int,
+               std::string,
+               DataComponentInterpretation::DataComponentInterpretation>>
+    vectors;
+
+  DataOutBase::VtkFlags flags;
+  std::ostringstream    out_single;
+  DataOutBase::write_vtu(patches, names, vectors, flags, out_single);
+
+  flags.compression_block_size = 64;
+  std::ostringstream out_blocks;
+  DataOutBase::write_vtu(patches, names, vectors, flags, out_blocks);
+
+  const auto arrays_single = decode_vtu(out_single.str());
+  const auto arrays_blocks = decode_vtu(out_blocks.str());
+  AssertDimension(arrays_single.size(), arrays_blocks.size());
+
+  unsigned int n_blocks_single = 0, n_blocks = 0;
+  bool         identical = true;
+  for (unsigned int i = 0; i < arrays_single.size(); ++i)
+    {
+      n_blocks_single += arrays_single[i].first;
+      n_blocks += arrays_blocks[i].first;
+      if (arrays_single[i].second != arrays_blocks[i].second)
+        identical = false;
+    }
+  deallog << "dim=" << dim << " spacedim=" << spacedim
+          << ": data arrays: " << arrays_single.size()
+          << ", blocks single: " << n_blocks_single
+          << ", blocks with block size 64: " << n_blocks
+          << ", identical data: " << identical << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  check<1, 1>();
+  check<1, 2>();
+  check<2, 2>();
+  check<2, 3>();
+  check<3, 3>();
+}
@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DataOutHDF5TimeSeries: write two time steps on the same mesh, the
+// second one with an additional field, then refine the mesh and write a
+// third one. The mesh must be written twice, the XDMF file must list all
+// three time steps, each with the dimensions of the datasets after that
+// step, and the HDF5 file must contain the meshes and one row of field
+// values per time step on each mesh
+
+#include <deal.II/base/data_out_hdf5_time_series.h>
+#include <deal.II/base/hdf5.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/data_out.h>
+
+#include "../tests.h"
+
+
+void
+write_step(DataOutHDF5TimeSeries<2> &time_series,
+           const DoFHandler<2> &     dof_handler,
+           const double              time,
+           const bool                write_v = false)
+{
+  Vector<double> solution(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = time + i;
+  Vector<double> v(dof_handler.n_dofs());
+  v = -1.;
+
+  DataOut<2> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "u");
+  if (write_v)
+    data_out.add_data_vector(v, "v");
+  data_out.build_patches();
+  time_series.write(data_out, time);
+
+  deallog << "Time steps: " << time_series.n_time_steps()
+          << ", meshes: " << time_series.n_meshes() << std::endl;
+}
+
+
+
+// print the dimensions of a dataset and, for the field datasets with one row
+// per time step, the smallest and largest value of each row
+void
+check_dataset(const HDF5::Group &group, const std::string &name)
+{
+  HDF5::DataSet              dataset    = group.open_dataset(name);
+  const std::vector<hsize_t> dimensions = dataset.get_dimensions();
+  deallog << group.get_name() << "/" << name << ": dimensions";
+  for (const hsize_t d : dimensions)
+    deallog << ' ' << d;
+  deallog << std::endl;
+
+  if (dimensions.size() == 3)
+    {
+      const std::vector<double> values = dataset.read<std::vector<double>>();
+
+      const std::size_t row_size = dimensions[1] * dimensions[2];
+      for (unsigned int row = 0; row < dimensions[0]; ++row)
+        deallog << "  row " << row << ": values from "
+                << *std::min_element(values.begin() + row * row_size,
+                                     values.begin() + (row + 1) * row_size)
+                << " to "
+                << *std::max_element(values.begin() + row * row_size,
+                                     values.begin() + (row + 1) * row_size)
+                << std::endl;
+    }
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  initlog();
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+
+  FE_Q<2>       fe(1);
+  DoFHandler<2> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  DataOutHDF5TimeSeries<2> time_series("solution", MPI_COMM_SELF);
+  write_step(time_series, dof_handler, 0.);
+  write_step(time_series, dof_handler, 0.5, true);
+
+  tria.refine_global(1);
+  dof_handler.distribute_dofs(fe);
+  write_step(time_series, dof_handler, 1.);
+
+  cat_file(time_series.get_xdmf_filename().c_str());
+
+  HDF5::File file(time_series.get_hdf5_filename(),
+                  HDF5::File::FileAccessMode::open);
+  for (const std::string mesh : {"mesh_0", "mesh_1"})
+    {
+      HDF5::Group group = file.open_group(mesh);
+      check_dataset(group, "nodes");
+      check_dataset(group, "cells");
+      check_dataset(group, "u");
+    }
+  check_dataset(file.open_group("mesh_0"), "v");
+}
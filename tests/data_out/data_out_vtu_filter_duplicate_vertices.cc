@@ -0,0 +1,276 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check VtkFlags::filter_duplicate_vertices for linear and high-order VTU
+// output of a continuous FE_Q field: with patches of as many subdivisions as
+// the polynomial degree, the number of points written equals the number of
+// degrees of freedom and the number of vertices of DataOutFilter. This also
+// holds for a small mesh far away from the origin, where distinct nodes
+// have the same coordinates in single precision. The data arrays are
+// decoded to check that each cell refers to points with the same
+// coordinates and data values as without filtering, and that each written
+// point is used by some cell
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/data_out.h>
+
+#include <zlib.h>
+
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../tests.h"
+
+
+std::vector<unsigned char>
+decode_base64(const std::string &encoded)
+{
+  const std::string alphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<unsigned char> decoded;
+  unsigned int               buffer = 0, n_bits = 0;
+  for (const char c : encoded)
+    {
+      if (c == '=')
+        break;
+      buffer = (buffer << 6) | alphabet.find(c);
+      n_bits += 6;
+      if (n_bits >= 8)
+        {
+          n_bits -= 8;
+          decoded.push_back((buffer >> n_bits) & 0xFF);
+        }
+    }
+  return decoded;
+}
+
+
+
+// decode the header and the compressed blocks of one data array and return
+// the uncompressed data as an array of type T
+template <typename T>
+std::vector<T>
+decode_data_array(const std::string &encoded)
+{
+  const std::vector<unsigned char> start = decode_base64(encoded.substr(0, 8));
+  uint32_t                         n_blocks;
+  std::memcpy(&n_blocks, start.data(), sizeof(uint32_t));
+  const unsigned int header_length = 4 * ((12 + 4 * n_blocks + 2) / 3);
+
+  const std::vector<unsigned char> header_bytes =
+    decode_base64(encoded.substr(0, header_length));
+  std::vector<uint32_t> header(3 + n_blocks);
+  std::memcpy(header.data(), header_bytes.data(), header.size() * 4);
+
+  const std::vector<unsigned char> compressed =
+    decode_base64(encoded.substr(header_length));
+  std::vector<unsigned char> data;
+  std::size_t                offset = 0;
+  for (unsigned int b = 0; b < n_blocks; ++b)
+    {
+      uLongf size = (b == n_blocks - 1) ? header[2] : header[1];
+      std::vector<unsigned char> block(size);
+      const int err = uncompress(block.data(),
+                                 &size,
+                                 compressed.data() + offset,
+                                 header[3 + b]);
+      AssertThrow(err == Z_OK, ExcInternalError());
+      data.insert(data.end(), block.begin(), block.begin() + size);
+      offset += header[3 + b];
+    }
+
+  std::vector<T> values(data.size() / sizeof(T));
+  std::memcpy(values.data(), data.data(), values.size() * sizeof(T));
+  return values;
+}
+
+
+
+// return the encoded content of the data array following the given
+// attribute
+std::string
+find_data_array(const std::string &vtu, const std::string &attribute)
+{
+  const std::string tag = "format=\"binary\">";
+  const std::size_t pos = vtu.find(tag, vtu.find(attribute)) + tag.size();
+  std::istringstream in(vtu.substr(pos, vtu.find('<', pos) - pos));
+  std::string        encoded;
+  in >> encoded;
+  return encoded;
+}
+
+
+
+// the points, connectivity and values of the field "solution" of a VTU file
+struct VtuData
+{
+  VtuData(const std::string &vtu)
+    : points(decode_data_array<float>(
+        find_data_array(vtu, "NumberOfComponents=\"3\"")))
+    , connectivity(
+        decode_data_array<int32_t>(find_data_array(vtu, "\"connectivity\"")))
+    , values(decode_data_array<float>(find_data_array(vtu, "\"solution\"")))
+  {}
+
+  std::vector<float>   points;
+  std::vector<int32_t> connectivity;
+  std::vector<float>   values;
+};
+
+
+
+template <int dim>
+std::string
+write(DataOut<dim> &data_out, const DataOutBase::VtkFlags &flags)
+{
+  data_out.set_flags(flags);
+  std::ostringstream out;
+  data_out.write_vtu(out);
+  const std::string vtu   = out.str();
+  const std::size_t start = vtu.find("<Piece");
+  deallog << "higher order cells: " << flags.write_higher_order_cells
+          << ", filter duplicates: " << flags.filter_duplicate_vertices
+          << ": " << vtu.substr(start, vtu.find('>', start) - start + 1)
+          << std::endl;
+  return vtu;
+}
+
+
+
+// compare the points each cell refers to in the filtered and in the
+// unfiltered output
+void
+compare(const std::string &vtu, const std::string &vtu_filtered)
+{
+  const VtuData data(vtu);
+  const VtuData filtered(vtu_filtered);
+  AssertDimension(data.connectivity.size(), filtered.connectivity.size());
+
+  bool                   same_points = true;
+  std::set<unsigned int> used_points;
+  for (unsigned int i = 0; i < data.connectivity.size(); ++i)
+    {
+      const unsigned int p   = data.connectivity[i];
+      const unsigned int p_f = filtered.connectivity[i];
+      used_points.insert(p_f);
+      if (data.values[p] != filtered.values[p_f])
+        same_points = false;
+      for (unsigned int d = 0; d < 3; ++d)
+        if (data.points[3 * p + d] != filtered.points[3 * p_f + d])
+          same_points = false;
+    }
+  deallog << "cells refer to the same points and values: " << same_points
+          << ", all points used: "
+          << (used_points.size() == filtered.values.size() &&
+              used_points.size() == filtered.points.size() / 3)
+          << std::endl;
+}
+
+
+
+template <int dim>
+void
+test_far_from_origin()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, 1e6, 1e6 + 1e-3);
+  tria.refine_global(1);
+
+  const unsigned int degree = 3;
+  FE_Q<dim>          fe(degree);
+  DoFHandler<dim>    dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  deallog << "dim = " << dim << ", far from origin, n_dofs = "
+          << dof_handler.n_dofs() << std::endl;
+
+  Vector<double> solution(dof_handler.n_dofs());
+  DataOut<dim>   data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "solution");
+  data_out.build_patches(degree);
+
+  DataOutBase::VtkFlags flags;
+  flags.write_higher_order_cells  = true;
+  flags.filter_duplicate_vertices = true;
+  write(data_out, flags);
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+
+  const unsigned int degree = 3;
+  FE_Q<dim>          fe(degree);
+  DoFHandler<dim>    dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  deallog << "dim = " << dim << ", n_dofs = " << dof_handler.n_dofs()
+          << std::endl;
+
+  Vector<double> solution(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = i;
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler(dof_handler);
+  data_out.add_data_vector(solution, "solution");
+  data_out.build_patches(degree);
+
+  DataOutBase::DataOutFilter data_filter(
+    DataOutBase::DataOutFilterFlags(true, false));
+  data_out.write_filtered_data(data_filter);
+  deallog << "DataOutFilter nodes: " << data_filter.n_nodes() << std::endl;
+
+  DataOutBase::VtkFlags flags;
+  for (const bool higher_order : {false, true})
+    {
+      flags.write_higher_order_cells  = higher_order;
+      flags.filter_duplicate_vertices = false;
+      const std::string vtu           = write(data_out, flags);
+      flags.filter_duplicate_vertices = true;
+      compare(vtu, write(data_out, flags));
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+  test_far_from_origin<2>();
+  test_far_from_origin<3>();
+}
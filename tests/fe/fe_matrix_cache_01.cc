@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write the matrices of FE_Q and FE_Nedelec to an FEMatrixCache file, read
+// them back, and check that elements created afterwards have the same
+// interface constraints and transfer matrices as without the cache. Also
+// check that the matrices of the elements are taken from the cache, again
+// when the same element is created a second time
+
+#include <deal.II/fe/fe_matrix_cache.h>
+#include <deal.II/fe/fe_nedelec.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <fstream>
+
+#include "../tests.h"
+
+
+double
+difference(const FullMatrix<double> &matrix_1,
+           const FullMatrix<double> &matrix_2)
+{
+  AssertDimension(matrix_1.m(), matrix_2.m());
+  AssertDimension(matrix_1.n(), matrix_2.n());
+  double difference = 0;
+  for (unsigned int i = 0; i < matrix_1.m(); ++i)
+    for (unsigned int j = 0; j < matrix_1.n(); ++j)
+      difference =
+        std::max(difference, std::abs(matrix_1(i, j) - matrix_2(i, j)));
+  return difference;
+}
+
+
+
+template <int dim>
+void
+compare(const FiniteElement<dim> &fe_1, const FiniteElement<dim> &fe_2)
+{
+  double difference_transfer = 0;
+  for (unsigned int c = 0; c < GeometryInfo<dim>::max_children_per_cell; ++c)
+    {
+      difference_transfer = std::max(
+        difference_transfer,
+        difference(fe_1.get_prolongation_matrix(c),
+                   fe_2.get_prolongation_matrix(c)));
+      difference_transfer = std::max(
+        difference_transfer,
+        difference(fe_1.get_restriction_matrix(c),
+                   fe_2.get_restriction_matrix(c)));
+    }
+  deallog << fe_1.get_name() << ": difference constraints "
+          << difference(fe_1.constraints(), fe_2.constraints())
+          << ", difference transfer matrices " << difference_transfer
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const FE_Q<2>       fe_q(4);
+  const FE_Nedelec<2> fe_nedelec(2);
+
+  FEMatrixCache::add(fe_q);
+  FEMatrixCache::add(fe_nedelec);
+  deallog << "Entries: " << FEMatrixCache::n_entries()
+          << ", enabled: " << FEMatrixCache::is_enabled() << std::endl;
+  FEMatrixCache::write("fe_matrices.bin");
+
+  FEMatrixCache::disable();
+  deallog << "Entries after disable: " << FEMatrixCache::n_entries()
+          << std::endl;
+
+  FEMatrixCache::read("fe_matrices.bin");
+  deallog << "Entries after read: " << FEMatrixCache::n_entries()
+          << ", enabled: " << FEMatrixCache::is_enabled() << std::endl;
+
+  compare<2>(fe_q, FE_Q<2>(4));
+  compare<2>(fe_nedelec, FE_Nedelec<2>(2));
+  deallog << "Cache hits: " << FEMatrixCache::n_hits() << std::endl;
+
+  const unsigned int n_hits = FEMatrixCache::n_hits();
+  const FE_Q<2>      fe_q_2(4);
+  deallog << "Cache hits for second FE_Q<2>(4): "
+          << FEMatrixCache::n_hits() - n_hits << std::endl;
+
+  // files of a different format are rejected
+  {
+    std::ofstream file("fe_matrices_invalid.bin", std::ios::binary);
+    file << "not a cache file";
+  }
+  try
+    {
+      FEMatrixCache::read("fe_matrices_invalid.bin");
+    }
+  catch (const FEMatrixCache::ExcInvalidCacheFile &)
+    {
+      deallog << "Invalid file rejected, entries: "
+              << FEMatrixCache::n_entries() << std::endl;
+    }
+}
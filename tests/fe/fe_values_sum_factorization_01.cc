@@ -0,0 +1,131 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that FEValues::get_function_values() and get_function_gradients(),
+// which use sum factorization for FE_Q and FE_DGQ of higher degree on
+// tensor-product quadrature formulas, give the same results as the
+// summation over the shape functions on a curved mesh. for elements of
+// degree three and higher, also check an FEValues object that is set up
+// without the flags for the shape function tables
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test(const FiniteElement<dim> &fe)
+{
+  deallog << fe.get_name() << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_shell(tria, Point<dim>(), 0.5, 1.);
+
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  Vector<double> solution(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = std::sin(0.3 * i);
+
+  const MappingQGeneric<dim> mapping(3);
+  const QGauss<dim>          quadrature(fe.degree + 1);
+  FEValues<dim>              fe_values(mapping,
+                          fe,
+                          quadrature,
+                          update_values | update_gradients);
+  const bool    check_without_tables = fe.degree >= 3;
+  FEValues<dim> fe_values_no_tables(mapping,
+                                    fe,
+                                    quadrature,
+                                    check_without_tables ?
+                                      update_default :
+                                      update_values | update_gradients);
+
+  std::vector<double>         values(quadrature.size());
+  std::vector<Tensor<1, dim>> gradients(quadrature.size());
+  std::vector<double>         values_no_tables(quadrature.size());
+  std::vector<Tensor<1, dim>> gradients_no_tables(quadrature.size());
+  std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+
+  double max_value = 0, error_value = 0, error_gradient = 0,
+         error_no_tables = 0;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      fe_values.reinit(cell);
+      fe_values.get_function_values(solution, values);
+      fe_values.get_function_gradients(solution, gradients);
+      fe_values_no_tables.reinit(cell);
+      fe_values_no_tables.get_function_values(solution, values_no_tables);
+      fe_values_no_tables.get_function_gradients(solution,
+                                                 gradients_no_tables);
+      cell->get_dof_indices(dof_indices);
+      for (unsigned int q = 0; q < quadrature.size(); ++q)
+        {
+          double         value = 0;
+          Tensor<1, dim> gradient;
+          for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+            {
+              value += solution(dof_indices[i]) * fe_values.shape_value(i, q);
+              gradient += solution(dof_indices[i]) * fe_values.shape_grad(i, q);
+            }
+          max_value   = std::max(max_value, std::abs(value));
+          error_value = std::max(error_value, std::abs(value - values[q]));
+          error_gradient =
+            std::max(error_gradient, (gradient - gradients[q]).norm());
+          error_no_tables =
+            std::max(error_no_tables,
+                     std::abs(values[q] - values_no_tables[q]) +
+                       (gradients[q] - gradients_no_tables[q]).norm());
+        }
+    }
+  deallog << "Function values nonzero: " << (max_value > 0.1) << std::endl;
+  deallog << "Error values:    " << filter_out_small_numbers(error_value, 1e-12)
+          << std::endl;
+  deallog << "Error gradients: "
+          << filter_out_small_numbers(error_gradient, 1e-10) << std::endl;
+  if (check_without_tables)
+    deallog << "Error without shape function tables: "
+            << filter_out_small_numbers(error_no_tables, 1e-12) << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>(FE_Q<2>(2));
+  test<2>(FE_Q<2>(4));
+  test<2>(FE_DGQ<2>(5));
+  test<3>(FE_Q<3>(3));
+  test<3>(FE_DGQ<3>(4));
+}
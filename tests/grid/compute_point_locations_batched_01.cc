@@ -0,0 +1,174 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test GridTools::compute_point_locations_batched: check that the points are
+// found in the same cells as with GridTools::compute_point_locations, that
+// the reference points are mapped back to the original points, and that
+// points outside the mesh are reported as missing. also check the format
+// when no point at all or no point inside the mesh is given
+
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/grid/tria.h>
+
+#include "../tests.h"
+
+
+// check the compressed format and the sorting of the cells
+template <int dim>
+bool
+check_format(const GridTools::PointLocations<dim, dim> &locations,
+             const unsigned int                         n_points)
+{
+  bool format_ok =
+    locations.cell_ptrs.size() == locations.cells.size() + 1 &&
+    locations.cell_ptrs.back() == locations.point_indices.size() &&
+    locations.point_indices.size() == locations.reference_points.size() &&
+    locations.point_indices.size() + locations.missing_points.size() ==
+      n_points;
+  for (unsigned int c = 0; c + 1 < locations.cells.size(); ++c)
+    if (!(locations.cells[c]->active_cell_index() <
+          locations.cells[c + 1]->active_cell_index()))
+      format_ok = false;
+  return format_ok;
+}
+
+
+
+template <int dim>
+void
+test(const Triangulation<dim> &tria, const unsigned int n_points)
+{
+  std::vector<Point<dim>> points;
+  for (unsigned int i = 0; i < n_points; ++i)
+    points.push_back(random_point<dim>(-0.5, 0.5));
+
+  // two points outside the mesh
+  points.insert(points.begin() + 3, Point<dim>::unit_vector(0) * 3.);
+  points.push_back(Point<dim>::unit_vector(dim - 1) * -5.);
+
+  GridTools::Cache<dim> cache(tria);
+  const GridTools::PointLocations<dim, dim> locations =
+    GridTools::compute_point_locations_batched(cache, points);
+
+  deallog << "Missing points:";
+  for (const unsigned int i : locations.missing_points)
+    deallog << ' ' << i;
+  deallog << std::endl;
+
+  deallog << "Format ok: " << check_format(locations, points.size())
+          << std::endl;
+
+  // check the reference points and compare the cells with the function
+  // that locates one point after the other
+  std::vector<Point<dim>>   inside_points;
+  std::vector<unsigned int> inside_indices;
+  for (unsigned int i = 0; i < points.size(); ++i)
+    if (std::find(locations.missing_points.begin(),
+                  locations.missing_points.end(),
+                  i) == locations.missing_points.end())
+      {
+        inside_points.push_back(points[i]);
+        inside_indices.push_back(i);
+      }
+  const auto reference = GridTools::compute_point_locations(cache,
+                                                            inside_points);
+  std::vector<unsigned int> reference_cell(points.size());
+  for (unsigned int c = 0; c < std::get<0>(reference).size(); ++c)
+    for (const unsigned int i : std::get<2>(reference)[c])
+      reference_cell[inside_indices[i]] =
+        std::get<0>(reference)[c]->active_cell_index();
+
+  double error      = 0;
+  bool   same_cells = true;
+  for (unsigned int c = 0; c < locations.cells.size(); ++c)
+    for (unsigned int j = locations.cell_ptrs[c];
+         j < locations.cell_ptrs[c + 1];
+         ++j)
+      {
+        const unsigned int i = locations.point_indices[j];
+        error                = std::max(
+          error,
+          points[i].distance(cache.get_mapping().transform_unit_to_real_cell(
+            locations.cells[c], locations.reference_points[j])));
+        if (reference_cell[i] != locations.cells[c]->active_cell_index())
+          same_cells = false;
+      }
+  deallog << "Error of reference points: "
+          << filter_out_small_numbers(error, 1e-10) << std::endl;
+  deallog << "Same cells as compute_point_locations: " << same_cells
+          << std::endl;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "dim = " << dim << std::endl;
+  {
+    Triangulation<dim> tria;
+    GridGenerator::hyper_cube(tria, -1, 1);
+    tria.refine_global(3);
+    test(tria, 500);
+  }
+  {
+    Triangulation<dim> tria;
+    GridGenerator::hyper_ball(tria);
+    tria.refine_global(2);
+    test(tria, 500);
+  }
+  {
+    Triangulation<dim> tria;
+    GridGenerator::hyper_cube(tria, -1, 1);
+    tria.refine_global(1);
+    GridTools::Cache<dim> cache(tria);
+
+    const std::vector<Point<dim>> no_points;
+    deallog << "Format ok without points: "
+            << check_format(
+                 GridTools::compute_point_locations_batched(cache, no_points),
+                 0)
+            << std::endl;
+
+    const std::vector<Point<dim>> outside_points(
+      3, Point<dim>::unit_vector(0) * 3.);
+    const GridTools::PointLocations<dim, dim> locations =
+      GridTools::compute_point_locations_batched(cache, outside_points);
+    deallog << "Format ok without points inside: "
+            << check_format(locations, outside_points.size()) << std::endl;
+    deallog << "Missing points:";
+    for (const unsigned int i : locations.missing_points)
+      deallog << ' ' << i;
+    deallog << std::endl;
+  }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// with many different elements, check that the DoF indices stored on faces
+// for each of the active fe indices of the face agree with the ones of the
+// adjacent cells, and that the active fe indices of faces and edges are
+// sorted and unique
+
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <deal.II/hp/dof_handler.h>
+
+#include "../tests.h"
+
+
+
+template <typename Iterator>
+void
+check_fe_indices(const Iterator &object)
+{
+  for (unsigned int n = 1; n < object->n_active_fe_indices(); ++n)
+    AssertThrow(object->nth_active_fe_index(n - 1) <
+                  object->nth_active_fe_index(n),
+                ExcInternalError());
+  for (unsigned int n = 0; n < object->n_active_fe_indices(); ++n)
+    AssertThrow(object->fe_index_is_active(object->nth_active_fe_index(n)),
+                ExcInternalError());
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  hp::FECollection<dim> fe_collection;
+  for (unsigned int degree = 1; degree <= (dim == 2 ? 10 : 5); ++degree)
+    fe_collection.push_back(FE_Q<dim>(degree));
+
+  hp::DoFHandler<dim> dof_handler(tria);
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    cell->set_active_fe_index(Testing::rand() % fe_collection.size());
+  dof_handler.distribute_dofs(fe_collection);
+
+  deallog << "Number of dofs: " << dof_handler.n_dofs() << std::endl;
+
+  unsigned int n_faces_with_two_fes = 0;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      const FiniteElement<dim> &fe = cell->get_fe();
+      std::vector<types::global_dof_index> cell_dof_indices(fe.dofs_per_cell);
+      std::vector<types::global_dof_index> face_dof_indices(fe.dofs_per_face);
+      cell->get_dof_indices(cell_dof_indices);
+
+      for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          check_fe_indices(cell->face(f));
+          if (cell->face(f)->n_active_fe_indices() == 2)
+            ++n_faces_with_two_fes;
+
+          if (cell->face(f)->has_children())
+            continue;
+
+          cell->face(f)->get_dof_indices(face_dof_indices,
+                                         cell->active_fe_index());
+          for (unsigned int i = 0; i < fe.dofs_per_face; ++i)
+            AssertThrow(face_dof_indices[i] ==
+                          cell_dof_indices[fe.face_to_cell_index(i, f)],
+                        ExcInternalError());
+        }
+
+      if (dim == 3)
+        for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell; ++l)
+          check_fe_indices(cell->line(l));
+    }
+
+  // every face shared by two cells with different elements is counted twice
+  deallog << "Faces with two active fe indices: " << n_faces_with_two_fes / 2
+          << std::endl;
+  deallog << "OK" << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
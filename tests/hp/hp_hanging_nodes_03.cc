@@ -0,0 +1,119 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that the hanging node constraints computed with several threads
+// working on different parts of the mesh are the same as the ones computed
+// by a single thread, for a mesh that is large enough to be split and with a
+// random distribution of finite elements
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <deal.II/hp/dof_handler.h>
+#include <deal.II/hp/fe_collection.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(dim == 2 ? 4 : 2);
+  for (unsigned int i = 0; i < 2; ++i)
+    {
+      for (const auto &cell : tria.active_cell_iterators())
+        if (random_value<double>() < 0.4)
+          cell->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+    }
+
+  hp::FECollection<dim> fe;
+  for (unsigned int degree = 1; degree <= 3; ++degree)
+    fe.push_back(FE_Q<dim>(degree));
+
+  hp::DoFHandler<dim> dof_handler(tria);
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    cell->set_active_fe_index(Testing::rand() % fe.size());
+  dof_handler.distribute_dofs(fe);
+
+  deallog << "Number of active cells: " << tria.n_active_cells() << std::endl;
+  deallog << "Number of dofs: " << dof_handler.n_dofs() << std::endl;
+
+  AffineConstraints<double> serial_constraints;
+  MultithreadInfo::set_thread_limit(1);
+  DoFTools::make_hanging_node_constraints(dof_handler, serial_constraints);
+  serial_constraints.close();
+
+  AffineConstraints<double> parallel_constraints;
+  MultithreadInfo::set_thread_limit(testing_max_num_threads());
+  DoFTools::make_hanging_node_constraints(dof_handler, parallel_constraints);
+  parallel_constraints.close();
+
+  deallog << "Number of constraints: " << serial_constraints.n_constraints()
+          << " " << parallel_constraints.n_constraints() << std::endl;
+
+  double difference = 0;
+  for (types::global_dof_index i = 0; i < dof_handler.n_dofs(); ++i)
+    {
+      AssertThrow(serial_constraints.is_constrained(i) ==
+                    parallel_constraints.is_constrained(i),
+                  ExcInternalError());
+      if (serial_constraints.is_constrained(i))
+        {
+          const auto &serial_entries =
+            *serial_constraints.get_constraint_entries(i);
+          const auto &parallel_entries =
+            *parallel_constraints.get_constraint_entries(i);
+          AssertThrow(serial_entries.size() == parallel_entries.size(),
+                      ExcInternalError());
+          for (unsigned int e = 0; e < serial_entries.size(); ++e)
+            {
+              AssertThrow(serial_entries[e].first ==
+                            parallel_entries[e].first,
+                          ExcInternalError());
+              difference += std::abs(serial_entries[e].second -
+                                     parallel_entries[e].second);
+            }
+        }
+    }
+  deallog << "Difference: " << filter_out_small_numbers(difference, 1e-12)
+          << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,167 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Test EigenLOBPCG on the five-point finite difference Laplacian, whose
+// eigenvalues are known: the standard problem with an SSOR preconditioner,
+// with and without soft locking, the generalized problem with a diagonal
+// mass matrix, and the standard problem on LinearAlgebra::distributed::Vector
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/eigen_lobpcg.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+template <typename VectorType>
+void
+initial_guess(MultiVector<VectorType> &X)
+{
+  for (unsigned int j = 0; j < X.n_vectors(); ++j)
+    for (unsigned int i = 0; i < X.size(); ++i)
+      X[j](i) = 1. + std::sin(0.37 * (j + 1) * i + 0.1 * j * j);
+}
+
+
+
+void
+check_eigenvalues(const std::vector<double> &eigenvalues,
+                  const std::vector<double> &exact,
+                  const double               scaling)
+{
+  double error = 0.;
+  for (unsigned int i = 0; i < eigenvalues.size(); ++i)
+    error = std::max(error, std::abs(eigenvalues[i] - scaling * exact[i]));
+  deallog << "Eigenvalues:";
+  for (const double eigenvalue : eigenvalues)
+    deallog << ' ' << filter_out_small_numbers(eigenvalue, 1e-6);
+  deallog << std::endl;
+  deallog << "Error: " << filter_out_small_numbers(error, 1e-8) << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  const unsigned int  n_eigenpairs = 4;
+  std::vector<double> exact;
+  for (unsigned int i = 1; i < size; ++i)
+    for (unsigned int j = 1; j < size; ++j)
+      exact.push_back(4. - 2. * std::cos(numbers::PI * i / size) -
+                      2. * std::cos(numbers::PI * j / size));
+  std::sort(exact.begin(), exact.end());
+  exact.resize(n_eigenpairs);
+
+  PreconditionSSOR<> ssor;
+  ssor.initialize(A, 1.2);
+
+  // standard problem with and without soft locking
+  unsigned int n_products[2] = {0, 0};
+  for (const bool soft_locking : {true, false})
+    {
+      SolverControl control(1000, 1e-8, false, false);
+      EigenLOBPCG<> solver(control,
+                           EigenLOBPCG<>::AdditionalData(soft_locking));
+
+      MultiVector<Vector<double>> X(n_eigenpairs, Vector<double>(dim));
+      initial_guess(X);
+      std::vector<double> eigenvalues;
+      solver.solve(A, ssor, eigenvalues, X);
+      n_products[soft_locking ? 0 : 1] = solver.n_matrix_vector_products();
+
+      deallog.push(soft_locking ? "soft_locking" : "no_locking");
+      check_eigenvalues(eigenvalues, exact, 1.);
+
+      Vector<double> residual(dim);
+      double         max_residual = 0.;
+      for (unsigned int j = 0; j < n_eigenpairs; ++j)
+        {
+          A.vmult(residual, X[j]);
+          residual.add(-eigenvalues[j], X[j]);
+          max_residual = std::max(max_residual, residual.l2_norm());
+        }
+      deallog << "Residuals below tolerance: "
+              << (max_residual < 1e-8 ? "yes" : "no") << std::endl;
+      deallog.pop();
+    }
+  deallog << "Soft locking saves matrix-vector products: "
+          << (n_products[0] < n_products[1] ? "yes" : "no") << std::endl;
+
+  // generalized problem with the mass matrix 2 I, which halves the
+  // eigenvalues and makes the eigenvectors B-orthonormal
+  {
+    Vector<double> mass(dim);
+    mass = 2.;
+    DiagonalMatrix<Vector<double>> B;
+    B.reinit(mass);
+
+    SolverControl control(1000, 1e-8, false, false);
+    EigenLOBPCG<> solver(control);
+
+    MultiVector<Vector<double>> X(n_eigenpairs, Vector<double>(dim));
+    initial_guess(X);
+    std::vector<double> eigenvalues;
+    solver.solve(A, B, ssor, eigenvalues, X);
+
+    deallog.push("generalized");
+    check_eigenvalues(eigenvalues, exact, 0.5);
+    FullMatrix<double> gram;
+    X.Tmmult(gram, X);
+    for (unsigned int i = 0; i < n_eigenpairs; ++i)
+      gram(i, i) -= 0.5;
+    deallog << "B-orthonormal: " << (gram.linfty_norm() < 1e-10 ? "yes" : "no")
+            << std::endl;
+    deallog.pop();
+  }
+
+  // standard problem on distributed vectors without preconditioner
+  {
+    using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+    SolverControl           control(1000, 1e-8, false, false);
+    EigenLOBPCG<VectorType> solver(control);
+
+    MultiVector<VectorType> X(n_eigenpairs, VectorType(dim));
+    initial_guess(X);
+    std::vector<double> eigenvalues;
+    solver.solve(A, PreconditionIdentity(), eigenvalues, X);
+
+    deallog.push("distributed");
+    check_eigenvalues(eigenvalues, exact, 1.);
+    deallog.pop();
+  }
+}
@@ -0,0 +1,129 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SolverGMRES with the classical Gram-Schmidt orthogonalization for
+// the difficult matrices of gmres_reorthogonalize_01, for dealii::Vector
+// and LinearAlgebra::distributed::Vector, and compare with the modified
+// Gram-Schmidt orthogonalization
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+// A wrapper around a FullMatrix that works on distributed vectors
+class DistributedMatrix
+{
+public:
+  DistributedMatrix(const FullMatrix<double> &matrix)
+    : matrix(matrix)
+  {}
+
+  void
+  vmult(LinearAlgebra::distributed::Vector<double> &      dst,
+        const LinearAlgebra::distributed::Vector<double> &src) const
+  {
+    Vector<double> serial_src(src.begin(), src.end());
+    Vector<double> serial_dst(dst.size());
+    matrix.vmult(serial_dst, serial_src);
+    std::copy(serial_dst.begin(), serial_dst.end(), dst.begin());
+  }
+
+private:
+  const FullMatrix<double> &matrix;
+};
+
+
+
+template <typename VectorType, typename MatrixType>
+void
+solve(const MatrixType & matrix,
+      const bool         use_classical_gram_schmidt,
+      VectorType &       sol,
+      const unsigned int n_steps)
+{
+  VectorType rhs(sol);
+  rhs = 1.;
+  sol = 0.;
+
+  SolverControl control(1000, 1e2 * std::numeric_limits<double>::epsilon());
+  typename SolverGMRES<VectorType>::AdditionalData data;
+  data.max_n_tmp_vectors = 80;
+  if (use_classical_gram_schmidt)
+    data.orthogonalization_strategy = SolverGMRES<VectorType>::
+      AdditionalData::OrthogonalizationStrategy::classical_gram_schmidt;
+
+  SolverGMRES<VectorType> solver(control, data);
+  check_solver_within_range(
+    solver.solve(matrix, sol, rhs, PreconditionIdentity()),
+    control.last_step(),
+    n_steps,
+    n_steps + 2);
+}
+
+
+
+void
+test(const unsigned int variant, const unsigned int n_steps)
+{
+  const unsigned int n = 64;
+
+  FullMatrix<double> matrix(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int j = 0; j < n; ++j)
+      matrix(i, j) = random_value<double>(-.1, .1);
+  for (unsigned int i = 0; i < n; ++i)
+    matrix(i, i) = (variant == 0 ? 1. : 1e10) * (i + 1);
+
+  deallog.push(Utilities::int_to_string(variant, 1));
+
+  Vector<double> sol_mgs(n), sol_cgs(n);
+  solve(matrix, false, sol_mgs, n_steps);
+  solve(matrix, true, sol_cgs, n_steps);
+  sol_cgs -= sol_mgs;
+  deallog << "Relative difference: "
+          << filter_out_small_numbers(sol_cgs.l2_norm() / sol_mgs.l2_norm(),
+                                      1e-8)
+          << std::endl;
+
+  LinearAlgebra::distributed::Vector<double> sol_distributed(n);
+  solve(DistributedMatrix(matrix), true, sol_distributed, n_steps);
+  for (unsigned int i = 0; i < n; ++i)
+    sol_distributed(i) -= sol_mgs(i);
+  deallog << "Relative difference distributed: "
+          << filter_out_small_numbers(sol_distributed.l2_norm() /
+                                        sol_mgs.l2_norm(),
+                                      1e-8)
+          << std::endl;
+
+  deallog.pop();
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test(0, 56);
+  test(1, 56);
+}
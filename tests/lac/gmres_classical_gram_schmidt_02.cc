@@ -0,0 +1,97 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SolverGMRES with the classical Gram-Schmidt orthogonalization on
+// vectors that are long enough to be split into several chunks that are
+// worked on by different threads, and compare with the modified
+// Gram-Schmidt orthogonalization
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+// A diagonal operator with entries between 1 and 100
+class DiagonalOperator
+{
+public:
+  template <typename VectorType>
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    for (unsigned int i = 0; i < src.size(); ++i)
+      dst(i) = (1. + i % 100) * src(i);
+  }
+};
+
+
+
+template <typename VectorType>
+void
+solve(const bool use_classical_gram_schmidt, VectorType &sol)
+{
+  VectorType rhs(sol);
+  for (unsigned int i = 0; i < rhs.size(); ++i)
+    rhs(i) = 1. + 0.1 * (i % 7);
+  sol = 0.;
+
+  SolverControl control(1000, 1e-10 * rhs.l2_norm());
+  typename SolverGMRES<VectorType>::AdditionalData data;
+  data.max_n_tmp_vectors = 40;
+  if (use_classical_gram_schmidt)
+    data.orthogonalization_strategy = SolverGMRES<VectorType>::
+      AdditionalData::OrthogonalizationStrategy::classical_gram_schmidt;
+
+  SolverGMRES<VectorType> solver(control, data);
+  solver.solve(DiagonalOperator(), sol, rhs, PreconditionIdentity());
+  deallog << "Iterations: " << control.last_step() << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+  MultithreadInfo::set_thread_limit(4);
+
+  const unsigned int n = 100000;
+
+  Vector<double> sol_mgs(n), sol_cgs(n);
+  solve(false, sol_mgs);
+  solve(true, sol_cgs);
+  sol_cgs -= sol_mgs;
+  deallog << "Relative difference: "
+          << filter_out_small_numbers(sol_cgs.l2_norm() / sol_mgs.l2_norm(),
+                                      1e-8)
+          << std::endl;
+
+  LinearAlgebra::distributed::Vector<double> sol_distributed(n);
+  solve(true, sol_distributed);
+  for (unsigned int i = 0; i < n; ++i)
+    sol_distributed(i) -= sol_mgs(i);
+  deallog << "Relative difference distributed: "
+          << filter_out_small_numbers(sol_distributed.l2_norm() /
+                                        sol_mgs.l2_norm(),
+                                      1e-8)
+          << std::endl;
+}
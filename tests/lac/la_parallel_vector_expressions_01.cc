@@ -0,0 +1,126 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check that the vector expressions of LinearAlgebra::distributed::Vector
+// give the same results as the separate vector operations, including the
+// reductions computed together with the assignment. The reductions must
+// agree bit for bit with the inner products and norms of the assigned vector
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_vector_expressions.h>
+
+#include "../tests.h"
+
+
+template <typename number>
+number
+relative_difference(const number a, const number b)
+{
+  const number result = std::abs(a - b) / std::abs(b);
+  return (result < 1e3 * std::numeric_limits<number>::epsilon() ? 0. :
+                                                                   result);
+}
+
+
+
+template <typename number>
+number
+relative_difference(
+  const LinearAlgebra::distributed::Vector<number> &a,
+  const LinearAlgebra::distributed::Vector<number> &b)
+{
+  LinearAlgebra::distributed::Vector<number> difference(a);
+  difference -= b;
+  const number result = difference.linfty_norm() / b.linfty_norm();
+  return (result < 1e3 * std::numeric_limits<number>::epsilon() ? 0. :
+                                                                   result);
+}
+
+
+
+template <typename number>
+void
+check()
+{
+  using VectorType = LinearAlgebra::distributed::Vector<number>;
+  namespace VectorReductions = LinearAlgebra::distributed::VectorReductions;
+
+  for (unsigned int test = 0; test < 5; ++test)
+    {
+      const unsigned int size         = 17 + test * 1101;
+      const IndexSet     complete_set = complete_index_set(size);
+      VectorType         x(complete_set, MPI_COMM_SELF),
+        y(complete_set, MPI_COMM_SELF), z(complete_set, MPI_COMM_SELF),
+        w(complete_set, MPI_COMM_SELF), p(complete_set, MPI_COMM_SELF);
+      for (unsigned int i = 0; i < size; ++i)
+        {
+          y(i) = 0.1 + 0.005 * i;
+          z(i) = -5.2 + 0.18 * (i % 31);
+          w(i) = 3.14159 + 2.7183 / (1. + i);
+        }
+      const number a = 1.5, b = -0.25, c = 0.125;
+
+      const auto Y = make_vector_expression(y);
+      const auto Z = make_vector_expression(z);
+      const auto W = make_vector_expression(w);
+
+      // linear combination compared to separate operations
+      VectorType reference(y);
+      reference.sadd(a, b, z);
+      reference.add(-c, w);
+      x = a * Y + b * Z - c * W;
+      deallog << "Size " << size
+              << " linear combination: " << relative_difference(x, reference);
+
+      // the same together with reductions
+      x = 0;
+      const std::array<number, 3> reduced = x.assign_and_reduce(
+        a * Y + b * Z - c * W,
+        VectorReductions::dot(w),
+        VectorReductions::norm_sqr(),
+        VectorReductions::dot(x));
+      deallog << " reduction: " << relative_difference(x, reference) << ' '
+              << relative_difference(reduced[0], reference * w) << ' '
+              << relative_difference(reduced[1], reference.norm_sqr()) << ' '
+              << relative_difference(reduced[2], reference.norm_sqr());
+      deallog << " exact: "
+              << (reduced[0] == x * w && reduced[1] == x.norm_sqr() &&
+                  reduced[2] == x * x);
+
+      // entry-wise products and several vectors updated at once, with the
+      // assigned vector also appearing in the expression
+      x = y;
+      reference.equ(2., z);
+      reference.scale(w);
+      reference.add(-1., y);
+      VectorType reference_x(y);
+      reference_x.add(-0.5, reference);
+      x = make_vector_expression(x) -
+          number(0.5) *
+            store_in(p, number(2.) * entrywise_product(Z, w) - Y);
+      deallog << " stored: " << relative_difference(p, reference) << ' '
+              << relative_difference(x, reference_x) << std::endl;
+    }
+}
+
+
+int
+main()
+{
+  initlog();
+  check<float>();
+  check<double>();
+}
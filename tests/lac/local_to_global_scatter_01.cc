@@ -0,0 +1,186 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that LocalToGlobalScatter gives the same matrix and right hand side
+// as AffineConstraints::distribute_local_to_global on an adaptively refined
+// mesh with hanging nodes and inhomogeneous boundary conditions, both for
+// the single-cell and the batched interface
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/local_to_global_scatter.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test(const unsigned int degree)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.begin()->face(0)->set_boundary_id(1);
+  tria.refine_global(1);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  VectorTools::interpolate_boundary_values(dof,
+                                           1,
+                                           Functions::ConstantFunction<dim>(1.),
+                                           constraints);
+  constraints.close();
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp(dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern(dof, dsp, constraints, false);
+    sparsity.copy_from(dsp);
+  }
+
+  LocalToGlobalScatter<double> scatter;
+  scatter.reinit(sparsity, constraints);
+
+  std::vector<types::global_dof_index> local_dof_indices(fe.dofs_per_cell);
+  unsigned int                         n_constrained_cells = 0;
+  for (const auto &cell : dof.active_cell_iterators())
+    {
+      cell->get_dof_indices(local_dof_indices);
+      const unsigned int index = scatter.add_cell(local_dof_indices);
+      if (scatter.is_constrained(index))
+        ++n_constrained_cells;
+    }
+  deallog << "Number of cells: " << scatter.n_cells()
+          << ", constrained: " << n_constrained_cells << std::endl;
+
+  // random cell matrices and vectors, with some zero diagonal entries to
+  // check the treatment of the diagonal of constrained rows
+  std::vector<FullMatrix<double>> cell_matrices(
+    scatter.n_cells(), FullMatrix<double>(fe.dofs_per_cell));
+  std::vector<Vector<double>> cell_vectors(scatter.n_cells(),
+                                           Vector<double>(fe.dofs_per_cell));
+  for (unsigned int c = 0; c < scatter.n_cells(); ++c)
+    {
+      for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+        {
+          for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+            cell_matrices[c](i, j) = random_value<double>();
+          cell_vectors[c](i) = random_value<double>();
+        }
+      cell_matrices[c](c % fe.dofs_per_cell, c % fe.dofs_per_cell) = 0.;
+    }
+
+  SparseMatrix<double> reference(sparsity), single(sparsity), batched(sparsity);
+  Vector<double> reference_rhs(dof.n_dofs()), single_rhs(dof.n_dofs()),
+    batched_rhs(dof.n_dofs());
+
+  unsigned int c = 0;
+  for (const auto &cell : dof.active_cell_iterators())
+    {
+      cell->get_dof_indices(local_dof_indices);
+      constraints.distribute_local_to_global(cell_matrices[c],
+                                             cell_vectors[c],
+                                             local_dof_indices,
+                                             reference,
+                                             reference_rhs,
+                                             true);
+      scatter.distribute_local_to_global(
+        c, cell_matrices[c], cell_vectors[c], single, single_rhs, true);
+      ++c;
+    }
+
+  // scatter in batches of three cells
+  for (unsigned int first = 0; first < scatter.n_cells(); first += 3)
+    {
+      const unsigned int n = std::min(3U, scatter.n_cells() - first);
+      scatter.distribute_local_to_global(
+        first,
+        ArrayView<const FullMatrix<double>>(&cell_matrices[first], n),
+        ArrayView<const Vector<double>>(&cell_vectors[first], n),
+        batched,
+        batched_rhs,
+        true);
+    }
+
+  single.add(-1., reference);
+  batched.add(-1., reference);
+  single_rhs -= reference_rhs;
+  batched_rhs -= reference_rhs;
+  deallog << "Matrix norm: " << reference.frobenius_norm() << std::endl;
+  deallog << "Difference single cell: "
+          << filter_out_small_numbers(single.frobenius_norm(), 1e-12) << " "
+          << filter_out_small_numbers(single_rhs.l2_norm(), 1e-12)
+          << std::endl;
+  deallog << "Difference batched: "
+          << filter_out_small_numbers(batched.frobenius_norm(), 1e-12) << " "
+          << filter_out_small_numbers(batched_rhs.l2_norm(), 1e-12)
+          << std::endl;
+
+  // the matrix-only interface
+  single = 0;
+  reference = 0;
+  c         = 0;
+  for (const auto &cell : dof.active_cell_iterators())
+    {
+      cell->get_dof_indices(local_dof_indices);
+      constraints.distribute_local_to_global(cell_matrices[c],
+                                             local_dof_indices,
+                                             reference);
+      ++c;
+    }
+  scatter.distribute_local_to_global(
+    0,
+    ArrayView<const FullMatrix<double>>(cell_matrices),
+    single);
+  single.add(-1., reference);
+  deallog << "Difference matrix only: "
+          << filter_out_small_numbers(single.frobenius_norm(), 1e-12)
+          << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+  deallog << std::setprecision(6);
+
+  test<2>(1);
+  test<2>(2);
+  test<3>(1);
+}
@@ -0,0 +1,184 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Test the fourth-kind Chebyshev polynomials of PreconditionChebyshev: the
+// fused updates for DiagonalMatrix around Vector and
+// LinearAlgebra::distributed::Vector must agree with the generic updates
+// used for other preconditioners, the smoother must reduce the residual,
+// and the eigenvalue estimates must be reused after re-initialization as
+// long as the power iteration check stays within the tolerance.
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+// wraps the inverse diagonal without being a DiagonalMatrix, in order to
+// select the generic vector updates
+class JacobiWrapper : public Subscriptor
+{
+public:
+  JacobiWrapper(const Vector<double> &diagonal_inverse)
+    : diagonal_inverse(diagonal_inverse)
+  {}
+
+  void
+  vmult(Vector<double> &dst, const Vector<double> &src) const
+  {
+    dst = src;
+    dst.scale(diagonal_inverse);
+  }
+
+private:
+  const Vector<double> diagonal_inverse;
+};
+
+
+
+template <typename VectorType, typename PreconditionerType>
+void
+smooth(const SparseMatrix<double> &                A,
+       const std::shared_ptr<PreconditionerType> &preconditioner,
+       const bool                                 optimal_weights,
+       const unsigned int                         degree,
+       const VectorType &                         b,
+       VectorType &                               x)
+{
+  using Chebyshev =
+    PreconditionChebyshev<SparseMatrix<double>, VectorType, PreconditionerType>;
+  typename Chebyshev::AdditionalData data(degree);
+  data.polynomial_type =
+    optimal_weights ?
+      Chebyshev::AdditionalData::PolynomialType::fourth_kind_optimal :
+      Chebyshev::AdditionalData::PolynomialType::fourth_kind;
+  data.eig_cg_n_iterations = 12;
+  data.preconditioner      = preconditioner;
+  Chebyshev chebyshev;
+  chebyshev.initialize(A, data);
+
+  chebyshev.vmult(x, b);
+  for (unsigned int s = 0; s < 3; ++s)
+    chebyshev.step(x, b);
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  Vector<double> diagonal_inverse(dim), b(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    {
+      diagonal_inverse(i) = 1. / A.diag_element(i);
+      b(i)                = 1. + std::sin(0.1 * i);
+    }
+
+  LinearAlgebra::distributed::Vector<double> diagonal_inverse_la(dim),
+    b_la(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    {
+      diagonal_inverse_la(i) = diagonal_inverse(i);
+      b_la(i)                = b(i);
+    }
+
+  const auto jacobi = std::make_shared<DiagonalMatrix<Vector<double>>>();
+  jacobi->reinit(diagonal_inverse);
+  const auto jacobi_la = std::make_shared<
+    DiagonalMatrix<LinearAlgebra::distributed::Vector<double>>>();
+  jacobi_la->reinit(diagonal_inverse_la);
+  const auto wrapper = std::make_shared<JacobiWrapper>(diagonal_inverse);
+
+  for (const bool optimal_weights : {false, true})
+    for (const unsigned int degree : {0, 3, 6})
+      {
+        Vector<double>                             x(dim), x_generic(dim);
+        LinearAlgebra::distributed::Vector<double> x_la(dim);
+        smooth(A, jacobi, optimal_weights, degree, b, x);
+        smooth(A, wrapper, optimal_weights, degree, b, x_generic);
+        smooth(A, jacobi_la, optimal_weights, degree, b_la, x_la);
+
+        Vector<double> residual(dim);
+        A.vmult(residual, x);
+        residual -= b;
+
+        double difference_la = 0.;
+        for (unsigned int i = 0; i < dim; ++i)
+          difference_la = std::max(difference_la, std::abs(x(i) - x_la(i)));
+        x_generic -= x;
+
+        deallog << (optimal_weights ? "fourth_kind_optimal" : "fourth_kind")
+                << " degree " << degree << ": residual reduced: "
+                << (residual.l2_norm() < b.l2_norm() ? "yes" : "no")
+                << ", difference generic: "
+                << filter_out_small_numbers(x_generic.linfty_norm(), 1e-12)
+                << ", difference LA vector: "
+                << filter_out_small_numbers(difference_la, 1e-12)
+                << std::endl;
+      }
+
+  // reuse of the eigenvalue estimates of the power iteration
+  {
+    SparseMatrix<double> A_scaled(structure);
+    A_scaled.copy_from(A);
+    A_scaled *= 2.;
+
+    using Chebyshev = PreconditionChebyshev<>;
+    Chebyshev::AdditionalData data(4);
+    data.polynomial_type =
+      Chebyshev::AdditionalData::PolynomialType::fourth_kind;
+    data.eigenvalue_algorithm =
+      Chebyshev::AdditionalData::EigenvalueAlgorithm::power_iteration;
+    data.eig_cg_n_iterations        = 40;
+    data.eigenvalue_reuse_tolerance = 0.05;
+    data.preconditioner             = jacobi;
+    Chebyshev chebyshev;
+
+    Vector<double> x(dim);
+    for (unsigned int s = 0; s < 3; ++s)
+      {
+        chebyshev.initialize(s < 2 ? A : A_scaled, data);
+        chebyshev.vmult(x, b);
+        const Chebyshev::EigenvalueInformation &info =
+          chebyshev.get_eigenvalue_information();
+        deallog << "Initialization " << s
+                << ": reused: " << info.reused_previous_estimate
+                << ", iterations: " << info.n_iterations
+                << ", max eigenvalue within 10%: "
+                << (std::abs(info.max_eigenvalue_estimate - (s < 2 ? 2. : 4.)) <
+                        (s < 2 ? 0.2 : 0.4) ?
+                      "yes" :
+                      "no")
+                << std::endl;
+      }
+  }
+}
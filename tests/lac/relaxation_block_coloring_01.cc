@@ -0,0 +1,137 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Test the block relaxation methods with colored blocks and with the packed
+// LU inversion of the diagonal blocks: the colored Jacobi method must agree
+// with the uncolored one, the threaded colored SOR method with the
+// sequential one, and the packed inverses with the Gauss-Jordan inverses.
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/lac/relaxation_block.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+template <typename PreconditionerType>
+Vector<double>
+apply(const PreconditionerType &preconditioner, const Vector<double> &src)
+{
+  Vector<double> dst(src.size());
+  preconditioner.vmult(dst, src);
+  return dst;
+}
+
+
+
+double
+difference(Vector<double> u, const Vector<double> &v)
+{
+  u -= v;
+  const double result = u.l2_norm() / v.l2_norm();
+  return (result < 1e-12 ? 0. : result);
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  Vector<double> src(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    src(i) = 1. + 0.01 * (i % 17);
+
+  // one block for each line of the grid
+  using Relaxation = RelaxationBlock<SparseMatrix<double>, double>;
+  Relaxation::AdditionalData data(0.8);
+  data.block_list.reinit(size - 1, dim, size - 1);
+  for (unsigned int block = 0; block < size - 1; ++block)
+    for (unsigned int i = 0; i < size - 1; ++i)
+      data.block_list.add(block, block * (size - 1) + i);
+  data.block_list.compress();
+
+  Relaxation::AdditionalData colored_data(0.8);
+  colored_data.block_list.copy_from(data.block_list);
+  colored_data.use_coloring = true;
+
+  Relaxation::AdditionalData packed_data(0.8);
+  packed_data.block_list.copy_from(data.block_list);
+  packed_data.use_coloring = true;
+  packed_data.inversion = PreconditionBlockBase<double>::Inversion::packed_lu;
+
+  // each line couples only to the neighboring lines, so the even lines can
+  // be worked on at the same time, and then the odd lines: two colors
+  RelaxationBlockJacobi<SparseMatrix<double>, double> jacobi, colored_jacobi;
+  jacobi.initialize(A, data);
+  colored_jacobi.initialize(A, colored_data);
+  deallog << "Colors: " << jacobi.n_colors() << ' '
+          << colored_jacobi.n_colors() << std::endl;
+  deallog << "Jacobi difference: "
+          << difference(apply(colored_jacobi, src), apply(jacobi, src))
+          << std::endl;
+
+  RelaxationBlockSOR<SparseMatrix<double>, double> sor, packed_sor;
+  sor.initialize(A, colored_data);
+  packed_sor.initialize(A, packed_data);
+  RelaxationBlockSSOR<SparseMatrix<double>, double> ssor, packed_ssor;
+  ssor.initialize(A, colored_data);
+  packed_ssor.initialize(A, packed_data);
+
+  // the colored sweeps on several threads must give the same result as on
+  // a single thread
+  MultithreadInfo::set_thread_limit(1);
+  const Vector<double> sor_sequential  = apply(sor, src);
+  const Vector<double> ssor_sequential = apply(ssor, src);
+  MultithreadInfo::set_thread_limit(3);
+  deallog << "SOR difference: " << difference(apply(sor, src), sor_sequential)
+          << std::endl;
+  deallog << "SSOR difference: "
+          << difference(apply(ssor, src), ssor_sequential) << std::endl;
+
+  deallog << "Packed SOR difference: "
+          << difference(apply(packed_sor, src), sor_sequential) << std::endl;
+  deallog << "Packed SSOR difference: "
+          << difference(apply(packed_ssor, src), ssor_sequential) << std::endl;
+
+  // the packed inverses must not change the convergence of the
+  // preconditioned solver
+  SolverControl            control(100, 1.e-8);
+  SolverCG<Vector<double>> solver(control);
+  Vector<double>           u(dim);
+  solver.solve(A, u, src, ssor);
+  const unsigned int n_iterations = control.last_step();
+  u                               = 0.;
+  solver.solve(A, u, src, packed_ssor);
+  deallog << "Same number of iterations with packed inverses: "
+          << (control.last_step() == n_iterations) << std::endl;
+}
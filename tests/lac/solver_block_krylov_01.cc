@@ -0,0 +1,167 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Test SolverBlockCG and SolverBlockGMRES with several right hand sides: the
+// multivector product of SparseMatrix must agree with the products of the
+// single vectors, the solutions must agree with the ones of SolverCG and
+// SolverGMRES, and a right hand side whose initial guess is already the
+// solution must be deflated right away. SolverBlockCG must also handle
+// right hand sides that are linearly dependent on each other.
+
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_block_krylov.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+const unsigned int n_rhs = 6;
+
+
+void
+make_rhs(MultiVector<Vector<double>> &B)
+{
+  for (unsigned int v = 0; v < B.n_vectors(); ++v)
+    for (unsigned int i = 0; i < B.size(); ++i)
+      B[v](i) = 1. + std::sin(0.1 * (v + 1) * i);
+}
+
+
+
+template <typename SolverType, typename BlockSolverType, typename Precondition>
+void
+test(const SparseMatrix<double> &A,
+     const Precondition &        preconditioner,
+     const std::string &         name,
+     const unsigned int          min_steps,
+     const unsigned int          max_steps)
+{
+  MultiVector<Vector<double>> B(n_rhs, Vector<double>(A.m()));
+  MultiVector<Vector<double>> X(n_rhs, Vector<double>(A.m()));
+  make_rhs(B);
+
+  // the first solution is known up front
+  for (unsigned int i = 0; i < A.m(); ++i)
+    X[0](i) = 1.;
+  A.vmult(B[0], X[0]);
+
+  {
+    deallog.push(name);
+    SolverControl   control(1000, 1.e-8);
+    BlockSolverType solver(control);
+    check_solver_within_range(solver.solve(A, X, B, preconditioner),
+                              control.last_step(),
+                              min_steps,
+                              max_steps);
+    deallog.pop();
+  }
+
+  double difference = 0.;
+  for (unsigned int v = 0; v < n_rhs; ++v)
+    {
+      SolverControl  control(1000, 1.e-12, false, false);
+      SolverType     solver(control);
+      Vector<double> x(A.m());
+      solver.solve(A, x, B[v], preconditioner);
+      x -= X[v];
+      difference = std::max(difference, x.linfty_norm());
+    }
+  deallog << "Difference to single solves: "
+          << (difference < 1.e-6 ? 0. : difference) << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+  SparseMatrix<double> A_nonsymmetric(structure);
+  testproblem.five_point(A_nonsymmetric, true);
+
+  // the multivector product must give the same result as the single
+  // products
+  {
+    MultiVector<Vector<double>> src(n_rhs, Vector<double>(dim));
+    MultiVector<Vector<double>> dst(n_rhs, Vector<double>(dim));
+    make_rhs(src);
+    A.vmult(dst, src);
+    double difference = 0.;
+    for (unsigned int v = 0; v < n_rhs; ++v)
+      {
+        Vector<double> tmp(dim);
+        A.vmult(tmp, src[v]);
+        tmp -= dst[v];
+        difference = std::max(difference, tmp.linfty_norm());
+      }
+    deallog << "Difference of vmult: " << difference << std::endl;
+  }
+
+  PreconditionSSOR<> ssor;
+  ssor.initialize(A, 1.2);
+
+  test<SolverCG<>, SolverBlockCG<>>(A, PreconditionIdentity(), "cg", 60, 80);
+  test<SolverCG<>, SolverBlockCG<>>(A, ssor, "cg-ssor", 15, 40);
+
+  // parallel right hand sides make the search directions linearly
+  // dependent, one of which must be dropped
+  {
+    MultiVector<Vector<double>> B(3, Vector<double>(dim));
+    MultiVector<Vector<double>> X(3, Vector<double>(dim));
+    make_rhs(B);
+    B[2] = B[1];
+    B[2] *= 2.;
+
+    deallog.push("cg-dependent");
+    SolverControl   control(1000, 1.e-8);
+    SolverBlockCG<> solver(control);
+    check_solver_within_range(solver.solve(A, X, B, ssor),
+                              control.last_step(),
+                              15,
+                              40);
+    deallog.pop();
+
+    double difference = 0.;
+    for (unsigned int v = 0; v < 3; ++v)
+      {
+        Vector<double> r(dim);
+        A.vmult(r, X[v]);
+        r -= B[v];
+        difference = std::max(difference, r.l2_norm());
+      }
+    deallog << "Residuals below tolerance: " << (difference < 1.e-7)
+            << std::endl;
+  }
+
+  test<SolverGMRES<>, SolverBlockGMRES<>>(
+    A_nonsymmetric, PreconditionIdentity(), "gmres", 190, 230);
+}
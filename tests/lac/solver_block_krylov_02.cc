@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Test SolverBlockCG and SolverBlockGMRES with a block of right hand sides
+// of lower rank, containing a zero vector and a vector that is the sum of
+// two others, together with the products of MultiVector objects without
+// vectors that the solvers run into. This test is run in debug mode only,
+// where the dimensions of all products between multivectors are checked.
+
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_block_krylov.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+void
+make_rhs(MultiVector<Vector<double>> &B)
+{
+  for (unsigned int v = 0; v < 2; ++v)
+    for (unsigned int i = 0; i < B.size(); ++i)
+      B[v](i) = 1. + std::sin(0.1 * (v + 1) * i);
+  B[2] = B[0];
+  B[2] += B[1];
+  B[3] = 0.;
+}
+
+
+
+template <typename BlockSolverType, typename Precondition>
+void
+test(const SparseMatrix<double> &A,
+     const Precondition &        preconditioner,
+     const std::string &         name,
+     const unsigned int          min_steps,
+     const unsigned int          max_steps)
+{
+  MultiVector<Vector<double>> B(4, Vector<double>(A.m()));
+  MultiVector<Vector<double>> X(4, Vector<double>(A.m()));
+  make_rhs(B);
+
+  {
+    deallog.push(name);
+    SolverControl   control(1000, 1.e-8);
+    BlockSolverType solver(control);
+    check_solver_within_range(solver.solve(A, X, B, preconditioner),
+                              control.last_step(),
+                              min_steps,
+                              max_steps);
+    deallog.pop();
+  }
+
+  double difference = 0.;
+  for (unsigned int v = 0; v < B.n_vectors(); ++v)
+    {
+      Vector<double> r(A.m());
+      A.vmult(r, X[v]);
+      r -= B[v];
+      difference = std::max(difference, r.l2_norm());
+    }
+  deallog << "Residuals below tolerance: " << (difference < 1.e-7)
+          << std::endl;
+  deallog << "Zero solution for zero right hand side: "
+          << (X[3].l2_norm() == 0.) << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+  SparseMatrix<double> A_nonsymmetric(structure);
+  testproblem.five_point(A_nonsymmetric, true);
+
+  // products with multivectors without vectors are empty
+  {
+    MultiVector<Vector<double>> empty;
+    MultiVector<Vector<double>> V(4, Vector<double>(dim));
+    make_rhs(V);
+
+    FullMatrix<double> C;
+    empty.Tmmult(C, V);
+    deallog << "Size of empty inner products: " << C.m() << 'x' << C.n()
+            << std::endl;
+    V.Tmmult(C, empty);
+    deallog << "Size of empty inner products: " << C.m() << 'x' << C.n()
+            << std::endl;
+
+    V.mmult(empty, C);
+    empty.mmult(V, C, true);
+    deallog << "Unchanged by adding an empty sum: " << (V[0].l2_norm() > 0.)
+            << std::endl;
+    empty.mmult(V, C);
+    deallog << "Zero after an empty sum: " << (V[0].l2_norm() == 0.)
+            << std::endl;
+  }
+
+  PreconditionSSOR<> ssor;
+  ssor.initialize(A, 1.2);
+
+  test<SolverBlockCG<>>(A, ssor, "cg", 15, 40);
+  test<SolverBlockGMRES<>>(
+    A_nonsymmetric, PreconditionIdentity(), "gmres", 150, 230);
+}
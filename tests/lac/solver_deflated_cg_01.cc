@@ -0,0 +1,112 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Test SolverDeflatedCG on a sequence of linear systems with changing right
+// hand sides and a slightly changed matrix: the solutions must agree with the
+// ones of SolverCG, and the recycled deflation space must reduce the number of
+// iterations after the first solve.
+
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_deflated_cg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+template <typename Precondition>
+void
+test(const SparseMatrix<double> &A,
+     const SparseMatrix<double> &A_shifted,
+     const Precondition &        preconditioner,
+     const std::string &         name)
+{
+  deallog.push(name);
+
+  SolverControl                      control(1000, 1.e-8, false, false);
+  SolverDeflatedCG<>::AdditionalData data(8, 30);
+  SolverDeflatedCG<>                 solver(control, data);
+  std::vector<unsigned int>          steps;
+  double                             difference = 0.;
+
+  for (unsigned int s = 0; s < 4; ++s)
+    {
+      const SparseMatrix<double> &matrix = (s < 3 ? A : A_shifted);
+
+      Vector<double> b(A.m()), x(A.m()), reference(A.m());
+      for (unsigned int i = 0; i < b.size(); ++i)
+        b(i) = 1. + std::sin(0.1 * (s + 1) * i);
+
+      solver.solve(matrix, x, b, preconditioner);
+      steps.push_back(control.last_step());
+
+      SolverControl reference_control(1000, 1.e-12, false, false);
+      SolverCG<>    reference_solver(reference_control);
+      reference_solver.solve(matrix, reference, b, preconditioner);
+      reference -= x;
+      difference = std::max(difference, reference.linfty_norm());
+    }
+
+  deallog << "Deflation vectors: " << solver.n_deflation_vectors()
+          << std::endl;
+  deallog << "Difference to CG: " << (difference < 1.e-6 ? 0. : difference)
+          << std::endl;
+  deallog << "Fewer iterations with recycling: "
+          << (steps[1] < steps[0] && steps[2] < steps[0] &&
+                  steps[3] < steps[0] ?
+                "yes" :
+                "no")
+          << std::endl;
+  deallog << "Iteration savings reported: "
+          << (solver.iteration_savings() ==
+                  static_cast<int>(steps[0]) - static_cast<int>(steps[3]) ?
+                "yes" :
+                "no")
+          << std::endl;
+
+  deallog.pop();
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+  SparseMatrix<double> A_shifted(structure);
+  A_shifted.copy_from(A);
+  for (unsigned int i = 0; i < dim; ++i)
+    A_shifted.diag_element(i) *= 1.01;
+
+  PreconditionSSOR<> ssor;
+  ssor.initialize(A, 1.2);
+
+  test(A, A_shifted, PreconditionIdentity(), "identity");
+  test(A, A_shifted, ssor, "ssor");
+}
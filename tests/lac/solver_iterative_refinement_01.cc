@@ -0,0 +1,101 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Test SolverIterativeRefinement with a single precision inner CG solver: the
+// solution must reach the double precision tolerance of the outer solver
+// control and agree with the one of SolverCG in double precision, both for
+// Vector and LinearAlgebra::distributed::Vector
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_iterative_refinement.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+template <typename VectorType, typename InnerVectorType, typename Precondition>
+void
+test(const SparseMatrix<double> &A,
+     const SparseMatrix<float> & A_float,
+     const Precondition &        preconditioner,
+     VectorType &                x,
+     VectorType &                b)
+{
+  for (unsigned int i = 0; i < x.size(); ++i)
+    b(i) = 1. + std::sin(0.1 * i);
+
+  ReductionControl          inner_control(1000, 1e-30, 1e-3, false, false);
+  SolverCG<InnerVectorType> inner_solver(inner_control);
+
+  x = 0.;
+  SolverControl                                          control(100, 1e-10);
+  SolverIterativeRefinement<VectorType, InnerVectorType> solver(control);
+  check_solver_within_range(
+    solver.solve(A, x, b, A_float, inner_solver, preconditioner),
+    control.last_step(),
+    2,
+    10);
+
+  VectorType reference(x);
+  reference = 0.;
+  {
+    SolverControl        control(1000, 1e-12, false, false);
+    SolverCG<VectorType> solver(control);
+    solver.solve(A, reference, b, PreconditionIdentity());
+  }
+  reference -= x;
+  const double difference = reference.linfty_norm();
+  deallog << "Difference to double precision CG: "
+          << (difference < 1e-7 ? 0. : difference) << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+  SparseMatrix<float> A_float(structure);
+  A_float.copy_from(A);
+
+  {
+    PreconditionSSOR<SparseMatrix<float>> preconditioner;
+    preconditioner.initialize(A_float, 1.2);
+    Vector<double> x(dim), b(dim);
+    test<Vector<double>, Vector<float>>(A, A_float, preconditioner, x, b);
+  }
+  {
+    LinearAlgebra::distributed::Vector<double> x(dim), b(dim);
+    test<LinearAlgebra::distributed::Vector<double>,
+         LinearAlgebra::distributed::Vector<float>>(
+      A, A_float, PreconditionIdentity(), x, b);
+  }
+}
@@ -0,0 +1,94 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Solve the five-point Laplacian on several meshes with SolverCG and the
+// SparseAMG preconditioner, with both smoothers. The number of iterations
+// should be almost independent of the mesh size: it grows by at most one
+// half from the coarsest to the finest mesh.
+
+
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+
+void
+test(const unsigned int              size,
+     const SparseAMG::AdditionalData &data,
+     const unsigned int              min_iterations,
+     const unsigned int              max_iterations)
+{
+  const unsigned int dim = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  SparseAMG amg;
+  amg.initialize(A, data);
+  deallog << "Size " << size << " Unknowns " << dim
+          << " Levels " << amg.n_levels() << std::endl;
+  for (unsigned int level = 1; level < amg.n_levels(); ++level)
+    {
+      AssertDimension(amg.get_prolongator(level).m(),
+                      amg.get_matrix(level - 1).m());
+      AssertDimension(amg.get_prolongator(level).n(),
+                      amg.get_matrix(level).m());
+    }
+
+  Vector<double> solution(dim), rhs(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    rhs(i) = random_value<double>();
+
+  SolverControl            control(100, 1e-10 * rhs.l2_norm());
+  SolverCG<Vector<double>> solver(control);
+  check_solver_within_range(solver.solve(A, solution, rhs, amg),
+                            control.last_step(),
+                            min_iterations,
+                            max_iterations);
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("Chebyshev");
+  for (unsigned int size = 32; size <= 256; size *= 2)
+    test(size, SparseAMG::AdditionalData(), 10, 15);
+  deallog.pop();
+
+  deallog.push("Jacobi");
+  for (unsigned int size = 32; size <= 256; size *= 2)
+    test(size,
+         SparseAMG::AdditionalData(0.08, SparseAMG::AdditionalData::jacobi),
+         12,
+         18);
+  deallog.pop();
+}
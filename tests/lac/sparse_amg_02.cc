@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Solve the five-point Laplacian with pure Neumann boundary conditions, whose
+// matrix is singular, with SolverCG and the SparseAMG preconditioner. The
+// aggregates preserve the constants, so the coarse matrix is singular as
+// well and must be treated by the pseudo-inverse.
+
+
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+
+void
+test(const unsigned int size)
+{
+  const unsigned int dim = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  // make the row sums zero, which gives the Neumann matrix
+  for (unsigned int i = 0; i < dim; ++i)
+    {
+      double off_diagonal_sum = 0;
+      for (auto entry = A.begin(i); entry != A.end(i); ++entry)
+        if (entry->column() != i)
+          off_diagonal_sum += entry->value();
+      A.set(i, i, -off_diagonal_sum);
+    }
+
+  SparseAMG amg;
+  amg.initialize(A);
+  deallog << "Size " << size << " Unknowns " << dim << " Levels "
+          << amg.n_levels() << " Coarse size "
+          << amg.get_matrix(amg.n_levels() - 1).m() << std::endl;
+
+  // a right hand side with zero mean is in the range of the matrix
+  Vector<double> solution(dim), rhs(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    rhs(i) = random_value<double>();
+  rhs.add(-rhs.mean_value());
+
+  SolverControl            control(100, 1e-10 * rhs.l2_norm());
+  SolverCG<Vector<double>> solver(control);
+  check_solver_within_range(solver.solve(A, solution, rhs, amg),
+                            control.last_step(),
+                            10,
+                            12);
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  for (unsigned int size = 32; size <= 128; size *= 2)
+    test(size);
+}
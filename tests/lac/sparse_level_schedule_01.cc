@@ -0,0 +1,128 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that the level-scheduled triangular solves of SparseILU, SparseMIC,
+// PreconditionSOR, and PreconditionSSOR give the same results as the
+// sequential ones, for the five-point Laplacian in a multicolor numbering
+
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_ilu.h>
+#include <deal.II/lac/sparse_level_schedule.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_mic.h>
+#include <deal.II/lac/sparsity_tools.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+
+template <typename PreconditionerType>
+void
+check(const std::string &       name,
+      const PreconditionerType &preconditioner,
+      const Vector<double> &    src)
+{
+  Vector<double> dst(src.size()), dst_sequential(src.size());
+  preconditioner.vmult(dst, src);
+
+  // the level schedule falls back to the sequential substitution with only
+  // one thread
+  const unsigned int n_threads = MultithreadInfo::n_threads();
+  MultithreadInfo::set_thread_limit(1);
+  preconditioner.vmult(dst_sequential, src);
+  MultithreadInfo::set_thread_limit(n_threads);
+
+  dst -= dst_sequential;
+  deallog << name << " difference: " << dst.linfty_norm() << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 128;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  SparseLevelSchedule schedule;
+  schedule.initialize(structure);
+  deallog << "Lexicographic numbering: " << schedule.n_lower_levels()
+          << " lower levels, " << schedule.n_upper_levels()
+          << " upper levels" << std::endl;
+
+  // renumber the matrix by colors
+  DynamicSparsityPattern dsp(dim, dim);
+  for (auto entry = structure.begin(); entry != structure.end(); ++entry)
+    dsp.add(entry->row(), entry->column());
+  std::vector<types::global_dof_index> new_indices(dim);
+  SparsityTools::reorder_multicolor(dsp, new_indices);
+
+  DynamicSparsityPattern renumbered_dsp(dim, dim);
+  for (auto entry = A.begin(); entry != A.end(); ++entry)
+    renumbered_dsp.add(new_indices[entry->row()],
+                       new_indices[entry->column()]);
+  SparsityPattern renumbered_structure;
+  renumbered_structure.copy_from(renumbered_dsp);
+  SparseMatrix<double> B(renumbered_structure);
+  for (auto entry = A.begin(); entry != A.end(); ++entry)
+    B.set(new_indices[entry->row()],
+          new_indices[entry->column()],
+          entry->value());
+
+  schedule.initialize(renumbered_structure);
+  deallog << "Multicolor numbering: " << schedule.n_lower_levels()
+          << " lower levels, " << schedule.n_upper_levels()
+          << " upper levels" << std::endl;
+
+  Vector<double> src(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    src(i) = random_value<double>();
+
+  for (SparseMatrix<double> *matrix : {&A, &B})
+    {
+      SparseILU<double> ilu;
+      ilu.initialize(*matrix);
+      check("ILU", ilu, src);
+
+      SparseMIC<double> mic;
+      mic.initialize(*matrix);
+      check("MIC", mic, src);
+
+      PreconditionSOR<> sor;
+      sor.initialize(*matrix, 1.2);
+      check("SOR", sor, src);
+
+      PreconditionSSOR<> ssor;
+      ssor.initialize(*matrix, 1.2);
+      check("SSOR", ssor, src);
+    }
+}
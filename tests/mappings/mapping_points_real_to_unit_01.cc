@@ -0,0 +1,126 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check Mapping::transform_points_real_to_unit_cell() for MappingQGeneric,
+// MappingQ1 and MappingCartesian: map random points on the unit cell to the
+// real cell, map them back with the function for several points, and
+// compare with the original points and with transform_real_to_unit_cell().
+// Also check that a point far away from the cell is reported as failed or
+// mapped outside the unit cell, while the other points are unaffected
+
+#include <deal.II/fe/mapping_cartesian.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test(const Mapping<dim> &mapping, const Triangulation<dim> &tria)
+{
+  // use a number of points that is not a multiple of the SIMD width
+  const unsigned int      n_points = 13;
+  std::vector<Point<dim>> unit_points(n_points);
+  for (unsigned int i = 0; i < n_points; ++i)
+    unit_points[i] = random_point<dim>();
+
+  std::vector<Point<dim>> real_points(n_points + 1);
+  std::vector<Point<dim>> result(n_points + 1);
+
+  double error = 0, error_single = 0;
+  bool   far_point_ok = true;
+  for (const auto &cell : tria.active_cell_iterators())
+    {
+      for (unsigned int i = 0; i < n_points; ++i)
+        real_points[i] =
+          mapping.transform_unit_to_real_cell(cell, unit_points[i]);
+      real_points[n_points] = cell->center() + Point<dim>::unit_vector(0) *
+                                                 (10. * cell->diameter());
+
+      mapping.transform_points_real_to_unit_cell(
+        cell,
+        make_array_view(real_points),
+        make_array_view(result));
+
+      for (unsigned int i = 0; i < n_points; ++i)
+        {
+          error = std::max(error, unit_points[i].distance(result[i]));
+          error_single =
+            std::max(error_single,
+                     result[i].distance(mapping.transform_real_to_unit_cell(
+                       cell, real_points[i])));
+        }
+      if (result[n_points][0] != std::numeric_limits<double>::infinity() &&
+          GeometryInfo<dim>::is_inside_unit_cell(result[n_points]))
+        far_point_ok = false;
+    }
+  deallog << "Error to original points:    "
+          << filter_out_small_numbers(error, 1e-10) << std::endl;
+  deallog << "Error to single point version: "
+          << filter_out_small_numbers(error_single, 1e-10) << std::endl;
+  deallog << "Far point outside: " << far_point_ok << std::endl;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "dim = " << dim << std::endl;
+
+  {
+    Triangulation<dim> tria;
+    GridGenerator::hyper_shell(tria, Point<dim>(), 0.5, 1.);
+    deallog << "MappingQGeneric(4)" << std::endl;
+    test(MappingQGeneric<dim>(4), tria);
+  }
+  {
+    Triangulation<dim> tria;
+    GridGenerator::subdivided_hyper_cube(tria, 2);
+    GridTools::distort_random(0.2, tria);
+    deallog << "MappingQ1" << std::endl;
+    test(MappingQ1<dim>(), tria);
+  }
+  {
+    Triangulation<dim> tria;
+    Point<dim>         lower, upper;
+    for (unsigned int d = 0; d < dim; ++d)
+      upper[d] = 1. + d;
+    GridGenerator::hyper_rectangle(tria, lower, upper);
+    tria.refine_global(1);
+    deallog << "MappingCartesian" << std::endl;
+    test(MappingCartesian<dim>(), tria);
+  }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,183 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that MappingQCache gives the same quadrature points and JxW values
+// as the MappingQGeneric it was initialized with on a curved mesh, and the
+// same values as MappingQEulerian when initialized with a displacement
+// field. Also check that the cache of a copy is cleared when the
+// triangulation changes after the original has been destroyed
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_cache.h>
+#include <deal.II/fe/mapping_q_eulerian.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+class Displacement : public Function<dim>
+{
+public:
+  Displacement()
+    : Function<dim>(dim)
+  {}
+
+  virtual double
+  value(const Point<dim> &p, const unsigned int component) const override
+  {
+    return 0.1 * std::sin(p[component] + component);
+  }
+};
+
+
+
+template <int dim>
+double
+max_difference(const Mapping<dim> &      mapping_1,
+               const Mapping<dim> &      mapping_2,
+               const Triangulation<dim> &tria)
+{
+  const FE_Q<dim>   fe(1);
+  const QGauss<dim> quadrature(4);
+  FEValues<dim>     fe_values_1(mapping_1,
+                            fe,
+                            quadrature,
+                            update_quadrature_points | update_JxW_values);
+  FEValues<dim>     fe_values_2(mapping_2,
+                            fe,
+                            quadrature,
+                            update_quadrature_points | update_JxW_values);
+
+  double difference = 0;
+  for (const auto &cell : tria.active_cell_iterators())
+    {
+      fe_values_1.reinit(cell);
+      fe_values_2.reinit(cell);
+      for (unsigned int q = 0; q < quadrature.size(); ++q)
+        {
+          difference =
+            std::max(difference,
+                     fe_values_1.quadrature_point(q).distance(
+                       fe_values_2.quadrature_point(q)));
+          difference = std::max(
+            difference, std::abs(fe_values_1.JxW(q) - fe_values_2.JxW(q)));
+        }
+    }
+  return difference;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "dim = " << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_shell(tria, Point<dim>(), 0.5, 1.);
+  tria.refine_global(1);
+
+  const unsigned int   degree = 4;
+  MappingQGeneric<dim> mapping(degree);
+  MappingQCache<dim>   mapping_cache(degree);
+  mapping_cache.initialize(tria, mapping);
+  deallog << "Difference to MappingQGeneric: "
+          << filter_out_small_numbers(
+               max_difference(mapping, mapping_cache, tria), 1e-12)
+          << std::endl;
+
+  // a copy shares the cache
+  const std::unique_ptr<Mapping<dim>> mapping_copy = mapping_cache.clone();
+  deallog << "Difference of clone: "
+          << filter_out_small_numbers(
+               max_difference(mapping, *mapping_copy, tria), 1e-12)
+          << std::endl;
+
+  // MappingQEulerian adds the displacement to the support points of a
+  // MappingQ1, so compare on a mesh with straight edges
+  Triangulation<dim> tria_flat;
+  GridGenerator::subdivided_hyper_cube(tria_flat, 3);
+  FESystem<dim>   fe(FE_Q<dim>(degree), dim);
+  DoFHandler<dim> dof_handler(tria_flat);
+  dof_handler.distribute_dofs(fe);
+  Vector<double> displacement(dof_handler.n_dofs());
+  VectorTools::interpolate(mapping,
+                           dof_handler,
+                           Displacement<dim>(),
+                           displacement);
+
+  MappingQEulerian<dim> mapping_eulerian(degree, dof_handler, displacement);
+  MappingQCache<dim>    mapping_cache_eulerian(degree);
+  mapping_cache_eulerian.initialize(mapping, dof_handler, displacement);
+  deallog << "Difference to MappingQEulerian: "
+          << filter_out_small_numbers(max_difference(mapping_eulerian,
+                                                     mapping_cache_eulerian,
+                                                     tria_flat),
+                                      1e-12)
+          << std::endl;
+
+  // the cache is cleared on refinement and must be set up again. this also
+  // holds for a copy that outlives the object it was copied from
+  std::unique_ptr<Mapping<dim>> copy_of_temporary;
+  {
+    MappingQCache<dim> temporary(degree);
+    temporary.initialize(tria, mapping);
+    copy_of_temporary = temporary.clone();
+  }
+  const MappingQCache<dim> &surviving_copy =
+    dynamic_cast<const MappingQCache<dim> &>(*copy_of_temporary);
+  const std::size_t memory_before = surviving_copy.memory_consumption();
+  tria.refine_global(1);
+  deallog << "Cache of surviving copy cleared: "
+          << (surviving_copy.memory_consumption() < memory_before ? "yes" :
+                                                                    "no")
+          << std::endl;
+
+  mapping_cache.initialize(tria, mapping);
+  deallog << "Difference after refinement: "
+          << filter_out_small_numbers(
+               max_difference(mapping, mapping_cache, tria), 1e-12)
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
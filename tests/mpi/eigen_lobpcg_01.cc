@@ -0,0 +1,143 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test EigenLOBPCG on LinearAlgebra::distributed::Vector split over several
+// processors: the standard problem for the five-point finite difference
+// Laplacian, applied matrix-free on a grid whose rows are distributed, must
+// give the known eigenvalues on all processors, like the distributed case
+// of lac/eigen_lobpcg_01
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/eigen_lobpcg.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <algorithm>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+// the five-point Laplacian on an n x n grid, numbered row by row
+class LaplaceOperator
+{
+public:
+  LaplaceOperator(const unsigned int n)
+    : n(n)
+  {}
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    src.update_ghost_values();
+    for (unsigned int i = src.local_range().first;
+         i < src.local_range().second;
+         ++i)
+      {
+        const unsigned int row = i / n, col = i % n;
+
+        double value = 4. * src(i);
+        if (col > 0)
+          value -= src(i - 1);
+        if (col < n - 1)
+          value -= src(i + 1);
+        if (row > 0)
+          value -= src(i - n);
+        if (row < n - 1)
+          value -= src(i + n);
+        dst(i) = value;
+      }
+    src.zero_out_ghosts();
+  }
+
+private:
+  const unsigned int n;
+};
+
+
+
+void
+test()
+{
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  const unsigned int my_id = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+  const unsigned int size = 33;
+  const unsigned int n    = size - 1;
+  const unsigned int dim  = n * n;
+
+  // each processor owns a range of grid rows and needs the rows next to it
+  const unsigned int first_row = my_id * n / n_procs;
+  const unsigned int last_row  = (my_id + 1) * n / n_procs;
+  IndexSet           owned(dim), relevant(dim);
+  owned.add_range(first_row * n, last_row * n);
+  relevant.add_range(first_row > 0 ? (first_row - 1) * n : 0,
+                     last_row < n ? (last_row + 1) * n : dim);
+
+  const unsigned int  n_eigenpairs = 4;
+  std::vector<double> exact;
+  for (unsigned int i = 1; i < size; ++i)
+    for (unsigned int j = 1; j < size; ++j)
+      exact.push_back(4. - 2. * std::cos(numbers::PI * i / size) -
+                      2. * std::cos(numbers::PI * j / size));
+  std::sort(exact.begin(), exact.end());
+  exact.resize(n_eigenpairs);
+
+  MultiVector<VectorType> X(n_eigenpairs,
+                            VectorType(owned, relevant, MPI_COMM_WORLD));
+  for (unsigned int j = 0; j < n_eigenpairs; ++j)
+    for (const auto i : owned)
+      X[j](i) = 1. + std::sin(0.37 * (j + 1) * i + 0.1 * j * j);
+
+  SolverControl           control(1000, 1e-8, false, false);
+  EigenLOBPCG<VectorType> solver(control);
+  std::vector<double>     eigenvalues;
+  solver.solve(LaplaceOperator(n), PreconditionIdentity(), eigenvalues, X);
+
+  double error = 0.;
+  for (unsigned int i = 0; i < eigenvalues.size(); ++i)
+    error = std::max(error, std::abs(eigenvalues[i] - exact[i]));
+  deallog << "Eigenvalues:";
+  for (const double eigenvalue : eigenvalues)
+    deallog << ' ' << filter_out_small_numbers(eigenvalue, 1e-6);
+  deallog << std::endl;
+  deallog << "Error: " << filter_out_small_numbers(error, 1e-8) << std::endl;
+
+  FullMatrix<double> gram;
+  X.Tmmult(gram, X);
+  for (unsigned int i = 0; i < n_eigenpairs; ++i)
+    gram(i, i) -= 1.;
+  deallog << "Orthonormal: " << (gram.linfty_norm() < 1e-10 ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log;
+
+  test();
+}
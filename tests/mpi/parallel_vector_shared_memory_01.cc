@@ -0,0 +1,168 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check update_ghost_values() and compress(add) of vectors in shared memory
+// against the regular vector. To have both ghosts exchanged through shared
+// memory and through messages, the processes on a node are split into two
+// groups that act as separate nodes
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <iostream>
+#include <vector>
+
+#include "../tests.h"
+
+
+void
+test()
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  if (myid == 0)
+    deallog << "numproc=" << numproc << std::endl;
+
+  MPI_Comm comm_node, comm_sm;
+  MPI_Comm_split_type(
+    MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myid, MPI_INFO_NULL, &comm_node);
+  MPI_Comm_split(comm_node, myid % 2, myid, &comm_sm);
+
+  const unsigned int set         = 200;
+  const unsigned int local_size  = set - myid;
+  unsigned int       global_size = 0;
+  unsigned int       my_start    = 0;
+  for (unsigned int i = 0; i < numproc; ++i)
+    {
+      global_size += set - i;
+      if (i < myid)
+        my_start += set - i;
+    }
+
+  // each processor owns some indices and ghosts a few entries of all other
+  // processors, some of them around the border between two processors
+  IndexSet local_owned(global_size);
+  local_owned.add_range(my_start, my_start + local_size);
+  IndexSet local_relevant(global_size);
+  unsigned int offset = 0;
+  for (unsigned int p = 0; p < numproc; ++p)
+    {
+      if (p != myid)
+        {
+          local_relevant.add_index(offset);
+          local_relevant.add_index(offset + 1);
+          local_relevant.add_index(offset + 7 + myid);
+          local_relevant.add_index(offset + set - p - 1);
+        }
+      offset += set - p;
+    }
+
+  auto partitioner = std::make_shared<Utilities::MPI::Partitioner>(
+    local_owned, local_relevant, MPI_COMM_WORLD);
+
+  LinearAlgebra::distributed::Vector<double> v(partitioner), v_shared,
+    w_shared;
+  v_shared.reinit(partitioner, comm_sm);
+  w_shared.reinit(v_shared);
+
+  for (unsigned int i = 0; i < local_size; ++i)
+    {
+      v.local_element(i)        = 2.0 * (i + my_start);
+      v_shared.local_element(i) = 2.0 * (i + my_start);
+    }
+
+  v.update_ghost_values();
+  v_shared.update_ghost_values();
+  for (unsigned int i = 0; i < local_size + partitioner->n_ghost_indices();
+       ++i)
+    AssertThrow(v.local_element(i) == v_shared.local_element(i),
+                ExcInternalError());
+  if (myid == 0)
+    deallog << "update_ghost_values OK" << std::endl;
+
+  // add to the ghost entries and compress twice to check that the ghost
+  // entries are cleared correctly
+  for (unsigned int cycle = 0; cycle < 2; ++cycle)
+    {
+      v.zero_out_ghosts();
+      v_shared.zero_out_ghosts();
+      for (unsigned int i = 0; i < partitioner->n_ghost_indices(); ++i)
+        {
+          v.local_element(local_size + i) += myid + 1. + i;
+          v_shared.local_element(local_size + i) += myid + 1. + i;
+        }
+      v.compress(VectorOperation::add);
+      v_shared.compress(VectorOperation::add);
+      for (unsigned int i = 0; i < local_size; ++i)
+        AssertThrow(v.local_element(i) == v_shared.local_element(i),
+                    ExcInternalError());
+      for (unsigned int i = 0; i < partitioner->n_ghost_indices(); ++i)
+        AssertThrow(v_shared.local_element(local_size + i) == 0.,
+                    ExcInternalError());
+    }
+  if (myid == 0)
+    deallog << "compress OK" << std::endl;
+
+  // vectors created from the shared vector share its layout
+  w_shared = v_shared;
+  w_shared.update_ghost_values();
+  v.update_ghost_values();
+  for (unsigned int i = 0; i < local_size + partitioner->n_ghost_indices();
+       ++i)
+    AssertThrow(v.local_element(i) == w_shared.local_element(i),
+                ExcInternalError());
+  if (myid == 0)
+    deallog << "copy OK" << std::endl;
+
+  // the memory consumption includes the part of the shared memory window
+  // that holds the locally owned and ghost entries
+  AssertThrow(w_shared.memory_consumption() >=
+                (local_size + partitioner->n_ghost_indices()) * sizeof(double),
+              ExcInternalError());
+  if (myid == 0)
+    deallog << "memory_consumption OK" << std::endl;
+
+  v_shared.reinit(0);
+  w_shared.reinit(0);
+  MPI_Comm_free(&comm_sm);
+  MPI_Comm_free(&comm_node);
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+      deallog << std::setprecision(4);
+
+      test();
+    }
+  else
+    test();
+}
@@ -0,0 +1,149 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test Utilities::MPI::RemotePointEvaluation on a
+// parallel::shared::Triangulation: all processes ask for the same points,
+// most of which lie in cells owned by other processes, and evaluate a
+// quadratic field that is represented exactly by FE_Q(2)
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/mpi_remote_point_evaluation.h>
+
+#include <deal.II/distributed/shared_tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/numerics/vector_tools_evaluate.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+class QuadraticFunction : public Function<dim>
+{
+public:
+  QuadraticFunction(const double factor)
+    : Function<dim>(1)
+    , factor(factor)
+  {}
+
+  virtual double
+  value(const Point<dim> &p, const unsigned int = 0) const override
+  {
+    return factor * (p[0] * p[0] + p[dim - 1]);
+  }
+
+  virtual Tensor<1, dim>
+  gradient(const Point<dim> &p, const unsigned int = 0) const override
+  {
+    Tensor<1, dim> gradient;
+    gradient[0] += factor * 2. * p[0];
+    gradient[dim - 1] += factor;
+    return gradient;
+  }
+
+private:
+  const double factor;
+};
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "dim = " << dim << std::endl;
+
+  parallel::shared::Triangulation<dim> tria(
+    MPI_COMM_WORLD,
+    Triangulation<dim>::none,
+    false,
+    parallel::shared::Triangulation<dim>::partition_zorder);
+  GridGenerator::hyper_cube(tria, -1, 1);
+  tria.refine_global(3);
+
+  const FE_Q<dim>            fe(2);
+  const MappingQGeneric<dim> mapping(1);
+  DoFHandler<dim>            dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  // the same points on all processes, and one point outside the mesh
+  std::vector<Point<dim>> points;
+  for (unsigned int i = 0; i < 50; ++i)
+    points.push_back(random_point<dim>(-1, 1));
+  points.push_back(Point<dim>::unit_vector(0) * 2.);
+
+  Utilities::MPI::RemotePointEvaluation<dim> evaluation;
+  evaluation.reinit(points, tria, mapping);
+  deallog << "Locally owned cells: " << tria.n_locally_owned_active_cells()
+          << std::endl;
+  deallog << "Points evaluated on this process: "
+          << evaluation.get_cell_data().point_indices.size() << std::endl;
+  deallog << "Missing points:";
+  for (const unsigned int i : evaluation.get_missing_points())
+    deallog << ' ' << i;
+  deallog << std::endl;
+
+  // evaluate twice to use the FEValues objects set up in the first round
+  Vector<double> solution(dof_handler.n_dofs());
+  for (const double factor : {1., -2.})
+    {
+      const QuadraticFunction<dim> function(factor);
+      VectorTools::interpolate(mapping, dof_handler, function, solution);
+
+      const auto values =
+        VectorTools::point_values<1>(evaluation, dof_handler, solution);
+      const auto gradients =
+        VectorTools::point_gradients<1>(evaluation, dof_handler, solution);
+
+      double error_values = 0, error_gradients = 0;
+      for (unsigned int i = 0; i + 1 < points.size(); ++i)
+        {
+          error_values =
+            std::max(error_values,
+                     std::abs(values[i][0] - function.value(points[i])));
+          error_gradients =
+            std::max(error_gradients,
+                     (gradients[i][0] - function.gradient(points[i])).norm());
+        }
+      deallog << "Error values:    "
+              << filter_out_small_numbers(error_values, 1e-12) << std::endl;
+      deallog << "Error gradients: "
+              << filter_out_small_numbers(error_gradients, 1e-10)
+              << std::endl;
+    }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log_all;
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,217 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check AssemblyPlan: assemble a Laplace matrix with inhomogeneous
+// constraints in parallel through AssemblyPlan::run() with concurrently
+// running copiers, and compare with a serial assembly through
+// AffineConstraints::distribute_local_to_global. Also check that cells of
+// the same color do not share any rows and that the gather operation
+// matches DoFCellAccessor::get_dof_values
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/assembly_plan.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <set>
+
+#include "../tests.h"
+
+
+template <int dim>
+struct ScratchData
+{
+  ScratchData(const FiniteElement<dim> &fe, const Quadrature<dim> &quadrature)
+    : fe_values(fe, quadrature, update_gradients | update_JxW_values)
+  {}
+
+  ScratchData(const ScratchData &data)
+    : fe_values(data.fe_values.get_fe(),
+                data.fe_values.get_quadrature(),
+                data.fe_values.get_update_flags())
+  {}
+
+  FEValues<dim> fe_values;
+};
+
+
+template <int dim>
+struct CopyData
+{
+  typename DoFHandler<dim>::active_cell_iterator cell;
+  FullMatrix<double>                             cell_matrix;
+  Vector<double>                                 cell_rhs;
+};
+
+
+template <int dim>
+void
+local_assemble(const typename DoFHandler<dim>::active_cell_iterator &cell,
+               ScratchData<dim> &                                    scratch,
+               CopyData<dim> &                                       copy)
+{
+  scratch.fe_values.reinit(cell);
+  const unsigned int dofs_per_cell = scratch.fe_values.dofs_per_cell;
+  copy.cell = cell;
+  copy.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+  copy.cell_rhs.reinit(dofs_per_cell);
+  for (unsigned int q = 0; q < scratch.fe_values.n_quadrature_points; ++q)
+    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+      {
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          copy.cell_matrix(i, j) += scratch.fe_values.shape_grad(i, q) *
+                                    scratch.fe_values.shape_grad(j, q) *
+                                    scratch.fe_values.JxW(q);
+        copy.cell_rhs(i) += scratch.fe_values.JxW(q);
+      }
+}
+
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  for (unsigned int i = 0; i < 2; ++i)
+    {
+      tria.begin_active()->set_refine_flag();
+      (std::next(tria.begin_active(), tria.n_active_cells() / 2))
+        ->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+    }
+
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  VectorTools::interpolate_boundary_values(dof_handler,
+                                           0,
+                                           Functions::ConstantFunction<dim>(2.),
+                                           constraints);
+  constraints.close();
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints, false);
+    sparsity.copy_from(dsp);
+  }
+
+  AssemblyPlan<DoFHandler<dim>> plan(dof_handler, constraints, sparsity);
+  deallog << "Number of cells: " << plan.n_cells() << std::endl;
+
+  // check that cells of the same color do not write into the same rows
+  bool colors_ok = true;
+  for (const auto &color : plan.get_colored_cells())
+    {
+      std::set<types::global_dof_index> rows;
+      for (const auto &cell : color)
+        {
+          std::vector<types::global_dof_index> indices(fe.dofs_per_cell);
+          cell->get_dof_indices(indices);
+          constraints.resolve_indices(indices);
+          for (const auto index : indices)
+            if (rows.insert(index).second == false)
+              colors_ok = false;
+        }
+    }
+  deallog << "Colors conflict free: " << (colors_ok ? "yes" : "no")
+          << std::endl;
+
+  // check the gather operation
+  Vector<double> solution(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = random_value<double>();
+  Vector<double> plan_values, cell_values(fe.dofs_per_cell);
+  double         gather_error = 0;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      plan.get_dof_values(cell, solution, plan_values);
+      cell->get_dof_values(solution, cell_values);
+      plan_values -= cell_values;
+      gather_error += plan_values.l2_norm();
+    }
+  deallog << "Gather error: " << gather_error << std::endl;
+
+  // serial reference assembly
+  SparseMatrix<double> reference(sparsity), matrix(sparsity);
+  Vector<double> reference_rhs(dof_handler.n_dofs()), rhs(dof_handler.n_dofs());
+  {
+    ScratchData<dim>                     scratch(fe, QGauss<dim>(3));
+    CopyData<dim>                        copy;
+    std::vector<types::global_dof_index> indices(fe.dofs_per_cell);
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      {
+        local_assemble<dim>(cell, scratch, copy);
+        cell->get_dof_indices(indices);
+        constraints.distribute_local_to_global(
+          copy.cell_matrix, copy.cell_rhs, indices, reference, reference_rhs);
+      }
+  }
+
+  // assemble twice to check that the plan can be reused
+  for (unsigned int repetition = 0; repetition < 2; ++repetition)
+    {
+      matrix = 0;
+      rhs    = 0;
+      plan.run(local_assemble<dim>,
+               [&](const CopyData<dim> &copy) {
+                 plan.distribute_local_to_global(
+                   copy.cell, copy.cell_matrix, copy.cell_rhs, matrix, rhs);
+               },
+               ScratchData<dim>(fe, QGauss<dim>(3)),
+               CopyData<dim>());
+
+      matrix.add(-1., reference);
+      rhs -= reference_rhs;
+      deallog << "Difference matrix: "
+              << filter_out_small_numbers(matrix.frobenius_norm(), 1e-12)
+              << ", rhs: " << filter_out_small_numbers(rhs.l2_norm(), 1e-12)
+              << std::endl;
+    }
+}
+
+
+int
+main()
+{
+  initlog();
+  MultithreadInfo::set_thread_limit(testing_max_num_threads());
+
+  test<2>();
+  test<3>();
+}
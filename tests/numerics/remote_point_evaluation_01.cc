@@ -0,0 +1,155 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test Utilities::MPI::RemotePointEvaluation together with
+// VectorTools::point_values() and VectorTools::point_gradients() on a serial
+// triangulation: evaluate a quadratic vector field that is represented
+// exactly by FE_Q(2) at random points, twice with the same setup, and check
+// that points outside the mesh are reported as missing
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/mpi_remote_point_evaluation.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/numerics/vector_tools_evaluate.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+class QuadraticFunction : public Function<dim>
+{
+public:
+  QuadraticFunction(const double factor)
+    : Function<dim>(2)
+    , factor(factor)
+  {}
+
+  virtual double
+  value(const Point<dim> &p, const unsigned int component) const override
+  {
+    if (component == 0)
+      return factor * (p[0] * p[0] + p[dim - 1]);
+    else
+      return factor * p[0] * p[dim - 1];
+  }
+
+  virtual Tensor<1, dim>
+  gradient(const Point<dim> &p, const unsigned int component) const override
+  {
+    Tensor<1, dim> gradient;
+    if (component == 0)
+      {
+        gradient[0] += factor * 2. * p[0];
+        gradient[dim - 1] += factor;
+      }
+    else
+      {
+        gradient[0] += factor * p[dim - 1];
+        gradient[dim - 1] += factor * p[0];
+      }
+    return gradient;
+  }
+
+private:
+  const double factor;
+};
+
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "dim = " << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, -1, 1);
+  tria.refine_global(2);
+
+  const FESystem<dim>        fe(FE_Q<dim>(2), 2);
+  const MappingQGeneric<dim> mapping(1);
+  DoFHandler<dim>            dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  std::vector<Point<dim>> points;
+  for (unsigned int i = 0; i < 100; ++i)
+    points.push_back(random_point<dim>(-1, 1));
+  points.insert(points.begin() + 10, Point<dim>::unit_vector(0) * 2.);
+
+  Utilities::MPI::RemotePointEvaluation<dim> evaluation;
+  evaluation.reinit(points, tria, mapping);
+  deallog << "Missing points:";
+  for (const unsigned int i : evaluation.get_missing_points())
+    deallog << ' ' << i;
+  deallog << std::endl;
+
+  Vector<double> solution(dof_handler.n_dofs());
+  for (const double factor : {1., -2.})
+    {
+      const QuadraticFunction<dim> function(factor);
+      VectorTools::interpolate(mapping, dof_handler, function, solution);
+
+      const auto values =
+        VectorTools::point_values<2>(evaluation, dof_handler, solution);
+      const auto gradients =
+        VectorTools::point_gradients<2>(evaluation, dof_handler, solution);
+
+      double error_values = 0, error_gradients = 0;
+      for (unsigned int i = 0; i < points.size(); ++i)
+        if (i != 10)
+          for (unsigned int c = 0; c < 2; ++c)
+            {
+              error_values =
+                std::max(error_values,
+                         std::abs(values[i][c] - function.value(points[i], c)));
+              error_gradients =
+                std::max(error_gradients,
+                         (gradients[i][c] - function.gradient(points[i], c))
+                           .norm());
+            }
+      deallog << "Error values:    "
+              << filter_out_small_numbers(error_values, 1e-12) << std::endl;
+      deallog << "Error gradients: "
+              << filter_out_small_numbers(error_gradients, 1e-10)
+              << std::endl;
+      deallog << "Value of missing point: " << values[10] << std::endl;
+    }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  initlog();
+
+  test<2>();
+  test<3>();
+}